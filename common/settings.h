@@ -280,6 +280,9 @@ struct Settings {
   // calls in this callback will cause applications to jank.
   LogMessageCallback log_message_callback;
   bool enable_software_rendering = false;
+  // Whether the depth of the frame pipeline between the UI and raster
+  // threads adapts to the raster time of frames.
+  bool enable_adaptive_pipeline_depth = false;
   bool skia_deterministic_rendering_on_cpu = false;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
@@ -21,6 +21,7 @@ DisplayList::DisplayList()
       nested_op_count_(0),
       unique_id_(0),
       bounds_({0, 0, 0, 0}),
+      opaque_bounds_({0, 0, 0, 0}),
       can_apply_group_opacity_(true) {}
 
 DisplayList::DisplayList(DisplayListStorage&& storage,
@@ -29,6 +30,7 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
                          size_t nested_byte_count,
                          unsigned int nested_op_count,
                          const SkRect& bounds,
+                         const SkRect& opaque_bounds,
                          bool can_apply_group_opacity,
                          sk_sp<const DlRTree> rtree)
     : storage_(std::move(storage)),
@@ -38,6 +40,7 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
       nested_op_count_(nested_op_count),
       unique_id_(next_unique_id()),
       bounds_(bounds),
+      opaque_bounds_(opaque_bounds),
       can_apply_group_opacity_(can_apply_group_opacity),
       rtree_(std::move(rtree)) {}
 
@@ -252,6 +252,11 @@ class DisplayList : public SkRefCnt {
 
   const SkRect& bounds() const { return bounds_; }
 
+  // A conservative rectangle, in the same coordinate space as |bounds|,
+  // that is known to be completely covered by opaque pixels when the
+  // DisplayList is rendered, or an empty rect if no such area was found.
+  const SkRect& opaque_bounds() const { return opaque_bounds_; }
+
   bool has_rtree() const { return rtree_ != nullptr; }
   sk_sp<const DlRTree> rtree() const { return rtree_; }
 
@@ -272,6 +277,7 @@ class DisplayList : public SkRefCnt {
               size_t nested_byte_count,
               unsigned int nested_op_count,
               const SkRect& bounds,
+              const SkRect& opaque_bounds,
               bool can_apply_group_opacity,
               sk_sp<const DlRTree> rtree);
 
@@ -286,6 +292,7 @@ class DisplayList : public SkRefCnt {
 
   const uint32_t unique_id_;
   const SkRect bounds_;
+  const SkRect opaque_bounds_;
 
   const bool can_apply_group_opacity_;
   const sk_sp<const DlRTree> rtree_;
@@ -2622,5 +2622,69 @@ TEST_F(DisplayListTest, DrawSaveDrawCannotInheritOpacity) {
   ASSERT_FALSE(display_list->can_apply_group_opacity());
 }
 
+TEST_F(DisplayListTest, OpaqueRectReportsOpaqueBounds) {
+  DisplayListBuilder builder;
+  builder.DrawRect({10, 10, 50, 50}, DlPaint(DlColor::kBlue()));
+  builder.Translate(5, 5);
+  builder.DrawRect({0, 0, 100, 100}, DlPaint(DlColor::kRed()));
+  auto display_list = builder.Build();
+
+  EXPECT_EQ(display_list->opaque_bounds(), SkRect::MakeLTRB(5, 5, 105, 105));
+}
+
+TEST_F(DisplayListTest, OpaqueColorReportsClipAsOpaqueBounds) {
+  DisplayListBuilder builder(SkRect::MakeWH(100, 100));
+  builder.ClipRect({10, 20, 30, 40}, DlCanvas::ClipOp::kIntersect, false);
+  builder.DrawColor(DlColor::kGreen(), DlBlendMode::kSrcOver);
+  auto display_list = builder.Build();
+
+  EXPECT_EQ(display_list->opaque_bounds(), SkRect::MakeLTRB(10, 20, 30, 40));
+}
+
+TEST_F(DisplayListTest, TranslucentOrStrokedRectHasNoOpaqueBounds) {
+  {
+    DisplayListBuilder builder;
+    DlPaint paint = DlPaint(DlColor::kBlue().withAlpha(0x7f));
+    builder.DrawRect({10, 10, 50, 50}, paint);
+    EXPECT_TRUE(builder.Build()->opaque_bounds().isEmpty());
+  }
+  {
+    DisplayListBuilder builder;
+    DlPaint paint =
+        DlPaint(DlColor::kBlue()).setDrawStyle(DlDrawStyle::kStroke);
+    builder.DrawRect({10, 10, 50, 50}, paint);
+    EXPECT_TRUE(builder.Build()->opaque_bounds().isEmpty());
+  }
+}
+
+TEST_F(DisplayListTest, OpaqueBoundsIgnoreContentsOfSaveLayerAndComplexClips) {
+  {
+    DisplayListBuilder builder;
+    builder.SaveLayer(nullptr, nullptr);
+    builder.DrawRect({10, 10, 50, 50}, DlPaint(DlColor::kBlue()));
+    builder.Restore();
+    EXPECT_TRUE(builder.Build()->opaque_bounds().isEmpty());
+  }
+  {
+    DisplayListBuilder builder;
+    builder.Save();
+    builder.ClipRRect(SkRRect::MakeRectXY({0, 0, 40, 40}, 5, 5),
+                      DlCanvas::ClipOp::kIntersect, true);
+    builder.DrawRect({10, 10, 50, 50}, DlPaint(DlColor::kBlue()));
+    builder.Restore();
+    builder.Rotate(45);
+    builder.DrawRect({10, 10, 50, 50}, DlPaint(DlColor::kBlue()));
+    EXPECT_TRUE(builder.Build()->opaque_bounds().isEmpty());
+  }
+}
+
+TEST_F(DisplayListTest, DestructiveBlendModeClearsOpaqueBounds) {
+  DisplayListBuilder builder;
+  builder.DrawRect({10, 10, 50, 50}, DlPaint(DlColor::kBlue()));
+  DlPaint clear_paint = DlPaint().setBlendMode(DlBlendMode::kClear);
+  builder.DrawRect({20, 20, 30, 30}, clear_paint);
+  EXPECT_TRUE(builder.Build()->opaque_bounds().isEmpty());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -73,9 +73,11 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   nested_bytes_ = nested_op_count_ = 0;
   storage_.realloc(bytes);
   bool compatible = layer_stack_.back().is_group_opacity_compatible();
-  return sk_sp<DisplayList>(new DisplayList(std::move(storage_), bytes, count,
-                                            nested_bytes, nested_count,
-                                            bounds(), compatible, rtree()));
+  SkRect opaque_bounds = opaque_bounds_;
+  opaque_bounds_.setEmpty();
+  return sk_sp<DisplayList>(new DisplayList(
+      std::move(storage_), bytes, count, nested_bytes, nested_count, bounds(),
+      opaque_bounds, compatible, rtree()));
 }
 
 DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
@@ -380,9 +382,11 @@ void DisplayListBuilder::checkForDeferredSave() {
 }
 
 void DisplayListBuilder::Save() {
+  bool tracks_opaque_bounds = current_layer_->tracks_opaque_bounds_;
   layer_stack_.emplace_back();
   current_layer_ = &layer_stack_.back();
   current_layer_->has_deferred_save_op_ = true;
+  current_layer_->tracks_opaque_bounds_ = tracks_opaque_bounds;
   tracker_.save();
   accumulator()->save();
 }
@@ -482,6 +486,10 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
   CheckLayerOpacityCompatibility(options.renders_with_attributes());
 
   if (options.renders_with_attributes()) {
+    // The contents of the layer are not known to be opaque, even if the
+    // paint used to composite it is.
+    CheckOpaqueBoundsCompatibility(current_.getBlendMode(), false);
+
     // The actual flood of the outer layer clip will occur after the
     // (eventual) corresponding restore is called, but rather than
     // remember this information in the LayerInfo until the restore
@@ -502,6 +510,8 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
   tracker_.save();
   accumulator()->save();
   current_layer_ = &layer_stack_.back();
+  // Ops inside the layer render onto the layer rather than the base surface.
+  current_layer_->tracks_opaque_bounds_ = false;
   if (options.renders_with_attributes()) {
     // |current_opacity_compatibility_| does not take an ImageFilter into
     // account because an individual primitive with an ImageFilter can apply
@@ -646,9 +656,14 @@ void DisplayListBuilder::ClipRect(const SkRect& rect,
   switch (clip_op) {
     case ClipOp::kIntersect:
       Push<ClipIntersectRectOp>(0, 1, rect, is_aa);
+      if (tracker_.using_4x4_matrix() ||
+          !tracker_.matrix_3x3().rectStaysRect()) {
+        current_layer_->tracks_opaque_bounds_ = false;
+      }
       break;
     case ClipOp::kDifference:
       Push<ClipDifferenceRectOp>(0, 1, rect, is_aa);
+      current_layer_->tracks_opaque_bounds_ = false;
       break;
   }
   tracker_.clipRect(rect, clip_op, is_aa);
@@ -668,6 +683,7 @@ void DisplayListBuilder::ClipRRect(const SkRRect& rrect,
         Push<ClipDifferenceRRectOp>(0, 1, rrect, is_aa);
         break;
     }
+    current_layer_->tracks_opaque_bounds_ = false;
     tracker_.clipRRect(rrect, clip_op, is_aa);
   }
 }
@@ -700,6 +716,7 @@ void DisplayListBuilder::ClipPath(const SkPath& path,
       Push<ClipDifferencePathOp>(0, 1, path, is_aa);
       break;
   }
+  current_layer_->tracks_opaque_bounds_ = false;
   tracker_.clipPath(path, clip_op, is_aa);
 }
 
@@ -711,6 +728,7 @@ void DisplayListBuilder::drawPaint() {
   Push<DrawPaintOp>(0, 1);
   CheckLayerOpacityCompatibility();
   AccumulateUnbounded();
+  AccumulateOpaqueBounds(nullptr);
 }
 void DisplayListBuilder::DrawPaint(const DlPaint& paint) {
   SetAttributesFromPaint(paint, DisplayListOpFlags::kDrawPaintFlags);
@@ -719,7 +737,17 @@ void DisplayListBuilder::DrawPaint(const DlPaint& paint) {
 void DisplayListBuilder::DrawColor(DlColor color, DlBlendMode mode) {
   Push<DrawColorOp>(0, 1, color, mode);
   CheckLayerOpacityCompatibility(mode);
+  CheckOpaqueBoundsCompatibility(mode, color.isOpaque());
   AccumulateUnbounded();
+  if (color.isOpaque() &&
+      (mode == DlBlendMode::kSrc || mode == DlBlendMode::kSrcOver) &&
+      current_layer_->tracks_opaque_bounds_) {
+    SkRect clip = tracker_.device_cull_rect();
+    if (clip.width() * clip.height() >
+        opaque_bounds_.width() * opaque_bounds_.height()) {
+      opaque_bounds_ = clip;
+    }
+  }
 }
 void DisplayListBuilder::drawLine(const SkPoint& p0, const SkPoint& p1) {
   Push<DrawLineOp>(0, 1, p0, p1);
@@ -740,6 +768,7 @@ void DisplayListBuilder::drawRect(const SkRect& rect) {
   Push<DrawRectOp>(0, 1, rect);
   CheckLayerOpacityCompatibility();
   AccumulateOpBounds(rect, kDrawRectFlags);
+  AccumulateOpaqueBounds(&rect);
 }
 void DisplayListBuilder::DrawRect(const SkRect& rect, const DlPaint& paint) {
   SetAttributesFromPaint(paint, DisplayListOpFlags::kDrawRectFlags);
@@ -868,6 +897,7 @@ void DisplayListBuilder::drawPoints(PointMode mode,
       return;
   }
   CopyV(data_ptr, pts, count);
+  CheckOpaqueBoundsCompatibility(current_.getBlendMode(), false);
   // drawPoints treats every point or line (or segment of a polygon)
   // as a completely separate operation meaning we cannot ensure
   // distribution of group opacity without analyzing the mode and the
@@ -906,6 +936,7 @@ void DisplayListBuilder::drawVertices(const DlVertices* vertices,
   // Although, examination of the |mode| might find some predictable
   // cases.
   UpdateLayerOpacityCompatibility(false);
+  CheckOpaqueBoundsCompatibility(current_.getBlendMode(), false);
   AccumulateOpBounds(vertices->bounds(), kDrawVerticesFlags);
 }
 void DisplayListBuilder::DrawVertices(const DlVertices* vertices,
@@ -1034,6 +1065,9 @@ void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
   // on it to distribute the opacity without overlap without checking all
   // of the transforms and texture rectangles.
   UpdateLayerOpacityCompatibility(false);
+  if (render_with_attributes) {
+    CheckOpaqueBoundsCompatibility(current_.getBlendMode(), false);
+  }
 
   SkPoint quad[4];
   RectBoundsAccumulator atlasBounds;
@@ -1109,6 +1143,9 @@ void DisplayListBuilder::DrawDisplayList(const sk_sp<DisplayList> display_list,
   nested_op_count_ += display_list->op_count(true) - 1;
   nested_bytes_ += display_list->bytes(true);
   UpdateLayerOpacityCompatibility(display_list->can_apply_group_opacity());
+  // The nested ops may use any blend mode so we cannot trust the opaque
+  // coverage computed so far.
+  opaque_bounds_.setEmpty();
 }
 void DisplayListBuilder::drawTextBlob(const sk_sp<SkTextBlob> blob,
                                       SkScalar x,
@@ -1121,6 +1158,7 @@ void DisplayListBuilder::drawTextBlob(const sk_sp<SkTextBlob> blob,
   // so we must make the conservative assessment that this DL layer is
   // not compatible with group opacity inheritance.
   UpdateLayerOpacityCompatibility(false);
+  CheckOpaqueBoundsCompatibility(current_.getBlendMode(), false);
 }
 void DisplayListBuilder::DrawTextBlob(const sk_sp<SkTextBlob>& blob,
                                       SkScalar x,
@@ -1211,6 +1249,45 @@ bool DisplayListBuilder::AdjustBoundsForPaint(SkRect& bounds,
   return true;
 }
 
+bool DisplayListBuilder::CurrentAttributesAreOpaque() const {
+  if (!current_.getColor().isOpaque() ||
+      current_.getDrawStyle() != DlDrawStyle::kFill) {
+    return false;
+  }
+  if (current_.getBlendMode() != DlBlendMode::kSrcOver &&
+      current_.getBlendMode() != DlBlendMode::kSrc) {
+    return false;
+  }
+  if (current_.getColorSource() && !current_.getColorSource()->is_opaque()) {
+    return false;
+  }
+  return current_.getColorFilter() == nullptr &&
+         current_.getImageFilter() == nullptr &&
+         current_.getMaskFilter() == nullptr &&
+         current_.getPathEffect() == nullptr;
+}
+
+void DisplayListBuilder::AccumulateOpaqueBounds(const SkRect* rect) {
+  if (!current_layer_->tracks_opaque_bounds_ || !CurrentAttributesAreOpaque()) {
+    return;
+  }
+  SkRect covered = tracker_.device_cull_rect();
+  if (rect) {
+    if (tracker_.using_4x4_matrix() ||
+        !tracker_.matrix_3x3().rectStaysRect()) {
+      return;
+    }
+    SkRect device_rect = tracker_.matrix_3x3().mapRect(*rect);
+    if (!covered.intersect(device_rect)) {
+      return;
+    }
+  }
+  if (covered.width() * covered.height() >
+      opaque_bounds_.width() * opaque_bounds_.height()) {
+    opaque_bounds_ = covered;
+  }
+}
+
 void DisplayListBuilder::AccumulateUnbounded() {
   accumulator()->accumulate(tracker_.device_cull_rect(), op_index_ - 1);
 }
@@ -576,6 +576,12 @@ class DisplayListBuilder final : public virtual DlCanvas,
     bool is_unbounded_;
     bool has_deferred_save_op_ = false;
 
+    // Indicates that ops at this level render directly onto the base
+    // surface of the DisplayList and that all outstanding clips are
+    // rectangles, so that any opaque coverage they produce can be
+    // recorded in |DisplayListBuilder::opaque_bounds_|.
+    bool tracks_opaque_bounds_ = true;
+
     friend class DisplayListBuilder;
   };
 
@@ -624,6 +630,10 @@ class DisplayListBuilder final : public virtual DlCanvas,
   void CheckLayerOpacityCompatibility(bool uses_blend_attribute = true) {
     UpdateLayerOpacityCompatibility(!uses_blend_attribute ||
                                     current_opacity_compatibility_);
+    if (uses_blend_attribute) {
+      CheckOpaqueBoundsCompatibility(current_.getBlendMode(),
+                                     CurrentAttributesAreOpaque());
+    }
   }
 
   void CheckLayerOpacityHairlineCompatibility() {
@@ -631,6 +641,8 @@ class DisplayListBuilder final : public virtual DlCanvas,
         current_opacity_compatibility_ &&
         (current_.getDrawStyle() == DlDrawStyle::kFill ||
          current_.getStrokeWidth() > 0));
+    CheckOpaqueBoundsCompatibility(current_.getBlendMode(),
+                                   CurrentAttributesAreOpaque());
   }
 
   // Check for opacity compatibility for an op that ignores the current
@@ -640,6 +652,50 @@ class DisplayListBuilder final : public virtual DlCanvas,
     UpdateLayerOpacityCompatibility(IsOpacityCompatible(mode));
   }
 
+  // The largest rectangle found so far, in the coordinate space of the
+  // DisplayList, that will be completely covered by opaque pixels once
+  // all of the ops recorded so far have been rendered. Only a single
+  // rectangle is tracked and it is only grown by simple opaque fills
+  // that render directly onto the base surface through rectangular clips.
+  SkRect opaque_bounds_ = SkRect::MakeEmpty();
+
+  // Returns true for the blend modes which can never lower the alpha of
+  // a destination pixel that is already fully opaque.
+  static bool PreservesOpaqueDestination(DlBlendMode mode) {
+    switch (mode) {
+      case DlBlendMode::kSrcOver:
+      case DlBlendMode::kDst:
+      case DlBlendMode::kDstOver:
+      case DlBlendMode::kSrcATop:
+      case DlBlendMode::kPlus:
+      case DlBlendMode::kScreen:
+        return true;
+      default:
+        // All of the separable and non-separable modes after the
+        // Porter-Duff modes compute their alpha as in kSrcOver.
+        return mode > DlBlendMode::kLastCoeffMode;
+    }
+  }
+
+  // Returns true iff the current rendering attributes will fill the
+  // geometry of an op with fully opaque pixels.
+  bool CurrentAttributesAreOpaque() const;
+
+  // Discards the |opaque_bounds_| if an op that renders with the blend
+  // |mode| might lower the alpha of the pixels that were already covered.
+  void CheckOpaqueBoundsCompatibility(DlBlendMode mode, bool op_is_opaque) {
+    if (!PreservesOpaqueDestination(mode) &&
+        !(mode == DlBlendMode::kSrc && op_is_opaque)) {
+      opaque_bounds_.setEmpty();
+    }
+  }
+
+  // Records that an op has filled the indicated |rect| in the current
+  // local coordinate space with opaque pixels, or the entire clip if the
+  // |rect| is null, as long as the transform and clip allow the covered
+  // area to be expressed as a rectangle in the DisplayList coordinates.
+  void AccumulateOpaqueBounds(const SkRect* rect);
+
   void onSetAntiAlias(bool aa);
   void onSetDither(bool dither);
   void onSetInvertColors(bool invert);
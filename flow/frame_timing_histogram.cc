@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_timing_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flutter {
+
+namespace {
+
+uint64_t ToMicroseconds(fml::TimeDelta delta) {
+  return std::max<int64_t>(delta.ToMicroseconds(), 0);
+}
+
+}  // namespace
+
+FrameTimingHistogram::FrameTimingHistogram()
+    : slots_(std::make_unique<std::array<Slot, kSlotCount>>()) {}
+
+FrameTimingHistogram::~FrameTimingHistogram() = default;
+
+void FrameTimingHistogram::Record(const FrameTiming& timing) {
+  const fml::TimePoint vsync_start = timing.Get(FrameTiming::kVsyncStart);
+  const fml::TimePoint build_start = timing.Get(FrameTiming::kBuildStart);
+  const fml::TimePoint raster_finish = timing.Get(FrameTiming::kRasterFinish);
+  Record(Metric::kVsyncToBuildStart, ToMicroseconds(build_start - vsync_start),
+         raster_finish);
+  Record(Metric::kBuild,
+         ToMicroseconds(timing.Get(FrameTiming::kBuildFinish) - build_start),
+         raster_finish);
+  Record(Metric::kRaster,
+         ToMicroseconds(raster_finish - timing.Get(FrameTiming::kRasterStart)),
+         raster_finish);
+  Record(Metric::kEndToEnd, ToMicroseconds(raster_finish - vsync_start),
+         raster_finish);
+  Record(Metric::kRasterCacheBytes,
+         timing.GetLayerCacheBytes() + timing.GetPictureCacheBytes(),
+         raster_finish);
+}
+
+void FrameTimingHistogram::Record(Metric metric,
+                                  uint64_t value,
+                                  fml::TimePoint time) {
+  Slot* slot = AcquireSlot(GetEpoch(time));
+  if (slot == nullptr) {
+    return;
+  }
+  const size_t m = static_cast<size_t>(metric);
+  slot->buckets[m][GetBucketIndex(value)].fetch_add(1,
+                                                    std::memory_order_relaxed);
+  uint64_t max = slot->max[m].load(std::memory_order_relaxed);
+  while (value > max && !slot->max[m].compare_exchange_weak(
+                            max, value, std::memory_order_relaxed)) {
+  }
+}
+
+FrameTimingPercentiles FrameTimingHistogram::GetPercentiles(
+    Metric metric,
+    fml::TimeDelta window,
+    fml::TimePoint now) const {
+  const size_t m = static_cast<size_t>(metric);
+  const int64_t last_epoch = GetEpoch(now);
+  const int64_t slot_count = std::clamp<int64_t>(
+      (window.ToNanoseconds() + kSlotDuration.ToNanoseconds() - 1) /
+          kSlotDuration.ToNanoseconds(),
+      1, kSlotCount);
+  const int64_t first_epoch = last_epoch - slot_count + 1;
+
+  FrameTimingPercentiles percentiles;
+  std::array<uint64_t, kBucketCount> counts = {};
+  for (const Slot& slot : *slots_) {
+    const int64_t epoch = slot.epoch.load(std::memory_order_acquire);
+    if (epoch < first_epoch || epoch > last_epoch) {
+      continue;
+    }
+    for (size_t i = 0; i < kBucketCount; i++) {
+      const uint32_t count =
+          slot.buckets[m][i].load(std::memory_order_relaxed);
+      counts[i] += count;
+      percentiles.count += count;
+    }
+    percentiles.max = std::max(percentiles.max,
+                               slot.max[m].load(std::memory_order_relaxed));
+  }
+  if (percentiles.count == 0) {
+    return percentiles;
+  }
+
+  // Walks the buckets once, reporting each percentile at the first bucket
+  // that brings the running count up to its rank.
+  const std::array<double, 3> quantiles = {0.5, 0.9, 0.99};
+  std::array<uint64_t*, 3> results = {&percentiles.p50, &percentiles.p90,
+                                      &percentiles.p99};
+  size_t next = 0;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount && next < quantiles.size(); i++) {
+    seen += counts[i];
+    while (next < quantiles.size() &&
+           seen >= std::ceil(quantiles[next] * percentiles.count)) {
+      *results[next++] = std::min(GetBucketUpperBound(i), percentiles.max);
+    }
+  }
+  return percentiles;
+}
+
+size_t FrameTimingHistogram::GetBucketIndex(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return value;
+  }
+  int exponent = 0;
+  for (uint64_t v = value >> 1; v != 0; v >>= 1) {
+    exponent++;
+  }
+  if (exponent >= kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  const size_t sub_bucket =
+      (value >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+  return (exponent - kSubBucketBits + 1) * kSubBucketCount + sub_bucket;
+}
+
+uint64_t FrameTimingHistogram::GetBucketUpperBound(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  if (index >= kBucketCount - 1) {
+    return UINT64_MAX;
+  }
+  const int exponent = index / kSubBucketCount + kSubBucketBits - 1;
+  const uint64_t sub_bucket = index % kSubBucketCount;
+  const int shift = exponent - kSubBucketBits;
+  return ((kSubBucketCount + sub_bucket + 1) << shift) - 1;
+}
+
+int64_t FrameTimingHistogram::GetEpoch(fml::TimePoint time) {
+  return time.ToEpochDelta().ToNanoseconds() / kSlotDuration.ToNanoseconds();
+}
+
+FrameTimingHistogram::Slot* FrameTimingHistogram::AcquireSlot(int64_t epoch) {
+  Slot& slot = (*slots_)[epoch % kSlotCount];
+  int64_t current = slot.epoch.load(std::memory_order_acquire);
+  if (current == epoch) {
+    return &slot;
+  }
+  // Only the thread that moves the slot out of an older epoch clears it.
+  // Values recorded for the slot while it is being cleared are dropped.
+  if (current > epoch || current == kRecyclingEpoch ||
+      !slot.epoch.compare_exchange_strong(current, kRecyclingEpoch,
+                                          std::memory_order_acq_rel)) {
+    return nullptr;
+  }
+  for (auto& metric_buckets : slot.buckets) {
+    for (auto& bucket : metric_buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+  for (auto& max : slot.max) {
+    max.store(0, std::memory_order_relaxed);
+  }
+  slot.epoch.store(epoch, std::memory_order_release);
+  return &slot;
+}
+
+}  // namespace flutter
@@ -0,0 +1,142 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_TIMING_HISTOGRAM_H_
+#define FLUTTER_FLOW_FRAME_TIMING_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// The distribution of the values recorded for a metric of a
+/// |FrameTimingHistogram| over a window of time.
+struct FrameTimingPercentiles {
+  // The number of values in the window.
+  uint64_t count = 0;
+  uint64_t p50 = 0;
+  uint64_t p90 = 0;
+  uint64_t p99 = 0;
+  uint64_t max = 0;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Aggregates the timings of rasterized frames into histograms
+///             that can be queried for percentiles over a sliding window,
+///             without keeping the timings of individual frames.
+///
+///             Values are counted in HDR-style log-linear buckets: every power
+///             of two range is split into |kSubBucketCount| equal buckets, so
+///             percentiles are reported with a relative error of at most
+///             1 / |kSubBucketCount|. The maximum is exact.
+///
+///             The histograms are kept per time slot of |kSlotDuration|, in a
+///             ring of |kSlotCount| slots that is reused as time passes, so
+///             the memory used is constant. A query aggregates the slots that
+///             fall within the requested window.
+///
+///             Recording and querying are lock-free and may happen on any
+///             thread. A value recorded while another thread recycles its
+///             slot may be dropped.
+///
+class FrameTimingHistogram {
+ public:
+  enum class Metric {
+    // From the vsync to the start of the build on the UI thread, in
+    // microseconds.
+    kVsyncToBuildStart,
+    // The build time on the UI thread, in microseconds.
+    kBuild,
+    // The raster time on the raster thread, in microseconds.
+    kRaster,
+    // From the vsync to the end of the raster, in microseconds.
+    kEndToEnd,
+    // The bytes used by the raster cache after the frame.
+    kRasterCacheBytes,
+  };
+
+  static constexpr size_t kMetricCount = 5;
+
+  static constexpr int kSubBucketBits = 3;
+  static constexpr size_t kSubBucketCount = 1 << kSubBucketBits;
+  // Values of 2^kMaxExponent and above are counted in the last bucket.
+  static constexpr int kMaxExponent = 40;
+  static constexpr size_t kBucketCount =
+      (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+
+  static constexpr fml::TimeDelta kSlotDuration =
+      fml::TimeDelta::FromSeconds(5);
+  static constexpr size_t kSlotCount = 12;
+  // The longest window that can be queried.
+  static constexpr fml::TimeDelta kMaxWindow = kSlotDuration * kSlotCount;
+
+  FrameTimingHistogram();
+
+  ~FrameTimingHistogram();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records all metrics of a rasterized frame, at the time its
+  ///             raster finished.
+  ///
+  void Record(const FrameTiming& timing);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records a single value of a metric at the given time.
+  ///
+  void Record(Metric metric, uint64_t value, fml::TimePoint time);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The distribution of the values of a metric recorded in the
+  ///             window that ends at |now|. The window is rounded up to whole
+  ///             slots and clamped to |kMaxWindow|.
+  ///
+  FrameTimingPercentiles GetPercentiles(Metric metric,
+                                        fml::TimeDelta window,
+                                        fml::TimePoint now) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The bucket that a value is counted in.
+  ///
+  static size_t GetBucketIndex(uint64_t value);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The largest value that is counted in a bucket, which is
+  ///             what percentiles falling in that bucket report.
+  ///
+  static uint64_t GetBucketUpperBound(size_t index);
+
+ private:
+  // Slots that are not in use or are being recycled have a negative epoch.
+  static constexpr int64_t kEmptyEpoch = -1;
+  static constexpr int64_t kRecyclingEpoch = -2;
+
+  struct Slot {
+    std::atomic<int64_t> epoch{kEmptyEpoch};
+    std::array<std::atomic<uint64_t>, kMetricCount> max = {};
+    std::array<std::array<std::atomic<uint32_t>, kBucketCount>, kMetricCount>
+        buckets = {};
+  };
+
+  // Allocated separately as the slots take tens of kilobytes.
+  const std::unique_ptr<std::array<Slot, kSlotCount>> slots_;
+
+  static int64_t GetEpoch(fml::TimePoint time);
+
+  // Returns the slot for |epoch|, recycling it if it holds an older epoch, or
+  // nullptr if the slot already moved on to a newer epoch.
+  Slot* AcquireSlot(int64_t epoch);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingHistogram);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_FRAME_TIMING_HISTOGRAM_H_
@@ -0,0 +1,190 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_timing_histogram.h"
+
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+using Metric = FrameTimingHistogram::Metric;
+
+static fml::TimePoint TimeFromSeconds(double seconds) {
+  return fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromSecondsF(seconds));
+}
+
+TEST(FrameTimingHistogramTest, BucketsCoverValuesWithBoundedError) {
+  for (uint64_t value = 0; value < 8; value++) {
+    ASSERT_EQ(FrameTimingHistogram::GetBucketIndex(value), value);
+    ASSERT_EQ(FrameTimingHistogram::GetBucketUpperBound(value), value);
+  }
+
+  const uint64_t sub_buckets = FrameTimingHistogram::kSubBucketCount;
+  size_t last_index = 0;
+  for (uint64_t value = 8; value < (1ull << 30); value = value * 9 / 8 + 1) {
+    const size_t index = FrameTimingHistogram::GetBucketIndex(value);
+    ASSERT_GE(index, last_index);
+    ASSERT_LT(index, FrameTimingHistogram::kBucketCount);
+    const uint64_t upper_bound =
+        FrameTimingHistogram::GetBucketUpperBound(index);
+    ASSERT_GE(upper_bound, value);
+    // The error is at most the width of a sub-bucket.
+    ASSERT_LE(upper_bound - value, value / sub_buckets);
+    ASSERT_EQ(FrameTimingHistogram::GetBucketIndex(upper_bound), index);
+    last_index = index;
+  }
+
+  ASSERT_EQ(FrameTimingHistogram::GetBucketIndex(UINT64_MAX),
+            FrameTimingHistogram::kBucketCount - 1);
+}
+
+TEST(FrameTimingHistogramTest, EmptyHistogramReportsNothing) {
+  FrameTimingHistogram histogram;
+  FrameTimingPercentiles percentiles = histogram.GetPercentiles(
+      Metric::kRaster, FrameTimingHistogram::kMaxWindow, TimeFromSeconds(10));
+  ASSERT_EQ(percentiles.count, 0u);
+  ASSERT_EQ(percentiles.p50, 0u);
+  ASSERT_EQ(percentiles.max, 0u);
+}
+
+TEST(FrameTimingHistogramTest, ReportsPercentiles) {
+  FrameTimingHistogram histogram;
+  const fml::TimePoint now = TimeFromSeconds(100);
+  // 1..1000 microseconds.
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.Record(Metric::kRaster, value, now);
+  }
+
+  FrameTimingPercentiles percentiles = histogram.GetPercentiles(
+      Metric::kRaster, fml::TimeDelta::FromSeconds(1), now);
+  ASSERT_EQ(percentiles.count, 1000u);
+  ASSERT_EQ(percentiles.max, 1000u);
+  auto near = [](uint64_t actual, uint64_t expected) {
+    const uint64_t error = expected / FrameTimingHistogram::kSubBucketCount;
+    return actual >= expected && actual <= expected + error;
+  };
+  EXPECT_TRUE(near(percentiles.p50, 500)) << percentiles.p50;
+  EXPECT_TRUE(near(percentiles.p90, 900)) << percentiles.p90;
+  EXPECT_TRUE(near(percentiles.p99, 990)) << percentiles.p99;
+
+  // Other metrics are counted separately.
+  ASSERT_EQ(histogram.GetPercentiles(Metric::kBuild,
+                                     fml::TimeDelta::FromSeconds(1), now)
+                .count,
+            0u);
+}
+
+TEST(FrameTimingHistogramTest, PercentilesDoNotExceedMax) {
+  FrameTimingHistogram histogram;
+  const fml::TimePoint now = TimeFromSeconds(100);
+  histogram.Record(Metric::kEndToEnd, 1001, now);
+
+  FrameTimingPercentiles percentiles = histogram.GetPercentiles(
+      Metric::kEndToEnd, fml::TimeDelta::FromSeconds(1), now);
+  ASSERT_EQ(percentiles.count, 1u);
+  ASSERT_EQ(percentiles.p50, 1001u);
+  ASSERT_EQ(percentiles.p99, 1001u);
+  ASSERT_EQ(percentiles.max, 1001u);
+}
+
+TEST(FrameTimingHistogramTest, WindowSlidesOverSlots) {
+  FrameTimingHistogram histogram;
+  const fml::TimeDelta slot = FrameTimingHistogram::kSlotDuration;
+  const fml::TimePoint start = TimeFromSeconds(1000);
+
+  histogram.Record(Metric::kRaster, 100, start);
+  histogram.Record(Metric::kRaster, 200, start + slot);
+  histogram.Record(Metric::kRaster, 300, start + slot * 2);
+
+  const fml::TimePoint now = start + slot * 2;
+  ASSERT_EQ(histogram.GetPercentiles(Metric::kRaster, slot, now).count, 1u);
+  ASSERT_EQ(histogram.GetPercentiles(Metric::kRaster, slot * 2, now).count,
+            2u);
+  FrameTimingPercentiles all =
+      histogram.GetPercentiles(Metric::kRaster, slot * 3, now);
+  ASSERT_EQ(all.count, 3u);
+  ASSERT_EQ(all.max, 300u);
+
+  // Once the ring wraps around, the oldest slot is recycled.
+  const fml::TimePoint later =
+      start + slot * FrameTimingHistogram::kSlotCount;
+  histogram.Record(Metric::kRaster, 50, later);
+  FrameTimingPercentiles recycled = histogram.GetPercentiles(
+      Metric::kRaster, FrameTimingHistogram::kMaxWindow, later);
+  ASSERT_EQ(recycled.count, 3u);
+  ASSERT_EQ(recycled.max, 300u);
+
+  // Values that are too old for their slot are dropped.
+  histogram.Record(Metric::kRaster, 5000, start);
+  ASSERT_EQ(histogram
+                .GetPercentiles(Metric::kRaster,
+                                FrameTimingHistogram::kMaxWindow, later)
+                .max,
+            300u);
+}
+
+TEST(FrameTimingHistogramTest, RecordsFrameTiming) {
+  FrameTimingHistogram histogram;
+  const fml::TimePoint vsync = TimeFromSeconds(100);
+  FrameTiming timing;
+  timing.Set(FrameTiming::kVsyncStart, vsync);
+  timing.Set(FrameTiming::kBuildStart,
+             vsync + fml::TimeDelta::FromMicroseconds(500));
+  timing.Set(FrameTiming::kBuildFinish,
+             vsync + fml::TimeDelta::FromMicroseconds(4500));
+  timing.Set(FrameTiming::kRasterStart,
+             vsync + fml::TimeDelta::FromMicroseconds(5000));
+  timing.Set(FrameTiming::kRasterFinish,
+             vsync + fml::TimeDelta::FromMicroseconds(12000));
+  timing.SetRasterCacheStatistics(1, 1024, 1, 2048);
+  histogram.Record(timing);
+
+  const fml::TimePoint now = timing.Get(FrameTiming::kRasterFinish);
+  const fml::TimeDelta window = fml::TimeDelta::FromSeconds(1);
+  EXPECT_EQ(histogram.GetPercentiles(Metric::kVsyncToBuildStart, window, now)
+                .max,
+            500u);
+  EXPECT_EQ(histogram.GetPercentiles(Metric::kBuild, window, now).max, 4000u);
+  EXPECT_EQ(histogram.GetPercentiles(Metric::kRaster, window, now).max, 7000u);
+  EXPECT_EQ(histogram.GetPercentiles(Metric::kEndToEnd, window, now).max,
+            12000u);
+  EXPECT_EQ(histogram.GetPercentiles(Metric::kRasterCacheBytes, window, now)
+                .max,
+            3072u);
+}
+
+TEST(FrameTimingHistogramTest, ConcurrentRecordingCountsEveryValue) {
+  FrameTimingHistogram histogram;
+  const fml::TimePoint now = TimeFromSeconds(100);
+  // Claim the slot before the threads start so that no value is dropped
+  // while it is recycled.
+  histogram.Record(Metric::kRaster, 1, now);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&histogram, now]() {
+      for (uint64_t value = 0; value < 1000; value++) {
+        histogram.Record(Metric::kRaster, value, now);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  FrameTimingPercentiles percentiles = histogram.GetPercentiles(
+      Metric::kRaster, fml::TimeDelta::FromSeconds(1), now);
+  ASSERT_EQ(percentiles.count, 4001u);
+  ASSERT_EQ(percentiles.max, 999u);
+}
+
+}  // namespace testing
+}  // namespace flutter
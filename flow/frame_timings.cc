@@ -101,6 +101,18 @@ size_t FrameTimingsRecorder::GetPictureCacheBytes() const {
   return picture_cache_bytes_;
 }
 
+size_t FrameTimingsRecorder::GetOcclusionCulledLayerCount() const {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ >= State::kRasterEnd);
+  return occlusion_culled_layer_count_;
+}
+
+size_t FrameTimingsRecorder::GetOcclusionCulledOpCount() const {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ >= State::kRasterEnd);
+  return occlusion_culled_op_count_;
+}
+
 void FrameTimingsRecorder::RecordVsync(fml::TimePoint vsync_start,
                                        fml::TimePoint vsync_target) {
   std::scoped_lock state_lock(state_mutex_);
@@ -131,6 +143,14 @@ void FrameTimingsRecorder::RecordRasterStart(fml::TimePoint raster_start) {
   raster_start_ = raster_start;
 }
 
+void FrameTimingsRecorder::RecordOcclusionCulling(size_t culled_layer_count,
+                                                  size_t culled_op_count) {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ == State::kRasterStart);
+  occlusion_culled_layer_count_ = culled_layer_count;
+  occlusion_culled_op_count_ = culled_op_count;
+}
+
 FrameTiming FrameTimingsRecorder::RecordRasterEnd(const RasterCache* cache) {
   std::scoped_lock state_lock(state_mutex_);
   FML_DCHECK(state_ == State::kRasterStart);
@@ -198,6 +218,8 @@ std::unique_ptr<FrameTimingsRecorder> FrameTimingsRecorder::CloneUntil(
     recorder->layer_cache_bytes_ = layer_cache_bytes_;
     recorder->picture_cache_count_ = picture_cache_count_;
     recorder->picture_cache_bytes_ = picture_cache_bytes_;
+    recorder->occlusion_culled_layer_count_ = occlusion_culled_layer_count_;
+    recorder->occlusion_culled_op_count_ = occlusion_culled_op_count_;
   }
 
   return recorder;
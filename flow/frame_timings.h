@@ -83,6 +83,14 @@ class FrameTimingsRecorder {
   /// Total Bytes in all picture cache entries
   size_t GetPictureCacheBytes() const;
 
+  /// Count of the layers that were skipped because opaque content painted
+  /// above them covered them entirely.
+  size_t GetOcclusionCulledLayerCount() const;
+
+  /// Count of the DisplayList ops that were skipped because opaque content
+  /// painted above them covered them entirely.
+  size_t GetOcclusionCulledOpCount() const;
+
   /// Records a vsync event.
   void RecordVsync(fml::TimePoint vsync_start, fml::TimePoint vsync_target);
 
@@ -95,6 +103,12 @@ class FrameTimingsRecorder {
   /// Records a raster start event.
   void RecordRasterStart(fml::TimePoint raster_start);
 
+  /// Records the number of layers and DisplayList ops that were culled by
+  /// occlusion while rasterizing this frame. Must be called after the raster
+  /// start event and before the raster end event.
+  void RecordOcclusionCulling(size_t culled_layer_count,
+                              size_t culled_op_count);
+
   /// Clones the recorder until (and including) the specified state.
   std::unique_ptr<FrameTimingsRecorder> CloneUntil(State state);
 
@@ -134,6 +148,8 @@ class FrameTimingsRecorder {
   size_t layer_cache_bytes_;
   size_t picture_cache_count_;
   size_t picture_cache_bytes_;
+  size_t occlusion_culled_layer_count_ = 0;
+  size_t occlusion_culled_op_count_ = 0;
 
   // Set when `RecordRasterEnd` is called. Cannot be reset once set.
   FrameTiming timing_;
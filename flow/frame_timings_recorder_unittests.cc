@@ -126,6 +126,25 @@ TEST(FrameTimingsRecorderTest, RecordRasterTimesWithCache) {
 #if !defined(OS_FUCHSIA) && !defined(FML_OS_WIN) && \
     (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG)
 
+TEST(FrameTimingsRecorderTest, RecordOcclusionCulling) {
+  auto recorder = std::make_unique<FrameTimingsRecorder>();
+
+  const auto now = fml::TimePoint::Now();
+  recorder->RecordVsync(now, now + fml::TimeDelta::FromMilliseconds(16));
+  recorder->RecordBuildStart(fml::TimePoint::Now());
+  recorder->RecordBuildEnd(fml::TimePoint::Now());
+  recorder->RecordRasterStart(fml::TimePoint::Now());
+  recorder->RecordOcclusionCulling(3, 42);
+  recorder->RecordRasterEnd();
+
+  ASSERT_EQ(recorder->GetOcclusionCulledLayerCount(), 3u);
+  ASSERT_EQ(recorder->GetOcclusionCulledOpCount(), 42u);
+
+  auto cloned = recorder->CloneUntil(FrameTimingsRecorder::State::kRasterEnd);
+  ASSERT_EQ(cloned->GetOcclusionCulledLayerCount(), 3u);
+  ASSERT_EQ(cloned->GetOcclusionCulledOpCount(), 42u);
+}
+
 TEST(FrameTimingsRecorderTest, ThrowWhenRecordBuildBeforeVsync) {
   auto recorder = std::make_unique<FrameTimingsRecorder>();
 
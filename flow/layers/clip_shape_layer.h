@@ -64,6 +64,10 @@ class ClipShapeLayer : public CacheableContainerLayer {
     } else {
       set_paint_bounds(SkRect::MakeEmpty());
     }
+    SkRect opaque_bounds = children_opaque_bounds();
+    if (opaque_bounds.intersect(ComputeInnerRect(clip_shape()))) {
+      set_opaque_bounds(opaque_bounds);
+    }
 
     // If we use a SaveLayer then we can accept opacity on behalf
     // of our children and apply it in the saveLayer.
@@ -43,6 +43,8 @@ void ColorFilterLayer::Preroll(PrerollContext* context) {
                               context->state_stack.transform_3x3());
 
   ContainerLayer::Preroll(context);
+  // The filter may change the alpha of the opaque content of our children.
+  set_opaque_bounds(SkRect::MakeEmpty());
 
   // Our saveLayer would apply any outstanding opacity or any outstanding
   // image filter before it applies our color filter, but that is in the
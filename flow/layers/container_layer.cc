@@ -8,7 +8,19 @@
 
 namespace flutter {
 
-ContainerLayer::ContainerLayer() : child_paint_bounds_(SkRect::MakeEmpty()) {}
+// The number of device pixels by which opaque bounds are shrunk before they
+// are used to occlude other layers. This accounts for partially covered
+// pixels along anti-aliased edges and for the snapping of the transform to
+// integer translations when layers are drawn from the raster cache.
+static constexpr SkScalar kOcclusionPixelSlop = 2.0f;
+
+static SkScalar RectArea(const SkRect& rect) {
+  return rect.isEmpty() ? 0.0f : rect.width() * rect.height();
+}
+
+ContainerLayer::ContainerLayer()
+    : child_paint_bounds_(SkRect::MakeEmpty()),
+      children_opaque_bounds_(SkRect::MakeEmpty()) {}
 
 void ContainerLayer::Diff(DiffContext* context, const Layer* old_layer) {
   auto old_container = static_cast<const ContainerLayer*>(old_layer);
@@ -111,6 +123,7 @@ void ContainerLayer::Preroll(PrerollContext* context) {
   SkRect child_paint_bounds = SkRect::MakeEmpty();
   PrerollChildren(context, &child_paint_bounds);
   set_paint_bounds(child_paint_bounds);
+  set_opaque_bounds(children_opaque_bounds());
 }
 
 void ContainerLayer::Paint(PaintContext& context) const {
@@ -148,6 +161,9 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
     // opt-in to applying state attributes during its |Preroll|
     context->renderable_state_flags = 0;
 
+    // Likewise, the layer must opt-in to reporting any opaque content.
+    layer->set_opaque_bounds(SkRect::MakeEmpty());
+
     layer->Preroll(context);
 
     all_renderable_state_flags &= context->renderable_state_flags;
@@ -171,6 +187,40 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   set_subtree_has_platform_view(child_has_platform_view);
   set_children_renderable_state_flags(all_renderable_state_flags);
   set_child_paint_bounds(*child_paint_bounds);
+
+  OccludeChildren(context);
+}
+
+void ContainerLayer::OccludeChildren(PrerollContext* context) {
+  // The size of a device pixel in the local coordinates of the children,
+  // or a non-positive value if the transform has perspective in which
+  // case we do not attempt any occlusion.
+  SkScalar min_scale = context->occlusion_culling_enabled
+                           ? context->state_stack.transform_3x3().getMinScale()
+                           : 0;
+
+  // Walk the children from front to back, hiding every child that lies
+  // entirely underneath the largest opaque rect painted in front of it.
+  SkRect occluder = SkRect::MakeEmpty();
+  SkRect children_opaque_bounds = SkRect::MakeEmpty();
+  for (auto it = layers_.rbegin(); it != layers_.rend(); ++it) {
+    Layer* layer = it->get();
+    if (layer->Occlude(context, occluder)) {
+      continue;
+    }
+    SkRect opaque_bounds = layer->opaque_bounds();
+    if (RectArea(opaque_bounds) > RectArea(children_opaque_bounds)) {
+      children_opaque_bounds = opaque_bounds;
+    }
+    if (min_scale > 0) {
+      SkScalar slop = kOcclusionPixelSlop / min_scale;
+      opaque_bounds.inset(slop, slop);
+      if (RectArea(opaque_bounds) > RectArea(occluder)) {
+        occluder = opaque_bounds;
+      }
+    }
+  }
+  children_opaque_bounds_ = children_opaque_bounds;
 }
 
 void ContainerLayer::PaintChildren(PaintContext& context) const {
@@ -188,7 +238,7 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // Intentionally not tracing here as there should be no self-time
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
-    if (layer->needs_painting(context)) {
+    if (!layer->is_occluded() && layer->needs_painting(context)) {
       layer->Paint(context);
     }
   }
@@ -37,6 +37,12 @@ class ContainerLayer : public Layer {
     child_paint_bounds_ = bounds;
   }
 
+  // The largest opaque rect reported by any of the children during the
+  // most recent PrerollChildren(), in this layer's child coordinate space.
+  const SkRect& children_opaque_bounds() const {
+    return children_opaque_bounds_;
+  }
+
   int children_renderable_state_flags() const {
     return children_renderable_state_flags_;
   }
@@ -50,8 +56,11 @@ class ContainerLayer : public Layer {
  private:
   std::vector<std::shared_ptr<Layer>> layers_;
   SkRect child_paint_bounds_;
+  SkRect children_opaque_bounds_;
   int children_renderable_state_flags_ = 0;
 
+  void OccludeChildren(PrerollContext* context);
+
   FML_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
 
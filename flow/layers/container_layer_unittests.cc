@@ -542,6 +542,133 @@ TEST_F(ContainerLayerTest, CollectionCacheableLayer) {
             static_cast<const unsigned long>(2));
 }
 
+TEST_F(ContainerLayerTest, OccludedChildIsNotPainted) {
+  SkPath child_path1;
+  child_path1.addRect(10.0f, 10.0f, 20.0f, 20.0f);
+  SkPath child_path2;
+  child_path2.addRect(0.0f, 0.0f, 50.0f, 50.0f);
+  DlPaint child_paint1 = DlPaint(DlColor::kMidGrey());
+  DlPaint child_paint2 = DlPaint(DlColor::kGreen());
+
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1, child_paint1);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2, child_paint2);
+  mock_layer2->set_fake_opaque(true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context());
+  EXPECT_TRUE(mock_layer1->is_occluded());
+  EXPECT_FALSE(mock_layer2->is_occluded());
+  EXPECT_EQ(layer->children_opaque_bounds(), child_path2.getBounds());
+  EXPECT_EQ(layer->opaque_bounds(), child_path2.getBounds());
+  EXPECT_EQ(preroll_context()->occluded_layer_count, 1u);
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path2, child_paint2}}}));
+}
+
+TEST_F(ContainerLayerTest, OccludedChildIsPaintedWhenCullingIsDisabled) {
+  SkPath child_path1;
+  child_path1.addRect(10.0f, 10.0f, 20.0f, 20.0f);
+  SkPath child_path2;
+  child_path2.addRect(0.0f, 0.0f, 50.0f, 50.0f);
+  DlPaint child_paint1 = DlPaint(DlColor::kMidGrey());
+  DlPaint child_paint2 = DlPaint(DlColor::kGreen());
+
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1, child_paint1);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2, child_paint2);
+  mock_layer2->set_fake_opaque(true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  preroll_context()->occlusion_culling_enabled = false;
+  layer->Preroll(preroll_context());
+  EXPECT_FALSE(mock_layer1->is_occluded());
+  EXPECT_EQ(layer->opaque_bounds(), child_path2.getBounds());
+  EXPECT_EQ(preroll_context()->occluded_layer_count, 0u);
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector({MockCanvas::DrawCall{
+                       0, MockCanvas::DrawPathData{child_path1, child_paint1}},
+                   MockCanvas::DrawCall{0, MockCanvas::DrawPathData{
+                                               child_path2, child_paint2}}}));
+}
+
+TEST_F(ContainerLayerTest, PartiallyOccludedChildIsPainted) {
+  SkPath child_path1;
+  child_path1.addRect(40.0f, 40.0f, 60.0f, 60.0f);
+  SkPath child_path2;
+  child_path2.addRect(0.0f, 0.0f, 50.0f, 50.0f);
+  DlPaint child_paint1 = DlPaint(DlColor::kMidGrey());
+  DlPaint child_paint2 = DlPaint(DlColor::kGreen());
+
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1, child_paint1);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2, child_paint2);
+  mock_layer2->set_fake_opaque(true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context());
+  EXPECT_FALSE(mock_layer1->is_occluded());
+  EXPECT_EQ(preroll_context()->occluded_layer_count, 0u);
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector({MockCanvas::DrawCall{
+                       0, MockCanvas::DrawPathData{child_path1, child_paint1}},
+                   MockCanvas::DrawCall{0, MockCanvas::DrawPathData{
+                                               child_path2, child_paint2}}}));
+}
+
+TEST_F(ContainerLayerTest, OpaqueChildOnlyOccludesChildrenBelowIt) {
+  SkPath child_path1;
+  child_path1.addRect(0.0f, 0.0f, 50.0f, 50.0f);
+  SkPath child_path2;
+  child_path2.addRect(10.0f, 10.0f, 20.0f, 20.0f);
+
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1);
+  mock_layer1->set_fake_opaque(true);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context());
+  EXPECT_FALSE(mock_layer1->is_occluded());
+  EXPECT_FALSE(mock_layer2->is_occluded());
+  EXPECT_EQ(preroll_context()->occluded_layer_count, 0u);
+}
+
+TEST_F(ContainerLayerTest, PlatformViewIsNeverOccluded) {
+  SkPath child_path1;
+  child_path1.addRect(10.0f, 10.0f, 20.0f, 20.0f);
+  SkPath child_path2;
+  child_path2.addRect(0.0f, 0.0f, 50.0f, 50.0f);
+
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1);
+  mock_layer1->set_fake_has_platform_view(true);
+  auto container_layer1 = std::make_shared<ContainerLayer>();
+  container_layer1->Add(mock_layer1);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2);
+  mock_layer2->set_fake_opaque(true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(container_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context());
+  EXPECT_TRUE(container_layer1->subtree_has_platform_view());
+  EXPECT_FALSE(container_layer1->is_occluded());
+  EXPECT_EQ(preroll_context()->occluded_layer_count, 0u);
+}
+
 using ContainerLayerDiffTest = DiffContextTest;
 
 // Insert PictureLayer amongst container layers
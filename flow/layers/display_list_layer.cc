@@ -5,6 +5,7 @@
 #include "flutter/flow/layers/display_list_layer.h"
 
 #include <utility>
+#include <vector>
 
 #include "flutter/display_list/dl_builder.h"
 #include "flutter/flow/layer_snapshot_store.h"
@@ -19,7 +20,9 @@ DisplayListLayer::DisplayListLayer(const SkPoint& offset,
                                    SkiaGPUObject<DisplayList> display_list,
                                    bool is_complex,
                                    bool will_change)
-    : offset_(offset), display_list_(std::move(display_list)) {
+    : offset_(offset),
+      occlusion_clip_(SkRect::MakeEmpty()),
+      display_list_(std::move(display_list)) {
   if (display_list_.skia_object() != nullptr) {
     bounds_ = display_list_.skia_object()->bounds().makeOffset(offset_.x(),
                                                                offset_.y());
@@ -102,6 +105,69 @@ void DisplayListLayer::Preroll(PrerollContext* context) {
     context->renderable_state_flags = LayerStateStack::kCallerCanApplyOpacity;
   }
   set_paint_bounds(bounds_);
+  set_opaque_bounds(
+      disp_list->opaque_bounds().makeOffset(offset_.x(), offset_.y()));
+  // Our parent will report any partial occlusion in |Occlude|.
+  occlusion_clip_.setEmpty();
+}
+
+// Computes the part of |bounds| not covered by |occluder| if it can be
+// expressed as a single rectangle.
+static bool ComputeVisibleRect(const SkRect& bounds,
+                               const SkRect& occluder,
+                               SkRect* visible) {
+  if (!bounds.intersects(occluder)) {
+    return false;
+  }
+  *visible = bounds;
+  if (occluder.fLeft <= bounds.fLeft && occluder.fRight >= bounds.fRight) {
+    if (occluder.fTop <= bounds.fTop) {
+      visible->fTop = occluder.fBottom;
+      return true;
+    }
+    if (occluder.fBottom >= bounds.fBottom) {
+      visible->fBottom = occluder.fTop;
+      return true;
+    }
+  }
+  if (occluder.fTop <= bounds.fTop && occluder.fBottom >= bounds.fBottom) {
+    if (occluder.fLeft <= bounds.fLeft) {
+      visible->fLeft = occluder.fRight;
+      return true;
+    }
+    if (occluder.fRight >= bounds.fRight) {
+      visible->fRight = occluder.fLeft;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DisplayListLayer::Occlude(PrerollContext* context,
+                               const SkRect& occluder) {
+  if (Layer::Occlude(context, occluder)) {
+    context->occluded_op_count += display_list()->op_count(true);
+    return true;
+  }
+  // When only a band along one edge of the display list is hidden we clip
+  // to the rest of it so that the ops in the hidden band will be culled by
+  // the R-Tree when the display list is rendered.
+  const DlRTree* rtree = display_list()->rtree().get();
+  SkRect visible;
+  if (rtree == nullptr || subtree_has_platform_view() ||
+      !ComputeVisibleRect(paint_bounds(), occluder, &visible) ||
+      visible.isEmpty()) {
+    return false;
+  }
+  visible.offset(-offset_.x(), -offset_.y());
+  std::vector<int> visible_ops;
+  rtree->search(visible, &visible_ops);
+  size_t hidden_op_count = rtree->leaf_count() - visible_ops.size();
+  if (hidden_op_count > 0) {
+    occlusion_clip_ = visible;
+    context->occluded_op_count += hidden_op_count;
+  }
+  return false;
 }
 
 void DisplayListLayer::Paint(PaintContext& context) const {
@@ -158,6 +224,10 @@ void DisplayListLayer::Paint(PaintContext& context) const {
     context.layer_snapshot_store->Add(snapshot_data);
   }
 
+  if (!occlusion_clip_.isEmpty()) {
+    mutator.clipRect(occlusion_clip_, false);
+  }
+
   auto display_list = display_list_.skia_object();
   context.canvas->DrawDisplayList(display_list, opacity);
 }
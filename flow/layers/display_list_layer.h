@@ -38,6 +38,8 @@ class DisplayListLayer : public Layer {
 
   void Preroll(PrerollContext* frame) override;
 
+  bool Occlude(PrerollContext* context, const SkRect& occluder) override;
+
   void Paint(PaintContext& context) const override;
 
   const DisplayListRasterCacheItem* raster_cache_item() const {
@@ -55,6 +57,11 @@ class DisplayListLayer : public Layer {
   SkPoint offset_;
   SkRect bounds_;
 
+  // The part of the display list, in its own coordinates, that is not
+  // covered by opaque content painted after this layer when the layer is
+  // only partially occluded, or empty if the display list is not clipped.
+  SkRect occlusion_clip_;
+
   flutter::SkiaGPUObject<DisplayList> display_list_;
 
   static bool Compare(DiffContext::Statistics& statistics,
@@ -10,6 +10,7 @@ namespace flutter {
 
 Layer::Layer()
     : paint_bounds_(SkRect::MakeEmpty()),
+      opaque_bounds_(SkRect::MakeEmpty()),
       unique_id_(NextUniqueID()),
       original_layer_id_(unique_id_),
       subtree_has_platform_view_(false) {}
@@ -25,6 +26,17 @@ uint64_t Layer::NextUniqueID() {
   return id;
 }
 
+bool Layer::Occlude(PrerollContext* context, const SkRect& occluder) {
+  // Layers hosting platform views must always be painted, see the comment
+  // in |needs_painting|.
+  is_occluded_ = !subtree_has_platform_view_ && !is_empty() &&
+                 occluder.contains(paint_bounds_);
+  if (is_occluded_) {
+    context->occluded_layer_count++;
+  }
+  return is_occluded_;
+}
+
 Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
     PrerollContext* preroll_context,
     bool save_layer_is_active,
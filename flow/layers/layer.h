@@ -89,6 +89,16 @@ struct PrerollContext {
   // the embedders that must decide between creating SkPicture or
   // DisplayList objects for the inter-view slices of the layer tree.
   bool display_list_enabled = false;
+
+  // Whether layers hidden underneath opaque content painted later in the
+  // frame are skipped. This is only turned off to measure what it saves.
+  bool occlusion_culling_enabled = true;
+
+  // The number of layers, and of the DisplayList ops recorded within them,
+  // that were found to be hidden underneath opaque content painted later
+  // in the frame and which will therefore not be painted.
+  size_t occluded_layer_count = 0;
+  size_t occluded_op_count = 0;
 };
 
 struct PaintContext {
@@ -228,6 +238,32 @@ class Layer {
   // Determines if the layer has any content.
   bool is_empty() const { return paint_bounds_.isEmpty(); }
 
+  // Returns a rect in the same coordinate system as |paint_bounds| that
+  // is known to be completely covered by opaque pixels when this layer
+  // is painted, or an empty rect if no such area is known.
+  //
+  // The parent resets the opaque bounds before it calls Preroll() on
+  // this layer, so a layer that does not set them during Preroll() is
+  // assumed to not occlude anything painted underneath it.
+  const SkRect& opaque_bounds() const { return opaque_bounds_; }
+  void set_opaque_bounds(const SkRect& opaque_bounds) {
+    opaque_bounds_ = opaque_bounds;
+  }
+
+  // Called by the parent at the end of its Preroll() with a rect, in the
+  // same coordinate system as |paint_bounds|, that will be covered by
+  // opaque content painted after this layer, or with an empty rect if no
+  // such content exists.
+  //
+  // Returns true and marks the layer as occluded if the layer is entirely
+  // hidden by the occluding content.
+  virtual bool Occlude(PrerollContext* context, const SkRect& occluder);
+
+  // Determines if the layer was found to be entirely hidden by the
+  // occluder passed to |Occlude| during the most recent Preroll(), in
+  // which case its parent will skip painting it.
+  bool is_occluded() const { return is_occluded_; }
+
   // Determines if the Paint() method is necessary based on the properties
   // of the indicated PaintContext object.
   bool needs_painting(PaintContext& context) const {
@@ -266,9 +302,11 @@ class Layer {
 
  private:
   SkRect paint_bounds_;
+  SkRect opaque_bounds_;
   uint64_t unique_id_;
   uint64_t original_layer_id_;
   bool subtree_has_platform_view_;
+  bool is_occluded_ = false;
 
   static uint64_t NextUniqueID();
 
@@ -72,6 +72,14 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
 
   root_layer_->Preroll(&context);
 
+  occluded_layer_count_ = context.occluded_layer_count;
+  occluded_op_count_ = context.occluded_op_count;
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "LayerTree::Occlusion",
+                    reinterpret_cast<int64_t>(this), "CulledLayers",
+                    occluded_layer_count_, "CulledOps", occluded_op_count_);
+#endif  // !FLUTTER_RELEASE
+
   return context.surface_needs_readback;
 }
 
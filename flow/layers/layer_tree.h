@@ -58,6 +58,12 @@ class LayerTree {
   const SkISize& frame_size() const { return frame_size_; }
   float device_pixel_ratio() const { return device_pixel_ratio_; }
 
+  // The number of layers, and of the DisplayList ops within them, that
+  // the most recent Preroll() found to be hidden underneath opaque content
+  // and that will be skipped when the tree is painted.
+  size_t occluded_layer_count() const { return occluded_layer_count_; }
+  size_t occluded_op_count() const { return occluded_op_count_; }
+
   const PaintRegionMap& paint_region_map() const { return paint_region_map_; }
   PaintRegionMap& paint_region_map() { return paint_region_map_; }
 
@@ -100,6 +106,8 @@ class LayerTree {
   bool checkerboard_raster_cache_images_;
   bool checkerboard_offscreen_layers_;
   bool enable_leaf_layer_tracing_ = false;
+  size_t occluded_layer_count_ = 0;
+  size_t occluded_op_count_ = 0;
 
   PaintRegionMap paint_region_map_;
 
@@ -0,0 +1,185 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/skia/dl_sk_canvas.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_state_stack.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/message_loop.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kScreenWidth = 1080;
+constexpr int kScreenHeight = 1920;
+
+// The number of tiles across and down that make up the content of a route.
+constexpr int kTileColumns = 8;
+constexpr int kTileRows = 16;
+
+// Records a full screen route consisting of an opaque background with a
+// grid of tiles painted on top of it, in the same way that a typical
+// Scaffold with a scrolling list of cards would.
+sk_sp<DisplayList> MakeRouteDisplayList(DlColor tile_color) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  builder.DrawRect(SkRect::MakeWH(kScreenWidth, kScreenHeight),
+                   DlPaint(DlColor::kWhite()));
+  SkScalar tile_width = kScreenWidth / static_cast<SkScalar>(kTileColumns);
+  SkScalar tile_height = kScreenHeight / static_cast<SkScalar>(kTileRows);
+  DlPaint tile_paint(tile_color);
+  tile_paint.setAntiAlias(true);
+  for (int y = 0; y < kTileRows; y++) {
+    for (int x = 0; x < kTileColumns; x++) {
+      SkRect tile = SkRect::MakeXYWH(x * tile_width, y * tile_height,
+                                     tile_width, tile_height);
+      builder.DrawRRect(SkRRect::MakeRectXY(tile.makeInset(8, 8), 6, 6),
+                        tile_paint);
+    }
+  }
+  return builder.Build();
+}
+
+// Builds a layer tree of |route_count| full screen routes stacked on top of
+// each other, as the Navigator does while routes are pushed, and the
+// |partial_route| flag adds a final route that only covers the bottom half
+// of the screen, like a modal bottom sheet.
+std::shared_ptr<ContainerLayer> MakeStackedRoutes(
+    int route_count,
+    bool partial_route,
+    const fml::RefPtr<SkiaUnrefQueue>& unref_queue) {
+  auto root = std::make_shared<ContainerLayer>();
+  for (int i = 0; i < route_count; i++) {
+    auto route = std::make_shared<TransformLayer>(SkMatrix::I());
+    auto display_list =
+        MakeRouteDisplayList(i % 2 ? DlColor::kBlue() : DlColor::kGreen());
+    route->Add(std::make_shared<DisplayListLayer>(
+        SkPoint::Make(0, 0),
+        SkiaGPUObject<DisplayList>(display_list, unref_queue), false, false));
+    root->Add(route);
+  }
+  if (partial_route) {
+    auto sheet = std::make_shared<TransformLayer>(
+        SkMatrix::Translate(0, kScreenHeight / 2));
+    auto display_list = MakeRouteDisplayList(DlColor::kRed());
+    sheet->Add(std::make_shared<DisplayListLayer>(
+        SkPoint::Make(0, 0),
+        SkiaGPUObject<DisplayList>(display_list, unref_queue), false, false));
+    root->Add(sheet);
+  }
+  return root;
+}
+
+}  // namespace
+
+static void BM_LayerTreeStackedRoutes(benchmark::State& state,
+                                      bool partial_route,
+                                      bool occlusion_culling) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(),
+      fml::TimeDelta::FromSeconds(0));
+  auto root = MakeStackedRoutes(state.range(0), partial_route, unref_queue);
+
+  auto surface = SkSurface::MakeRasterN32Premul(kScreenWidth, kScreenHeight);
+  DlSkCanvasAdapter canvas(surface->getCanvas());
+  auto texture_registry = std::make_shared<TextureRegistry>();
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  std::vector<RasterCacheItem*> raster_cached_entries;
+
+  size_t occluded_layer_count = 0;
+  size_t occluded_op_count = 0;
+  while (state.KeepRunning()) {
+    LayerStateStack preroll_state_stack;
+    preroll_state_stack.set_preroll_delegate(
+        SkRect::MakeWH(kScreenWidth, kScreenHeight), SkMatrix::I());
+    raster_cached_entries.clear();
+    PrerollContext preroll_context{
+        // clang-format off
+        .raster_cache                  = nullptr,
+        .gr_context                    = nullptr,
+        .view_embedder                 = nullptr,
+        .state_stack                   = preroll_state_stack,
+        .dst_color_space               = nullptr,
+        .surface_needs_readback        = false,
+        .raster_time                   = raster_time,
+        .ui_time                       = ui_time,
+        .texture_registry              = texture_registry,
+        .frame_device_pixel_ratio      = 1.0f,
+        .raster_cached_entries         = &raster_cached_entries,
+        .occlusion_culling_enabled     = occlusion_culling,
+        // clang-format on
+    };
+    root->Preroll(&preroll_context);
+    occluded_layer_count = preroll_context.occluded_layer_count;
+    occluded_op_count = preroll_context.occluded_op_count;
+
+    LayerStateStack paint_state_stack;
+    paint_state_stack.set_delegate(&canvas);
+    PaintContext paint_context{
+        // clang-format off
+        .state_stack                   = paint_state_stack,
+        .canvas                        = &canvas,
+        .gr_context                    = nullptr,
+        .dst_color_space               = nullptr,
+        .view_embedder                 = nullptr,
+        .raster_time                   = raster_time,
+        .ui_time                       = ui_time,
+        .texture_registry              = texture_registry,
+        .raster_cache                  = nullptr,
+        .frame_device_pixel_ratio      = 1.0f,
+        // clang-format on
+    };
+    root->Paint(paint_context);
+    surface->flushAndSubmit();
+  }
+
+  state.counters["CulledLayers"] = occluded_layer_count;
+  state.counters["CulledOps"] = occluded_op_count;
+}
+
+BENCHMARK_CAPTURE(BM_LayerTreeStackedRoutes,
+                  FullScreenRoutes,
+                  /*partial_route=*/false,
+                  /*occlusion_culling=*/true)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_LayerTreeStackedRoutes,
+                  FullScreenRoutesWithoutCulling,
+                  /*partial_route=*/false,
+                  /*occlusion_culling=*/false)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_LayerTreeStackedRoutes,
+                  RoutesWithBottomSheet,
+                  /*partial_route=*/true,
+                  /*occlusion_culling=*/true)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_LayerTreeStackedRoutes,
+                  RoutesWithBottomSheetWithoutCulling,
+                  /*partial_route=*/true,
+                  /*occlusion_culling=*/false)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
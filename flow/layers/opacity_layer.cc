@@ -58,6 +58,11 @@ void OpacityLayer::Preroll(PrerollContext* context) {
   context->renderable_state_flags |= LayerStateStack::kCallerCanApplyOpacity;
 
   set_paint_bounds(paint_bounds().makeOffset(offset_.fX, offset_.fY));
+  if (alpha_ == SK_AlphaOPAQUE) {
+    set_opaque_bounds(opaque_bounds().makeOffset(offset_.fX, offset_.fY));
+  } else {
+    set_opaque_bounds(SkRect::MakeEmpty());
+  }
 
   if (children_can_accept_opacity()) {
     // For opacity layer, we can use raster_cache children only when the
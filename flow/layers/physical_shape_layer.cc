@@ -74,6 +74,22 @@ void PhysicalShapeLayer::Preroll(PrerollContext* context) {
   }
 
   set_paint_bounds(paint_bounds);
+
+  // Either our own fill or the opaque content of our children (restricted
+  // to our shape if we clip them) may occlude the layers painted below us.
+  SkRect shape_inner_bounds = ComputeInnerRect(path_);
+  SkRect opaque_bounds =
+      color_.isOpaque() ? shape_inner_bounds : SkRect::MakeEmpty();
+  SkRect child_opaque_bounds = children_opaque_bounds();
+  if (clip_behavior_ != Clip::none &&
+      !child_opaque_bounds.intersect(shape_inner_bounds)) {
+    child_opaque_bounds.setEmpty();
+  }
+  if (child_opaque_bounds.width() * child_opaque_bounds.height() >
+      opaque_bounds.width() * opaque_bounds.height()) {
+    opaque_bounds = child_opaque_bounds;
+  }
+  set_opaque_bounds(opaque_bounds);
 }
 
 void PhysicalShapeLayer::Paint(PaintContext& context) const {
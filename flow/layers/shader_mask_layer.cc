@@ -41,6 +41,8 @@ void ShaderMaskLayer::Preroll(PrerollContext* context) {
                               context->state_stack.transform_3x3());
 
   ContainerLayer::Preroll(context);
+  // The mask may change the alpha of the opaque content of our children.
+  set_opaque_bounds(SkRect::MakeEmpty());
   // We always paint with a saveLayer (or a cached rendering),
   // so we can always apply opacity in any of those cases.
   context->renderable_state_flags = kSaveLayerRenderFlags;
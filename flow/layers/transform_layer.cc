@@ -49,6 +49,12 @@ void TransformLayer::Preroll(PrerollContext* context) {
 
   transform_.mapRect(&child_paint_bounds);
   set_paint_bounds(child_paint_bounds);
+
+  // The mapped opaque bounds are only exact if the transform keeps
+  // rectangles axis-aligned.
+  if (transform_.rectStaysRect()) {
+    set_opaque_bounds(transform_.mapRect(children_opaque_bounds()));
+  }
 }
 
 void TransformLayer::Paint(PaintContext& context) const {
@@ -6,6 +6,8 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImage.h"
 
@@ -54,4 +56,54 @@ void DrawCheckerboard(DlCanvas* canvas, const SkRect& rect) {
   canvas->DrawRect(rect, debug_paint);
 }
 
+SkRect ComputeInnerRect(const SkRect& rect) {
+  return rect.makeSorted();
+}
+
+SkRect ComputeInnerRect(const SkRRect& rrect) {
+  if (rrect.isEmpty()) {
+    return SkRect::MakeEmpty();
+  }
+  const SkRect& rect = rrect.rect();
+  if (rrect.isRect()) {
+    return rect;
+  }
+  SkVector ul = rrect.radii(SkRRect::kUpperLeft_Corner);
+  SkVector ur = rrect.radii(SkRRect::kUpperRight_Corner);
+  SkVector lr = rrect.radii(SkRRect::kLowerRight_Corner);
+  SkVector ll = rrect.radii(SkRRect::kLowerLeft_Corner);
+  // The corners only cut into the rect within their radii, so the full
+  // width band between the corners and the full height band between the
+  // corners are both contained within the round rect.
+  SkRect horizontal = SkRect::MakeLTRB(
+      rect.fLeft, rect.fTop + std::max(ul.fY, ur.fY),  //
+      rect.fRight, rect.fBottom - std::max(ll.fY, lr.fY));
+  SkRect vertical = SkRect::MakeLTRB(
+      rect.fLeft + std::max(ul.fX, ll.fX), rect.fTop,  //
+      rect.fRight - std::max(ur.fX, lr.fX), rect.fBottom);
+  SkScalar horizontal_area =
+      horizontal.isEmpty() ? 0 : horizontal.width() * horizontal.height();
+  SkScalar vertical_area =
+      vertical.isEmpty() ? 0 : vertical.width() * vertical.height();
+  if (horizontal_area == 0 && vertical_area == 0) {
+    return SkRect::MakeEmpty();
+  }
+  return horizontal_area >= vertical_area ? horizontal : vertical;
+}
+
+SkRect ComputeInnerRect(const SkPath& path) {
+  if (path.isInverseFillType()) {
+    return SkRect::MakeEmpty();
+  }
+  SkRect rect;
+  if (path.isRect(&rect)) {
+    return ComputeInnerRect(rect);
+  }
+  SkRRect rrect;
+  if (path.isRRect(&rrect)) {
+    return ComputeInnerRect(rrect);
+  }
+  return SkRect::MakeEmpty();
+}
+
 }  // namespace flutter
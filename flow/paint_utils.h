@@ -8,6 +8,8 @@
 #include "flutter/display_list/dl_canvas.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
 #include "third_party/skia/include/core/SkRect.h"
 
 namespace flutter {
@@ -16,6 +18,13 @@ typedef void (*CheckerboardFunc)(DlCanvas*, const SkRect&);
 
 void DrawCheckerboard(DlCanvas* canvas, const SkRect& rect);
 
+// Returns a rect that is entirely contained within the given shape, or an
+// empty rect if no such rect can be computed cheaply. This is used to find
+// the area covered by a layer that fills or clips to the shape.
+SkRect ComputeInnerRect(const SkRect& rect);
+SkRect ComputeInnerRect(const SkRRect& rrect);
+SkRect ComputeInnerRect(const SkPath& path);
+
 }  // namespace flutter
 
 #endif  // FLUTTER_FLOW_PAINT_UTILS_H_
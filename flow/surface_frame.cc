@@ -20,7 +20,8 @@ SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            const SubmitCallback& submit_callback,
                            SkISize frame_size,
                            std::unique_ptr<GLContextResult> context_result,
-                           bool display_list_fallback)
+                           bool display_list_fallback,
+                           bool display_list_fallback_rtree)
     : surface_(std::move(surface)),
       framebuffer_info_(framebuffer_info),
       submit_callback_(submit_callback),
@@ -31,7 +32,8 @@ SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
     canvas_ = &adapter_;
   } else if (display_list_fallback) {
     FML_DCHECK(!frame_size.isEmpty());
-    dl_builder_ = sk_make_sp<DisplayListBuilder>(SkRect::Make(frame_size));
+    dl_builder_ = sk_make_sp<DisplayListBuilder>(SkRect::Make(frame_size),
+                                                 display_list_fallback_rtree);
     canvas_ = dl_builder_.get();
   }
 }
@@ -34,4 +34,19 @@ TEST(FlowTest, SurfaceFrameDoesNotHaveEmptyCanvas) {
   EXPECT_FALSE(frame.Canvas()->QuickReject(SkRect::MakeLTRB(10, 10, 50, 50)));
 }
 
+TEST(FlowTest, SurfaceFrameDisplayListFallbackCanPrepareRTree) {
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  SurfaceFrame frame(
+      /*surface=*/nullptr, framebuffer_info,
+      /*submit_callback=*/[](const SurfaceFrame&, DlCanvas*) { return true; },
+      /*frame_size=*/SkISize::Make(800, 600),
+      /*context_result=*/nullptr, /*display_list_fallback=*/true,
+      /*display_list_fallback_rtree=*/true);
+
+  frame.Canvas()->DrawRect(SkRect::MakeLTRB(10, 10, 50, 50), DlPaint());
+  auto display_list = frame.BuildDisplayList();
+  ASSERT_NE(display_list, nullptr);
+  EXPECT_TRUE(display_list->has_rtree());
+}
+
 }  // namespace flutter
@@ -47,6 +47,9 @@ void MockLayer::Preroll(PrerollContext* context) {
   if (fake_opacity_compatible()) {
     context->renderable_state_flags = LayerStateStack::kCallerCanApplyOpacity;
   }
+  if (fake_opaque()) {
+    set_opaque_bounds(paint_bounds());
+  }
 }
 
 void MockLayer::Paint(PaintContext& context) const {
@@ -66,6 +66,8 @@ class MockLayer : public Layer {
 
   bool fake_has_texture_layer() { return mock_flags_ & kFakeHasTextureLayer; }
 
+  bool fake_opaque() { return mock_flags_ & kFakeOpaque; }
+
   MockLayer& set_parent_has_platform_view(bool flag) {
     flag ? (mock_flags_ |= kParentHasPlatformView)
          : (mock_flags_ &= ~(kParentHasPlatformView));
@@ -102,6 +104,13 @@ class MockLayer : public Layer {
     return *this;
   }
 
+  // Reports the bounds of the path as opaque so that the layer occludes
+  // any sibling painted underneath it.
+  MockLayer& set_fake_opaque(bool flag) {
+    flag ? (mock_flags_ |= kFakeOpaque) : (mock_flags_ &= ~(kFakeOpaque));
+    return *this;
+  }
+
   void set_expected_paint_matrix(const SkMatrix& matrix) {
     expected_paint_matrix_ = matrix;
   }
@@ -120,6 +129,7 @@ class MockLayer : public Layer {
   static constexpr int kFakeReadsSurface = 1 << 3;
   static constexpr int kFakeOpacityCompatible = 1 << 4;
   static constexpr int kFakeHasTextureLayer = 1 << 5;
+  static constexpr int kFakeOpaque = 1 << 6;
 
   int mock_flags_ = 0;
 
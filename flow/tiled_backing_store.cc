@@ -0,0 +1,154 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/tiled_backing_store.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/display_list/skia/dl_sk_canvas.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+
+namespace flutter {
+
+TiledBackingStore::TiledBackingStore(
+    const SkISize& tile_size,
+    std::shared_ptr<fml::BasicTaskRunner> worker_task_runner,
+    size_t worker_count)
+    : tile_size_(tile_size),
+      worker_task_runner_(std::move(worker_task_runner)),
+      worker_count_(worker_task_runner_ ? worker_count : 0) {
+  FML_DCHECK(!tile_size_.isEmpty());
+}
+
+TiledBackingStore::~TiledBackingStore() = default;
+
+bool TiledBackingStore::Resize(const SkISize& size) {
+  if (surface_ != nullptr && size == size_) {
+    return true;
+  }
+
+  TRACE_EVENT0("flutter", "TiledBackingStore::Resize");
+  tiles_.clear();
+  surface_ = nullptr;
+  has_contents_ = false;
+  size_ = size;
+
+  SkImageInfo info = SkImageInfo::MakeN32Premul(size.width(), size.height(),
+                                                SkColorSpace::MakeSRGB());
+  if (size.isEmpty() || !pixels_.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Could not allocate the tiled backing store.";
+    pixels_.reset();
+    return false;
+  }
+  surface_ = SkSurface::MakeRasterDirect(pixels_.pixmap());
+
+  for (int y = 0; y < size.height(); y += tile_size_.height()) {
+    for (int x = 0; x < size.width(); x += tile_size_.width()) {
+      SkIRect bounds = SkIRect::MakeXYWH(x, y, tile_size_.width(),
+                                         tile_size_.height());
+      if (!bounds.intersect(SkIRect::MakeSize(size))) {
+        continue;
+      }
+      SkPixmap tile_pixels;
+      if (!pixels_.pixmap().extractSubset(&tile_pixels, bounds)) {
+        continue;
+      }
+      tiles_.push_back({
+          .bounds = bounds,
+          .surface = SkSurface::MakeRasterDirect(tile_pixels),
+      });
+    }
+  }
+  return surface_ != nullptr;
+}
+
+std::optional<SkIRect> TiledBackingStore::existing_damage() const {
+  if (!has_contents_) {
+    return std::nullopt;
+  }
+  return SkIRect::MakeEmpty();
+}
+
+void TiledBackingStore::Invalidate() {
+  has_contents_ = false;
+}
+
+size_t TiledBackingStore::Rasterize(const sk_sp<DisplayList>& display_list,
+                                    const std::optional<SkIRect>& damage) {
+  TRACE_EVENT0("flutter", "TiledBackingStore::Rasterize");
+  last_rasterized_tile_count_ = 0;
+  if (!surface_ || !display_list) {
+    return 0;
+  }
+
+  SkIRect dirty = SkIRect::MakeSize(size_);
+  if (has_contents_ && damage.has_value() && !dirty.intersect(*damage)) {
+    return 0;
+  }
+
+  std::vector<TileDamage> work;
+  for (const Tile& tile : tiles_) {
+    SkIRect tile_damage = tile.bounds;
+    if (tile_damage.intersect(dirty)) {
+      work.push_back({.tile = &tile, .damage = tile_damage});
+    }
+  }
+
+  std::atomic_size_t next_tile = 0;
+  // The calling thread rasterizes tiles as well, so only hand out work to
+  // as many workers as there are tiles left for them.
+  const size_t helper_count =
+      work.empty() ? 0 : std::min(worker_count_, work.size() - 1);
+  if (helper_count > 0) {
+    fml::CountDownLatch latch(helper_count);
+    for (size_t i = 0; i < helper_count; i++) {
+      worker_task_runner_->PostTask([&work, &next_tile, &display_list,
+                                     &latch]() {
+        RasterizeTiles(work, next_tile, display_list);
+        latch.CountDown();
+      });
+    }
+    RasterizeTiles(work, next_tile, display_list);
+    latch.Wait();
+  } else {
+    RasterizeTiles(work, next_tile, display_list);
+  }
+
+  has_contents_ = true;
+  last_rasterized_tile_count_ = work.size();
+  return last_rasterized_tile_count_;
+}
+
+void TiledBackingStore::RasterizeTiles(const std::vector<TileDamage>& work,
+                                       std::atomic_size_t& next_tile,
+                                       const sk_sp<DisplayList>& display_list) {
+  for (size_t i = next_tile++; i < work.size(); i = next_tile++) {
+    RasterizeTile(*work[i].tile, work[i].damage, display_list);
+  }
+}
+
+void TiledBackingStore::RasterizeTile(const Tile& tile,
+                                      const SkIRect& damage,
+                                      const sk_sp<DisplayList>& display_list) {
+  SkCanvas* canvas = tile.surface->getCanvas();
+  DlSkCanvasAdapter adapter(canvas);
+
+  // The tile surface wraps the pixels of the tile alone, so the frame is
+  // translated to place the tile at the origin and everything outside of
+  // the damaged part of the tile is clipped away. The adapter culls the
+  // display list to the clip through its R-Tree.
+  canvas->save();
+  canvas->translate(-tile.bounds.left(), -tile.bounds.top());
+  canvas->clipIRect(damage);
+  canvas->clear(SK_ColorTRANSPARENT);
+  adapter.DrawDisplayList(display_list);
+  canvas->restore();
+}
+
+}  // namespace flutter
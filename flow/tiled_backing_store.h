@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_TILED_BACKING_STORE_H_
+#define FLUTTER_FLOW_TILED_BACKING_STORE_H_
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A raster backing store that persists across frames and is
+///             divided into a grid of fixed size tiles.
+///
+///             Each frame is recorded into a |DisplayList| and only the tiles
+///             that intersect the damage computed for the frame are
+///             re-rasterized from it. The remaining tiles keep the pixels of
+///             the previous frame. All tiles share a single allocation so the
+///             store can be presented as one contiguous buffer.
+///
+///             When given a worker task runner, the damaged tiles are
+///             rasterized in parallel by the calling thread and the workers,
+///             each tile through its own canvas. Each tile only dispatches
+///             the ops of the display list that its |DlRTree| reports as
+///             intersecting the tile, if the display list has one.
+///
+class TiledBackingStore {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a tiled backing store.
+  ///
+  /// @param[in]  tile_size           The size of the tiles.
+  /// @param[in]  worker_task_runner  The task runner used to rasterize tiles
+  ///                                 in parallel, or nullptr to rasterize all
+  ///                                 tiles on the calling thread.
+  /// @param[in]  worker_count        The number of tasks that can run
+  ///                                 concurrently on the worker task runner.
+  ///
+  explicit TiledBackingStore(
+      const SkISize& tile_size = SkISize::Make(kDefaultTileSize,
+                                               kDefaultTileSize),
+      std::shared_ptr<fml::BasicTaskRunner> worker_task_runner = nullptr,
+      size_t worker_count = 0);
+
+  ~TiledBackingStore();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Ensures that the store covers a frame of the given size. If
+  ///             the size changes the pixels are reallocated and every tile
+  ///             will be rasterized by the next call to |Rasterize|.
+  ///
+  /// @return     Whether the store could be allocated.
+  ///
+  bool Resize(const SkISize& size);
+
+  const SkISize& size() const { return size_; }
+
+  const SkISize& tile_size() const { return tile_size_; }
+
+  size_t tile_count() const { return tiles_.size(); }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of tiles that were re-rasterized by the most
+  ///             recent call to |Rasterize|.
+  ///
+  size_t last_rasterized_tile_count() const {
+    return last_rasterized_tile_count_;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      A surface that wraps the pixels of all tiles, used to
+  ///             present the frame.
+  ///
+  sk_sp<SkSurface> surface() const { return surface_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The area of the store whose pixels do not match the last
+  ///             frame that was rasterized into it, in the form expected by
+  ///             |SurfaceFrame::FramebufferInfo::existing_damage|.
+  ///
+  /// @return     An empty rect if the store holds the previous frame, or
+  ///             std::nullopt if the entire frame must be repainted.
+  ///
+  std::optional<SkIRect> existing_damage() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Discards the contents of the store so that every tile will
+  ///             be rasterized by the next call to |Rasterize|.
+  ///
+  void Invalidate();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Re-rasterizes the tiles that intersect the damaged area of
+  ///             the frame from the given display list. Pixels outside of the
+  ///             damaged area are left untouched.
+  ///
+  /// @param[in]  display_list  The recording of the frame.
+  /// @param[in]  damage        The area of the frame that changed since the
+  ///                           previous frame, or std::nullopt to repaint
+  ///                           the entire frame.
+  ///
+  /// @return     The number of tiles that were re-rasterized.
+  ///
+  size_t Rasterize(const sk_sp<DisplayList>& display_list,
+                   const std::optional<SkIRect>& damage);
+
+ private:
+  struct Tile {
+    SkIRect bounds;
+    sk_sp<SkSurface> surface;
+  };
+
+  const SkISize tile_size_;
+  const std::shared_ptr<fml::BasicTaskRunner> worker_task_runner_;
+  const size_t worker_count_;
+  SkISize size_ = SkISize::MakeEmpty();
+  SkBitmap pixels_;
+  sk_sp<SkSurface> surface_;
+  std::vector<Tile> tiles_;
+  bool has_contents_ = false;
+  size_t last_rasterized_tile_count_ = 0;
+
+  struct TileDamage {
+    const Tile* tile;
+    SkIRect damage;
+  };
+
+  static void RasterizeTile(const Tile& tile,
+                            const SkIRect& damage,
+                            const sk_sp<DisplayList>& display_list);
+
+  // Rasterizes tiles from |work| until none are left, claiming them one at
+  // a time through |next_tile| so that several threads can share the work.
+  static void RasterizeTiles(const std::vector<TileDamage>& work,
+                             std::atomic_size_t& next_tile,
+                             const sk_sp<DisplayList>& display_list);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TiledBackingStore);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_TILED_BACKING_STORE_H_
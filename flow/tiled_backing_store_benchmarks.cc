@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/flow/tiled_backing_store.h"
+#include "flutter/fml/concurrent_message_loop.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr SkISize kFrameSize = SkISize::Make(1080, 1920);
+constexpr SkISize k4KFrameSize = SkISize::Make(3840, 2160);
+
+// Records a frame made of a grid of anti-aliased rounded rects over an
+// opaque background, which is representative of a scrolling list.
+sk_sp<DisplayList> MakeFrameDisplayList(const SkISize& size = kFrameSize) {
+  DisplayListBuilder builder(SkRect::Make(size), /*prepare_rtree=*/true);
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  DlPaint paint(DlColor::kBlue());
+  paint.setAntiAlias(true);
+  for (int y = 0; y < size.height(); y += 40) {
+    for (int x = 0; x < size.width(); x += 40) {
+      builder.DrawRRect(
+          SkRRect::MakeRectXY(SkRect::MakeXYWH(x + 4, y + 4, 32, 32), 6, 6),
+          paint);
+    }
+  }
+  return builder.Build();
+}
+
+}  // namespace
+
+// Measures the time to rasterize a frame into a tiled backing store that
+// holds the previous frame, where the frame damage is a square with the
+// edge length given by the benchmark argument centered in the frame.
+static void BM_TiledBackingStoreDamage(benchmark::State& state) {
+  auto display_list = MakeFrameDisplayList();
+  TiledBackingStore store;
+  store.Resize(kFrameSize);
+  store.Rasterize(display_list, std::nullopt);
+
+  const int edge = state.range(0);
+  const SkIRect damage = SkIRect::MakeXYWH(
+      (kFrameSize.width() - edge) / 2, (kFrameSize.height() - edge) / 2,
+      edge, edge);
+  while (state.KeepRunning()) {
+    store.Rasterize(display_list, damage);
+  }
+  state.counters["Tiles"] = store.last_rasterized_tile_count();
+}
+
+// Measures the time to rasterize every tile of a frame, which is the cost
+// of a software frame without partial repaint.
+static void BM_TiledBackingStoreFullRepaint(benchmark::State& state) {
+  auto display_list = MakeFrameDisplayList();
+  TiledBackingStore store;
+  store.Resize(kFrameSize);
+
+  while (state.KeepRunning()) {
+    store.Rasterize(display_list, std::nullopt);
+  }
+  state.counters["Tiles"] = store.last_rasterized_tile_count();
+}
+
+// Measures the time to rasterize every tile of a frame of the given size
+// with the number of threads given by the benchmark argument, which
+// includes the calling thread.
+static void BM_TiledBackingStoreParallel(benchmark::State& state,
+                                         SkISize frame_size) {
+  auto display_list = MakeFrameDisplayList(frame_size);
+  const size_t thread_count = state.range(0);
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::BasicTaskRunner> worker_task_runner;
+  if (thread_count > 1) {
+    loop = fml::ConcurrentMessageLoop::Create(thread_count - 1);
+    worker_task_runner = loop->GetTaskRunner();
+  }
+  TiledBackingStore store(
+      SkISize::Make(TiledBackingStore::kDefaultTileSize,
+                    TiledBackingStore::kDefaultTileSize),
+      worker_task_runner, thread_count - 1);
+  store.Resize(frame_size);
+
+  while (state.KeepRunning()) {
+    store.Rasterize(display_list, std::nullopt);
+  }
+  state.counters["Tiles"] = store.last_rasterized_tile_count();
+  state.counters["Pixels"] = benchmark::Counter(
+      static_cast<double>(frame_size.area()) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_TiledBackingStoreDamage)
+    ->RangeMultiplier(2)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_TiledBackingStoreFullRepaint)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_TiledBackingStoreParallel, 1080p, kFrameSize)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_TiledBackingStoreParallel, 4K, k4KFrameSize)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,163 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/tiled_backing_store.h"
+
+#include <cstring>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkColor.h"
+
+namespace flutter::testing {
+
+static sk_sp<DisplayList> MakeFilledDisplayList(const SkISize& size,
+                                                DlColor color) {
+  DisplayListBuilder builder(SkRect::Make(size));
+  builder.DrawRect(SkRect::Make(size), DlPaint(color));
+  return builder.Build();
+}
+
+static SkColor GetPixel(const TiledBackingStore& store, int x, int y) {
+  SkPixmap pixmap;
+  EXPECT_TRUE(store.surface()->peekPixels(&pixmap));
+  return pixmap.getColor(x, y);
+}
+
+TEST(TiledBackingStoreTest, EmptyStoreIsInvalid) {
+  TiledBackingStore store;
+  EXPECT_FALSE(store.Resize(SkISize::MakeEmpty()));
+  EXPECT_EQ(store.surface(), nullptr);
+  EXPECT_EQ(store.tile_count(), 0u);
+}
+
+TEST(TiledBackingStoreTest, ResizeCoversFrameWithTiles) {
+  TiledBackingStore store(SkISize::Make(256, 256));
+  ASSERT_TRUE(store.Resize(SkISize::Make(600, 300)));
+  ASSERT_NE(store.surface(), nullptr);
+  EXPECT_EQ(store.surface()->width(), 600);
+  EXPECT_EQ(store.surface()->height(), 300);
+  // 3 columns (256 + 256 + 88) by 2 rows (256 + 44).
+  EXPECT_EQ(store.tile_count(), 6u);
+  EXPECT_FALSE(store.existing_damage().has_value());
+}
+
+TEST(TiledBackingStoreTest, FirstFrameRasterizesAllTiles) {
+  const SkISize size = SkISize::Make(600, 300);
+  TiledBackingStore store(SkISize::Make(256, 256));
+  ASSERT_TRUE(store.Resize(size));
+
+  // The damage is ignored as the store has no contents yet.
+  EXPECT_EQ(store.Rasterize(MakeFilledDisplayList(size, DlColor::kRed()),
+                            SkIRect::MakeXYWH(0, 0, 10, 10)),
+            6u);
+  EXPECT_EQ(store.last_rasterized_tile_count(), 6u);
+  EXPECT_EQ(GetPixel(store, 599, 299), SK_ColorRED);
+  ASSERT_TRUE(store.existing_damage().has_value());
+  EXPECT_TRUE(store.existing_damage()->isEmpty());
+}
+
+TEST(TiledBackingStoreTest, OnlyDamagedTilesAreRasterized) {
+  const SkISize size = SkISize::Make(600, 300);
+  TiledBackingStore store(SkISize::Make(256, 256));
+  ASSERT_TRUE(store.Resize(size));
+  store.Rasterize(MakeFilledDisplayList(size, DlColor::kRed()), std::nullopt);
+
+  EXPECT_EQ(store.Rasterize(MakeFilledDisplayList(size, DlColor::kBlue()),
+                            SkIRect::MakeLTRB(10, 10, 20, 20)),
+            1u);
+  // Inside of the damage.
+  EXPECT_EQ(GetPixel(store, 15, 15), SK_ColorBLUE);
+  // Inside of the damaged tile, but outside of the damage.
+  EXPECT_EQ(GetPixel(store, 5, 5), SK_ColorRED);
+  // Inside of an undamaged tile.
+  EXPECT_EQ(GetPixel(store, 300, 100), SK_ColorRED);
+
+  // Damage that straddles a tile boundary rasterizes both tiles.
+  EXPECT_EQ(store.Rasterize(MakeFilledDisplayList(size, DlColor::kGreen()),
+                            SkIRect::MakeLTRB(250, 10, 260, 20)),
+            2u);
+  EXPECT_EQ(GetPixel(store, 255, 15), SK_ColorGREEN);
+  EXPECT_EQ(GetPixel(store, 256, 15), SK_ColorGREEN);
+
+  // No damage rasterizes nothing.
+  EXPECT_EQ(store.Rasterize(MakeFilledDisplayList(size, DlColor::kBlack()),
+                            SkIRect::MakeEmpty()),
+            0u);
+  EXPECT_EQ(GetPixel(store, 15, 15), SK_ColorBLUE);
+}
+
+TEST(TiledBackingStoreTest, MissingDamageRasterizesAllTiles) {
+  const SkISize size = SkISize::Make(600, 300);
+  TiledBackingStore store(SkISize::Make(256, 256));
+  ASSERT_TRUE(store.Resize(size));
+  store.Rasterize(MakeFilledDisplayList(size, DlColor::kRed()), std::nullopt);
+
+  EXPECT_EQ(store.Rasterize(MakeFilledDisplayList(size, DlColor::kBlue()),
+                            std::nullopt),
+            6u);
+  EXPECT_EQ(GetPixel(store, 5, 5), SK_ColorBLUE);
+  EXPECT_EQ(GetPixel(store, 599, 299), SK_ColorBLUE);
+}
+
+TEST(TiledBackingStoreTest, ResizeAndInvalidateDiscardContents) {
+  TiledBackingStore store(SkISize::Make(256, 256));
+  ASSERT_TRUE(store.Resize(SkISize::Make(600, 300)));
+  store.Rasterize(
+      MakeFilledDisplayList(SkISize::Make(600, 300), DlColor::kRed()),
+      std::nullopt);
+  ASSERT_TRUE(store.existing_damage().has_value());
+
+  // Resizing to the same size keeps the contents.
+  ASSERT_TRUE(store.Resize(SkISize::Make(600, 300)));
+  EXPECT_TRUE(store.existing_damage().has_value());
+
+  store.Invalidate();
+  EXPECT_FALSE(store.existing_damage().has_value());
+
+  store.Rasterize(
+      MakeFilledDisplayList(SkISize::Make(600, 300), DlColor::kRed()),
+      std::nullopt);
+  ASSERT_TRUE(store.Resize(SkISize::Make(300, 600)));
+  EXPECT_FALSE(store.existing_damage().has_value());
+  EXPECT_EQ(store.tile_count(), 6u);
+}
+
+TEST(TiledBackingStoreTest, ParallelRasterizationMatchesSingleThreaded) {
+  const SkISize size = SkISize::Make(700, 500);
+  DisplayListBuilder builder(SkRect::Make(size), /*prepare_rtree=*/true);
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  DlPaint paint(DlColor::kBlue());
+  paint.setAntiAlias(true);
+  for (int i = 0; i < 40; i++) {
+    SkPoint center =
+        SkPoint::Make(i * 17 % size.width(), i * 29 % size.height());
+    builder.DrawCircle(center, 15 + i, paint);
+    paint.setColor(paint.getColor().withRed(i * 6));
+  }
+  auto display_list = builder.Build();
+
+  TiledBackingStore single_threaded(SkISize::Make(64, 64));
+  ASSERT_TRUE(single_threaded.Resize(size));
+  single_threaded.Rasterize(display_list, std::nullopt);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  TiledBackingStore parallel(SkISize::Make(64, 64), loop->GetTaskRunner(),
+                             loop->GetWorkerCount());
+  ASSERT_TRUE(parallel.Resize(size));
+  EXPECT_EQ(parallel.Rasterize(display_list, std::nullopt),
+            single_threaded.tile_count());
+
+  SkPixmap expected;
+  SkPixmap actual;
+  ASSERT_TRUE(single_threaded.surface()->peekPixels(&expected));
+  ASSERT_TRUE(parallel.surface()->peekPixels(&actual));
+  ASSERT_EQ(expected.computeByteSize(), actual.computeByteSize());
+  EXPECT_EQ(std::memcmp(expected.addr(), actual.addr(),
+                        expected.computeByteSize()),
+            0);
+}
+
+}  // namespace flutter::testing
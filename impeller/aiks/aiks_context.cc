@@ -41,6 +41,8 @@ bool AiksContext::Render(const Picture& picture, RenderTarget& render_target) {
     return false;
   }
 
+  content_context_->GetTextScaleTracker()->AdvanceFrame();
+
   if (picture.pass) {
     return picture.pass->Render(*content_context_, render_target);
   }
@@ -107,6 +107,7 @@ enum class PixelFormat {
   kB10G10R10A10XR,
   // Depth and stencil formats.
   kS8UInt,
+  kD24UnormS8Uint,
   kD32FloatS8UInt,
 };
 
@@ -337,6 +338,7 @@ constexpr size_t BytesPerPixelForPixelFormat(PixelFormat format) {
     case PixelFormat::kB8G8R8A8UNormIntSRGB:
     case PixelFormat::kB10G10R10XRSRGB:
     case PixelFormat::kB10G10R10XR:
+    case PixelFormat::kD24UnormS8Uint:
       return 4u;
     case PixelFormat::kD32FloatS8UInt:
       return 5u;
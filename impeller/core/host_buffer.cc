@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <numeric>
 
 #include "flutter/fml/logging.h"
 
@@ -16,10 +17,20 @@
 namespace impeller {
 
 std::shared_ptr<HostBuffer> HostBuffer::Create() {
-  return std::shared_ptr<HostBuffer>(new HostBuffer());
+  return std::shared_ptr<HostBuffer>(new HostBuffer(nullptr));
 }
 
-HostBuffer::HostBuffer() = default;
+std::shared_ptr<HostBuffer> HostBuffer::Create(
+    std::shared_ptr<Allocator> allocator) {
+  return std::shared_ptr<HostBuffer>(new HostBuffer(std::move(allocator)));
+}
+
+HostBuffer::HostBuffer(std::shared_ptr<Allocator> allocator)
+    : allocator_(std::move(allocator)) {
+  for (auto& arena : arenas_) {
+    arena = std::make_shared<Arena>();
+  }
+}
 
 HostBuffer::~HostBuffer() = default;
 
@@ -27,9 +38,144 @@ void HostBuffer::SetLabel(std::string label) {
   label_ = std::move(label);
 }
 
+bool HostBuffer::IsRing() const {
+  return allocator_ != nullptr;
+}
+
+static size_t GetUsedBytes(
+    const std::vector<std::shared_ptr<DeviceBuffer>>& blocks,
+    size_t block_index,
+    size_t offset) {
+  for (size_t i = 0u; i < block_index && i < blocks.size(); i++) {
+    offset += blocks[i]->GetDeviceBufferDescriptor().size;
+  }
+  return offset;
+}
+
+static size_t GetCapacity(
+    const std::vector<std::shared_ptr<DeviceBuffer>>& blocks) {
+  return GetUsedBytes(blocks, blocks.size(), 0u);
+}
+
+const HostBuffer::Statistics& HostBuffer::GetStatistics() const {
+  statistics_.ring_capacity = std::accumulate(
+      arenas_.begin(), arenas_.end(), size_t{0u},
+      [](size_t total, const std::shared_ptr<Arena>& arena) {
+        return total + GetCapacity(arena->blocks);
+      });
+  return statistics_;
+}
+
+std::shared_ptr<const void> HostBuffer::GetFrameFence() const {
+  if (!IsRing()) {
+    return nullptr;
+  }
+  return arenas_[frame_ % kFrameCount];
+}
+
+void HostBuffer::Reset() {
+  if (!IsRing()) {
+    return;
+  }
+
+  const auto& arena = *arenas_[frame_ % kFrameCount];
+  used_bytes_[frame_ % kHighWaterFrameCount] =
+      GetUsedBytes(arena.blocks, arena.block_index, arena.offset);
+  frame_++;
+
+  // The command buffers of a frame that is still fenced may not have been
+  // executed yet, so its blocks go to the fence holders.
+  if (arenas_[frame_ % kFrameCount].use_count() > 1) {
+    arenas_[frame_ % kFrameCount] = std::make_shared<Arena>();
+  }
+  auto& next = *arenas_[frame_ % kFrameCount];
+  next.block_index = 0u;
+  next.offset = 0u;
+
+  // Blocks still referenced from outside of the ring, such as by views or
+  // by backends that track the buffers of their commands, must not be
+  // written to either.
+  next.blocks.erase(std::remove_if(next.blocks.begin(), next.blocks.end(),
+                                   [](const auto& block) {
+                                     return block.use_count() > 1;
+                                   }),
+                    next.blocks.end());
+
+  // Size the frame for the largest of the recent frames in a single block.
+  // Frames that had to grow by more blocks are consolidated, and blocks far
+  // larger than needed are given back.
+  const auto high_water =
+      std::max(*std::max_element(used_bytes_.begin(), used_bytes_.end()),
+               kMinimumBlockSize);
+  const auto capacity = GetCapacity(next.blocks);
+  if (next.blocks.size() > 1u || capacity < high_water ||
+      capacity > high_water * 4u) {
+    next.blocks.clear();
+    if (auto block = CreateBlock(high_water)) {
+      next.blocks.push_back(std::move(block));
+    }
+  }
+}
+
+std::shared_ptr<DeviceBuffer> HostBuffer::CreateBlock(size_t size) {
+  DeviceBufferDescriptor desc;
+  desc.size = size;
+  desc.storage_mode = StorageMode::kHostVisible;
+  auto block = allocator_->CreateBuffer(desc);
+  if (!block) {
+    return nullptr;
+  }
+  if (!label_.empty()) {
+    block->SetLabel(label_);
+  }
+  statistics_.device_buffer_allocation_count++;
+  return block;
+}
+
+BufferView HostBuffer::EmplaceInRing(const void* buffer,
+                                     size_t length,
+                                     size_t align) {
+  auto& arena = *arenas_[frame_ % kFrameCount];
+
+  auto offset = arena.offset;
+  if (align != 0 && (offset % align) != 0) {
+    offset += align - (offset % align);
+  }
+
+  // Move on to the next block with enough room, or add one.
+  while (arena.block_index < arena.blocks.size() &&
+         offset + length > arena.blocks[arena.block_index]
+                               ->GetDeviceBufferDescriptor()
+                               .size) {
+    arena.block_index++;
+    offset = 0u;
+  }
+  if (arena.block_index == arena.blocks.size()) {
+    auto block = CreateBlock(std::max(length, kMinimumBlockSize));
+    if (!block) {
+      return {};
+    }
+    arena.blocks.push_back(std::move(block));
+  }
+
+  const auto& block = arena.blocks[arena.block_index];
+  // Copy through the device buffer rather than into its contents directly so
+  // that backends that shadow the contents on the host see the write.
+  if (buffer && !block->CopyHostBuffer(static_cast<const uint8_t*>(buffer),
+                                       Range{0u, length}, offset)) {
+    return {};
+  }
+  arena.offset = offset + length;
+  return BufferView{block, block->OnGetContents(), Range{offset, length}};
+}
+
 BufferView HostBuffer::Emplace(const void* buffer,
                                size_t length,
                                size_t align) {
+  if (IsRing()) {
+    return EmplaceInRing(buffer, length, align);
+  }
+
   if (align == 0 || (GetLength() % align) == 0) {
     return Emplace(buffer, length);
   }
@@ -66,6 +212,7 @@ std::shared_ptr<const DeviceBuffer> HostBuffer::GetDeviceBuffer(
     return nullptr;
   }
   new_buffer->SetLabel(label_);
+  statistics_.device_buffer_allocation_count++;
   device_buffer_generation_ = generation_;
   device_buffer_ = std::move(new_buffer);
   return device_buffer_;
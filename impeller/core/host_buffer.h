@@ -5,9 +5,11 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/base/allocation.h"
@@ -17,17 +19,102 @@
 
 namespace impeller {
 
+class Allocator;
+
+//------------------------------------------------------------------------------
+/// @brief      A buffer of transient data, such as uniforms and vertices, that
+///             is written on the host and read by the device.
+///
+///             By default, the data is gathered in a single host allocation
+///             that is copied to a new device buffer whenever it changed.
+///
+///             A host buffer created with an allocator is a ring instead.
+///             Data is written straight into host visible device buffers that
+///             are recycled every `kFrameCount` frames, so that a frame does
+///             not allocate or copy device buffers once the ring has grown to
+///             the size of its frames. Call `Reset` at the end of each frame.
+///             Command buffers that read the data of a frame hold its
+///             `GetFrameFence` until they complete, and a ring that wraps
+///             around to a frame that is still fenced allocates new device
+///             buffers instead of overwriting it.
+///
 class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
                          public Allocation,
                          public Buffer {
  public:
+  //----------------------------------------------------------------------------
+  /// The number of frames whose data a ring keeps apart.
+  ///
+  static constexpr size_t kFrameCount = 3u;
+
+  //----------------------------------------------------------------------------
+  /// The smallest device buffer a ring allocates.
+  ///
+  static constexpr size_t kMinimumBlockSize = 256u * 1024u;
+
+  //----------------------------------------------------------------------------
+  /// The number of recent frames whose high-water mark sizes the device
+  /// buffers of a ring.
+  ///
+  static constexpr size_t kHighWaterFrameCount = 16u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counters for the device buffers of a host buffer.
+  ///
+  struct Statistics {
+    /// The number of device buffers allocated over the lifetime of the host
+    /// buffer.
+    size_t device_buffer_allocation_count = 0u;
+    /// The number of bytes of device buffers held by a ring.
+    size_t ring_capacity = 0u;
+  };
+
   static std::shared_ptr<HostBuffer> Create();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Create a host buffer that is a ring of host visible device
+  ///             buffers allocated from the given allocator.
+  ///
+  /// @param[in]  allocator  The allocator of the device buffers. If it is
+  ///                        null, a regular host buffer is created.
+  ///
+  static std::shared_ptr<HostBuffer> Create(
+      std::shared_ptr<Allocator> allocator);
+
   // |Buffer|
   virtual ~HostBuffer();
 
   void SetLabel(std::string label);
 
+  //----------------------------------------------------------------------------
+  /// @brief      End the frame of a ring, and recycle the device buffers of the
+  ///             frame `kFrameCount - 1` frames ago for the next one.
+  ///
+  ///             Does nothing if this host buffer is not a ring.
+  ///
+  void Reset();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether data is written straight into device buffers.
+  ///
+  bool IsRing() const;
+
+  const Statistics& GetStatistics() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get a fence that keeps the device buffers of the current
+  ///             frame of a ring from being recycled for as long as it is
+  ///             held.
+  ///
+  ///             Not every backend retains the buffers bound to its commands,
+  ///             so command buffers that read the frame must hold the fence
+  ///             until the device is done with them, usually by capturing it
+  ///             in their completion callback.
+  ///
+  /// @return     The fence, or null if this host buffer is not a ring.
+  ///
+  std::shared_ptr<const void> GetFrameFence() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Emplace uniform data onto the host buffer. Ensure that backend
   ///             specific uniform alignment requirements are respected.
@@ -91,15 +178,35 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
     );
   }
 
+  //----------------------------------------------------------------------------
+  /// @brief      Emplace data onto the buffer.
+  ///
+  ///             If `buffer` is null, the space is only reserved. Data written
+  ///             into the contents of the returned view of a ring afterwards
+  ///             is not guaranteed to reach the device.
+  ///
   [[nodiscard]] BufferView Emplace(const void* buffer,
                                    size_t length,
                                    size_t align);
 
  private:
+  struct Arena {
+    std::vector<std::shared_ptr<DeviceBuffer>> blocks;
+    size_t block_index = 0u;
+    size_t offset = 0u;
+  };
+
   mutable std::shared_ptr<DeviceBuffer> device_buffer_;
   mutable size_t device_buffer_generation_ = 0u;
   size_t generation_ = 1u;
   std::string label_;
+  mutable Statistics statistics_;
+  std::shared_ptr<Allocator> allocator_;
+  // Arenas are shared with the fences of their frame. An arena that is still
+  // fenced when the ring wraps around to it is left to the fence holders.
+  std::array<std::shared_ptr<Arena>, kFrameCount> arenas_;
+  size_t frame_ = 0u;
+  std::array<size_t, kHighWaterFrameCount> used_bytes_ = {};
 
   // |Buffer|
   std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
@@ -107,7 +214,13 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
 
   [[nodiscard]] BufferView Emplace(const void* buffer, size_t length);
 
-  HostBuffer();
+  [[nodiscard]] BufferView EmplaceInRing(const void* buffer,
+                                         size_t length,
+                                         size_t align);
+
+  std::shared_ptr<DeviceBuffer> CreateBlock(size_t size);
+
+  explicit HostBuffer(std::shared_ptr<Allocator> allocator);
 
   FML_DISALLOW_COPY_AND_ASSIGN(HostBuffer);
 };
@@ -0,0 +1,254 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/core/allocator.h"
+#include "impeller/core/device_buffer.h"
+#include "impeller/core/host_buffer.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+class TestDeviceBuffer final : public DeviceBuffer {
+ public:
+  explicit TestDeviceBuffer(const DeviceBufferDescriptor& desc)
+      : DeviceBuffer(desc), storage_(desc.size) {}
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label) override { return true; }
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+
+  // |DeviceBuffer|
+  uint8_t* OnGetContents() const override {
+    return const_cast<uint8_t*>(storage_.data());
+  }
+
+ private:
+  std::vector<uint8_t> storage_;
+
+  // |DeviceBuffer|
+  bool OnCopyHostBuffer(const uint8_t* source,
+                        Range source_range,
+                        size_t offset) override {
+    std::memmove(storage_.data() + offset, source + source_range.offset,
+                 source_range.length);
+    return true;
+  }
+};
+
+class TestAllocator final : public Allocator {
+ public:
+  // |Allocator|
+  ISize GetMaxTextureSizeSupported() const override { return {}; }
+
+  size_t GetBufferCount() const { return buffer_count_; }
+
+ private:
+  size_t buffer_count_ = 0u;
+
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> OnCreateBuffer(
+      const DeviceBufferDescriptor& desc) override {
+    buffer_count_++;
+    return std::make_shared<TestDeviceBuffer>(desc);
+  }
+
+  // |Allocator|
+  std::shared_ptr<Texture> OnCreateTexture(
+      const TextureDescriptor& desc) override {
+    return nullptr;
+  }
+};
+
+// Emplaces `count` values of `size` bytes, each filled with `value`.
+std::vector<BufferView> EmplaceFrame(HostBuffer& buffer,
+                                     size_t count,
+                                     size_t size,
+                                     uint8_t value) {
+  std::vector<uint8_t> data(size, value);
+  std::vector<BufferView> views;
+  for (size_t i = 0u; i < count; i++) {
+    views.push_back(buffer.Emplace(data.data(), data.size(), 256u));
+  }
+  return views;
+}
+
+bool ViewContains(const BufferView& view, uint8_t value) {
+  for (size_t i = 0u; i < view.range.length; i++) {
+    if (view.contents[view.range.offset + i] != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(HostBufferTest, CopiesToNewDeviceBufferWhenChanged) {
+  TestAllocator allocator;
+  auto buffer = HostBuffer::Create();
+  ASSERT_FALSE(buffer->IsRing());
+
+  auto view = buffer->Emplace(std::array<uint8_t, 4>{1, 2, 3, 4});
+  ASSERT_TRUE(view);
+  const Buffer& host_buffer = *buffer;
+  auto device_buffer = host_buffer.GetDeviceBuffer(allocator);
+  ASSERT_TRUE(device_buffer);
+  ASSERT_EQ(host_buffer.GetDeviceBuffer(allocator), device_buffer);
+  ASSERT_EQ(allocator.GetBufferCount(), 1u);
+
+  ASSERT_TRUE(buffer->Emplace(std::array<uint8_t, 4>{5, 6, 7, 8}));
+  ASSERT_NE(host_buffer.GetDeviceBuffer(allocator), device_buffer);
+  ASSERT_EQ(allocator.GetBufferCount(), 2u);
+  ASSERT_EQ(buffer->GetStatistics().device_buffer_allocation_count, 2u);
+}
+
+TEST(HostBufferTest, RingEmplacesIntoDeviceBuffers) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+  ASSERT_TRUE(buffer->IsRing());
+
+  auto first = buffer->Emplace(std::array<uint8_t, 3>{1, 2, 3});
+  auto second = buffer->EmplaceUniform(std::array<uint32_t, 2>{4, 5});
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+
+  // Both views are backed by the same device buffer, which is handed to the
+  // backends as is.
+  ASSERT_EQ(first.buffer, second.buffer);
+  ASSERT_EQ(first.buffer->GetDeviceBuffer(*allocator), first.buffer);
+  ASSERT_EQ(allocator->GetBufferCount(), 1u);
+
+  ASSERT_EQ(first.range.offset, 0u);
+  ASSERT_EQ(second.range.offset % DefaultUniformAlignment(), 0u);
+  ASSERT_GT(second.range.offset, 0u);
+  ASSERT_EQ(first.contents[first.range.offset + 2], 3u);
+  uint32_t value = 0u;
+  std::memcpy(&value, second.contents + second.range.offset + 4u, 4u);
+  ASSERT_EQ(value, 5u);
+}
+
+TEST(HostBufferTest, RingReusesDeviceBuffersAcrossFrames) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+
+  for (size_t frame = 0u; frame < HostBuffer::kFrameCount; frame++) {
+    EmplaceFrame(*buffer, 64u, 128u, static_cast<uint8_t>(frame));
+    buffer->Reset();
+  }
+  const auto allocation_count = allocator->GetBufferCount();
+  ASSERT_LE(allocation_count, HostBuffer::kFrameCount);
+
+  for (size_t frame = 0u; frame < 30u; frame++) {
+    const auto value = static_cast<uint8_t>(frame);
+    auto views = EmplaceFrame(*buffer, 64u, 128u, value);
+    for (const auto& view : views) {
+      ASSERT_TRUE(ViewContains(view, value));
+    }
+    buffer->Reset();
+  }
+  ASSERT_EQ(allocator->GetBufferCount(), allocation_count);
+}
+
+TEST(HostBufferTest, RingSizesDeviceBuffersForLargeFrames) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+
+  // A frame larger than a single block spills into more blocks.
+  const size_t large_count = 3u * HostBuffer::kMinimumBlockSize / 1024u;
+  auto views = EmplaceFrame(*buffer, large_count, 1024u, 1u);
+  ASSERT_GT(allocator->GetBufferCount(), 1u);
+  for (const auto& view : views) {
+    ASSERT_TRUE(ViewContains(view, 1u));
+  }
+  views.clear();
+
+  // Once every frame of the ring was sized for it, frames of the same size
+  // fit in a single block each.
+  for (size_t frame = 0u; frame < HostBuffer::kFrameCount + 1u; frame++) {
+    buffer->Reset();
+    EmplaceFrame(*buffer, large_count, 1024u, 1u);
+  }
+  const auto allocation_count = allocator->GetBufferCount();
+  for (size_t frame = 0u; frame < 10u; frame++) {
+    buffer->Reset();
+    EmplaceFrame(*buffer, large_count, 1024u, 1u);
+  }
+  ASSERT_EQ(allocator->GetBufferCount(), allocation_count);
+  ASSERT_LE(buffer->GetStatistics().ring_capacity,
+            HostBuffer::kFrameCount * 4u * HostBuffer::kMinimumBlockSize);
+}
+
+TEST(HostBufferTest, RingDoesNotOverwriteDeviceBuffersInUse) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+
+  // The view stands in for a command buffer that is still being executed.
+  auto in_use = buffer->Emplace(std::array<uint8_t, 4>{7, 7, 7, 7});
+  ASSERT_TRUE(in_use);
+  for (size_t frame = 0u; frame < HostBuffer::kFrameCount; frame++) {
+    buffer->Reset();
+    auto views = EmplaceFrame(*buffer, 4u, 4u, 9u);
+    ASSERT_NE(views.front().buffer, in_use.buffer);
+  }
+  ASSERT_TRUE(ViewContains(in_use, 7u));
+}
+
+TEST(HostBufferTest, RingDoesNotRecycleFencedFrames) {
+  auto allocator = std::make_shared<TestAllocator>();
+  auto buffer = HostBuffer::Create(allocator);
+
+  // The fence stands in for a command buffer that is still being executed by
+  // a backend that does not retain the buffers bound to its commands.
+  auto fence = buffer->GetFrameFence();
+  ASSERT_TRUE(fence);
+  auto view = buffer->Emplace(std::array<uint8_t, 4>{7, 7, 7, 7});
+  ASSERT_TRUE(view);
+  const auto* fenced_contents = view.contents + view.range.offset;
+  view = {};
+
+  for (size_t frame = 0u; frame < 2u * HostBuffer::kFrameCount; frame++) {
+    buffer->Reset();
+    EmplaceFrame(*buffer, 4u, 4u, 9u);
+  }
+  for (size_t i = 0u; i < 4u; i++) {
+    ASSERT_EQ(fenced_contents[i], 7u);
+  }
+
+  // Once the fence is released, the ring settles again.
+  fence.reset();
+  for (size_t frame = 0u; frame < HostBuffer::kFrameCount; frame++) {
+    buffer->Reset();
+    EmplaceFrame(*buffer, 4u, 4u, 9u);
+  }
+  const auto allocation_count = allocator->GetBufferCount();
+  for (size_t frame = 0u; frame < 10u; frame++) {
+    buffer->Reset();
+    EmplaceFrame(*buffer, 4u, 4u, 9u);
+  }
+  ASSERT_EQ(allocator->GetBufferCount(), allocation_count);
+}
+
+TEST(HostBufferTest, ResetDoesNothingWithoutRing) {
+  auto buffer = HostBuffer::Create();
+  auto view = buffer->Emplace(std::array<uint8_t, 4>{1, 2, 3, 4});
+  buffer->Reset();
+  ASSERT_EQ(view.contents[view.range.offset + 3], 4u);
+  ASSERT_EQ(buffer->GetLength(), 4u);
+  ASSERT_FALSE(buffer->GetFrameFence());
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -61,6 +61,18 @@ struct TextureDescriptor {
            mip_count >= 1u &&                  //
            SamplingOptionsAreValid();
   }
+
+  constexpr bool operator==(const TextureDescriptor& other) const {
+    return storage_mode == other.storage_mode && type == other.type &&
+           format == other.format && size == other.size &&
+           mip_count == other.mip_count && usage == other.usage &&
+           sample_count == other.sample_count &&
+           compression_type == other.compression_type;
+  }
+
+  constexpr bool operator!=(const TextureDescriptor& other) const {
+    return !(*this == other);
+  }
 };
 
 }  // namespace impeller
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <sstream>
+#include <thread>
 
 #include "impeller/base/strings.h"
 #include "impeller/core/formats.h"
@@ -141,6 +142,18 @@ void ContentContextOptions::ApplyToPipelineDescriptor(
     desc.SetStencilAttachmentDescriptors(stencil);
   }
 
+  if (depth_attachment_pixel_format.has_value()) {
+    // The depth and the stencil of entity passes share a texture.
+    desc.SetDepthStencilAttachmentDescriptor(DepthAttachmentDescriptor{
+        .depth_compare = depth_compare,
+        .depth_write_enabled = depth_write_enabled,
+    });
+    desc.SetDepthPixelFormat(depth_attachment_pixel_format.value());
+    if (desc.HasStencilAttachmentDescriptors()) {
+      desc.SetStencilPixelFormat(depth_attachment_pixel_format.value());
+    }
+  }
+
   desc.SetPrimitiveType(primitive_type);
 
   desc.SetPolygonMode(wireframe ? PolygonMode::kLine : PolygonMode::kFill);
@@ -161,10 +174,29 @@ static std::unique_ptr<PipelineT> CreateDefaultPipeline(
   return std::make_unique<PipelineT>(context, desc);
 }
 
+static std::shared_ptr<GlyphAtlasContext> CreateGlyphAtlasContext(
+    const std::shared_ptr<Context>& context) {
+  auto worker_task_runner =
+      context ? context->GetConcurrentWorkerTaskRunner() : nullptr;
+  // Worker task runners are backed by a loop with a thread per core.
+  return std::make_shared<GlyphAtlasContext>(
+      GlyphAtlasContext::kDefaultPageSize,
+      GlyphAtlasContext::kDefaultMaxPageCount, std::move(worker_task_runner),
+      std::thread::hardware_concurrency());
+}
+
 ContentContext::ContentContext(std::shared_ptr<Context> context)
     : context_(std::move(context)),
       tessellator_(std::make_shared<Tessellator>()),
-      glyph_atlas_context_(std::make_shared<GlyphAtlasContext>()),
+      glyph_atlas_context_(CreateGlyphAtlasContext(context_)),
+      sdf_glyph_atlas_context_(CreateGlyphAtlasContext(context_)),
+      text_layout_cache_(std::make_shared<TextLayoutCache>()),
+      text_scale_tracker_(std::make_shared<TextScaleTracker>()),
+      render_target_cache_(std::make_shared<RenderTargetCache>(
+          context_ ? context_->GetResourceAllocator() : nullptr)),
+      gaussian_blur_kernel_cache_(std::make_shared<GaussianBlurKernelCache>()),
+      transients_buffer_(HostBuffer::Create(
+          context_ ? context_->GetResourceAllocator() : nullptr)),
       scene_context_(std::make_shared<scene::SceneContext>(context_)) {
   if (!context_ || !context_->IsValid()) {
     return;
@@ -349,8 +381,14 @@ std::shared_ptr<Texture> ContentContext::MakeSubpass(
     return nullptr;
   }
   sub_renderpass->SetLabel(SPrintF("%s RenderPass", label.c_str()));
-
-  if (!subpass_callback(*this, *sub_renderpass)) {
+  sub_renderpass->SetTransientsBuffer(GetTransientsBuffer());
+
+  // Whatever samples the subpass expects all of it to be drawn, so its
+  // pipelines are always waited on.
+  subpass_depth_++;
+  const bool subpass_rendered = subpass_callback(*this, *sub_renderpass);
+  subpass_depth_--;
+  if (!subpass_rendered) {
     return nullptr;
   }
 
@@ -358,7 +396,13 @@ std::shared_ptr<Texture> ContentContext::MakeSubpass(
     return nullptr;
   }
 
-  if (!sub_command_buffer->SubmitCommands()) {
+  // The device may still read the transient data of the subpass after the
+  // frame ends.
+  auto transients_buffer = GetTransientsBuffer();
+  auto fence =
+      transients_buffer ? transients_buffer->GetFrameFence() : nullptr;
+  if (!sub_command_buffer->SubmitCommands(
+          [fence = std::move(fence)](CommandBuffer::Status) {})) {
     return nullptr;
   }
 
@@ -373,9 +417,47 @@ std::shared_ptr<Tessellator> ContentContext::GetTessellator() const {
   return tessellator_;
 }
 
-std::shared_ptr<GlyphAtlasContext> ContentContext::GetGlyphAtlasContext()
+std::shared_ptr<GlyphAtlasContext> ContentContext::GetGlyphAtlasContext(
+    GlyphAtlas::Type type) const {
+  return type == GlyphAtlas::Type::kSignedDistanceField
+             ? sdf_glyph_atlas_context_
+             : glyph_atlas_context_;
+}
+
+std::shared_ptr<TextLayoutCache> ContentContext::GetTextLayoutCache() const {
+  return text_layout_cache_;
+}
+
+std::shared_ptr<TextScaleTracker> ContentContext::GetTextScaleTracker() const {
+  return text_scale_tracker_;
+}
+
+std::shared_ptr<RenderTargetCache> ContentContext::GetRenderTargetCache()
     const {
-  return glyph_atlas_context_;
+  return render_target_cache_;
+}
+
+std::shared_ptr<GaussianBlurKernelCache>
+ContentContext::GetGaussianBlurKernelCache() const {
+  return gaussian_blur_kernel_cache_;
+}
+
+void ContentContext::StartFrame() {
+  render_target_cache_->Start();
+  frame_depth_++;
+}
+
+void ContentContext::EndFrame() {
+  render_target_cache_->End();
+  if (frame_depth_ == 0u || --frame_depth_ > 0u) {
+    return;
+  }
+  transients_buffer_->Reset();
+}
+
+std::shared_ptr<HostBuffer> ContentContext::GetTransientsBuffer() const {
+  // Outside of a frame, nothing would ever reset the ring.
+  return frame_depth_ > 0u ? transients_buffer_ : nullptr;
 }
 
 std::shared_ptr<Context> ContentContext::GetContext() const {
@@ -390,4 +472,46 @@ void ContentContext::SetWireframe(bool wireframe) {
   wireframe_ = wireframe;
 }
 
+void ContentContext::SetOpaqueDepthPassEnabled(bool enabled) {
+  opaque_depth_pass_enabled_ = enabled;
+}
+
+bool ContentContext::IsOpaqueDepthPassEnabled() const {
+  return opaque_depth_pass_enabled_;
+}
+
+void ContentContext::SetPendingPipelineSkippingEnabled(bool enabled) {
+  pending_pipeline_skipping_enabled_ = enabled;
+}
+
+bool ContentContext::IsPendingPipelineSkippingEnabled() const {
+  return pending_pipeline_skipping_enabled_;
+}
+
+ContentContext::PendingPipelineSkippingScope::PendingPipelineSkippingScope(
+    const ContentContext& renderer,
+    RenderPass& pass)
+    : renderer_(renderer),
+      pass_(pass),
+      was_allowed_(renderer.pipeline_skipping_allowed_),
+      was_skipping_(pass.GetSkipCommandsWithoutPipeline()) {
+  renderer_.pipeline_skipping_allowed_ = true;
+  pass_.SetSkipCommandsWithoutPipeline(
+      renderer_.pending_pipeline_skipping_enabled_ &&
+      renderer_.subpass_depth_ == 0u);
+}
+
+ContentContext::PendingPipelineSkippingScope::~PendingPipelineSkippingScope() {
+  renderer_.pipeline_skipping_allowed_ = was_allowed_;
+  pass_.SetSkipCommandsWithoutPipeline(was_skipping_);
+}
+
+void ContentContext::SetComputeTessellationEnabled(bool enabled) {
+  compute_tessellation_enabled_ = enabled;
+}
+
+bool ContentContext::IsComputeTessellationEnabled() const {
+  return compute_tessellation_enabled_;
+}
+
 }  // namespace impeller
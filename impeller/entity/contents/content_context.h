@@ -13,9 +13,13 @@
 #include "flutter/fml/macros.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
+#include "impeller/core/host_buffer.h"
+#include "impeller/entity/contents/filters/gaussian_blur_kernel.h"
 #include "impeller/entity/entity.h"
+#include "impeller/entity/render_target_cache.h"
 #include "impeller/renderer/capabilities.h"
 #include "impeller/renderer/pipeline.h"
+#include "impeller/renderer/pipeline_library.h"
 #include "impeller/scene/scene_context.h"
 
 #include "impeller/entity/blend.frag.h"
@@ -60,6 +64,8 @@
 #include "impeller/entity/position_color.vert.h"
 
 #include "impeller/typographer/glyph_atlas.h"
+#include "impeller/typographer/text_layout_cache.h"
+#include "impeller/typographer/text_scale_tracker.h"
 
 #include "impeller/entity/conical_gradient_ssbo_fill.frag.h"
 #include "impeller/entity/linear_gradient_ssbo_fill.frag.h"
@@ -282,6 +288,9 @@ struct ContentContextOptions {
   PrimitiveType primitive_type = PrimitiveType::kTriangle;
   std::optional<PixelFormat> color_attachment_pixel_format;
   bool has_stencil_attachment = true;
+  std::optional<PixelFormat> depth_attachment_pixel_format;
+  CompareFunction depth_compare = CompareFunction::kAlways;
+  bool depth_write_enabled = false;
   bool wireframe = false;
 
   struct Hash {
@@ -289,7 +298,10 @@ struct ContentContextOptions {
       return fml::HashCombine(o.sample_count, o.blend_mode, o.stencil_compare,
                               o.stencil_operation, o.primitive_type,
                               o.color_attachment_pixel_format,
-                              o.has_stencil_attachment, o.wireframe);
+                              o.has_stencil_attachment,
+                              o.depth_attachment_pixel_format,
+                              o.depth_compare, o.depth_write_enabled,
+                              o.wireframe);
     }
   };
 
@@ -304,6 +316,10 @@ struct ContentContextOptions {
              lhs.color_attachment_pixel_format ==
                  rhs.color_attachment_pixel_format &&
              lhs.has_stencil_attachment == rhs.has_stencil_attachment &&
+             lhs.depth_attachment_pixel_format ==
+                 rhs.depth_attachment_pixel_format &&
+             lhs.depth_compare == rhs.depth_compare &&
+             lhs.depth_write_enabled == rhs.depth_write_enabled &&
              lhs.wireframe == rhs.wireframe;
     }
   };
@@ -446,7 +462,8 @@ class ContentContext {
 
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetClipPipeline(
       ContentContextOptions opts) const {
-    return GetPipeline(clip_pipelines_, opts);
+    // Clips are never skipped, or whatever they clip would draw unclipped.
+    return GetPipeline(clip_pipelines_, opts, /*skippable=*/false);
   }
 
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetGlyphAtlasPipeline(
@@ -639,12 +656,108 @@ class ContentContext {
 
   std::shared_ptr<Context> GetContext() const;
 
-  std::shared_ptr<GlyphAtlasContext> GetGlyphAtlasContext() const;
+  //----------------------------------------------------------------------------
+  /// @brief      Get the context that keeps the glyph atlas of the given
+  ///             type across frames. Signed distance field atlases are kept
+  ///             apart from bitmap atlases so that text switching between
+  ///             them does not rebuild either.
+  ///
+  std::shared_ptr<GlyphAtlasContext> GetGlyphAtlasContext(
+      GlyphAtlas::Type type) const;
+
+  std::shared_ptr<TextLayoutCache> GetTextLayoutCache() const;
+
+  std::shared_ptr<TextScaleTracker> GetTextScaleTracker() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the allocator that recycles the textures of offscreen
+  ///             render targets, such as those of entity subpasses, from
+  ///             frame to frame.
+  ///
+  std::shared_ptr<RenderTargetCache> GetRenderTargetCache() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the cache of the kernels of Gaussian blurs.
+  ///
+  std::shared_ptr<GaussianBlurKernelCache> GetGaussianBlurKernelCache() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the start of a frame. Frames may be nested, in which
+  ///             case only the outermost one counts.
+  ///
+  void StartFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the end of a frame. The offscreen textures and the
+  ///             transient data of the frame may be recycled afterwards.
+  ///
+  void EndFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the ring the render passes of the current frame emplace
+  ///             their transient data onto.
+  ///
+  /// @return     The ring, or null outside of a frame.
+  ///
+  std::shared_ptr<HostBuffer> GetTransientsBuffer() const;
 
   const Capabilities& GetDeviceCapabilities() const;
 
   void SetWireframe(bool wireframe);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Whether entity passes draw the opaque entities that cover
+  ///             other entities first, and reject what they cover with a
+  ///             depth test. Enabled by default, but only used by passes
+  ///             that draw offscreen.
+  ///
+  void SetOpaqueDepthPassEnabled(bool enabled);
+
+  bool IsOpaqueDepthPassEnabled() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether pipelines that are still being created are returned
+  ///             as null instead of being waited on, while a
+  ///             `PendingPipelineSkippingScope` is open. Entity passes then
+  ///             leave out what they would draw with them. Clip pipelines and
+  ///             the draws into subpasses are always waited on. Disabled by
+  ///             default.
+  ///
+  void SetPendingPipelineSkippingEnabled(bool enabled);
+
+  bool IsPendingPipelineSkippingEnabled() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Lets the draws into a render pass leave out the commands
+  ///             whose pipelines are still being created, for as long as it
+  ///             is alive and pending pipeline skipping is enabled. Only open
+  ///             it around draws that leave the stencil alone.
+  ///
+  class PendingPipelineSkippingScope {
+   public:
+    PendingPipelineSkippingScope(const ContentContext& renderer,
+                                 RenderPass& pass);
+
+    ~PendingPipelineSkippingScope();
+
+   private:
+    const ContentContext& renderer_;
+    RenderPass& pass_;
+    const bool was_allowed_;
+    const bool was_skipping_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(PendingPipelineSkippingScope);
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether complex strokes are tessellated by compute shaders
+  ///             when the device supports them. See `StrokePathGeometry`.
+  ///             Disabled by default.
+  ///
+  void SetComputeTessellationEnabled(bool enabled);
+
+  bool IsComputeTessellationEnabled() const;
+
   using SubpassCallback =
       std::function<bool(const ContentContext&, RenderPass&)>;
 
@@ -756,7 +869,8 @@ class ContentContext {
   template <class TypedPipeline>
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetPipeline(
       Variants<TypedPipeline>& container,
-      ContentContextOptions opts) const {
+      ContentContextOptions opts,
+      bool skippable = true) const {
     if (!IsValid()) {
       return nullptr;
     }
@@ -766,7 +880,7 @@ class ContentContext {
     }
 
     if (auto found = container.find(opts); found != container.end()) {
-      return found->second->WaitAndGet();
+      return WaitAndGetPipeline(*found->second, skippable);
     }
 
     auto prototype = container.find({});
@@ -774,23 +888,60 @@ class ContentContext {
     // The prototype must always be initialized in the constructor.
     FML_CHECK(prototype != container.end());
 
-    auto variant_future = prototype->second->WaitAndGet()->CreateVariant(
+    auto prototype_pipeline =
+        WaitAndGetPipeline(*prototype->second, skippable);
+    if (!prototype_pipeline) {
+      return nullptr;
+    }
+    auto variant_future = prototype_pipeline->CreateVariant(
         [&opts, variants_count = container.size()](PipelineDescriptor& desc) {
           opts.ApplyToPipelineDescriptor(desc);
           desc.SetLabel(
               SPrintF("%s V#%zu", desc.GetLabel().c_str(), variants_count));
         });
     auto variant = std::make_unique<TypedPipeline>(std::move(variant_future));
-    auto variant_pipeline = variant->WaitAndGet();
+    auto variant_pipeline = WaitAndGetPipeline(*variant, skippable);
     container[opts] = std::move(variant);
     return variant_pipeline;
   }
 
+  template <class TypedPipeline>
+  std::shared_ptr<Pipeline<PipelineDescriptor>> WaitAndGetPipeline(
+      TypedPipeline& pipeline,
+      bool skippable) const {
+    if (!pipeline.IsReady()) {
+      const bool skip = skippable && pending_pipeline_skipping_enabled_ &&
+                        pipeline_skipping_allowed_ && subpass_depth_ == 0u;
+      // Don't wait for the pipelines requested before this one, and have a
+      // skipped one ready as soon as possible.
+      if (auto desc = pipeline.GetDescriptor(); desc.has_value()) {
+        context_->GetPipelineLibrary()->PrioritizePipeline(desc.value(),
+                                                           !skip);
+      }
+      if (skip) {
+        return nullptr;
+      }
+    }
+    return pipeline.WaitAndGet();
+  }
+
   bool is_valid_ = false;
   std::shared_ptr<Tessellator> tessellator_;
   std::shared_ptr<GlyphAtlasContext> glyph_atlas_context_;
+  std::shared_ptr<GlyphAtlasContext> sdf_glyph_atlas_context_;
+  std::shared_ptr<TextLayoutCache> text_layout_cache_;
+  std::shared_ptr<TextScaleTracker> text_scale_tracker_;
+  std::shared_ptr<RenderTargetCache> render_target_cache_;
+  std::shared_ptr<GaussianBlurKernelCache> gaussian_blur_kernel_cache_;
+  std::shared_ptr<HostBuffer> transients_buffer_;
+  size_t frame_depth_ = 0u;
   std::shared_ptr<scene::SceneContext> scene_context_;
   bool wireframe_ = false;
+  bool opaque_depth_pass_enabled_ = true;
+  bool pending_pipeline_skipping_enabled_ = false;
+  mutable bool pipeline_skipping_allowed_ = false;
+  mutable size_t subpass_depth_ = 0u;
+  bool compute_tessellation_enabled_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContentContext);
 };
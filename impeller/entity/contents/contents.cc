@@ -9,6 +9,7 @@
 #include "impeller/base/strings.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
+#include "impeller/core/texture.h"
 #include "impeller/entity/contents/anonymous_contents.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/contents/texture_contents.h"
@@ -24,17 +25,21 @@ ContentContextOptions OptionsFromPass(const RenderPass& pass) {
       pass.GetRenderTarget().GetRenderTargetPixelFormat();
   opts.has_stencil_attachment =
       pass.GetRenderTarget().GetStencilAttachment().has_value();
+  if (const auto& depth0 = pass.GetRenderTarget().GetDepthAttachment();
+      depth0.has_value() && depth0->texture) {
+    opts.depth_attachment_pixel_format =
+        depth0->texture->GetTextureDescriptor().format;
+  }
+  if (const auto& depth = pass.GetCommandDepth(); depth.has_value()) {
+    opts.depth_compare = depth->descriptor.depth_compare;
+    opts.depth_write_enabled = depth->descriptor.depth_write_enabled;
+  }
   return opts;
 }
 
 ContentContextOptions OptionsFromPassAndEntity(const RenderPass& pass,
                                                const Entity& entity) {
-  ContentContextOptions opts;
-  opts.sample_count = pass.GetRenderTarget().GetSampleCount();
-  opts.color_attachment_pixel_format =
-      pass.GetRenderTarget().GetRenderTargetPixelFormat();
-  opts.has_stencil_attachment =
-      pass.GetRenderTarget().GetStencilAttachment().has_value();
+  ContentContextOptions opts = OptionsFromPass(pass);
   opts.blend_mode = entity.GetBlendMode();
   return opts;
 }
@@ -104,6 +109,14 @@ void Contents::SetInheritedOpacity(Scalar opacity) {
                     "Contents::CanAcceptOpacity returns false.";
 }
 
+bool Contents::IsOpaque() const {
+  return false;
+}
+
+std::optional<Contents::SolidFill> Contents::AsSolidFill() const {
+  return std::nullopt;
+}
+
 bool Contents::ShouldRender(const Entity& entity,
                             const std::optional<Rect>& stencil_coverage) const {
   if (!stencil_coverage.has_value()) {
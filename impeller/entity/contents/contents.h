@@ -20,6 +20,7 @@ namespace impeller {
 class ContentContext;
 struct ContentContextOptions;
 class Entity;
+class Geometry;
 class Surface;
 class RenderPass;
 
@@ -37,6 +38,11 @@ class Contents {
     std::optional<Rect> coverage = std::nullopt;
   };
 
+  struct SolidFill {
+    Color color;
+    const Geometry* geometry = nullptr;
+  };
+
   using RenderProc = std::function<bool(const ContentContext& renderer,
                                         const Entity& entity,
                                         RenderPass& pass)>;
@@ -101,6 +107,19 @@ class Contents {
   ///        Use of this method is invalid if CanAcceptOpacity returns false.
   virtual void SetInheritedOpacity(Scalar opacity);
 
+  /// @brief Whether these contents completely cover every pixel they draw to
+  ///        when drawn with `BlendMode::kSourceOver`.
+  ///
+  ///        By default all contents return false.
+  virtual bool IsOpaque() const;
+
+  /// @brief Describe these contents as a geometry filled with a single color,
+  ///        if that is all they draw. Solid fills of the same color may be
+  ///        drawn together with a single command.
+  ///
+  ///        By default all contents return std::nullopt.
+  virtual std::optional<SolidFill> AsSolidFill() const;
+
  private:
   std::optional<Size> color_source_size_;
 
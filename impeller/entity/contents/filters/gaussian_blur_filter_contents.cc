@@ -5,6 +5,7 @@
 #include "impeller/entity/contents/filters/gaussian_blur_filter_contents.h"
 
 #include <cmath>
+#include <type_traits>
 #include <utility>
 #include <valarray>
 
@@ -81,6 +82,11 @@ void DirectionalGaussianBlurFilterContents::SetSourceOverride(
   source_override_ = std::move(source_override);
 }
 
+void DirectionalGaussianBlurFilterContents::SetMaxLevelCount(
+    size_t max_level_count) {
+  max_level_count_ = max_level_count;
+}
+
 std::optional<Entity> DirectionalGaussianBlurFilterContents::RenderFilter(
     const FilterInput::Vector& inputs,
     const ContentContext& renderer,
@@ -89,6 +95,8 @@ std::optional<Entity> DirectionalGaussianBlurFilterContents::RenderFilter(
     const Rect& coverage) const {
   using VS = GaussianBlurAlphaDecalPipeline::VertexShader;
   using FS = GaussianBlurAlphaDecalPipeline::FragmentShader;
+  static_assert(std::extent_v<decltype(FS::BlurInfo::taps)> ==
+                GaussianBlurKernel::kMaxTapCount);
 
   //----------------------------------------------------------------------------
   /// Handle inputs.
@@ -167,121 +175,17 @@ std::optional<Entity> DirectionalGaussianBlurFilterContents::RenderFilter(
   auto source_uvs = pass_uv_project(source_snapshot.value());
 
   //----------------------------------------------------------------------------
-  /// Render to texture.
+  /// Split the blur into passes.
   ///
 
-  ContentContext::SubpassCallback callback = [&](const ContentContext& renderer,
-                                                 RenderPass& pass) {
-    auto& host_buffer = pass.GetTransientsBuffer();
-
-    VertexBufferBuilder<VS::PerVertexData> vtx_builder;
-    vtx_builder.AddVertices({
-        {Point(0, 0), input_uvs[0], source_uvs[0]},
-        {Point(1, 0), input_uvs[1], source_uvs[1]},
-        {Point(1, 1), input_uvs[3], source_uvs[3]},
-        {Point(0, 0), input_uvs[0], source_uvs[0]},
-        {Point(1, 1), input_uvs[3], source_uvs[3]},
-        {Point(0, 1), input_uvs[2], source_uvs[2]},
-    });
-    auto vtx_buffer = vtx_builder.CreateVertexBuffer(host_buffer);
-
-    VS::FrameInfo frame_info;
-    frame_info.mvp = Matrix::MakeOrthographic(ISize(1, 1));
-    frame_info.texture_sampler_y_coord_scale =
-        input_snapshot->texture->GetYCoordScale();
-    frame_info.alpha_mask_sampler_y_coord_scale =
-        source_snapshot->texture->GetYCoordScale();
-
-    FS::BlurInfo frag_info;
-    auto r = Radius{transformed_blur_radius_length};
-    frag_info.blur_sigma = Sigma{r}.sigma;
-    frag_info.blur_radius = std::round(r.radius);
-
-    // The blur direction is in input UV space.
-    frag_info.blur_uv_offset =
-        pass_transform.Invert().TransformDirection(Vector2(1, 0)).Normalize() /
-        Point(input_snapshot->GetCoverage().value().size);
-
-    Command cmd;
-    cmd.label = SPrintF("Gaussian Blur Filter (Radius=%.2f)",
-                        transformed_blur_radius_length);
-    cmd.BindVertices(vtx_buffer);
-
-    auto options = OptionsFromPass(pass);
-    options.blend_mode = BlendMode::kSource;
-    auto input_descriptor = input_snapshot->sampler_descriptor;
-    auto source_descriptor = source_snapshot->sampler_descriptor;
-    switch (tile_mode_) {
-      case Entity::TileMode::kDecal:
-        if (renderer.GetDeviceCapabilities().SupportsDecalTileMode()) {
-          input_descriptor.width_address_mode = SamplerAddressMode::kDecal;
-          input_descriptor.height_address_mode = SamplerAddressMode::kDecal;
-          source_descriptor.width_address_mode = SamplerAddressMode::kDecal;
-          source_descriptor.height_address_mode = SamplerAddressMode::kDecal;
-        }
-        break;
-      case Entity::TileMode::kClamp:
-        input_descriptor.width_address_mode = SamplerAddressMode::kClampToEdge;
-        input_descriptor.height_address_mode = SamplerAddressMode::kClampToEdge;
-        source_descriptor.width_address_mode = SamplerAddressMode::kClampToEdge;
-        source_descriptor.height_address_mode =
-            SamplerAddressMode::kClampToEdge;
-        break;
-      case Entity::TileMode::kMirror:
-        input_descriptor.width_address_mode = SamplerAddressMode::kMirror;
-        input_descriptor.height_address_mode = SamplerAddressMode::kMirror;
-        source_descriptor.width_address_mode = SamplerAddressMode::kMirror;
-        source_descriptor.height_address_mode = SamplerAddressMode::kMirror;
-        break;
-      case Entity::TileMode::kRepeat:
-        input_descriptor.width_address_mode = SamplerAddressMode::kRepeat;
-        input_descriptor.height_address_mode = SamplerAddressMode::kRepeat;
-        source_descriptor.width_address_mode = SamplerAddressMode::kRepeat;
-        source_descriptor.height_address_mode = SamplerAddressMode::kRepeat;
-        break;
-    }
-    input_descriptor.mag_filter = MinMagFilter::kLinear;
-    input_descriptor.min_filter = MinMagFilter::kLinear;
-
-    bool has_alpha_mask = blur_style_ != BlurStyle::kNormal;
-    bool has_decal_specialization =
-        tile_mode_ == Entity::TileMode::kDecal &&
-        !renderer.GetDeviceCapabilities().SupportsDecalTileMode();
-
-    if (has_alpha_mask && has_decal_specialization) {
-      cmd.pipeline = renderer.GetGaussianBlurAlphaDecalPipeline(options);
-    } else if (has_alpha_mask) {
-      cmd.pipeline = renderer.GetGaussianBlurAlphaPipeline(options);
-    } else if (has_decal_specialization) {
-      cmd.pipeline = renderer.GetGaussianBlurDecalPipeline(options);
-    } else {
-      cmd.pipeline = renderer.GetGaussianBlurPipeline(options);
-    }
-
-    FS::BindTextureSampler(
-        cmd, input_snapshot->texture,
-        renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-            input_descriptor));
-    VS::BindFrameInfo(cmd, host_buffer.EmplaceUniform(frame_info));
-    FS::BindBlurInfo(cmd, host_buffer.EmplaceUniform(frag_info));
-
-    if (has_alpha_mask) {
-      FS::MaskInfo mask_info;
-      mask_info.src_factor = src_color_factor_;
-      mask_info.inner_blur_factor = inner_blur_factor_;
-      mask_info.outer_blur_factor = outer_blur_factor_;
-
-      FS::BindAlphaMaskSampler(
-          cmd, source_snapshot->texture,
-          renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-              source_descriptor));
-      FS::BindMaskInfo(cmd, host_buffer.EmplaceUniform(mask_info));
-    }
-
-    return pass.AddCommand(cmd);
-  };
+  // Large blurs are rendered at a fraction of the resolution of the pass.
+  // The input is halved along the blur direction once per level, and the
+  // kernel is applied to the last level, where its sigma is small.
+  auto levels = GaussianBlurLevels::Make(
+      Sigma{Radius{transformed_blur_radius_length}}, max_level_count_);
 
-  Vector2 scale;
+  // The resolution across the blur direction is only reduced by as much as
+  // the blur that follows in that direction allows.
   auto scale_curve = [](Scalar radius) {
     constexpr Scalar decay = 4.0;   // Larger is more gradual.
     constexpr Scalar limit = 0.95;  // The maximum percentage of the scaledown.
@@ -289,19 +193,193 @@ std::optional<Entity> DirectionalGaussianBlurFilterContents::RenderFilter(
         std::min(1.0, decay / (std::max(1.0f, radius) + decay - 1.0));
     return (curve - 1) * limit + 1;
   };
-  {
-    scale.x = scale_curve(transformed_blur_radius_length);
+  Scalar y_radius = std::abs(pass_transform.GetDirectionScale(Vector2(
+      0, source_override_ ? Radius{secondary_blur_sigma_}.radius : 1)));
+  auto pass_height = std::max<int64_t>(
+      1, pass_texture_rect.size.height * scale_curve(y_radius));
+
+  auto get_level_size = [&pass_texture_rect, pass_height](size_t level) {
+    return ISize(std::max<int64_t>(1, std::ceil(pass_texture_rect.size.width /
+                                                (1u << level))),
+                 pass_height);
+  };
 
-    Scalar y_radius = std::abs(pass_transform.GetDirectionScale(Vector2(
-        0, source_override_ ? Radius{secondary_blur_sigma_}.radius : 1)));
-    scale.y = scale_curve(y_radius);
-  }
+  //----------------------------------------------------------------------------
+  /// Render to texture.
+  ///
+
+  // Renders one pass of the blur. The first pass reads from the input
+  // snapshot, the others from the level rendered by the previous pass.
+  auto render_pass = [&](const std::shared_ptr<Texture>& level_texture,
+                         ISize size, const GaussianBlurKernel& kernel,
+                         bool is_last_pass) -> std::shared_ptr<Texture> {
+    auto callback = [&](const ContentContext& renderer, RenderPass& pass) {
+      auto& host_buffer = pass.GetTransientsBuffer();
+
+      VertexBufferBuilder<VS::PerVertexData> vtx_builder;
+      if (level_texture) {
+        vtx_builder.AddVertices({
+            {Point(0, 0), Point(0, 0), source_uvs[0]},
+            {Point(1, 0), Point(1, 0), source_uvs[1]},
+            {Point(1, 1), Point(1, 1), source_uvs[3]},
+            {Point(0, 0), Point(0, 0), source_uvs[0]},
+            {Point(1, 1), Point(1, 1), source_uvs[3]},
+            {Point(0, 1), Point(0, 1), source_uvs[2]},
+        });
+      } else {
+        vtx_builder.AddVertices({
+            {Point(0, 0), input_uvs[0], source_uvs[0]},
+            {Point(1, 0), input_uvs[1], source_uvs[1]},
+            {Point(1, 1), input_uvs[3], source_uvs[3]},
+            {Point(0, 0), input_uvs[0], source_uvs[0]},
+            {Point(1, 1), input_uvs[3], source_uvs[3]},
+            {Point(0, 1), input_uvs[2], source_uvs[2]},
+        });
+      }
+      auto vtx_buffer = vtx_builder.CreateVertexBuffer(host_buffer);
+
+      const auto& texture =
+          level_texture ? level_texture : input_snapshot->texture;
+
+      VS::FrameInfo frame_info;
+      frame_info.mvp = Matrix::MakeOrthographic(ISize(1, 1));
+      frame_info.texture_sampler_y_coord_scale = texture->GetYCoordScale();
+      frame_info.alpha_mask_sampler_y_coord_scale =
+          source_snapshot->texture->GetYCoordScale();
+
+      FS::BlurInfo frag_info;
+      if (level_texture) {
+        // The levels are rendered with the blur direction along +X.
+        frag_info.blur_uv_offset =
+            Point(1.0f / level_texture->GetSize().width, 0.0f);
+      } else {
+        // The blur direction is in input UV space.
+        auto direction =
+            pass_transform.Invert().TransformDirection(Vector2(1, 0));
+        frag_info.blur_uv_offset =
+            direction.Normalize() /
+            Point(input_snapshot->GetCoverage().value().size);
+      }
+      frag_info.tap_count = kernel.tap_count;
+      for (size_t i = 0; i < kernel.tap_count; i++) {
+        frag_info.taps[i] =
+            Vector4(kernel.taps[i].offset, kernel.taps[i].weight, 0, 0);
+      }
+
+      Command cmd;
+      cmd.label = SPrintF("Gaussian Blur Filter (Radius=%.2f, Taps=%zu)",
+                          transformed_blur_radius_length, kernel.tap_count);
+      cmd.BindVertices(vtx_buffer);
+
+      auto options = OptionsFromPass(pass);
+      options.blend_mode = BlendMode::kSource;
+      auto input_descriptor = input_snapshot->sampler_descriptor;
+      auto source_descriptor = source_snapshot->sampler_descriptor;
+      switch (tile_mode_) {
+        case Entity::TileMode::kDecal:
+          if (renderer.GetDeviceCapabilities().SupportsDecalTileMode()) {
+            input_descriptor.width_address_mode = SamplerAddressMode::kDecal;
+            input_descriptor.height_address_mode = SamplerAddressMode::kDecal;
+            source_descriptor.width_address_mode = SamplerAddressMode::kDecal;
+            source_descriptor.height_address_mode = SamplerAddressMode::kDecal;
+          }
+          break;
+        case Entity::TileMode::kClamp:
+          input_descriptor.width_address_mode =
+              SamplerAddressMode::kClampToEdge;
+          input_descriptor.height_address_mode =
+              SamplerAddressMode::kClampToEdge;
+          source_descriptor.width_address_mode =
+              SamplerAddressMode::kClampToEdge;
+          source_descriptor.height_address_mode =
+              SamplerAddressMode::kClampToEdge;
+          break;
+        case Entity::TileMode::kMirror:
+          input_descriptor.width_address_mode = SamplerAddressMode::kMirror;
+          input_descriptor.height_address_mode = SamplerAddressMode::kMirror;
+          source_descriptor.width_address_mode = SamplerAddressMode::kMirror;
+          source_descriptor.height_address_mode = SamplerAddressMode::kMirror;
+          break;
+        case Entity::TileMode::kRepeat:
+          input_descriptor.width_address_mode = SamplerAddressMode::kRepeat;
+          input_descriptor.height_address_mode = SamplerAddressMode::kRepeat;
+          source_descriptor.width_address_mode = SamplerAddressMode::kRepeat;
+          source_descriptor.height_address_mode = SamplerAddressMode::kRepeat;
+          break;
+      }
+      if (level_texture) {
+        // The levels already contain the tiled input, padded by the blur
+        // radius.
+        input_descriptor = {};
+        input_descriptor.width_address_mode = SamplerAddressMode::kClampToEdge;
+        input_descriptor.height_address_mode = SamplerAddressMode::kClampToEdge;
+      }
+      input_descriptor.mag_filter = MinMagFilter::kLinear;
+      input_descriptor.min_filter = MinMagFilter::kLinear;
+
+      bool has_alpha_mask = is_last_pass && blur_style_ != BlurStyle::kNormal;
+      bool has_decal_specialization =
+          !level_texture && tile_mode_ == Entity::TileMode::kDecal &&
+          !renderer.GetDeviceCapabilities().SupportsDecalTileMode();
+
+      if (has_alpha_mask && has_decal_specialization) {
+        cmd.pipeline = renderer.GetGaussianBlurAlphaDecalPipeline(options);
+      } else if (has_alpha_mask) {
+        cmd.pipeline = renderer.GetGaussianBlurAlphaPipeline(options);
+      } else if (has_decal_specialization) {
+        cmd.pipeline = renderer.GetGaussianBlurDecalPipeline(options);
+      } else {
+        cmd.pipeline = renderer.GetGaussianBlurPipeline(options);
+      }
+
+      FS::BindTextureSampler(
+          cmd, texture,
+          renderer.GetContext()->GetSamplerLibrary()->GetSampler(
+              input_descriptor));
+      VS::BindFrameInfo(cmd, host_buffer.EmplaceUniform(frame_info));
+      FS::BindBlurInfo(cmd, host_buffer.EmplaceUniform(frag_info));
+
+      if (has_alpha_mask) {
+        FS::MaskInfo mask_info;
+        mask_info.src_factor = src_color_factor_;
+        mask_info.inner_blur_factor = inner_blur_factor_;
+        mask_info.outer_blur_factor = outer_blur_factor_;
+
+        FS::BindAlphaMaskSampler(
+            cmd, source_snapshot->texture,
+            renderer.GetContext()->GetSamplerLibrary()->GetSampler(
+                source_descriptor));
+        FS::BindMaskInfo(cmd, host_buffer.EmplaceUniform(mask_info));
+      }
+
+      return pass.AddCommand(cmd);
+    };
+
+    return renderer.MakeSubpass(is_last_pass
+                                    ? "Directional Gaussian Blur Filter"
+                                    : "Directional Gaussian Blur Downsample",
+                                size, callback);
+  };
 
-  Vector2 scaled_size = pass_texture_rect.size * scale;
-  ISize floored_size = ISize(scaled_size.x, scaled_size.y);
+  std::shared_ptr<Texture> out_texture;
+  for (size_t level = 1; level <= levels.level_count; level++) {
+    out_texture = render_pass(out_texture, get_level_size(level),
+                              GaussianBlurKernel::MakeDownsample(), false);
+    if (!out_texture) {
+      return std::nullopt;
+    }
+  }
 
-  auto out_texture = renderer.MakeSubpass("Directional Gaussian Blur Filter",
-                                          floored_size, callback);
+  // The kernel is applied in texels of the last level.
+  auto out_size = get_level_size(levels.level_count);
+  Scalar texel_size = levels.level_count > 0
+                          ? pass_texture_rect.size.width / out_size.width
+                          : 1.0f;
+  out_texture = render_pass(
+      out_texture, out_size,
+      renderer.GetGaussianBlurKernelCache()->GetKernel(
+          Sigma{levels.level_sigma.sigma / texel_size}),
+      true);
 
   if (!out_texture) {
     return std::nullopt;
@@ -315,8 +393,8 @@ std::optional<Entity> DirectionalGaussianBlurFilterContents::RenderFilter(
       Snapshot{.texture = out_texture,
                .transform = texture_rotate.Invert() *
                             Matrix::MakeTranslation(pass_texture_rect.origin) *
-                            Matrix::MakeScale((1 / scale) *
-                                              (scaled_size / floored_size)),
+                            Matrix::MakeScale(Point(pass_texture_rect.size) /
+                                              Point(out_size)),
                .sampler_descriptor = sampler_desc,
                .opacity = input_snapshot->opacity},
       entity.GetBlendMode(), entity.GetStencilDepth());
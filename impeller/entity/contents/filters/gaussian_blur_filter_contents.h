@@ -7,6 +7,7 @@
 #include <memory>
 #include <optional>
 #include "impeller/entity/contents/filters/filter_contents.h"
+#include "impeller/entity/contents/filters/gaussian_blur_kernel.h"
 #include "impeller/entity/contents/filters/inputs/filter_input.h"
 
 namespace impeller {
@@ -29,6 +30,11 @@ class DirectionalGaussianBlurFilterContents final : public FilterContents {
 
   void SetSourceOverride(FilterInput::Ref alpha_mask);
 
+  /// @brief  Limit the number of times the input is halved before the blur
+  ///         kernel is applied. Mostly useful to compare against blurs that
+  ///         are rendered at full resolution.
+  void SetMaxLevelCount(size_t max_level_count);
+
   // |FilterContents|
   std::optional<Rect> GetFilterCoverage(
       const FilterInput::Vector& inputs,
@@ -51,6 +57,7 @@ class DirectionalGaussianBlurFilterContents final : public FilterContents {
   bool inner_blur_factor_ = true;
   bool outer_blur_factor_ = true;
   FilterInput::Ref source_override_;
+  size_t max_level_count_ = GaussianBlurLevels::kMaxLevelCount;
 
   FML_DISALLOW_COPY_AND_ASSIGN(DirectionalGaussianBlurFilterContents);
 };
@@ -0,0 +1,102 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/filters/gaussian_blur_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace impeller {
+
+GaussianBlurKernel GaussianBlurKernel::Make(Sigma sigma) {
+  const Scalar clamped_sigma = std::clamp(sigma.sigma, 0.0f, kMaxSigma);
+  const int radius =
+      static_cast<int>(std::round(Radius{Sigma{clamped_sigma}}.radius));
+
+  GaussianBlurKernel kernel;
+  if (radius <= 0) {
+    kernel.taps[0] = {.offset = 0.0f, .weight = 1.0f};
+    kernel.tap_count = 1u;
+    return kernel;
+  }
+
+  auto gaussian = [clamped_sigma](int x) {
+    return std::exp(-0.5f * x * x / (clamped_sigma * clamped_sigma));
+  };
+  Scalar integral = 0.0f;
+  for (int x = -radius; x <= radius; x++) {
+    integral += gaussian(x);
+  }
+
+  // Sampling between two texels with a linear filter blends them by the
+  // ratio of their weights.
+  for (int x = -radius; x <= radius; x += 2) {
+    const Scalar weight = gaussian(x);
+    if (x == radius) {
+      kernel.taps[kernel.tap_count++] = {.offset = static_cast<Scalar>(x),
+                                         .weight = weight / integral};
+      break;
+    }
+    const Scalar next_weight = gaussian(x + 1);
+    kernel.taps[kernel.tap_count++] = {
+        .offset = x + next_weight / (weight + next_weight),
+        .weight = (weight + next_weight) / integral};
+  }
+  return kernel;
+}
+
+GaussianBlurKernel GaussianBlurKernel::MakeDownsample() {
+  // The output texels are centered between two input texels. Each tap blends
+  // two of the four input texels by 1:3.
+  GaussianBlurKernel kernel;
+  kernel.taps[0] = {.offset = -0.75f, .weight = 0.5f};
+  kernel.taps[1] = {.offset = 0.75f, .weight = 0.5f};
+  kernel.tap_count = 2u;
+  return kernel;
+}
+
+GaussianBlurLevels GaussianBlurLevels::Make(Sigma sigma,
+                                            size_t max_level_count) {
+  GaussianBlurLevels levels;
+  max_level_count = std::min(max_level_count, kMaxLevelCount);
+  while (levels.level_count < max_level_count &&
+         sigma.sigma >= kMinLevelSigma * (2u << levels.level_count)) {
+    levels.level_count++;
+  }
+
+  // Halving texels of size t with a [1 3 3 1] filter has a variance of
+  // 0.75 t^2, so the variances of all levels add up to (4^n - 1) / 4.
+  const Scalar downsample_variance =
+      ((1u << (2u * levels.level_count)) - 1u) / 4.0f;
+  levels.level_sigma = Sigma{std::sqrt(
+      std::max(sigma.sigma * sigma.sigma - downsample_variance, 0.0f))};
+  return levels;
+}
+
+GaussianBlurKernelCache::GaussianBlurKernelCache() = default;
+
+GaussianBlurKernelCache::~GaussianBlurKernelCache() = default;
+
+const GaussianBlurKernel& GaussianBlurKernelCache::GetKernel(Sigma sigma) {
+  const auto key = static_cast<uint32_t>(std::round(
+      std::clamp(sigma.sigma, 0.0f, GaussianBlurKernel::kMaxSigma) *
+      kSigmaResolution));
+  auto found = kernels_.find(key);
+  if (found != kernels_.end()) {
+    return found->second;
+  }
+
+  if (kernels_.size() >= kMaxKernelCount) {
+    kernels_.clear();
+  }
+  return kernels_
+      .emplace(key, GaussianBlurKernel::Make(Sigma{key / kSigmaResolution}))
+      .first->second;
+}
+
+size_t GaussianBlurKernelCache::GetKernelCount() const {
+  return kernels_.size();
+}
+
+}  // namespace impeller
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/scalar.h"
+#include "impeller/geometry/sigma.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      The weights of a one dimensional Gaussian kernel, reduced to
+///             half as many taps by sampling between two texels with a
+///             linear filter.
+///
+struct GaussianBlurKernel {
+  //----------------------------------------------------------------------------
+  /// The maximum number of taps of a kernel. This must match the size of the
+  /// tap array of the blur shader.
+  ///
+  static constexpr size_t kMaxTapCount = 32u;
+
+  //----------------------------------------------------------------------------
+  /// The largest sigma a kernel is made for, in texels. Kernels of larger
+  /// sigmas do not fit into `kMaxTapCount` taps.
+  ///
+  static constexpr Scalar kMaxSigma = 17.5f;
+
+  struct Tap {
+    /// The offset from the center of the kernel, in texels.
+    Scalar offset = 0.0f;
+    /// The weight of the sample. The weights of a kernel add up to one.
+    Scalar weight = 0.0f;
+  };
+
+  std::array<Tap, kMaxTapCount> taps;
+  size_t tap_count = 0u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Make the kernel of a blur, truncated at the radius that
+  ///             corresponds to its sigma.
+  ///
+  /// @param[in]  sigma  The sigma of the blur, in texels. It is clamped to
+  ///                    `kMaxSigma`.
+  ///
+  static GaussianBlurKernel Make(Sigma sigma);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Make the kernel that halves the resolution of a texture along
+  ///             one axis, using a [1 3 3 1] binomial filter to suppress
+  ///             aliasing.
+  ///
+  static GaussianBlurKernel MakeDownsample();
+};
+
+//------------------------------------------------------------------------------
+/// @brief      How a blur is split into passes.
+///
+///             Large blurs are rendered at a fraction of the resolution of
+///             their input. The input is halved once per level along the
+///             blur axis, and the blur kernel is applied to the last level,
+///             where its sigma is small.
+///
+struct GaussianBlurLevels {
+  //----------------------------------------------------------------------------
+  /// The largest number of times the input is halved.
+  ///
+  static constexpr size_t kMaxLevelCount = 6u;
+
+  //----------------------------------------------------------------------------
+  /// Blurs are downsampled until their sigma is no smaller than this at the
+  /// last level, which keeps the result smooth when it is scaled back up
+  /// with a linear filter.
+  ///
+  static constexpr Scalar kMinLevelSigma = 2.0f;
+
+  /// The number of times the input is halved before it is blurred.
+  size_t level_count = 0u;
+  /// The sigma that is left to apply at the last level, in pixels of the
+  /// input. Each of the downsampling passes blurs the input a little, which
+  /// is accounted for.
+  Sigma level_sigma;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Split a blur into passes.
+  ///
+  /// @param[in]  sigma            The sigma of the blur, in pixels.
+  /// @param[in]  max_level_count  The largest number of times the input may
+  ///                              be halved.
+  ///
+  static GaussianBlurLevels Make(Sigma sigma,
+                                 size_t max_level_count = kMaxLevelCount);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A cache of Gaussian blur kernels, keyed by their sigma rounded
+///             to a small fraction of a texel.
+///
+///             This class is not thread safe.
+///
+class GaussianBlurKernelCache {
+ public:
+  //----------------------------------------------------------------------------
+  /// Sigmas are rounded to multiples of the inverse of this, in texels.
+  ///
+  static constexpr Scalar kSigmaResolution = 64.0f;
+
+  //----------------------------------------------------------------------------
+  /// The maximum number of kernels kept. Once reached, all of them are
+  /// dropped.
+  ///
+  static constexpr size_t kMaxKernelCount = 512u;
+
+  GaussianBlurKernelCache();
+
+  ~GaussianBlurKernelCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the kernel of a blur, making it if it is not cached yet.
+  ///
+  ///             Like `GaussianBlurKernel::Make`, sigmas are clamped to
+  ///             `GaussianBlurKernel::kMaxSigma`. All larger sigmas get the
+  ///             kernel of `kMaxSigma`, so there are no more than
+  ///             `kMaxSigma * kSigmaResolution + 1` distinct kernels.
+  ///
+  /// @param[in]  sigma  The sigma of the blur, in texels.
+  ///
+  /// @return     The kernel, which is valid until the next call.
+  ///
+  const GaussianBlurKernel& GetKernel(Sigma sigma);
+
+  size_t GetKernelCount() const;
+
+ private:
+  std::unordered_map<uint32_t, GaussianBlurKernel> kernels_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(GaussianBlurKernelCache);
+};
+
+}  // namespace impeller
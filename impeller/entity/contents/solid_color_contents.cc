@@ -38,6 +38,19 @@ void SolidColorContents::SetInheritedOpacity(Scalar opacity) {
   inherited_opacity_ = opacity;
 }
 
+// |Contents|
+bool SolidColorContents::IsOpaque() const {
+  return GetColor().IsOpaque();
+}
+
+// |Contents|
+std::optional<Contents::SolidFill> SolidColorContents::AsSolidFill() const {
+  if (!geometry_) {
+    return std::nullopt;
+  }
+  return SolidFill{.color = GetColor(), .geometry = geometry_.get()};
+}
+
 std::optional<Rect> SolidColorContents::GetCoverage(
     const Entity& entity) const {
   if (GetColor().IsTransparent()) {
@@ -41,6 +41,12 @@ class SolidColorContents final : public Contents {
   // | Contents|
   void SetInheritedOpacity(Scalar opacity) override;
 
+  // |Contents|
+  bool IsOpaque() const override;
+
+  // |Contents|
+  std::optional<SolidFill> AsSolidFill() const override;
+
   // |Contents|
   std::optional<Rect> GetCoverage(const Entity& entity) const override;
 
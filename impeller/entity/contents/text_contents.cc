@@ -7,6 +7,7 @@
 #include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "impeller/core/formats.h"
 #include "impeller/core/sampler_descriptor.h"
@@ -18,6 +19,7 @@
 #include "impeller/tessellator/tessellator.h"
 #include "impeller/typographer/glyph_atlas.h"
 #include "impeller/typographer/lazy_glyph_atlas.h"
+#include "impeller/typographer/text_layout_cache.h"
 
 namespace impeller {
 
@@ -78,129 +80,92 @@ std::optional<Rect> TextContents::GetCoverage(const Entity& entity) const {
   return bounds->TransformBounds(entity.GetTransformation());
 }
 
+// Builds the glyph quads of a frame, with separate vertices for every page
+// of the atlas that holds glyphs of the frame.
+//
+// If a pixel basis is given, the quads are transformed by it and snapped to
+// the pixel grid, relative to the position of the frame on the screen.
+// Otherwise the quads are in the coordinate space of the frame.
 template <class TPipeline>
-static bool CommonRender(
-    const ContentContext& renderer,
-    const Entity& entity,
-    RenderPass& pass,
-    const Color& color,
+static std::optional<TextLayoutCache::Layout> BuildGlyphLayout(
     const TextFrame& frame,
-    Vector2 offset,
-    std::shared_ptr<GlyphAtlas>
-        atlas,  // NOLINT(performance-unnecessary-value-param)
-    Command& cmd) {
+    const GlyphAtlas& atlas,
+    const std::optional<Matrix>& pixel_basis) {
   using VS = typename TPipeline::VertexShader;
-  using FS = typename TPipeline::FragmentShader;
-
-  // Common vertex uniforms for all glyphs.
-  typename VS::FrameInfo frame_info;
-
-  frame_info.mvp = Matrix::MakeOrthographic(pass.GetRenderTargetSize());
-  VS::BindFrameInfo(cmd, pass.GetTransientsBuffer().EmplaceUniform(frame_info));
-
-  SamplerDescriptor sampler_desc;
-  if (entity.GetTransformation().IsTranslationScaleOnly()) {
-    sampler_desc.min_filter = MinMagFilter::kNearest;
-    sampler_desc.mag_filter = MinMagFilter::kNearest;
-  } else {
-    // Currently, we only propagate the scale of the transform to the atlas
-    // renderer, so if the transform has more than just a translation, we turn
-    // on linear sampling to prevent crunchiness caused by the pixel grid not
-    // being perfectly aligned.
-    // The downside is that this slightly over-blurs rotated/skewed text.
-    sampler_desc.min_filter = MinMagFilter::kLinear;
-    sampler_desc.mag_filter = MinMagFilter::kLinear;
-  }
-  sampler_desc.mip_filter = MipFilter::kNearest;
+  using VertexData = typename VS::PerVertexData;
 
-  typename FS::FragInfo frag_info;
-  frag_info.text_color = ToVector(color.Premultiply());
-  FS::BindFragInfo(cmd, pass.GetTransientsBuffer().EmplaceUniform(frag_info));
-
-  // Common fragment uniforms for all glyphs.
-  FS::BindGlyphAtlasSampler(
-      cmd,                  // command
-      atlas->GetTexture(),  // texture
-      renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-          sampler_desc)  // sampler
-  );
-
-  // Common vertex information for all glyphs.
   // All glyphs are given the same vertex information in the form of a
-  // unit-sized quad. The size of the glyph is specified in per instance data
-  // and the vertex shader uses this to size the glyph correctly. The
+  // unit-sized quad, which is scaled to the size of the glyph. The
   // interpolated vertex information is also used in the fragment shader to
   // sample from the glyph atlas.
-
   constexpr std::array<Point, 4> unit_points = {Point{0, 0}, Point{1, 0},
                                                 Point{0, 1}, Point{1, 1}};
   constexpr std::array<uint32_t, 6> indices = {0, 1, 2, 1, 2, 3};
 
-  VertexBufferBuilder<typename VS::PerVertexData> vertex_builder;
+  const size_t page_count = atlas.GetPageCount();
+  std::vector<std::vector<VertexData>> page_vertices(page_count);
+  std::vector<std::vector<uint32_t>> page_indices(page_count);
+  std::vector<Point> atlas_sizes(page_count);
+  for (size_t page = 0; page < page_count; page++) {
+    const auto& texture = atlas.GetTexture(page);
+    atlas_sizes[page] = Point{static_cast<Scalar>(texture->GetSize().width),
+                              static_cast<Scalar>(texture->GetSize().height)};
+  }
 
-  size_t count = 0;
+  size_t glyph_count = 0;
   for (const auto& run : frame.GetRuns()) {
-    count += run.GetGlyphPositions().size();
+    glyph_count += run.GetGlyphPositions().size();
   }
-
-  vertex_builder.Reserve(count * 4);
-  vertex_builder.ReserveIndices(count * 6);
-
-  uint32_t index_offset = 0u;
-  for (auto i = 0u; i < count; i++) {
-    for (const auto& index : indices) {
-      vertex_builder.AppendIndex(index + index_offset);
-    }
-    index_offset += 4;
+  if (page_count == 1u) {
+    page_vertices[0].reserve(glyph_count * 4);
+    page_indices[0].reserve(glyph_count * 6);
   }
 
-  auto atlas_size =
-      Point{static_cast<Scalar>(atlas->GetTexture()->GetSize().width),
-            static_cast<Scalar>(atlas->GetTexture()->GetSize().height)};
-
-  Vector2 screen_offset = (entity.GetTransformation() * offset).Round();
-
   for (const auto& run : frame.GetRuns()) {
-    auto font = run.GetFont();
+    auto font = GlyphAtlas::GetAtlasFont(atlas.GetType(), run.GetFont());
 
     for (const auto& glyph_position : run.GetGlyphPositions()) {
       FontGlyphPair font_glyph_pair{font, glyph_position.glyph};
-      auto atlas_glyph_bounds = atlas->FindFontGlyphBounds(font_glyph_pair);
-      if (!atlas_glyph_bounds.has_value()) {
+      auto atlas_glyph_location = atlas.FindFontGlyphLocation(font_glyph_pair);
+      if (!atlas_glyph_location.has_value() ||
+          atlas_glyph_location->page >= page_count) {
         VALIDATION_LOG << "Could not find glyph position in the atlas.";
-        return false;
+        return std::nullopt;
       }
+      const auto& atlas_glyph_bounds = atlas_glyph_location->bounds;
+      const auto& atlas_size = atlas_sizes[atlas_glyph_location->page];
+      auto& vertices = page_vertices[atlas_glyph_location->page];
 
       // For each glyph, we compute two rectangles. One for the vertex positions
       // and one for the texture coordinates (UVs).
 
       auto uv_origin =
-          (atlas_glyph_bounds->origin - Point(0.5, 0.5)) / atlas_size;
-      auto uv_size = (atlas_glyph_bounds->size + Size(1, 1)) / atlas_size;
+          (atlas_glyph_bounds.origin - Point(0.5, 0.5)) / atlas_size;
+      auto uv_size = (atlas_glyph_bounds.size + Size(1, 1)) / atlas_size;
 
-      // Rounding here prevents most jitter between glyphs in the run when
-      // nearest sampling.
-      auto screen_glyph_position =
-          screen_offset +
-          (entity.GetTransformation().Basis() *
-           (glyph_position.position + glyph_position.glyph.bounds.origin))
-              .Round();
+      const auto index_offset = static_cast<uint32_t>(vertices.size());
+      for (const auto& index : indices) {
+        page_indices[atlas_glyph_location->page].push_back(index +
+                                                           index_offset);
+      }
 
+      const auto glyph_origin =
+          glyph_position.position + glyph_position.glyph.bounds.origin;
       for (const auto& point : unit_points) {
-        typename VS::PerVertexData vtx;
+        VertexData vtx;
 
-        if (entity.GetTransformation().IsTranslationScaleOnly()) {
-          // Rouding up here prevents the bounds from becoming 1 pixel too small
-          // when nearest sampling. This path breaks down for projections.
+        if (pixel_basis.has_value()) {
+          // Rounding here prevents most jitter between glyphs in the run when
+          // nearest sampling. Rounding up the size prevents the bounds from
+          // becoming 1 pixel too small. This path breaks down for
+          // projections.
           vtx.position =
-              screen_glyph_position + (entity.GetTransformation().Basis() *
-                                       point * glyph_position.glyph.bounds.size)
-                                          .Ceil();
+              (pixel_basis.value() * glyph_origin).Round() +
+              (pixel_basis.value() * point * glyph_position.glyph.bounds.size)
+                  .Ceil();
         } else {
-          vtx.position = entity.GetTransformation() *
-                         Vector4(offset + glyph_position.position +
-                                 glyph_position.glyph.bounds.origin +
-                                 point * glyph_position.glyph.bounds.size);
+          vtx.position =
+              Vector4(glyph_origin + point * glyph_position.glyph.bounds.size);
         }
         vtx.uv = uv_origin + point * uv_size;
 
@@ -209,27 +174,169 @@ static bool CommonRender(
               glyph_position.glyph.type == Glyph::Type::kBitmap ? 1.0 : 0.0;
         }
 
-        vertex_builder.AppendVertex(std::move(vtx));
+        vertices.push_back(std::move(vtx));
       }
     }
   }
-  auto vertex_buffer =
-      vertex_builder.CreateVertexBuffer(pass.GetTransientsBuffer());
-  cmd.BindVertices(std::move(vertex_buffer));
 
-  if (!pass.AddCommand(cmd)) {
+  TextLayoutCache::Layout layout;
+  layout.glyph_count = glyph_count;
+  for (size_t page = 0; page < page_count; page++) {
+    const auto& vertices = page_vertices[page];
+    if (vertices.empty()) {
+      continue;
+    }
+    const auto* vertex_data = reinterpret_cast<const uint8_t*>(vertices.data());
+    layout.pages.push_back({
+        .page = page,
+        .vertices = std::vector<uint8_t>(
+            vertex_data, vertex_data + vertices.size() * sizeof(VertexData)),
+        .vertex_alignment = alignof(VertexData),
+        .indices = std::move(page_indices[page]),
+    });
+  }
+  return layout;
+}
+
+// The scale the glyphs of a frame were rasterized at in an atlas of the
+// given type.
+static Scalar GetGlyphScale(const TextFrame& frame, GlyphAtlas::Type type) {
+  const auto& runs = frame.GetRuns();
+  return runs.empty() ? 1.0f
+                      : GlyphAtlas::GetAtlasFont(type, runs.front().GetFont())
+                            .GetMetrics()
+                            .scale;
+}
+
+// The edges of signed distance field glyphs are tuned by the luminance of the
+// text. Dark text on a light background looks thinner than light text on a
+// dark background with the same coverage, so dark text is emboldened and
+// light text is thinned.
+static constexpr Scalar kSdfEdgeContrast = 1.25f;
+static constexpr Scalar kSdfDarkTextGamma = 0.8f;
+static constexpr Scalar kSdfLightTextGamma = 1.2f;
+
+static Scalar GetSdfEdgeGamma(const Color& color) {
+  const auto luminance =
+      0.2126f * color.red + 0.7152f * color.green + 0.0722f * color.blue;
+  return kSdfDarkTextGamma +
+         (kSdfLightTextGamma - kSdfDarkTextGamma) * luminance;
+}
+
+template <class TPipeline>
+static bool CommonRender(
+    const ContentContext& renderer,
+    const Entity& entity,
+    RenderPass& pass,
+    const Color& color,
+    const TextFrame& frame,
+    Vector2 offset,
+    std::shared_ptr<GlyphAtlas>
+        atlas,  // NOLINT(performance-unnecessary-value-param)
+    Command& cmd) {
+  using VS = typename TPipeline::VertexShader;
+  using FS = typename TPipeline::FragmentShader;
+
+  const auto& transform = entity.GetTransformation();
+  // Signed distance fields are resampled at any scale, so their glyphs are
+  // neither snapped to the pixel grid nor sampled with the nearest filter.
+  const bool is_sdf =
+      atlas->GetType() == GlyphAtlas::Type::kSignedDistanceField;
+  const bool snap_to_pixels = !is_sdf && transform.IsTranslationScaleOnly();
+
+  // The glyph quads of the frame do not depend on where the frame is drawn,
+  // which is applied through the MVP instead. This allows them to be reused
+  // from the text layout cache while the frame moves, e.g. while scrolling.
+  TextLayoutCache::Key key;
+  key.frame_identity = frame.GetIdentity();
+  key.type = atlas->GetType();
+  key.glyph_scale = GetGlyphScale(frame, atlas->GetType());
+
+  // Common vertex uniforms for all glyphs.
+  typename VS::FrameInfo frame_info;
+  frame_info.mvp = Matrix::MakeOrthographic(pass.GetRenderTargetSize());
+  std::optional<Matrix> pixel_basis;
+  if (snap_to_pixels) {
+    pixel_basis = transform.Basis();
+    key.pixel_scale = Vector2(transform.m[0], transform.m[5]);
+    Vector2 screen_offset = (transform * offset).Round();
+    frame_info.mvp = frame_info.mvp * Matrix::MakeTranslation(screen_offset);
+  } else {
+    frame_info.mvp =
+        frame_info.mvp * transform * Matrix::MakeTranslation(offset);
+  }
+  VS::BindFrameInfo(cmd, pass.GetTransientsBuffer().EmplaceUniform(frame_info));
+
+  SamplerDescriptor sampler_desc;
+  if (snap_to_pixels) {
+    sampler_desc.min_filter = MinMagFilter::kNearest;
+    sampler_desc.mag_filter = MinMagFilter::kNearest;
+  } else {
+    // Currently, we only propagate the scale of the transform to the atlas
+    // renderer, so if the transform has more than just a translation, we turn
+    // on linear sampling to prevent crunchiness caused by the pixel grid not
+    // being perfectly aligned.
+    // The downside is that this slightly over-blurs rotated/skewed text.
+    sampler_desc.min_filter = MinMagFilter::kLinear;
+    sampler_desc.mag_filter = MinMagFilter::kLinear;
+  }
+  sampler_desc.mip_filter = MipFilter::kNearest;
+
+  typename FS::FragInfo frag_info;
+  frag_info.text_color = ToVector(color.Premultiply());
+  if constexpr (std::is_same_v<TPipeline, GlyphAtlasSdfPipeline>) {
+    frag_info.edge_contrast = kSdfEdgeContrast;
+    frag_info.edge_gamma = GetSdfEdgeGamma(color);
+  }
+  FS::BindFragInfo(cmd, pass.GetTransientsBuffer().EmplaceUniform(frag_info));
+
+  auto sampler =
+      renderer.GetContext()->GetSamplerLibrary()->GetSampler(sampler_desc);
+
+  auto layout = renderer.GetTextLayoutCache()->GetOrBuildLayout(
+      key, *atlas, [&frame, &atlas, &pixel_basis]() {
+        return BuildGlyphLayout<TPipeline>(frame, *atlas, pixel_basis);
+      });
+  if (!layout) {
     return false;
   }
 
+  // The glyphs may be spread over several pages of the atlas. The glyphs of
+  // each page are drawn by a separate command that samples from the texture
+  // of that page.
+  auto& host_buffer = pass.GetTransientsBuffer();
+  for (const auto& page : layout->pages) {
+    Command page_cmd = cmd;
+    // Common fragment uniforms for all glyphs of the page.
+    FS::BindGlyphAtlasSampler(page_cmd,                      // command
+                              atlas->GetTexture(page.page),  // texture
+                              sampler                        // sampler
+    );
+    VertexBuffer vertex_buffer;
+    vertex_buffer.vertex_buffer =
+        host_buffer.Emplace(page.vertices.data(), page.vertices.size(),
+                            page.vertex_alignment);
+    vertex_buffer.index_buffer = host_buffer.Emplace(
+        page.indices.data(), page.indices.size() * sizeof(uint32_t),
+        alignof(uint32_t));
+    vertex_buffer.index_count = page.indices.size();
+    vertex_buffer.index_type = IndexType::k32bit;
+    page_cmd.BindVertices(vertex_buffer);
+    if (!pass.AddCommand(std::move(page_cmd))) {
+      return false;
+    }
+  }
+
   return true;
 }
 
 bool TextContents::RenderSdf(const ContentContext& renderer,
                              const Entity& entity,
                              RenderPass& pass) const {
-  auto atlas =
-      ResolveAtlas(GlyphAtlas::Type::kSignedDistanceField,
-                   renderer.GetGlyphAtlasContext(), renderer.GetContext());
+  auto atlas = ResolveAtlas(
+      GlyphAtlas::Type::kSignedDistanceField,
+      renderer.GetGlyphAtlasContext(GlyphAtlas::Type::kSignedDistanceField),
+      renderer.GetContext());
 
   if (!atlas || !atlas->IsValid()) {
     VALIDATION_LOG << "Cannot render glyphs without prepared atlas.";
@@ -256,16 +363,27 @@ bool TextContents::Render(const ContentContext& renderer,
     return true;
   }
 
+  // Text whose scale keeps changing, e.g. during a zoom, would need its
+  // glyphs rasterized again at every frame. Draw it from signed distance
+  // fields instead, which serve all scales, until the scale settles. The
+  // lazy atlas decides this once per scene, so that the glyphs of such text
+  // are not collected into the bitmap atlases either.
+  FML_DCHECK(lazy_atlas_);
+  lazy_atlas_->SortTextFrames(*renderer.GetTextScaleTracker());
+  if (lazy_atlas_->IsSignedDistanceField(frame_)) {
+    return RenderSdf(renderer, entity, pass);
+  }
+
   // This TextContents may be for a frame that doesn't have color, but the
   // lazy atlas for this scene already does have color.
   // Benchmarks currently show that creating two atlases per pass regresses
   // render time. This should get re-evaluated if we start caching atlases
   // between frames or get significantly faster at creating atlases, because
   // we're potentially trading memory for time here.
-  auto atlas =
-      ResolveAtlas(lazy_atlas_->HasColor() ? GlyphAtlas::Type::kColorBitmap
-                                           : GlyphAtlas::Type::kAlphaBitmap,
-                   renderer.GetGlyphAtlasContext(), renderer.GetContext());
+  auto type = lazy_atlas_->HasColor() ? GlyphAtlas::Type::kColorBitmap
+                                      : GlyphAtlas::Type::kAlphaBitmap;
+  auto atlas = ResolveAtlas(type, renderer.GetGlyphAtlasContext(type),
+                            renderer.GetContext());
 
   if (!atlas || !atlas->IsValid()) {
     VALIDATION_LOG << "Cannot render glyphs without prepared atlas.";
@@ -50,7 +50,13 @@ class TextContents final : public Contents {
               const Entity& entity,
               RenderPass& pass) const override;
 
-  // TODO(dnfield): remove this https://github.com/flutter/flutter/issues/111640
+  //----------------------------------------------------------------------------
+  /// @brief      Render the text from a signed distance field atlas, which
+  ///             serves all scales of the text with the same glyphs.
+  ///
+  ///             `Render` picks this automatically for text that is under a
+  ///             scale animation.
+  ///
   bool RenderSdf(const ContentContext& renderer,
                  const Entity& entity,
                  RenderPass& pass) const;
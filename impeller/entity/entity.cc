@@ -125,6 +125,15 @@ bool Entity::IsBlendModeDestructive(BlendMode blend_mode) {
   }
 }
 
+bool Entity::IsOpaque() const {
+  if (!contents_) {
+    return false;
+  }
+  return (blend_mode_ == BlendMode::kSourceOver ||
+          blend_mode_ == BlendMode::kSource) &&
+         contents_->IsOpaque();
+}
+
 bool Entity::Render(const ContentContext& renderer,
                     RenderPass& parent_pass) const {
   if (!contents_) {
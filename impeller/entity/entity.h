@@ -84,6 +84,12 @@ class Entity {
 
   BlendMode GetBlendMode() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Whether nothing drawn before this entity shows through the
+  ///             pixels it draws to.
+  ///
+  bool IsOpaque() const;
+
   bool Render(const ContentContext& renderer, RenderPass& parent_pass) const;
 
   static bool IsBlendModeDestructive(BlendMode blend_mode);
@@ -0,0 +1,522 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "impeller/base/comparable.h"
+#include "impeller/base/promise.h"
+#include "impeller/core/allocator.h"
+#include "impeller/core/device_buffer.h"
+#include "impeller/core/host_buffer.h"
+#include "impeller/core/texture.h"
+#include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/contents/filters/gaussian_blur_kernel.h"
+#include "impeller/entity/contents/solid_color_contents.h"
+#include "impeller/entity/entity.h"
+#include "impeller/entity/geometry.h"
+#include "impeller/entity/render_target_cache.h"
+#include "impeller/entity/solid_fill_batcher.h"
+#include "impeller/renderer/capabilities.h"
+#include "impeller/renderer/context.h"
+#include "impeller/renderer/pipeline.h"
+#include "impeller/renderer/pipeline_library.h"
+#include "impeller/renderer/render_pass.h"
+#include "impeller/renderer/render_target.h"
+#include "impeller/renderer/shader_function.h"
+#include "impeller/renderer/shader_library.h"
+
+namespace impeller {
+
+namespace {
+
+// A texture that drops its contents. Nothing is ever drawn into it or sampled
+// from it here, so only the cost of allocating it is measured.
+class HostTexture final : public Texture {
+ public:
+  explicit HostTexture(const TextureDescriptor& desc) : Texture(desc) {}
+
+  // |Texture|
+  void SetLabel(std::string_view label) override {}
+
+  // |Texture|
+  bool IsValid() const override { return true; }
+
+  // |Texture|
+  ISize GetSize() const override { return GetTextureDescriptor().size; }
+
+ private:
+  // |Texture|
+  bool OnSetContents(const uint8_t* contents,
+                     size_t length,
+                     size_t slice) override {
+    return true;
+  }
+
+  // |Texture|
+  bool OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
+                     size_t slice) override {
+    return true;
+  }
+};
+
+// A device buffer in host memory, which is what host visible device buffers
+// amount to on unified memory.
+class HostDeviceBuffer final : public DeviceBuffer {
+ public:
+  explicit HostDeviceBuffer(const DeviceBufferDescriptor& desc)
+      : DeviceBuffer(desc), storage_(desc.size) {}
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label) override { return true; }
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+
+  // |DeviceBuffer|
+  uint8_t* OnGetContents() const override {
+    return const_cast<uint8_t*>(storage_.data());
+  }
+
+ private:
+  std::vector<uint8_t> storage_;
+
+  // |DeviceBuffer|
+  bool OnCopyHostBuffer(const uint8_t* source,
+                        Range source_range,
+                        size_t offset) override {
+    std::memmove(storage_.data() + offset, source + source_range.offset,
+                 source_range.length);
+    return true;
+  }
+};
+
+// An allocator that counts the buffers and textures it allocates.
+class HostAllocator final : public Allocator {
+ public:
+  // |Allocator|
+  ISize GetMaxTextureSizeSupported() const override { return {8192, 8192}; }
+
+  size_t GetBufferCount() const { return buffer_count_; }
+
+  size_t GetTextureCount() const { return texture_count_; }
+
+ private:
+  size_t buffer_count_ = 0u;
+  size_t texture_count_ = 0u;
+
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> OnCreateBuffer(
+      const DeviceBufferDescriptor& desc) override {
+    buffer_count_++;
+    return std::make_shared<HostDeviceBuffer>(desc);
+  }
+
+  // |Allocator|
+  std::shared_ptr<Texture> OnCreateTexture(
+      const TextureDescriptor& desc) override {
+    texture_count_++;
+    return std::make_shared<HostTexture>(desc);
+  }
+};
+
+class HostShaderFunction final : public ShaderFunction {
+ public:
+  HostShaderFunction(UniqueID library_id, std::string name, ShaderStage stage)
+      : ShaderFunction(library_id, std::move(name), stage) {}
+};
+
+// A shader library that has every function asked for.
+class HostShaderLibrary final : public ShaderLibrary {
+ public:
+  // |ShaderLibrary|
+  bool IsValid() const override { return true; }
+
+  // |ShaderLibrary|
+  std::shared_ptr<const ShaderFunction> GetFunction(
+      std::string_view name,
+      ShaderStage stage) override {
+    return std::make_shared<HostShaderFunction>(library_id_, std::string(name),
+                                                stage);
+  }
+
+  // |ShaderLibrary|
+  void UnregisterFunction(std::string name, ShaderStage stage) override {}
+
+ private:
+  UniqueID library_id_;
+};
+
+class HostPipeline final : public Pipeline<PipelineDescriptor> {
+ public:
+  HostPipeline(std::weak_ptr<PipelineLibrary> library, PipelineDescriptor desc)
+      : Pipeline(std::move(library), std::move(desc)) {}
+
+  // |Pipeline|
+  bool IsValid() const override { return true; }
+};
+
+// A pipeline library whose render pipelines are ready right away.
+class HostPipelineLibrary final : public PipelineLibrary {
+ public:
+  // |PipelineLibrary|
+  bool IsValid() const override { return true; }
+
+  // |PipelineLibrary|
+  PipelineFuture<PipelineDescriptor> GetPipeline(
+      PipelineDescriptor descriptor) override {
+    return {descriptor,
+            RealizedFuture<std::shared_ptr<Pipeline<PipelineDescriptor>>>(
+                std::make_shared<HostPipeline>(weak_from_this(), descriptor))};
+  }
+
+  // |PipelineLibrary|
+  PipelineFuture<ComputePipelineDescriptor> GetPipeline(
+      ComputePipelineDescriptor descriptor) override {
+    return {descriptor,
+            RealizedFuture<
+                std::shared_ptr<Pipeline<ComputePipelineDescriptor>>>(
+                nullptr)};
+  }
+
+  // |PipelineLibrary|
+  void RemovePipelinesWithEntryPoint(
+      std::shared_ptr<const ShaderFunction> function) override {}
+};
+
+// A render pass that only records commands.
+class HostRenderPass final : public RenderPass {
+ public:
+  HostRenderPass(std::weak_ptr<const Context> context,
+                 const RenderTarget& target)
+      : RenderPass(std::move(context), target) {}
+
+  // |RenderPass|
+  bool IsValid() const override { return true; }
+
+ private:
+  // |RenderPass|
+  void OnSetLabel(std::string label) override {}
+
+  // |RenderPass|
+  bool OnEncodeCommands(const Context& context) const override { return true; }
+};
+
+// A context that allocates in host memory and builds pipelines that are never
+// executed, which is all that is needed to create render targets and record
+// commands.
+class HostContext final : public Context {
+ public:
+  HostContext()
+      : capabilities_(CapabilitiesBuilder()
+                          .SetSupportsOffscreenMSAA(true)
+                          .SetDefaultColorFormat(PixelFormat::kR8G8B8A8UNormInt)
+                          .SetDefaultStencilFormat(PixelFormat::kS8UInt)
+                          .Build()) {}
+
+  // |Context|
+  bool IsValid() const override { return true; }
+
+  // |Context|
+  const std::shared_ptr<const Capabilities>& GetCapabilities() const override {
+    return capabilities_;
+  }
+
+  // |Context|
+  std::shared_ptr<Allocator> GetResourceAllocator() const override {
+    return allocator_;
+  }
+
+  // |Context|
+  std::shared_ptr<ShaderLibrary> GetShaderLibrary() const override {
+    return shader_library_;
+  }
+
+  // |Context|
+  std::shared_ptr<SamplerLibrary> GetSamplerLibrary() const override {
+    return nullptr;
+  }
+
+  // |Context|
+  std::shared_ptr<PipelineLibrary> GetPipelineLibrary() const override {
+    return pipeline_library_;
+  }
+
+  // |Context|
+  std::shared_ptr<CommandBuffer> CreateCommandBuffer() const override {
+    return nullptr;
+  }
+
+  size_t GetTextureCount() const { return allocator_->GetTextureCount(); }
+
+ private:
+  std::shared_ptr<const Capabilities> capabilities_;
+  std::shared_ptr<HostAllocator> allocator_ = std::make_shared<HostAllocator>();
+  std::shared_ptr<HostShaderLibrary> shader_library_ =
+      std::make_shared<HostShaderLibrary>();
+  std::shared_ptr<HostPipelineLibrary> pipeline_library_ =
+      std::make_shared<HostPipelineLibrary>();
+};
+
+constexpr ISize kFrameSize = {1080, 1920};
+
+// A scrolling list of cards. Each card is a rounded rectangle with an avatar
+// and two lines of text drawn as bars on top of it.
+std::vector<Entity> MakeCardList(size_t card_count) {
+  std::vector<Entity> entities;
+  auto add = [&entities](std::unique_ptr<Geometry> geometry, Color color) {
+    auto contents = std::make_shared<SolidColorContents>();
+    contents->SetGeometry(std::move(geometry));
+    contents->SetColor(color);
+    Entity entity;
+    entity.SetContents(std::move(contents));
+    entities.push_back(std::move(entity));
+  };
+  for (size_t i = 0u; i < card_count; i++) {
+    const Scalar top = 16.0f + static_cast<Scalar>(i) * 120.0f;
+    add(Geometry::MakeRRect(Rect::MakeXYWH(16, top, 1048, 104), 12),
+        Color::White());
+    add(Geometry::MakeRect(Rect::MakeXYWH(32, top + 16, 72, 72)),
+        Color::CornflowerBlue());
+    add(Geometry::MakeRect(Rect::MakeXYWH(120, top + 24, 600, 20)),
+        Color::DarkGray());
+    add(Geometry::MakeRect(Rect::MakeXYWH(120, top + 60, 400, 16)),
+        Color::DarkGray());
+  }
+  return entities;
+}
+
+}  // namespace
+
+// Measures the time to create the render targets of a frame with as many
+// nested saveLayers as the benchmark argument, the way entity passes create
+// them for their subpasses. Each saveLayer is a little smaller than its
+// parent, and the frame is drawn again and again.
+static void BM_NestedSaveLayerRenderTargets(benchmark::State& state,
+                                            bool use_cache) {
+  auto context = std::make_shared<HostContext>();
+  RenderTargetCache cache(context->GetResourceAllocator());
+  RenderTargetAllocator uncached(context->GetResourceAllocator());
+  RenderTargetAllocator& allocator = use_cache ? cache : uncached;
+  const auto layer_count = state.range(0);
+
+  size_t frame_count = 0u;
+  while (state.KeepRunning()) {
+    allocator.Start();
+    // The render targets of the parents are alive while their children are
+    // drawn, as they are in entity passes.
+    std::vector<RenderTarget> targets;
+    targets.reserve(layer_count);
+    for (int64_t layer = 0; layer < layer_count; layer++) {
+      const ISize size(kFrameSize.width - layer * 8,
+                       kFrameSize.height - layer * 8);
+      targets.push_back(RenderTarget::CreateOffscreenMSAA(
+          *context, allocator, size, "EntityPass",
+          RenderTarget::AttachmentConfigMSAA{
+              .storage_mode = StorageMode::kDeviceTransient,
+              .resolve_storage_mode = StorageMode::kDevicePrivate,
+              .load_action = LoadAction::kDontCare,
+              .store_action = StoreAction::kMultisampleResolve},
+          RenderTarget::AttachmentConfig{
+              .storage_mode = StorageMode::kDeviceTransient,
+              .load_action = LoadAction::kDontCare,
+              .store_action = StoreAction::kDontCare}));
+    }
+    targets.clear();
+    allocator.End();
+    frame_count++;
+  }
+
+  state.counters["TextureAllocationsPerFrame"] =
+      frame_count == 0u ? 0.0
+                        : static_cast<double>(context->GetTextureCount()) /
+                              static_cast<double>(frame_count);
+  state.counters["CachedTextures"] = cache.GetCachedTextureCount();
+}
+
+BENCHMARK_CAPTURE(BM_NestedSaveLayerRenderTargets, Cached, true)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_NestedSaveLayerRenderTargets, Uncached, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+// Measures the time to emplace the transient data of a frame with as many
+// render passes as the benchmark argument and to hand it to the device the
+// way the backends do when the passes are encoded. Either every render pass
+// has a host buffer of its own, or all of them share a ring.
+static void BM_TransientsBuffer(benchmark::State& state, bool use_ring) {
+  auto allocator = std::make_shared<HostAllocator>();
+  auto ring = HostBuffer::Create(allocator);
+  const auto pass_count = state.range(0);
+  // Roughly the frame info and fragment uniforms of a hundred solid fills.
+  constexpr size_t kUniformCount = 200u;
+  struct Uniforms {
+    float values[32];
+  } uniforms = {};
+
+  size_t frame_count = 0u;
+  while (state.KeepRunning()) {
+    for (int64_t pass = 0; pass < pass_count; pass++) {
+      auto transients = use_ring ? ring : HostBuffer::Create();
+      BufferView view;
+      for (size_t i = 0u; i < kUniformCount; i++) {
+        view = transients->EmplaceUniform(uniforms);
+      }
+      benchmark::DoNotOptimize(view.buffer->GetDeviceBuffer(*allocator));
+    }
+    ring->Reset();
+    frame_count++;
+  }
+
+  state.counters["DeviceBufferAllocationsPerFrame"] =
+      frame_count == 0u ? 0.0
+                        : static_cast<double>(allocator->GetBufferCount()) /
+                              static_cast<double>(frame_count);
+}
+
+BENCHMARK_CAPTURE(BM_TransientsBuffer, PerPass, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_TransientsBuffer, Ring, true)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+// Measures the time to record the commands of a list with as many cards as
+// the benchmark argument, with the solid fills either batched the way entity
+// passes batch them or drawn one by one.
+static void BM_CardListSolidFills(benchmark::State& state, bool use_batching) {
+  auto context = std::make_shared<HostContext>();
+  ContentContext renderer(context);
+  if (!renderer.IsValid()) {
+    state.SkipWithError("Could not create the content context.");
+    return;
+  }
+  auto render_target = RenderTarget::CreateOffscreen(*context, kFrameSize);
+  auto entities = MakeCardList(state.range(0));
+
+  size_t frame_count = 0u;
+  size_t command_count = 0u;
+  while (state.KeepRunning()) {
+    HostRenderPass pass(context, render_target);
+    SolidFillBatcher batcher(renderer);
+    for (const auto& entity : entities) {
+      auto result = use_batching ? batcher.Render(entity, pass)
+                                 : entity.Render(renderer, pass);
+      benchmark::DoNotOptimize(result);
+    }
+    benchmark::DoNotOptimize(batcher.Flush());
+    command_count += pass.GetCommands().size();
+    frame_count++;
+  }
+
+  state.counters["SolidFillsPerFrame"] = static_cast<double>(entities.size());
+  state.counters["CommandsPerFrame"] =
+      frame_count == 0u ? 0.0
+                        : static_cast<double>(command_count) /
+                              static_cast<double>(frame_count);
+}
+
+BENCHMARK_CAPTURE(BM_CardListSolidFills, Batched, true)
+    ->RangeMultiplier(4)
+    ->Range(4, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_CardListSolidFills, Unbatched, false)
+    ->RangeMultiplier(4)
+    ->Range(4, 64)
+    ->Unit(benchmark::kMicrosecond);
+
+// Measures the time to split a blur with the sigma of the benchmark argument
+// into passes and to get the kernel of its last pass, either from a cache or
+// by computing it. The counters estimate the texture samples taken per pixel
+// of the blurred area, compared to a single pass at full resolution.
+static void BM_GaussianBlurKernel(benchmark::State& state, bool use_cache) {
+  const Sigma sigma{static_cast<Scalar>(state.range(0))};
+  GaussianBlurKernelCache cache;
+
+  GaussianBlurLevels levels;
+  size_t tap_count = 0u;
+  while (state.KeepRunning()) {
+    levels = GaussianBlurLevels::Make(sigma);
+    const Sigma level_sigma{levels.level_sigma.sigma /
+                            (1u << levels.level_count)};
+    tap_count = use_cache ? cache.GetKernel(level_sigma).tap_count
+                          : GaussianBlurKernel::Make(level_sigma).tap_count;
+    benchmark::DoNotOptimize(tap_count);
+  }
+
+  // Each downsampling pass takes two samples per texel of its level, which
+  // has half as many texels as the one before it.
+  double samples_per_pixel = 0.0;
+  for (size_t level = 1u; level <= levels.level_count; level++) {
+    samples_per_pixel += 2.0 / (1u << level);
+  }
+  samples_per_pixel +=
+      static_cast<double>(tap_count) / (1u << levels.level_count);
+
+  state.counters["Levels"] = static_cast<double>(levels.level_count);
+  state.counters["Taps"] = static_cast<double>(tap_count);
+  state.counters["SamplesPerPixel"] = samples_per_pixel;
+  state.counters["FullResolutionSamplesPerPixel"] =
+      std::round(Radius{sigma}.radius) + 1.0;
+}
+
+BENCHMARK_CAPTURE(BM_GaussianBlurKernel, Cached, true)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->Unit(benchmark::kNanosecond);
+
+BENCHMARK_CAPTURE(BM_GaussianBlurKernel, Uncached, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->Unit(benchmark::kNanosecond);
+
+// Measures the time to get the kernels of a blur whose sigma changes every
+// frame, such as an animated one, from a cache. The benchmark argument is the
+// number of distinct sigmas, which are spread evenly up to the largest sigma
+// of a kernel. Up to `kMaxKernelCount` sigmas, kernels are only made once and
+// then looked up. Beyond that the cache is dropped before the sigmas come
+// around again, so every kernel is made anew.
+static void BM_GaussianBlurKernelCache(benchmark::State& state) {
+  const auto sigma_count = static_cast<size_t>(state.range(0));
+  std::vector<Sigma> sigmas;
+  for (size_t i = 0; i < sigma_count; i++) {
+    sigmas.push_back(
+        Sigma{GaussianBlurKernel::kMaxSigma * i / (sigma_count - 1u)});
+  }
+  GaussianBlurKernelCache cache;
+
+  size_t index = 0u;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(cache.GetKernel(sigmas[index]).tap_count);
+    index = (index + 1u) % sigmas.size();
+  }
+
+  state.counters["CachedKernels"] =
+      static_cast<double>(cache.GetKernelCount());
+}
+
+BENCHMARK(BM_GaussianBlurKernelCache)
+    ->Arg(2)
+    ->Arg(64)
+    ->Arg(GaussianBlurKernelCache::kMaxKernelCount)
+    ->Arg(static_cast<int64_t>(GaussianBlurKernel::kMaxSigma *
+                               GaussianBlurKernelCache::kSigmaResolution) +
+          1)
+    ->Unit(benchmark::kNanosecond);
+
+}  // namespace impeller
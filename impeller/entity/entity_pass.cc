@@ -8,6 +8,7 @@
 #include <utility>
 #include <variant>
 
+#include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/trace_event.h"
@@ -23,6 +24,7 @@
 #include "impeller/entity/contents/texture_contents.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/inline_pass_context.h"
+#include "impeller/entity/solid_fill_batcher.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/renderer/command.h"
 #include "impeller/renderer/command_buffer.h"
@@ -142,21 +144,26 @@ EntityPass* EntityPass::AddSubpass(std::unique_ptr<EntityPass> pass) {
   return subpass_pointer;
 }
 
-static EntityPassTarget CreateRenderTarget(ContentContext& renderer,
-                                           ISize size,
-                                           bool readable,
-                                           const Color& clear_color) {
+static RenderTarget CreateOffscreenTarget(
+    ContentContext& renderer,
+    ISize size,
+    std::optional<RenderTarget::AttachmentConfig> stencil_attachment_config,
+    const Color& clear_color) {
   auto context = renderer.GetContext();
+  auto& allocator = *renderer.GetRenderTargetCache();
 
   /// All of the load/store actions are managed by `InlinePassContext` when
   /// `RenderPasses` are created, so we just set them to `kDontCare` here.
   /// What's important is the `StorageMode` of the textures, which cannot be
   /// changed for the lifetime of the textures.
+  ///
+  /// The textures are recycled by the render target cache of the renderer,
+  /// so that subpasses do not allocate new textures every frame.
 
-  RenderTarget target;
   if (context->GetCapabilities()->SupportsOffscreenMSAA()) {
-    target = RenderTarget::CreateOffscreenMSAA(
+    return RenderTarget::CreateOffscreenMSAA(
         *context,      // context
+        allocator,     // allocator
         size,          // size
         "EntityPass",  // label
         RenderTarget::AttachmentConfigMSAA{
@@ -165,34 +172,71 @@ static EntityPassTarget CreateRenderTarget(ContentContext& renderer,
             .load_action = LoadAction::kDontCare,
             .store_action = StoreAction::kMultisampleResolve,
             .clear_color = clear_color},  // color_attachment_config
-        RenderTarget::AttachmentConfig{
-            .storage_mode = readable ? StorageMode::kDevicePrivate
-                                     : StorageMode::kDeviceTransient,
-            .load_action = LoadAction::kDontCare,
-            .store_action = StoreAction::kDontCare,
-        }  // stencil_attachment_config
-    );
-  } else {
-    target = RenderTarget::CreateOffscreen(
-        *context,      // context
-        size,          // size
-        "EntityPass",  // label
-        RenderTarget::AttachmentConfig{
-            .storage_mode = StorageMode::kDevicePrivate,
-            .load_action = LoadAction::kDontCare,
-            .store_action = StoreAction::kDontCare,
-        },  // color_attachment_config
-        RenderTarget::AttachmentConfig{
-            .storage_mode = readable ? StorageMode::kDevicePrivate
-                                     : StorageMode::kDeviceTransient,
-            .load_action = LoadAction::kDontCare,
-            .store_action = StoreAction::kDontCare,
-        }  // stencil_attachment_config
+        stencil_attachment_config         // stencil_attachment_config
     );
   }
+  return RenderTarget::CreateOffscreen(
+      *context,      // context
+      allocator,     // allocator
+      size,          // size
+      "EntityPass",  // label
+      RenderTarget::AttachmentConfig{
+          .storage_mode = StorageMode::kDevicePrivate,
+          .load_action = LoadAction::kDontCare,
+          .store_action = StoreAction::kDontCare,
+      },                         // color_attachment_config
+      stencil_attachment_config  // stencil_attachment_config
+  );
+}
 
-  return EntityPassTarget(
-      target, renderer.GetDeviceCapabilities().SupportsReadFromResolve());
+static EntityPassTarget CreateRenderTarget(ContentContext& renderer,
+                                           ISize size,
+                                           bool readable,
+                                           bool with_depth,
+                                           const Color& clear_color) {
+  const auto& capabilities = renderer.GetDeviceCapabilities();
+  const auto stencil_storage_mode =
+      readable ? StorageMode::kDevicePrivate : StorageMode::kDeviceTransient;
+  const auto stencil_attachment_config = RenderTarget::AttachmentConfig{
+      .storage_mode = stencil_storage_mode,
+      .load_action = LoadAction::kDontCare,
+      .store_action = StoreAction::kDontCare,
+  };
+
+  if (with_depth) {
+    // With a depth attachment, the stencil shares its texture.
+    EntityPassTarget pass_target(
+        CreateOffscreenTarget(renderer, size, std::nullopt, clear_color),
+        capabilities.SupportsReadFromResolve());
+    if (pass_target.AddDepthAttachment(
+            *renderer.GetRenderTargetCache(),
+            capabilities.GetDefaultDepthStencilFormat(),
+            stencil_storage_mode)) {
+      return pass_target;
+    }
+    // Clips still need a stencil, so fall back to a stencil-only target.
+  }
+
+  return EntityPassTarget(CreateOffscreenTarget(renderer, size,
+                                                stencil_attachment_config,
+                                                clear_color),
+                          capabilities.SupportsReadFromResolve());
+}
+
+bool EntityPass::UsesOpaqueDepthPass(const ContentContext& renderer) const {
+  if (!renderer.IsOpaqueDepthPassEnabled() ||
+      renderer.GetDeviceCapabilities().GetDefaultDepthStencilFormat() ==
+          PixelFormat::kUnknown) {
+    return false;
+  }
+  // An opaque entity only saves work if something is drawn before it.
+  for (size_t i = 1u; i < elements_.size(); i++) {
+    auto entity = std::get_if<Entity>(&elements_[i]);
+    if (entity && entity->IsOpaque()) {
+      return true;
+    }
+  }
+  return false;
 }
 
 uint32_t EntityPass::GetTotalPassReads(ContentContext& renderer) const {
@@ -209,13 +253,19 @@ bool EntityPass::Render(ContentContext& renderer,
     return false;
   }
 
+  // The offscreen textures and transient data of this frame may be recycled
+  // once it ends.
+  renderer.StartFrame();
+  fml::ScopedCleanupClosure end_frame([&renderer]() { renderer.EndFrame(); });
+
   StencilCoverageStack stencil_coverage_stack = {StencilCoverageLayer{
       .coverage = Rect::MakeSize(render_target.GetRenderTargetSize()),
       .stencil_depth = 0}};
 
   if (GetTotalPassReads(renderer) > 0) {
-    auto offscreen_target = CreateRenderTarget(
-        renderer, render_target.GetRenderTargetSize(), true, clear_color_);
+    auto offscreen_target =
+        CreateRenderTarget(renderer, render_target.GetRenderTargetSize(), true,
+                           UsesOpaqueDepthPass(renderer), clear_color_);
 
     if (!OnRender(renderer,  // renderer
                   offscreen_target.GetRenderTarget()
@@ -248,6 +298,7 @@ bool EntityPass::Render(ContentContext& renderer,
     } else {
       auto render_pass = command_buffer->CreateRenderPass(render_target);
       render_pass->SetLabel("EntityPass Root Render Pass");
+      render_pass->SetTransientsBuffer(renderer.GetTransientsBuffer());
 
       {
         auto size_rect = Rect::MakeSize(
@@ -268,7 +319,13 @@ bool EntityPass::Render(ContentContext& renderer,
         return false;
       }
     }
-    if (!command_buffer->SubmitCommands()) {
+    // The device may still read the transient data of the pass after the
+    // frame ends.
+    auto transients_buffer = renderer.GetTransientsBuffer();
+    auto fence =
+        transients_buffer ? transients_buffer->GetFrameFence() : nullptr;
+    if (!command_buffer->SubmitCommands(
+            [fence = std::move(fence)](CommandBuffer::Status) {})) {
       return false;
     }
 
@@ -407,6 +464,7 @@ EntityPass::EntityResult EntityPass::GetEntityForElement(
         CreateRenderTarget(renderer,                                  //
                            ISize(subpass_coverage->size),             //
                            subpass->GetTotalPassReads(renderer) > 0,  //
+                           subpass->UsesOpaqueDepthPass(renderer),    //
                            clear_color_);
 
     auto subpass_texture =
@@ -475,10 +533,18 @@ bool EntityPass::OnRender(ContentContext& renderer,
                               collapsed_parent_pass) const {
   TRACE_EVENT0("impeller", "EntityPass::OnRender");
 
+  // Collapsed passes draw into the render pass of their parent, whose depths
+  // they know nothing about. Only the offscreen targets created for passes
+  // get a depth attachment, as onscreen targets may wrap a framebuffer that
+  // ignores it, such as the default framebuffer of OpenGL ES.
+  const bool use_opaque_depth_pass = !collapsed_parent_pass.has_value() &&
+                                     UsesOpaqueDepthPass(renderer) &&
+                                     pass_target.HasDepthAttachment();
+
   auto context = renderer.GetContext();
-  InlinePassContext pass_context(context, pass_target,
-                                 GetTotalPassReads(renderer),
-                                 std::move(collapsed_parent_pass));
+  InlinePassContext pass_context(
+      context, pass_target, GetTotalPassReads(renderer),
+      renderer.GetTransientsBuffer(), std::move(collapsed_parent_pass));
   if (!pass_context.IsValid()) {
     return false;
   }
@@ -492,9 +558,15 @@ bool EntityPass::OnRender(ContentContext& renderer,
     pass_context.GetRenderPass(pass_depth);
   }
 
+  // Merges runs of solid fills into single draws. It has to be flushed
+  // before the active render pass can end and before the stencil changes.
+  SolidFillBatcher batcher(renderer);
+
   auto render_element = [&stencil_depth_floor, &pass_context, &pass_depth,
                          &renderer, &stencil_coverage_stack,
-                         &global_pass_position](Entity& element_entity) {
+                         &global_pass_position, &batcher](
+                            Entity& element_entity,
+                            std::optional<CommandDepth> depth) {
     auto result = pass_context.GetRenderPass(pass_depth);
 
     if (!result.pass) {
@@ -592,7 +664,20 @@ bool EntityPass::OnRender(ContentContext& renderer,
 
     element_entity.SetStencilDepth(element_entity.GetStencilDepth() -
                                    stencil_depth_floor);
-    if (!element_entity.Render(renderer, *result.pass)) {
+    if (stencil_coverage.type == Contents::StencilCoverage::Type::kNoChange) {
+      // Only the draws that leave the stencil alone may be skipped while
+      // their pipelines are pending.
+      ContentContext::PendingPipelineSkippingScope skipping_scope(
+          renderer, *result.pass);
+      if (depth.has_value()) {
+        result.pass->SetCommandDepth(depth);
+        auto rendered = element_entity.Render(renderer, *result.pass);
+        result.pass->SetCommandDepth(std::nullopt);
+        return rendered;
+      }
+      return batcher.Render(element_entity, *result.pass);
+    }
+    if (!batcher.Flush() || !element_entity.Render(renderer, *result.pass)) {
       return false;
     }
     return true;
@@ -609,10 +694,71 @@ bool EntityPass::OnRender(ContentContext& renderer,
         Matrix::MakeTranslation(Vector3(local_pass_position)));
     backdrop_entity.SetStencilDepth(stencil_depth_floor);
 
-    render_element(backdrop_entity);
+    render_element(backdrop_entity, std::nullopt);
   }
 
+  // Entities that leave the stencil alone are collected into runs, which may
+  // be drawn out of order as long as the result is the same. The opaque
+  // entities of a run are drawn first and front to back, and write their
+  // depth. Everything else in the run is drawn in order afterwards, and the
+  // depth test rejects whatever an opaque entity drawn after it covers.
+  //
+  // Depths increase in draw order across the runs of the pass, so that the
+  // runs never reject each other.
+  std::vector<Entity> run;
+  size_t run_depth_offset = 0u;
+  const auto depth_scale = static_cast<Scalar>(elements_.size() + 1u);
+  auto render_run = [&run, &run_depth_offset, depth_scale, &batcher,
+                     &render_element]() {
+    bool has_occluder = false;
+    for (size_t i = 1u; i < run.size() && !has_occluder; i++) {
+      has_occluder = run[i].IsOpaque();
+    }
+    if (!has_occluder) {
+      for (auto& entity : run) {
+        if (!render_element(entity, std::nullopt)) {
+          return false;
+        }
+      }
+      run.clear();
+      return true;
+    }
+
+    if (!batcher.Flush()) {
+      return false;
+    }
+    auto get_depth = [&run_depth_offset, depth_scale](size_t index,
+                                                      bool opaque) {
+      return CommandDepth{
+          .depth = static_cast<Scalar>(run_depth_offset + index + 1u) /
+                   depth_scale,
+          .descriptor = {.depth_compare = CompareFunction::kGreaterEqual,
+                         .depth_write_enabled = opaque}};
+    };
+    for (size_t i = run.size(); i > 0u; i--) {
+      auto& entity = run[i - 1u];
+      if (entity.IsOpaque() &&
+          !render_element(entity, get_depth(i - 1u, true))) {
+        return false;
+      }
+    }
+    for (size_t i = 0u; i < run.size(); i++) {
+      if (!run[i].IsOpaque() && !render_element(run[i], get_depth(i, false))) {
+        return false;
+      }
+    }
+    run_depth_offset += run.size();
+    run.clear();
+    return true;
+  };
+
   for (const auto& element : elements_) {
+    // Subpasses may end the active render pass or draw into it.
+    if (!std::holds_alternative<Entity>(element) &&
+        (!render_run() || !batcher.Flush())) {
+      return false;
+    }
+
     EntityResult result =
         GetEntityForElement(element,                 // element
                             renderer,                // renderer
@@ -632,11 +778,26 @@ bool EntityPass::OnRender(ContentContext& renderer,
         continue;
     };
 
+    if (use_opaque_depth_pass &&
+        std::holds_alternative<Entity>(element) &&
+        result.entity.GetBlendMode() <= Entity::kLastPipelineBlendMode &&
+        result.entity.GetStencilCoverage(std::nullopt).type ==
+            Contents::StencilCoverage::Type::kNoChange) {
+      run.push_back(std::move(result.entity));
+      continue;
+    }
+    if (!render_run()) {
+      return false;
+    }
+
     //--------------------------------------------------------------------------
     /// Setup advanced blends.
     ///
 
     if (result.entity.GetBlendMode() > Entity::kLastPipelineBlendMode) {
+      if (!batcher.Flush()) {
+        return false;
+      }
       if (renderer.GetDeviceCapabilities().SupportsFramebufferFetch()) {
         auto src_contents = result.entity.GetContents();
         auto contents = std::make_shared<FramebufferBlendContents>();
@@ -682,11 +843,24 @@ bool EntityPass::OnRender(ContentContext& renderer,
     /// Render the Element.
     ///
 
-    if (!render_element(result.entity)) {
+    if (!render_element(result.entity, std::nullopt)) {
       return false;
     }
   }
 
+  if (!render_run() || !batcher.Flush()) {
+    return false;
+  }
+
+#if !FLUTTER_RELEASE
+  const auto& batcher_statistics = batcher.GetStatistics();
+  FML_TRACE_COUNTER(
+      "impeller",                                             //
+      "EntityPassBatching", reinterpret_cast<int64_t>(this),  //
+      "SolidFills", batcher_statistics.solid_fill_count,      //
+      "Commands", batcher_statistics.command_count);
+#endif  // !FLUTTER_RELEASE
+
   return true;
 }
 
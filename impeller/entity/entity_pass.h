@@ -223,6 +223,12 @@ class EntityPass {
 
   uint32_t GetTotalPassReads(ContentContext& renderer) const;
 
+  /// @brief  Whether this pass draws its opaque entities first and front to
+  ///         back, which it only does if one of them is drawn on top of
+  ///         something else. Requires an offscreen target with a depth
+  ///         attachment.
+  bool UsesOpaqueDepthPass(const ContentContext& renderer) const;
+
   std::optional<BackdropFilterProc> backdrop_filter_proc_ = std::nullopt;
 
   std::unique_ptr<EntityPassDelegate> delegate_ =
@@ -58,6 +58,50 @@ const RenderTarget& EntityPassTarget::GetRenderTarget() const {
   return target_;
 }
 
+bool EntityPassTarget::AddDepthAttachment(RenderTargetAllocator& allocator,
+                                          PixelFormat format,
+                                          StorageMode storage_mode) {
+  if (!IsValid() || format == PixelFormat::kUnknown) {
+    return false;
+  }
+  const auto& color0 = target_.GetColorAttachments().find(0)->second;
+  if (!color0.texture) {
+    return false;
+  }
+  const auto& color_desc = color0.texture->GetTextureDescriptor();
+
+  TextureDescriptor desc;
+  desc.storage_mode = storage_mode;
+  desc.type = color_desc.type;
+  desc.sample_count = color_desc.sample_count;
+  desc.format = format;
+  desc.size = color_desc.size;
+  desc.usage = static_cast<TextureUsageMask>(TextureUsage::kRenderTarget);
+  auto texture = allocator.CreateTexture(desc);
+  if (!texture) {
+    VALIDATION_LOG << "Could not create the EntityPass depth texture.";
+    return false;
+  }
+  texture->SetLabel("EntityPass Depth Stencil Texture");
+
+  // Load and store actions are managed by `InlinePassContext`.
+  DepthAttachment depth;
+  depth.texture = texture;
+  depth.clear_depth = 0.0;
+  target_.SetDepthAttachment(depth);
+
+  StencilAttachment stencil;
+  stencil.texture = std::move(texture);
+  stencil.clear_stencil = 0u;
+  target_.SetStencilAttachment(stencil);
+  has_depth_attachment_ = true;
+  return true;
+}
+
+bool EntityPassTarget::HasDepthAttachment() const {
+  return has_depth_attachment_;
+}
+
 bool EntityPassTarget::IsValid() const {
   return !target_.GetColorAttachments().empty();
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "fml/macros.h"
+#include "impeller/core/formats.h"
 #include "impeller/renderer/render_target.h"
 
 namespace impeller {
@@ -27,11 +28,35 @@ class EntityPassTarget {
 
   const RenderTarget& GetRenderTarget() const;
 
+  /// @brief  Replaces the stencil attachment with a depth and stencil
+  ///         attachment, so that opaque entities can reject whatever they
+  ///         cover with a depth test.
+  ///
+  ///         Depths start out cleared to zero. The target is left untouched
+  ///         if the attachment cannot be created.
+  ///
+  /// @param[in]  allocator     The allocator of the attachment texture.
+  /// @param[in]  format        The combined depth-stencil format of the
+  ///                           attachment texture, usually
+  ///                           `Capabilities::GetDefaultDepthStencilFormat`.
+  /// @param[in]  storage_mode  The storage mode of the attachment texture,
+  ///                           which must be retained if the stencil is
+  ///                           loaded by later render passes.
+  ///
+  /// @return     Whether the depth attachment was added.
+  bool AddDepthAttachment(RenderTargetAllocator& allocator,
+                          PixelFormat format,
+                          StorageMode storage_mode);
+
+  /// @brief  Whether `AddDepthAttachment` added a depth attachment.
+  bool HasDepthAttachment() const;
+
   bool IsValid() const;
 
  private:
   RenderTarget target_;
   std::shared_ptr<Texture> secondary_color_texture_;
+  bool has_depth_attachment_ = false;
 
   bool supports_read_from_resolve_;
 
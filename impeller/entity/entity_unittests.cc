@@ -3,22 +3,28 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <optional>
 #include <unordered_map>
 #include <vector>
 
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/testing/testing.h"
 #include "fml/logging.h"
 #include "fml/time/time_point.h"
 #include "gtest/gtest.h"
 #include "impeller/entity/contents/atlas_contents.h"
 #include "impeller/entity/contents/clip_contents.h"
+#include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/contents/contents.h"
 #include "impeller/entity/contents/filters/blend_filter_contents.h"
 #include "impeller/entity/contents/filters/color_filter_contents.h"
 #include "impeller/entity/contents/filters/filter_contents.h"
+#include "impeller/entity/contents/filters/gaussian_blur_filter_contents.h"
+#include "impeller/entity/contents/filters/gaussian_blur_kernel.h"
 #include "impeller/entity/contents/filters/inputs/filter_input.h"
 #include "impeller/entity/contents/linear_gradient_contents.h"
 #include "impeller/entity/contents/rrect_shadow_contents.h"
@@ -33,13 +39,17 @@
 #include "impeller/entity/entity_pass_delegate.h"
 #include "impeller/entity/entity_playground.h"
 #include "impeller/entity/geometry.h"
+#include "impeller/entity/render_target_cache.h"
+#include "impeller/entity/solid_fill_batcher.h"
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/geometry_asserts.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/geometry/sigma.h"
 #include "impeller/playground/playground.h"
 #include "impeller/playground/widgets.h"
+#include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/render_pass.h"
+#include "impeller/renderer/render_target.h"
 #include "impeller/renderer/vertex_buffer_builder.h"
 #include "impeller/runtime_stage/runtime_stage.h"
 #include "impeller/tessellator/tessellator.h"
@@ -49,6 +59,10 @@
 #include "third_party/imgui/imgui.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
 
+#if IMPELLER_ENABLE_OPENGLES
+#include "impeller/renderer/backend/gles/surface_gles.h"
+#endif  // IMPELLER_ENABLE_OPENGLES
+
 namespace impeller {
 namespace testing {
 
@@ -781,6 +795,143 @@ TEST_P(EntityTest, SolidColorContentsStrokeSetMiterLimit) {
   }
 }
 
+TEST_P(EntityTest, StrokeGeometryUsesComputeTessellationForComplexPaths) {
+  ContentContext renderer(GetContext());
+  ASSERT_TRUE(renderer.IsValid());
+
+  auto make_polyline = [](size_t line_count) {
+    PathBuilder builder;
+    builder.MoveTo({0, 0});
+    for (size_t i = 1; i <= line_count; i++) {
+      builder.LineTo({i * 2.0f, (i % 2) * 10.0f});
+    }
+    return builder.TakePath();
+  };
+  auto complex_path = make_polyline(
+      StrokePathGeometry::kMinComputeTessellationComponentCount);
+  auto make_stroke = [](const Path& path, Cap cap, Join join) {
+    return StrokePathGeometry(path, 4.0, 4.0, cap, join);
+  };
+
+  // Disabled by default.
+  ASSERT_FALSE(renderer.IsComputeTessellationEnabled());
+  EXPECT_FALSE(make_stroke(complex_path, Cap::kButt, Join::kBevel)
+                   .UsesComputeTessellation(renderer));
+
+  renderer.SetComputeTessellationEnabled(true);
+  bool supports_compute = renderer.GetDeviceCapabilities().SupportsCompute();
+  EXPECT_EQ(make_stroke(complex_path, Cap::kButt, Join::kBevel)
+                .UsesComputeTessellation(renderer),
+            supports_compute);
+
+  // Styles the compute shaders don't implement.
+  EXPECT_FALSE(make_stroke(complex_path, Cap::kRound, Join::kBevel)
+                   .UsesComputeTessellation(renderer));
+  EXPECT_FALSE(make_stroke(complex_path, Cap::kButt, Join::kMiter)
+                   .UsesComputeTessellation(renderer));
+
+  // Too simple.
+  auto simple_path = make_polyline(
+      StrokePathGeometry::kMinComputeTessellationComponentCount - 1);
+  EXPECT_FALSE(make_stroke(simple_path, Cap::kButt, Join::kBevel)
+                   .UsesComputeTessellation(renderer));
+
+  // More than one contour, such as a dashed stroke.
+  PathBuilder dashes;
+  for (size_t i = 0; i < 100; i++) {
+    dashes.MoveTo({i * 10.0f, 0}).LineTo({i * 10.0f + 5.0f, 0});
+  }
+  EXPECT_FALSE(make_stroke(dashes.TakePath(), Cap::kButt, Join::kBevel)
+                   .UsesComputeTessellation(renderer));
+
+  // Too complex for the compute shaders.
+  auto huge_path = make_polyline(2048);
+  EXPECT_FALSE(make_stroke(huge_path, Cap::kButt, Join::kBevel)
+                   .UsesComputeTessellation(renderer));
+
+  // Curves, which may be flattened to more lines than estimated.
+  PathBuilder curves;
+  curves.MoveTo({0, 0});
+  for (size_t i = 0;
+       i < StrokePathGeometry::kMinComputeTessellationComponentCount; i++) {
+    curves.QuadraticCurveTo({i * 10.0f + 5.0f, 10.0f}, {i * 10.0f + 10.0f, 0});
+  }
+  EXPECT_FALSE(make_stroke(curves.TakePath(), Cap::kButt, Join::kBevel)
+                   .UsesComputeTessellation(renderer));
+}
+
+TEST_P(EntityTest, ScaledUpCurveStrokesMatchTheCPUStroke) {
+  ContentContext renderer(GetContext());
+  ASSERT_TRUE(renderer.IsValid());
+  renderer.SetComputeTessellationEnabled(true);
+  auto render_target =
+      RenderTarget::CreateOffscreen(*GetContext(), {200, 200}, "Stroke");
+  auto command_buffer = GetContext()->CreateCommandBuffer();
+  ASSERT_NE(command_buffer, nullptr);
+  auto pass = command_buffer->CreateRenderPass(render_target);
+  ASSERT_NE(pass, nullptr);
+
+  // At this scale, each cubic is flattened to many more lines than the ten
+  // the compute tessellator estimates.
+  static constexpr Scalar kScale = 50.0f;
+  PathBuilder builder;
+  builder.MoveTo({0, 0});
+  for (size_t i = 0;
+       i < StrokePathGeometry::kMinComputeTessellationComponentCount; i++) {
+    builder.CubicCurveTo({i * 10.0f + 2.0f, 20.0f},
+                         {i * 10.0f + 8.0f, -20.0f}, {i * 10.0f + 10.0f, 0});
+  }
+  auto path = builder.TakePath();
+  auto geometry = Geometry::MakeStrokePath(path, 4.0, 4.0, Cap::kButt,
+                                           Join::kBevel);
+  EXPECT_FALSE(static_cast<StrokePathGeometry*>(geometry.get())
+                   ->UsesComputeTessellation(renderer));
+
+  Entity entity;
+  entity.SetTransformation(Matrix::MakeScale({kScale, kScale, 1.0f}));
+  auto result = geometry->GetPositionBuffer(renderer, entity, *pass);
+  auto expected = StrokePathGeometry::CreateSolidStrokeVertices(
+      path, 4.0, 4.0 * 4.0 * 0.5, Cap::kButt, Join::kBevel, kScale);
+  ASSERT_GT(expected.GetVertexCount(),
+            StrokePathGeometry::kMinComputeTessellationComponentCount * 10 * 4);
+  ASSERT_EQ(result.vertex_buffer.index_count, expected.GetIndexCount());
+
+  using VS = SolidFillVertexShader;
+  auto vertex_view = result.vertex_buffer.vertex_buffer;
+  auto* vertices = reinterpret_cast<const VS::PerVertexData*>(
+      vertex_view.contents + vertex_view.range.offset);
+  size_t i = 0;
+  expected.IterateVertices([&](VS::PerVertexData& vertex) {
+    ASSERT_POINT_NEAR(vertices[i].position, vertex.position);
+    i++;
+  });
+  EXPECT_EQ(i, expected.GetVertexCount());
+}
+
+TEST_P(EntityTest, ComputeTessellatedStrokeOfLongPolyline) {
+  PathBuilder builder;
+  builder.MoveTo({100, 100});
+  for (size_t i = 1; i <= 500; i++) {
+    builder.LineTo({100 + i * 1.5f, 100 + std::sin(i * 0.1f) * 50});
+  }
+  auto path = builder.TakePath();
+
+  auto callback = [&](ContentContext& context, RenderPass& pass) -> bool {
+    context.SetComputeTessellationEnabled(true);
+    Entity entity;
+    entity.SetTransformation(Matrix::MakeScale(GetContentScale()));
+    auto contents = std::make_unique<SolidColorContents>();
+    contents->SetGeometry(Geometry::MakeStrokePath(path, 4.0, 4.0, Cap::kButt,
+                                                   Join::kBevel));
+    contents->SetColor(Color::Red());
+    entity.SetContents(std::move(contents));
+    auto result = entity.Render(context, pass);
+    context.SetComputeTessellationEnabled(false);
+    return result;
+  };
+  ASSERT_TRUE(OpenPlaygroundHere(callback));
+}
+
 TEST_P(EntityTest, BlendingModeOptions) {
   std::vector<const char*> blend_mode_names;
   std::vector<BlendMode> blend_mode_values;
@@ -2487,5 +2638,351 @@ TEST_P(EntityTest, CoverageForStrokePathWithNegativeValuesInTransform) {
   ASSERT_RECT_NEAR(coverage.value(), Rect::MakeXYWH(102.5, 342.5, 85, 155));
 }
 
+TEST_P(EntityTest, RenderTargetCacheRecyclesTexturesAcrossFrames) {
+  RenderTargetCache cache(GetContext()->GetResourceAllocator());
+  TextureDescriptor desc;
+  desc.format = PixelFormat::kR8G8B8A8UNormInt;
+  desc.size = {100, 100};
+  desc.usage = static_cast<TextureUsageMask>(TextureUsage::kRenderTarget);
+
+  cache.Start();
+  auto first = cache.CreateTexture(desc);
+  ASSERT_NE(first, nullptr);
+  // A texture is never handed out twice in a frame.
+  auto second = cache.CreateTexture(desc);
+  ASSERT_NE(second, nullptr);
+  EXPECT_NE(first, second);
+  cache.End();
+  EXPECT_EQ(cache.GetFrameStatistics().allocation_count, 2u);
+  EXPECT_EQ(cache.GetCachedTextureCount(), 2u);
+
+  // Textures that are still referenced are not recycled.
+  auto first_ptr = first.get();
+  second.reset();
+  cache.Start();
+  auto recycled = cache.CreateTexture(desc);
+  EXPECT_NE(recycled.get(), first_ptr);
+  cache.End();
+  EXPECT_EQ(cache.GetFrameStatistics().reuse_count, 1u);
+  EXPECT_EQ(cache.GetFrameStatistics().allocation_count, 0u);
+
+  // Textures that match nothing are allocated.
+  first.reset();
+  recycled.reset();
+  auto other_desc = desc;
+  other_desc.size = {200, 100};
+  cache.Start();
+  EXPECT_NE(cache.CreateTexture(other_desc), nullptr);
+  cache.End();
+  EXPECT_EQ(cache.GetFrameStatistics().allocation_count, 1u);
+  EXPECT_EQ(cache.GetCachedTextureCount(), 3u);
+
+  // Textures that go unused for long enough are released.
+  for (uint64_t i = 0; i < RenderTargetCache::kMaxUnusedFrameCount; i++) {
+    cache.Start();
+    cache.End();
+  }
+  EXPECT_EQ(cache.GetCachedTextureCount(), 0u);
+}
+
+TEST_P(EntityTest, SolidFillBatcherMergesNonOverlappingSolidFills) {
+  ContentContext renderer(GetContext());
+  ASSERT_TRUE(renderer.IsValid());
+  auto render_target =
+      RenderTarget::CreateOffscreen(*GetContext(), {200, 200}, "Batching");
+  auto command_buffer = GetContext()->CreateCommandBuffer();
+  ASSERT_NE(command_buffer, nullptr);
+  auto pass = command_buffer->CreateRenderPass(render_target);
+  ASSERT_NE(pass, nullptr);
+
+  auto make_entity = [](Rect rect, Color color) {
+    auto contents = std::make_shared<SolidColorContents>();
+    contents->SetGeometry(Geometry::MakeRect(rect));
+    contents->SetColor(color);
+    Entity entity;
+    entity.SetContents(std::move(contents));
+    return entity;
+  };
+
+  SolidFillBatcher batcher(renderer);
+  ASSERT_TRUE(batcher.Render(
+      make_entity(Rect::MakeXYWH(0, 0, 10, 10), Color::Red()), *pass));
+  // Solid fills of another color are drawn after the batch.
+  ASSERT_TRUE(batcher.Render(
+      make_entity(Rect::MakeXYWH(5, 5, 10, 10), Color::Blue()), *pass));
+  // This one does not overlap the blue fill, so it joins the batch.
+  ASSERT_TRUE(batcher.Render(
+      make_entity(Rect::MakeXYWH(100, 100, 10, 10), Color::Red()), *pass));
+  // This one does, so it has to be drawn after the blue fill.
+  ASSERT_TRUE(batcher.Render(
+      make_entity(Rect::MakeXYWH(8, 8, 4, 4), Color::Red()), *pass));
+  EXPECT_TRUE(pass->GetCommands().empty());
+
+  ASSERT_TRUE(batcher.Flush());
+  EXPECT_EQ(pass->GetCommands().size(), 3u);
+  EXPECT_EQ(batcher.GetStatistics().solid_fill_count, 2u);
+  EXPECT_EQ(batcher.GetStatistics().command_count, 1u);
+  EXPECT_EQ(pass->GetCommands()[0].label, "Solid Fill Batch");
+  EXPECT_EQ(pass->GetCommands()[0].index_count, 12u);
+}
+
+// Renders a pass into an offscreen texture and reads its pixels back.
+static std::vector<uint8_t> RenderToPixels(ContentContext& renderer,
+                                           const EntityPass& pass,
+                                           ISize size) {
+  auto context = renderer.GetContext();
+  auto render_target = RenderTarget::CreateOffscreen(*context, size, "Pixels");
+  if (!pass.Render(renderer, render_target)) {
+    return {};
+  }
+
+  auto texture = render_target.GetRenderTargetTexture();
+  DeviceBufferDescriptor buffer_desc;
+  buffer_desc.storage_mode = StorageMode::kHostVisible;
+  buffer_desc.size =
+      texture->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
+  auto buffer = context->GetResourceAllocator()->CreateBuffer(buffer_desc);
+  auto command_buffer = context->CreateCommandBuffer();
+  auto blit_pass = command_buffer->CreateBlitPass();
+  fml::AutoResetWaitableEvent latch;
+  if (!buffer || !blit_pass || !blit_pass->AddCopy(texture, buffer) ||
+      !blit_pass->EncodeCommands(context->GetResourceAllocator()) ||
+      !command_buffer->SubmitCommands(
+          [&latch](CommandBuffer::Status) { latch.Signal(); })) {
+    return {};
+  }
+  latch.Wait();
+  auto contents = buffer->OnGetContents();
+  return std::vector<uint8_t>(contents, contents + buffer_desc.size);
+}
+
+TEST_P(EntityTest, OpaqueDepthPassMatchesPainterOrder) {
+  auto make_solid = [](Rect rect, Color color) {
+    auto contents = std::make_shared<SolidColorContents>();
+    contents->SetGeometry(Geometry::MakeRect(rect));
+    contents->SetColor(color);
+    Entity entity;
+    entity.SetContents(std::move(contents));
+    return entity;
+  };
+
+  auto make_scene = [&make_solid]() {
+    auto pass = std::make_unique<EntityPass>();
+    pass->AddEntity(make_solid(Rect::MakeXYWH(0, 0, 256, 256), Color::White()));
+    pass->AddEntity(make_solid(Rect::MakeXYWH(20, 20, 100, 100), Color::Red()));
+    pass->AddEntity(make_solid(Rect::MakeXYWH(60, 60, 100, 100),
+                               Color::Blue().WithAlpha(0.5)));
+    pass->AddEntity(
+        make_solid(Rect::MakeXYWH(80, 40, 60, 120), Color::Green()));
+
+    // Opaque entities after a clip only cover what follows the clip.
+    auto clip_contents = std::make_shared<ClipContents>();
+    clip_contents->SetGeometry(
+        Geometry::MakeRect(Rect::MakeXYWH(0, 0, 128, 256)));
+    clip_contents->SetClipOperation(Entity::ClipOperation::kIntersect);
+    Entity clip;
+    clip.SetContents(std::move(clip_contents));
+    pass->AddEntity(clip);
+    pass->AddEntity(make_solid(Rect::MakeXYWH(100, 100, 120, 40),
+                               Color::Yellow().WithAlpha(0.25)));
+    auto source = make_solid(Rect::MakeXYWH(110, 90, 40, 40),
+                             Color::Fuchsia().WithAlpha(0.75));
+    source.SetBlendMode(BlendMode::kSource);
+    source.SetStencilDepth(1u);
+    pass->AddEntity(source);
+    auto clipped = make_solid(Rect::MakeXYWH(90, 120, 80, 30), Color::Black());
+    clipped.SetStencilDepth(1u);
+    pass->AddEntity(clipped);
+    Entity restore;
+    restore.SetContents(std::make_shared<ClipRestoreContents>());
+    restore.SetStencilDepth(1u);
+    pass->AddEntity(restore);
+
+    auto subpass = std::make_unique<EntityPass>();
+    subpass->AddEntity(
+        make_solid(Rect::MakeXYWH(150, 150, 80, 80), Color::Orange()));
+    subpass->AddEntity(make_solid(Rect::MakeXYWH(170, 170, 40, 40),
+                                  Color::Purple().WithAlpha(0.5)));
+    subpass->AddEntity(
+        make_solid(Rect::MakeXYWH(190, 140, 20, 100), Color::Maroon()));
+    pass->AddSubpass(std::move(subpass));
+    pass->AddEntity(
+        make_solid(Rect::MakeXYWH(10, 200, 200, 20), Color::Navy()));
+    return pass;
+  };
+
+  auto render_scene = [this, &make_scene](bool opaque_depth_pass) {
+    ContentContext renderer(GetContext());
+    if (!renderer.IsValid()) {
+      return std::vector<uint8_t>();
+    }
+    renderer.SetOpaqueDepthPassEnabled(opaque_depth_pass);
+    return RenderToPixels(renderer, *make_scene(), {256, 256});
+  };
+
+  auto expected = render_scene(false);
+  ASSERT_FALSE(expected.empty());
+  auto actual = render_scene(true);
+  ASSERT_EQ(actual.size(), expected.size());
+  EXPECT_TRUE(actual == expected);
+}
+
+#if IMPELLER_ENABLE_OPENGLES
+TEST_P(EntityTest, OpaqueDepthPassIsNotUsedOnTheDefaultFramebuffer) {
+  if (GetBackend() != PlaygroundBackend::kOpenGLES) {
+    GTEST_SKIP_("Only OpenGLES wraps the default framebuffer.");
+  }
+  ContentContext renderer(GetContext());
+  ASSERT_TRUE(renderer.IsValid());
+  renderer.SetOpaqueDepthPassEnabled(true);
+
+  auto make_solid = [](Rect rect, Color color) {
+    auto contents = std::make_shared<SolidColorContents>();
+    contents->SetGeometry(Geometry::MakeRect(rect));
+    contents->SetColor(color);
+    Entity entity;
+    entity.SetContents(std::move(contents));
+    return entity;
+  };
+  EntityPass pass;
+  pass.AddEntity(make_solid(Rect::MakeXYWH(0, 0, 256, 256), Color::White()));
+  pass.AddEntity(make_solid(Rect::MakeXYWH(20, 20, 100, 100),
+                            Color::Blue().WithAlpha(0.5)));
+  pass.AddEntity(make_solid(Rect::MakeXYWH(60, 60, 100, 100), Color::Red()));
+
+  // The default framebuffer ignores the attachments of render passes and
+  // may have no depth buffer at all, in which case opaque entities would be
+  // drawn underneath the translucent ones painted before them.
+  auto surface = SurfaceGLES::WrapFBO(
+      GetContext(), []() { return true; }, 0u, PixelFormat::kR8G8B8A8UNormInt,
+      ISize(256, 256));
+  ASSERT_TRUE(surface);
+  ASSERT_TRUE(pass.Render(renderer, surface->GetTargetRenderPassDescriptor()));
+
+  // No depth attachment was created for the onscreen target.
+  const auto& statistics =
+      renderer.GetRenderTargetCache()->GetFrameStatistics();
+  EXPECT_EQ(statistics.allocation_count, 0u);
+  EXPECT_EQ(statistics.reuse_count, 0u);
+}
+#endif  // IMPELLER_ENABLE_OPENGLES
+
+TEST_P(EntityTest, GaussianBlurKernelWeightsAddUpToOne) {
+  for (auto sigma : {0.1f, 1.0f, 2.5f, 7.0f, 17.5f, 100.0f}) {
+    auto kernel = GaussianBlurKernel::Make(Sigma{sigma});
+    ASSERT_GT(kernel.tap_count, 0u);
+    ASSERT_LE(kernel.tap_count, GaussianBlurKernel::kMaxTapCount);
+    Scalar total_weight = 0.0f;
+    Scalar mean = 0.0f;
+    for (size_t i = 0; i < kernel.tap_count; i++) {
+      total_weight += kernel.taps[i].weight;
+      mean += kernel.taps[i].offset * kernel.taps[i].weight;
+    }
+    EXPECT_NEAR(total_weight, 1.0f, 1e-4f);
+    EXPECT_NEAR(mean, 0.0f, 1e-3f);
+  }
+
+  // Each tap blends two texels.
+  auto kernel = GaussianBlurKernel::Make(Sigma{4.0f});
+  auto radius = std::round(Radius{Sigma{4.0f}}.radius);
+  EXPECT_EQ(kernel.tap_count, static_cast<size_t>(radius) + 1u);
+}
+
+TEST_P(EntityTest, GaussianBlurLevelsDependOnSigma) {
+  EXPECT_EQ(GaussianBlurLevels::Make(Sigma{1.0f}).level_count, 0u);
+  EXPECT_EQ(GaussianBlurLevels::Make(Sigma{3.9f}).level_count, 0u);
+  EXPECT_EQ(GaussianBlurLevels::Make(Sigma{4.0f}).level_count, 1u);
+  EXPECT_EQ(GaussianBlurLevels::Make(Sigma{100.0f}).level_count, 5u);
+  EXPECT_EQ(GaussianBlurLevels::Make(Sigma{1000.0f}).level_count,
+            GaussianBlurLevels::kMaxLevelCount);
+  EXPECT_EQ(GaussianBlurLevels::Make(Sigma{100.0f}, 2u).level_count, 2u);
+
+  // The downsampling passes take their share of the blur.
+  auto levels = GaussianBlurLevels::Make(Sigma{100.0f});
+  EXPECT_NEAR(levels.level_sigma.sigma, std::sqrt(10000.0f - 255.75f), 1e-2f);
+  EXPECT_FLOAT_EQ(GaussianBlurLevels::Make(Sigma{3.0f}).level_sigma.sigma,
+                  3.0f);
+}
+
+TEST_P(EntityTest, GaussianBlurKernelCacheReusesKernels) {
+  GaussianBlurKernelCache cache;
+  auto tap_count = cache.GetKernel(Sigma{3.0f}).tap_count;
+  EXPECT_EQ(cache.GetKernelCount(), 1u);
+  // Sigmas within a fraction of a texel share their kernel.
+  EXPECT_EQ(cache.GetKernel(Sigma{3.001f}).tap_count, tap_count);
+  EXPECT_EQ(cache.GetKernelCount(), 1u);
+  cache.GetKernel(Sigma{4.0f});
+  EXPECT_EQ(cache.GetKernelCount(), 2u);
+}
+
+TEST_P(EntityTest, GaussianBlurKernelCacheClampsSigmas) {
+  GaussianBlurKernelCache cache;
+  const auto& max_kernel =
+      cache.GetKernel(Sigma{GaussianBlurKernel::kMaxSigma});
+  const auto max_tap_count = max_kernel.tap_count;
+  EXPECT_LE(max_tap_count, GaussianBlurKernel::kMaxTapCount);
+  EXPECT_EQ(cache.GetKernelCount(), 1u);
+
+  // Larger sigmas share the kernel of the largest one.
+  for (auto sigma : {18.0f, 100.0f, 1e6f}) {
+    EXPECT_EQ(cache.GetKernel(Sigma{sigma}).tap_count, max_tap_count);
+  }
+  EXPECT_EQ(cache.GetKernelCount(), 1u);
+
+  // So do negative sigmas with the kernel of no blur.
+  EXPECT_EQ(cache.GetKernel(Sigma{-1.0f}).tap_count, 1u);
+  EXPECT_EQ(cache.GetKernel(Sigma{0.0f}).tap_count, 1u);
+  EXPECT_EQ(cache.GetKernelCount(), 2u);
+}
+
+TEST_P(EntityTest, GaussianBlurLevelsMatchFullResolutionBlur) {
+  auto render_blur = [this](size_t max_level_count) {
+    ContentContext renderer(GetContext());
+    if (!renderer.IsValid()) {
+      return std::vector<uint8_t>();
+    }
+
+    auto rect = std::make_shared<SolidColorContents>();
+    rect->SetGeometry(Geometry::MakeRect(Rect::MakeXYWH(88, 88, 80, 80)));
+    rect->SetColor(Color::White());
+    auto input = FilterInput::Make(rect);
+
+    auto x_blur = std::make_shared<DirectionalGaussianBlurFilterContents>();
+    x_blur->SetInputs({input});
+    x_blur->SetSigma(Sigma{16.0f});
+    x_blur->SetDirection({1, 0});
+    x_blur->SetMaxLevelCount(max_level_count);
+    auto y_blur = std::make_shared<DirectionalGaussianBlurFilterContents>();
+    y_blur->SetInputs({FilterInput::Make(x_blur)});
+    y_blur->SetSigma(Sigma{16.0f});
+    y_blur->SetDirection({0, 1});
+    y_blur->SetSourceOverride(input);
+    y_blur->SetSecondarySigma(Sigma{16.0f});
+    y_blur->SetMaxLevelCount(max_level_count);
+
+    Entity entity;
+    entity.SetContents(y_blur);
+    EntityPass pass;
+    pass.AddEntity(entity);
+    return RenderToPixels(renderer, pass, {256, 256});
+  };
+
+  // A sigma of 16 is blurred at an eighth of the resolution.
+  ASSERT_EQ(GaussianBlurLevels::Make(Sigma{16.0f}).level_count, 3u);
+  auto expected = render_blur(0u);
+  ASSERT_FALSE(expected.empty());
+  auto actual = render_blur(GaussianBlurLevels::kMaxLevelCount);
+  ASSERT_EQ(actual.size(), expected.size());
+
+  // Scaling the blur back up is not exact, but stays within a few percent.
+  constexpr int kTolerance = 8;
+  int max_difference = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    max_difference =
+        std::max(max_difference, std::abs(actual[i] - expected[i]));
+  }
+  EXPECT_LE(max_difference, kTolerance);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -4,6 +4,10 @@
 
 #include "impeller/entity/geometry.h"
 
+#include <numeric>
+#include <type_traits>
+
+#include "flutter/fml/trace_event.h"
 #include "impeller/core/device_buffer.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/entity.h"
@@ -14,6 +18,10 @@
 #include "impeller/renderer/render_pass.h"
 #include "impeller/tessellator/tessellator.h"
 
+#if IMPELLER_ENABLE_COMPUTE
+#include "impeller/renderer/compute_tessellator.h"
+#endif  // IMPELLER_ENABLE_COMPUTE
+
 namespace impeller {
 
 Geometry::Geometry() = default;
@@ -28,6 +36,13 @@ GeometryResult Geometry::GetPositionUVBuffer(Rect texture_coverage,
   return {};
 }
 
+bool Geometry::AppendTriangles(const ContentContext& renderer,
+                               const Matrix& transform,
+                               std::vector<Point>& vertices,
+                               std::vector<uint16_t>& indices) const {
+  return false;
+}
+
 // static
 std::unique_ptr<Geometry> Geometry::MakeFillPath(const Path& path) {
   return std::make_unique<FillPathGeometry>(path);
@@ -175,6 +190,30 @@ GeometryResult FillPathGeometry::GetPositionUVBuffer(
   };
 }
 
+// |Geometry|
+bool FillPathGeometry::AppendTriangles(const ContentContext& renderer,
+                                       const Matrix& transform,
+                                       std::vector<Point>& vertices,
+                                       std::vector<uint16_t>& indices) const {
+  const auto base = vertices.size();
+  auto tesselation_result = renderer.GetTessellator()->Tessellate(
+      path_.GetFillType(), path_.CreatePolyline(transform.GetMaxBasisLength()),
+      [&vertices, &indices, &transform, base](
+          const float* tessellated_vertices, size_t vertices_count,
+          const uint16_t* tessellated_indices, size_t indices_count) {
+        for (auto i = 0u; i < vertices_count; i += 2) {
+          vertices.push_back(transform * Point(tessellated_vertices[i],
+                                               tessellated_vertices[i + 1]));
+        }
+        for (auto i = 0u; i < indices_count; i++) {
+          indices.push_back(
+              static_cast<uint16_t>(base + tessellated_indices[i]));
+        }
+        return true;
+      });
+  return tesselation_result == Tessellator::Result::kSuccess;
+}
+
 GeometryVertexType FillPathGeometry::GetVertexType() const {
   return GeometryVertexType::kPosition;
 }
@@ -215,13 +254,16 @@ Join StrokePathGeometry::GetStrokeJoin() const {
   return stroke_join_;
 }
 
-// static
-Scalar StrokePathGeometry::CreateBevelAndGetDirection(
-    VertexBufferBuilder<SolidFillVertexShader::PerVertexData>& vtx_builder,
-    const Point& position,
-    const Point& start_offset,
-    const Point& end_offset) {
-  SolidFillVertexShader::PerVertexData vtx;
+namespace {
+
+using VS = SolidFillVertexShader;
+using VertexBuilder = VertexBufferBuilder<VS::PerVertexData>;
+
+Scalar CreateBevelAndGetDirection(VertexBuilder& vtx_builder,
+                                  const Point& position,
+                                  const Point& start_offset,
+                                  const Point& end_offset) {
+  VS::PerVertexData vtx;
   vtx.position = position;
   vtx_builder.AppendVertex(vtx);
 
@@ -234,200 +276,255 @@ Scalar StrokePathGeometry::CreateBevelAndGetDirection(
   return dir;
 }
 
-// static
-StrokePathGeometry::JoinProc StrokePathGeometry::GetJoinProc(Join stroke_join) {
-  using VS = SolidFillVertexShader;
-  StrokePathGeometry::JoinProc join_proc;
-  switch (stroke_join) {
-    case Join::kBevel:
-      join_proc = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                     const Point& position, const Point& start_offset,
-                     const Point& end_offset, Scalar miter_limit,
+// The joins and caps are resolved at compile time by
+// `GenerateStrokeVertices` so that they can be inlined into the loop over
+// the polyline. `GetReservedVertexCount` is the number of vertices reserved
+// for each of them up front, given the number of vertices appended for a
+// quarter circle.
+
+struct BevelJoin {
+  static size_t GetReservedVertexCount(size_t arc_vertex_count) { return 3u; }
+
+  static void Append(VertexBuilder& vtx_builder,
+                     const Point& position,
+                     const Point& start_offset,
+                     const Point& end_offset,
+                     Scalar miter_limit,
                      Scalar scale) {
-        CreateBevelAndGetDirection(vtx_builder, position, start_offset,
-                                   end_offset);
-      };
-      break;
-    case Join::kMiter:
-      join_proc = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                     const Point& position, const Point& start_offset,
-                     const Point& end_offset, Scalar miter_limit,
+    CreateBevelAndGetDirection(vtx_builder, position, start_offset,
+                               end_offset);
+  }
+};
+
+struct MiterJoin {
+  static size_t GetReservedVertexCount(size_t arc_vertex_count) { return 4u; }
+
+  static void Append(VertexBuilder& vtx_builder,
+                     const Point& position,
+                     const Point& start_offset,
+                     const Point& end_offset,
+                     Scalar miter_limit,
                      Scalar scale) {
-        Point start_normal = start_offset.Normalize();
-        Point end_normal = end_offset.Normalize();
+    Point start_normal = start_offset.Normalize();
+    Point end_normal = end_offset.Normalize();
 
-        // 1 for no joint (straight line), 0 for max joint (180 degrees).
-        Scalar alignment = (start_normal.Dot(end_normal) + 1) / 2;
-        if (ScalarNearlyEqual(alignment, 1)) {
-          return;
-        }
+    // 1 for no joint (straight line), 0 for max joint (180 degrees).
+    Scalar alignment = (start_normal.Dot(end_normal) + 1) / 2;
+    if (ScalarNearlyEqual(alignment, 1)) {
+      return;
+    }
 
-        Scalar dir = CreateBevelAndGetDirection(vtx_builder, position,
-                                                start_offset, end_offset);
+    Scalar dir = CreateBevelAndGetDirection(vtx_builder, position,
+                                            start_offset, end_offset);
 
-        Point miter_point = (start_offset + end_offset) / 2 / alignment;
-        if (miter_point.GetDistanceSquared({0, 0}) >
-            miter_limit * miter_limit) {
-          return;  // Convert to bevel when we exceed the miter limit.
-        }
+    Point miter_point = (start_offset + end_offset) / 2 / alignment;
+    if (miter_point.GetDistanceSquared({0, 0}) > miter_limit * miter_limit) {
+      return;  // Convert to bevel when we exceed the miter limit.
+    }
 
-        // Outer miter point.
-        VS::PerVertexData vtx;
-        vtx.position = position + miter_point * dir;
-        vtx_builder.AppendVertex(vtx);
-      };
-      break;
-    case Join::kRound:
-      join_proc = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                     const Point& position, const Point& start_offset,
-                     const Point& end_offset, Scalar miter_limit,
+    // Outer miter point.
+    VS::PerVertexData vtx;
+    vtx.position = position + miter_point * dir;
+    vtx_builder.AppendVertex(vtx);
+  }
+};
+
+struct RoundJoin {
+  // The length of the arc depends on the angle between the lines, which is
+  // only known once the offsets are computed. Only the bevel is reserved.
+  static size_t GetReservedVertexCount(size_t arc_vertex_count) { return 3u; }
+
+  static void Append(VertexBuilder& vtx_builder,
+                     const Point& position,
+                     const Point& start_offset,
+                     const Point& end_offset,
+                     Scalar miter_limit,
                      Scalar scale) {
-        Point start_normal = start_offset.Normalize();
-        Point end_normal = end_offset.Normalize();
+    Point start_normal = start_offset.Normalize();
+    Point end_normal = end_offset.Normalize();
 
-        // 0 for no joint (straight line), 1 for max joint (180 degrees).
-        Scalar alignment = 1 - (start_normal.Dot(end_normal) + 1) / 2;
-        if (ScalarNearlyEqual(alignment, 0)) {
-          return;
-        }
+    // 0 for no joint (straight line), 1 for max joint (180 degrees).
+    Scalar alignment = 1 - (start_normal.Dot(end_normal) + 1) / 2;
+    if (ScalarNearlyEqual(alignment, 0)) {
+      return;
+    }
 
-        Scalar dir = CreateBevelAndGetDirection(vtx_builder, position,
-                                                start_offset, end_offset);
-
-        Point middle =
-            (start_offset + end_offset).Normalize() * start_offset.GetLength();
-        Point middle_normal = middle.Normalize();
-
-        Point middle_handle = middle + Point(-middle.y, middle.x) *
-                                           PathBuilder::kArcApproximationMagic *
-                                           alignment * dir;
-        Point start_handle =
-            start_offset + Point(start_offset.y, -start_offset.x) *
-                               PathBuilder::kArcApproximationMagic * alignment *
-                               dir;
-
-        auto arc_points = CubicPathComponent(start_offset, start_handle,
-                                             middle_handle, middle)
-                              .CreatePolyline(scale);
-
-        VS::PerVertexData vtx;
-        for (const auto& point : arc_points) {
-          vtx.position = position + point * dir;
-          vtx_builder.AppendVertex(vtx);
-          vtx.position = position + (-point * dir).Reflect(middle_normal);
-          vtx_builder.AppendVertex(vtx);
-        }
-      };
-      break;
-  }
-  return join_proc;
-}
+    Scalar dir = CreateBevelAndGetDirection(vtx_builder, position,
+                                            start_offset, end_offset);
 
-// static
-StrokePathGeometry::CapProc StrokePathGeometry::GetCapProc(Cap stroke_cap) {
-  using VS = SolidFillVertexShader;
-  StrokePathGeometry::CapProc cap_proc;
-  switch (stroke_cap) {
-    case Cap::kButt:
-      cap_proc = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                    const Point& position, const Point& offset, Scalar scale,
-                    bool reverse) {
-        Point orientation = offset * (reverse ? -1 : 1);
-        VS::PerVertexData vtx;
-        vtx.position = position + orientation;
-        vtx_builder.AppendVertex(vtx);
-        vtx.position = position - orientation;
-        vtx_builder.AppendVertex(vtx);
-      };
-      break;
-    case Cap::kRound:
-      cap_proc = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                    const Point& position, const Point& offset, Scalar scale,
-                    bool reverse) {
-        Point orientation = offset * (reverse ? -1 : 1);
-
-        VS::PerVertexData vtx;
-
-        Point forward(offset.y, -offset.x);
-        Point forward_normal = forward.Normalize();
-
-        CubicPathComponent arc;
-        if (reverse) {
-          arc = CubicPathComponent(
-              forward,
-              forward + orientation * PathBuilder::kArcApproximationMagic,
-              orientation + forward * PathBuilder::kArcApproximationMagic,
-              orientation);
-        } else {
-          arc = CubicPathComponent(
-              orientation,
-              orientation + forward * PathBuilder::kArcApproximationMagic,
-              forward + orientation * PathBuilder::kArcApproximationMagic,
-              forward);
-        }
+    Point middle =
+        (start_offset + end_offset).Normalize() * start_offset.GetLength();
+    Point middle_normal = middle.Normalize();
 
-        vtx.position = position + orientation;
-        vtx_builder.AppendVertex(vtx);
-        vtx.position = position - orientation;
-        vtx_builder.AppendVertex(vtx);
-        for (const auto& point : arc.CreatePolyline(scale)) {
-          vtx.position = position + point;
-          vtx_builder.AppendVertex(vtx);
-          vtx.position = position + (-point).Reflect(forward_normal);
-          vtx_builder.AppendVertex(vtx);
-        }
-      };
-      break;
-    case Cap::kSquare:
-      cap_proc = [](VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                    const Point& position, const Point& offset, Scalar scale,
-                    bool reverse) {
-        Point orientation = offset * (reverse ? -1 : 1);
+    Point middle_handle = middle + Point(-middle.y, middle.x) *
+                                       PathBuilder::kArcApproximationMagic *
+                                       alignment * dir;
+    Point start_handle =
+        start_offset + Point(start_offset.y, -start_offset.x) *
+                           PathBuilder::kArcApproximationMagic * alignment *
+                           dir;
 
-        VS::PerVertexData vtx;
+    auto arc_points =
+        CubicPathComponent(start_offset, start_handle, middle_handle, middle)
+            .CreatePolyline(scale);
 
-        Point forward(offset.y, -offset.x);
+    VS::PerVertexData vtx;
+    for (const auto& point : arc_points) {
+      vtx.position = position + point * dir;
+      vtx_builder.AppendVertex(vtx);
+      vtx.position = position + (-point * dir).Reflect(middle_normal);
+      vtx_builder.AppendVertex(vtx);
+    }
+  }
+};
+
+struct ButtCap {
+  static size_t GetReservedVertexCount(size_t arc_vertex_count) { return 2u; }
+
+  static void Append(VertexBuilder& vtx_builder,
+                     const Point& position,
+                     const Point& offset,
+                     Scalar scale,
+                     bool reverse) {
+    Point orientation = offset * (reverse ? -1 : 1);
+    VS::PerVertexData vtx;
+    vtx.position = position + orientation;
+    vtx_builder.AppendVertex(vtx);
+    vtx.position = position - orientation;
+    vtx_builder.AppendVertex(vtx);
+  }
+};
 
-        vtx.position = position + orientation;
-        vtx_builder.AppendVertex(vtx);
-        vtx.position = position - orientation;
-        vtx_builder.AppendVertex(vtx);
-        vtx.position = position + orientation + forward;
-        vtx_builder.AppendVertex(vtx);
-        vtx.position = position - orientation + forward;
-        vtx_builder.AppendVertex(vtx);
-      };
-      break;
+struct RoundCap {
+  static size_t GetReservedVertexCount(size_t arc_vertex_count) {
+    return 2u + arc_vertex_count;
   }
-  return cap_proc;
-}
 
-// static
-VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
-StrokePathGeometry::CreateSolidStrokeVertices(
-    const Path& path,
-    Scalar stroke_width,
-    Scalar scaled_miter_limit,
-    const StrokePathGeometry::JoinProc& join_proc,
-    const StrokePathGeometry::CapProc& cap_proc,
-    Scalar scale) {
-  VertexBufferBuilder<VS::PerVertexData> vtx_builder;
-  auto polyline = path.CreatePolyline(scale);
+  static void Append(VertexBuilder& vtx_builder,
+                     const Point& position,
+                     const Point& offset,
+                     Scalar scale,
+                     bool reverse) {
+    Point orientation = offset * (reverse ? -1 : 1);
 
-  VS::PerVertexData vtx;
+    VS::PerVertexData vtx;
 
-  // Offset state.
-  Point offset;
-  Point previous_offset;  // Used for computing joins.
+    Point forward(offset.y, -offset.x);
+    Point forward_normal = forward.Normalize();
 
-  auto compute_offset = [&polyline, &offset, &previous_offset,
-                         &stroke_width](size_t point_i) {
-    previous_offset = offset;
-    Point direction =
-        (polyline.points[point_i] - polyline.points[point_i - 1]).Normalize();
-    offset = Vector2{-direction.y, direction.x} * stroke_width * 0.5;
-  };
+    CubicPathComponent arc;
+    if (reverse) {
+      arc = CubicPathComponent(
+          forward, forward + orientation * PathBuilder::kArcApproximationMagic,
+          orientation + forward * PathBuilder::kArcApproximationMagic,
+          orientation);
+    } else {
+      arc = CubicPathComponent(
+          orientation,
+          orientation + forward * PathBuilder::kArcApproximationMagic,
+          forward + orientation * PathBuilder::kArcApproximationMagic, forward);
+    }
 
+    vtx.position = position + orientation;
+    vtx_builder.AppendVertex(vtx);
+    vtx.position = position - orientation;
+    vtx_builder.AppendVertex(vtx);
+    for (const auto& point : arc.CreatePolyline(scale)) {
+      vtx.position = position + point;
+      vtx_builder.AppendVertex(vtx);
+      vtx.position = position + (-point).Reflect(forward_normal);
+      vtx_builder.AppendVertex(vtx);
+    }
+  }
+};
+
+struct SquareCap {
+  static size_t GetReservedVertexCount(size_t arc_vertex_count) { return 4u; }
+
+  static void Append(VertexBuilder& vtx_builder,
+                     const Point& position,
+                     const Point& offset,
+                     Scalar scale,
+                     bool reverse) {
+    Point orientation = offset * (reverse ? -1 : 1);
+
+    VS::PerVertexData vtx;
+
+    Point forward(offset.y, -offset.x);
+
+    vtx.position = position + orientation;
+    vtx_builder.AppendVertex(vtx);
+    vtx.position = position - orientation;
+    vtx_builder.AppendVertex(vtx);
+    vtx.position = position + orientation + forward;
+    vtx_builder.AppendVertex(vtx);
+    vtx.position = position - orientation + forward;
+    vtx_builder.AppendVertex(vtx);
+  }
+};
+
+/// The number of vertices appended for the polyline of a quarter circle with
+/// the radius of the stroke.
+size_t GetArcVertexCount(Scalar stroke_width, Scalar scale) {
+  const Scalar radius = stroke_width * 0.5f;
+  const Scalar handle = radius * PathBuilder::kArcApproximationMagic;
+  return CubicPathComponent({radius, 0}, {radius, handle}, {handle, radius},
+                            {0, radius})
+             .CreatePolyline(scale)
+             .size() *
+         2u;
+}
+
+template <class JoinT, class CapT>
+size_t GetReservedStrokeVertexCount(const Path::Polyline& polyline,
+                                    size_t arc_vertex_count) {
+  const size_t join_count = JoinT::GetReservedVertexCount(arc_vertex_count);
+  const size_t cap_count = CapT::GetReservedVertexCount(arc_vertex_count);
+  size_t vertex_count = 0u;
+  for (size_t contour_i = 0; contour_i < polyline.contours.size();
+       contour_i++) {
+    auto [start_i, end_i] = polyline.GetContourPointBounds(contour_i);
+    const size_t point_count = end_i - start_i;
+    if (point_count == 0u) {
+      continue;
+    }
+    if (point_count == 1u) {
+      vertex_count += cap_count * 2u;
+      continue;
+    }
+    // The vertices that pick up the pen from the previous contour, the line
+    // rects, and the joins between them.
+    vertex_count += (contour_i > 0 ? 4u : 0u) + (point_count - 1u) * 4u +
+                    (point_count - 2u) * join_count;
+    vertex_count += polyline.contours[contour_i].is_closed ? join_count
+                                                           : cap_count * 2u;
+  }
+  return vertex_count;
+}
+
+template <class JoinT, class CapT>
+VertexBuilder GenerateStrokeVertices(const Path::Polyline& polyline,
+                                     Scalar stroke_width,
+                                     Scalar scaled_miter_limit,
+                                     Scalar scale) {
+  VertexBuilder vtx_builder;
+  vtx_builder.Reserve(GetReservedStrokeVertexCount<JoinT, CapT>(
+      polyline, std::is_same_v<CapT, RoundCap>
+                    ? GetArcVertexCount(stroke_width, scale)
+                    : 0u));
+
+  // The offset of each line is computed up front in a loop of its own, which
+  // the compiler can vectorize. `offsets[i]` is the offset of the line ending
+  // at `polyline.points[i]`. The offsets of lines that would connect two
+  // contours are never read.
+  const auto& points = polyline.points;
+  std::vector<Point> offsets(points.size());
+  for (size_t point_i = 1; point_i < points.size(); point_i++) {
+    Point direction = (points[point_i] - points[point_i - 1]).Normalize();
+    offsets[point_i] = Vector2{-direction.y, direction.x} * stroke_width * 0.5;
+  }
+
+  VS::PerVertexData vtx;
   for (size_t contour_i = 0; contour_i < polyline.contours.size();
        contour_i++) {
     auto contour = polyline.contours[contour_i];
@@ -437,9 +534,9 @@ StrokePathGeometry::CreateSolidStrokeVertices(
 
     switch (contour_end_point_i - contour_start_point_i) {
       case 1: {
-        Point p = polyline.points[contour_start_point_i];
-        cap_proc(vtx_builder, p, {-stroke_width * 0.5f, 0}, scale, false);
-        cap_proc(vtx_builder, p, {stroke_width * 0.5f, 0}, scale, false);
+        Point p = points[contour_start_point_i];
+        CapT::Append(vtx_builder, p, {-stroke_width * 0.5f, 0}, scale, false);
+        CapT::Append(vtx_builder, p, {stroke_width * 0.5f, 0}, scale, false);
         continue;
       }
       case 0:
@@ -449,8 +546,7 @@ StrokePathGeometry::CreateSolidStrokeVertices(
     }
 
     // The first point's offset is always the same as the second point.
-    compute_offset(contour_start_point_i + 1);
-    const Point contour_first_offset = offset;
+    const Point contour_first_offset = offsets[contour_start_point_i + 1];
 
     if (contour_i > 0) {
       // This branch only executes when we've just finished drawing a contour
@@ -460,14 +556,14 @@ StrokePathGeometry::CreateSolidStrokeVertices(
       // vertices at the start of the new contour (thus connecting the two
       // contours with two zero volume triangles, which will be discarded by
       // the rasterizer).
-      vtx.position = polyline.points[contour_start_point_i - 1];
+      vtx.position = points[contour_start_point_i - 1];
       // Append two vertices when "picking up" the pen so that the triangle
       // drawn when moving to the beginning of the new contour will have zero
       // volume.
       vtx_builder.AppendVertex(vtx);
       vtx_builder.AppendVertex(vtx);
 
-      vtx.position = polyline.points[contour_start_point_i];
+      vtx.position = points[contour_start_point_i];
       // Append two vertices at the beginning of the new contour, which
       // appends  two triangles of zero area.
       vtx_builder.AppendVertex(vtx);
@@ -475,52 +571,198 @@ StrokePathGeometry::CreateSolidStrokeVertices(
     }
 
     // Generate start cap.
-    if (!polyline.contours[contour_i].is_closed) {
+    if (!contour.is_closed) {
       auto cap_offset =
           Vector2(-contour.start_direction.y, contour.start_direction.x) *
           stroke_width * 0.5;  // Counterclockwise normal
-      cap_proc(vtx_builder, polyline.points[contour_start_point_i], cap_offset,
-               scale, true);
+      CapT::Append(vtx_builder, points[contour_start_point_i], cap_offset,
+                   scale, true);
     }
 
     // Generate contour geometry.
     for (size_t point_i = contour_start_point_i + 1;
          point_i < contour_end_point_i; point_i++) {
+      const Point& offset = offsets[point_i];
+
       // Generate line rect.
-      vtx.position = polyline.points[point_i - 1] + offset;
+      vtx.position = points[point_i - 1] + offset;
       vtx_builder.AppendVertex(vtx);
-      vtx.position = polyline.points[point_i - 1] - offset;
+      vtx.position = points[point_i - 1] - offset;
       vtx_builder.AppendVertex(vtx);
-      vtx.position = polyline.points[point_i] + offset;
+      vtx.position = points[point_i] + offset;
       vtx_builder.AppendVertex(vtx);
-      vtx.position = polyline.points[point_i] - offset;
+      vtx.position = points[point_i] - offset;
       vtx_builder.AppendVertex(vtx);
 
       if (point_i < contour_end_point_i - 1) {
-        compute_offset(point_i + 1);
-
         // Generate join from the current line to the next line.
-        join_proc(vtx_builder, polyline.points[point_i], previous_offset,
-                  offset, scaled_miter_limit, scale);
+        JoinT::Append(vtx_builder, points[point_i], offset,
+                      offsets[point_i + 1], scaled_miter_limit, scale);
       }
     }
 
     // Generate end cap or join.
-    if (!polyline.contours[contour_i].is_closed) {
+    if (!contour.is_closed) {
       auto cap_offset =
           Vector2(-contour.end_direction.y, contour.end_direction.x) *
           stroke_width * 0.5;  // Clockwise normal
-      cap_proc(vtx_builder, polyline.points[contour_end_point_i - 1],
-               cap_offset, scale, false);
+      CapT::Append(vtx_builder, points[contour_end_point_i - 1], cap_offset,
+                   scale, false);
     } else {
-      join_proc(vtx_builder, polyline.points[contour_start_point_i], offset,
-                contour_first_offset, scaled_miter_limit, scale);
+      JoinT::Append(vtx_builder, points[contour_start_point_i],
+                    offsets[contour_end_point_i - 1], contour_first_offset,
+                    scaled_miter_limit, scale);
     }
   }
 
   return vtx_builder;
 }
 
+template <class JoinT>
+VertexBuilder GenerateStrokeVertices(const Path::Polyline& polyline,
+                                     Scalar stroke_width,
+                                     Scalar scaled_miter_limit,
+                                     Cap stroke_cap,
+                                     Scalar scale) {
+  switch (stroke_cap) {
+    case Cap::kButt:
+      return GenerateStrokeVertices<JoinT, ButtCap>(
+          polyline, stroke_width, scaled_miter_limit, scale);
+    case Cap::kRound:
+      return GenerateStrokeVertices<JoinT, RoundCap>(
+          polyline, stroke_width, scaled_miter_limit, scale);
+    case Cap::kSquare:
+      return GenerateStrokeVertices<JoinT, SquareCap>(
+          polyline, stroke_width, scaled_miter_limit, scale);
+  }
+  FML_UNREACHABLE();
+}
+
+}  // namespace
+
+// static
+VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
+StrokePathGeometry::CreateSolidStrokeVertices(const Path& path,
+                                              Scalar stroke_width,
+                                              Scalar scaled_miter_limit,
+                                              Cap stroke_cap,
+                                              Join stroke_join,
+                                              Scalar scale) {
+  auto polyline = path.CreatePolyline(scale);
+  switch (stroke_join) {
+    case Join::kBevel:
+      return GenerateStrokeVertices<BevelJoin>(
+          polyline, stroke_width, scaled_miter_limit, stroke_cap, scale);
+    case Join::kMiter:
+      return GenerateStrokeVertices<MiterJoin>(
+          polyline, stroke_width, scaled_miter_limit, stroke_cap, scale);
+    case Join::kRound:
+      return GenerateStrokeVertices<RoundJoin>(
+          polyline, stroke_width, scaled_miter_limit, stroke_cap, scale);
+  }
+  FML_UNREACHABLE();
+}
+
+bool StrokePathGeometry::UsesComputeTessellation(
+    const ContentContext& renderer) const {
+#if IMPELLER_ENABLE_COMPUTE
+  if (!renderer.IsComputeTessellationEnabled() ||
+      !renderer.GetDeviceCapabilities().SupportsCompute()) {
+    return false;
+  }
+  if (stroke_cap_ != Cap::kButt || stroke_join_ != Join::kBevel) {
+    return false;
+  }
+  auto contour_count = path_.GetComponentCount(Path::ComponentType::kContour);
+  if (contour_count > 1u || path_.GetComponentCount() - contour_count <
+                                kMinComputeTessellationComponentCount) {
+    return false;
+  }
+  // The vertex buffer is sized by estimating how many lines each curve is
+  // flattened to, which is exceeded by large or scaled up curves.
+  if (path_.GetComponentCount(Path::ComponentType::kQuadratic) > 0u ||
+      path_.GetComponentCount(Path::ComponentType::kCubic) > 0u) {
+    return false;
+  }
+  return ComputeTessellator::ComputeStrokeVertexCount(path_) > 0u;
+#else
+  return false;
+#endif  // IMPELLER_ENABLE_COMPUTE
+}
+
+std::optional<GeometryResult> StrokePathGeometry::GetComputePositionBuffer(
+    const ContentContext& renderer,
+    const Entity& entity,
+    RenderPass& pass,
+    Scalar stroke_width) const {
+#if IMPELLER_ENABLE_COMPUTE
+  TRACE_EVENT0("impeller", "StrokePathGeometry::GetComputePositionBuffer");
+  auto context = renderer.GetContext();
+  auto vertex_count = ComputeTessellator::ComputeStrokeVertexCount(path_);
+
+  DeviceBufferDescriptor vertex_buffer_desc;
+  vertex_buffer_desc.storage_mode = StorageMode::kDevicePrivate;
+  vertex_buffer_desc.size = vertex_count * sizeof(VS::PerVertexData);
+  auto vertex_buffer =
+      context->GetResourceAllocator()->CreateBuffer(vertex_buffer_desc);
+
+  DeviceBufferDescriptor vertex_count_desc;
+  vertex_count_desc.storage_mode = StorageMode::kDevicePrivate;
+  vertex_count_desc.size = sizeof(uint32_t);
+  auto vertex_count_buffer =
+      context->GetResourceAllocator()->CreateBuffer(vertex_count_desc);
+  if (!vertex_buffer || !vertex_count_buffer) {
+    return std::nullopt;
+  }
+  vertex_buffer->SetLabel("Compute Stroke Vertices");
+  vertex_count_buffer->SetLabel("Compute Stroke Vertex Count");
+
+  // Curves are flattened as finely as on the CPU, for the scale the path is
+  // drawn at.
+  const auto tolerance =
+      kDefaultCurveTolerance / entity.GetTransformation().GetMaxBasisLength();
+
+  // The tessellation is submitted before the render pass that draws it, so
+  // the vertices are consumed on the GPU without being read back.
+  auto status = ComputeTessellator{}
+                    .SetStyle(ComputeTessellator::Style::kStroke)
+                    .SetStrokeWidth(stroke_width)
+                    .SetStrokeCap(stroke_cap_)
+                    .SetStrokeJoin(stroke_join_)
+                    .SetMiterLimit(miter_limit_)
+                    .SetCubicAccuracy(tolerance)
+                    .SetQuadraticTolerance(tolerance)
+                    .Tessellate(path_, context, vertex_buffer->AsBufferView(),
+                                vertex_count_buffer->AsBufferView());
+  if (status != ComputeTessellator::Status::kOk) {
+    return std::nullopt;
+  }
+
+  // The vertex buffer is padded with degenerate triangles past the end of the
+  // stroke, so all of it is drawn.
+  std::vector<uint16_t> indices(vertex_count);
+  std::iota(indices.begin(), indices.end(), 0u);
+  auto& host_buffer = pass.GetTransientsBuffer();
+  return GeometryResult{
+      .type = PrimitiveType::kTriangleStrip,
+      .vertex_buffer =
+          {
+              .vertex_buffer = vertex_buffer->AsBufferView(),
+              .index_buffer = host_buffer.Emplace(
+                  indices.data(), indices.size() * sizeof(uint16_t),
+                  alignof(uint16_t)),
+              .index_count = indices.size(),
+              .index_type = IndexType::k16bit,
+          },
+      .transform = Matrix::MakeOrthographic(pass.GetRenderTargetSize()) *
+                   entity.GetTransformation(),
+      .prevent_overdraw = true,
+  };
+#else
+  return std::nullopt;
+#endif  // IMPELLER_ENABLE_COMPUTE
+}
+
 GeometryResult StrokePathGeometry::GetPositionBuffer(
     const ContentContext& renderer,
     const Entity& entity,
@@ -536,11 +778,18 @@ GeometryResult StrokePathGeometry::GetPositionBuffer(
   Scalar min_size = 1.0f / sqrt(std::abs(determinant));
   Scalar stroke_width = std::max(stroke_width_, min_size);
 
+  if (UsesComputeTessellation(renderer)) {
+    if (auto result =
+            GetComputePositionBuffer(renderer, entity, pass, stroke_width);
+        result.has_value()) {
+      return result.value();
+    }
+  }
+
   auto& host_buffer = pass.GetTransientsBuffer();
   auto vertex_builder = CreateSolidStrokeVertices(
-      path_, stroke_width, miter_limit_ * stroke_width_ * 0.5,
-      GetJoinProc(stroke_join_), GetCapProc(stroke_cap_),
-      entity.GetTransformation().GetMaxBasisLength());
+      path_, stroke_width, miter_limit_ * stroke_width_ * 0.5, stroke_cap_,
+      stroke_join_, entity.GetTransformation().GetMaxBasisLength());
 
   return GeometryResult{
       .type = PrimitiveType::kTriangleStrip,
@@ -570,11 +819,11 @@ GeometryResult StrokePathGeometry::GetPositionUVBuffer(
 
   auto& host_buffer = pass.GetTransientsBuffer();
   auto stroke_builder = CreateSolidStrokeVertices(
-      path_, stroke_width, miter_limit_ * stroke_width_ * 0.5,
-      GetJoinProc(stroke_join_), GetCapProc(stroke_cap_),
-      entity.GetTransformation().GetMaxBasisLength());
+      path_, stroke_width, miter_limit_ * stroke_width_ * 0.5, stroke_cap_,
+      stroke_join_, entity.GetTransformation().GetMaxBasisLength());
 
   VertexBufferBuilder<TextureFillVertexShader::PerVertexData> vertex_builder;
+  vertex_builder.Reserve(stroke_builder.GetVertexCount());
   stroke_builder.IterateVertices(
       [&vertex_builder, &texture_coverage,
        &effect_transform](SolidFillVertexShader::PerVertexData old_vtx) {
@@ -714,6 +963,22 @@ GeometryResult RectGeometry::GetPositionUVBuffer(Rect texture_coverage,
                                   renderer, entity, pass);
 }
 
+// |Geometry|
+bool RectGeometry::AppendTriangles(const ContentContext& renderer,
+                                   const Matrix& transform,
+                                   std::vector<Point>& vertices,
+                                   std::vector<uint16_t>& indices) const {
+  const auto base = static_cast<uint16_t>(vertices.size());
+  for (const auto& point : rect_.GetTransformedPoints(transform)) {
+    vertices.push_back(point);
+  }
+  // The points are in triangle strip order.
+  for (auto index : {0, 1, 2, 2, 1, 3}) {
+    indices.push_back(static_cast<uint16_t>(base + index));
+  }
+  return true;
+}
+
 GeometryVertexType RectGeometry::GetVertexType() const {
   return GeometryVertexType::kPosition;
 }
@@ -742,7 +1007,7 @@ static void AppendRRectCorner(Path::Polyline polyline,
 }
 
 VertexBufferBuilder<Point> RRectGeometry::CreatePositionBuffer(
-    const Entity& entity) const {
+    const Matrix& transform) const {
   VertexBufferBuilder<Point> vtx_builder;
 
   // The rounded rectangle is split into parts:
@@ -761,25 +1026,25 @@ VertexBufferBuilder<Point> RRectGeometry::CreatePositionBuffer(
           .MoveTo({rect_.origin.x, rect_.origin.y + corner_radius_})
           .AddRoundedRectTopLeft(rect_, radii)
           .TakePath()
-          .CreatePolyline(entity.GetTransformation().GetMaxBasisLength());
+          .CreatePolyline(transform.GetMaxBasisLength());
   auto topRight =
       PathBuilder{}
           .MoveTo({right - radii.top_right.x, rect_.origin.y})
           .AddRoundedRectTopRight(rect_, radii)
           .TakePath()
-          .CreatePolyline(entity.GetTransformation().GetMaxBasisLength());
+          .CreatePolyline(transform.GetMaxBasisLength());
   auto bottomLeft =
       PathBuilder{}
           .MoveTo({left + corner_radius_, bottom})
           .AddRoundedRectBottomLeft(rect_, radii)
           .TakePath()
-          .CreatePolyline(entity.GetTransformation().GetMaxBasisLength());
+          .CreatePolyline(transform.GetMaxBasisLength());
   auto bottomRight =
       PathBuilder{}
           .MoveTo({right, bottom - corner_radius_})
           .AddRoundedRectBottomRight(rect_, radii)
           .TakePath()
-          .CreatePolyline(entity.GetTransformation().GetMaxBasisLength());
+          .CreatePolyline(transform.GetMaxBasisLength());
 
   vtx_builder.Reserve(12 * (topLeft.points.size() - 1) + 18);
 
@@ -832,7 +1097,7 @@ VertexBufferBuilder<Point> RRectGeometry::CreatePositionBuffer(
 GeometryResult RRectGeometry::GetPositionBuffer(const ContentContext& renderer,
                                                 const Entity& entity,
                                                 RenderPass& pass) {
-  auto vtx_builder = CreatePositionBuffer(entity);
+  auto vtx_builder = CreatePositionBuffer(entity.GetTransformation());
 
   return GeometryResult{
       .type = PrimitiveType::kTriangle,
@@ -850,7 +1115,7 @@ GeometryResult RRectGeometry::GetPositionUVBuffer(
     const ContentContext& renderer,
     const Entity& entity,
     RenderPass& pass) {
-  auto vtx_builder = CreatePositionBuffer(entity);
+  auto vtx_builder = CreatePositionBuffer(entity.GetTransformation());
 
   VertexBufferBuilder<TextureFillVertexShader::PerVertexData> vertex_builder;
   vtx_builder.IterateVertices(
@@ -873,6 +1138,19 @@ GeometryResult RRectGeometry::GetPositionUVBuffer(
   };
 }
 
+// |Geometry|
+bool RRectGeometry::AppendTriangles(const ContentContext& renderer,
+                                    const Matrix& transform,
+                                    std::vector<Point>& vertices,
+                                    std::vector<uint16_t>& indices) const {
+  auto vtx_builder = CreatePositionBuffer(transform);
+  vtx_builder.IterateVertices([&vertices, &indices, &transform](Point& point) {
+    indices.push_back(static_cast<uint16_t>(vertices.size()));
+    vertices.push_back(transform * point);
+  });
+  return true;
+}
+
 GeometryVertexType RRectGeometry::GetVertexType() const {
   return GeometryVertexType::kPosition;
 }
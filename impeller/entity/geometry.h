@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "impeller/core/allocator.h"
 #include "impeller/core/host_buffer.h"
 #include "impeller/core/vertex_buffer.h"
@@ -67,6 +69,21 @@ class Geometry {
   virtual GeometryVertexType GetVertexType() const = 0;
 
   virtual std::optional<Rect> GetCoverage(const Matrix& transform) const = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Append the triangles of this geometry, with their positions
+  ///             transformed by `transform`, to an indexed triangle list.
+  ///
+  ///             This allows the geometries of several entities to be drawn
+  ///             with a single command. See `SolidFillBatcher`.
+  ///
+  /// @return     Whether the triangles were appended. Geometries that are not
+  ///             drawn as plain triangles append nothing.
+  ///
+  virtual bool AppendTriangles(const ContentContext& renderer,
+                               const Matrix& transform,
+                               std::vector<Point>& vertices,
+                               std::vector<uint16_t>& indices) const;
 };
 
 /// @brief A geometry that is created from a vertices object.
@@ -109,6 +126,12 @@ class FillPathGeometry : public Geometry {
                                      const Entity& entity,
                                      RenderPass& pass) override;
 
+  // |Geometry|
+  bool AppendTriangles(const ContentContext& renderer,
+                       const Matrix& transform,
+                       std::vector<Point>& vertices,
+                       std::vector<uint16_t>& indices) const override;
+
   Path path_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(FillPathGeometry);
@@ -133,23 +156,46 @@ class StrokePathGeometry : public Geometry {
 
   Join GetStrokeJoin() const;
 
+  /// Paths with fewer components are always tessellated on the CPU.
+  static constexpr size_t kMinComputeTessellationComponentCount = 64u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the stroke is tessellated by compute shaders.
+  ///
+  ///             That is only the case when enabled on the content context,
+  ///             supported by the device, and the stroke is a single contour
+  ///             of lines with butt caps and bevel joins, which are the only
+  ///             styles the compute shaders implement. Simple paths are
+  ///             cheaper to tessellate on the CPU than to dispatch, and the
+  ///             number of lines curves are flattened to is not known up
+  ///             front.
+  ///
+  bool UsesComputeTessellation(const ContentContext& renderer) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Generate the triangle strip of a stroke on the CPU.
+  ///
+  /// @param[in]  path                The path to stroke.
+  /// @param[in]  stroke_width        The width of the stroke.
+  /// @param[in]  scaled_miter_limit  The miter limit times half the stroke
+  ///                                 width.
+  /// @param[in]  stroke_cap          The cap of open contours.
+  /// @param[in]  stroke_join         The join between lines.
+  /// @param[in]  scale               The scale the stroke is drawn at, which
+  ///                                 determines how finely curves are
+  ///                                 flattened.
+  ///
+  static VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
+  CreateSolidStrokeVertices(const Path& path,
+                            Scalar stroke_width,
+                            Scalar scaled_miter_limit,
+                            Cap stroke_cap,
+                            Join stroke_join,
+                            Scalar scale);
+
  private:
   using VS = SolidFillVertexShader;
 
-  using CapProc =
-      std::function<void(VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                         const Point& position,
-                         const Point& offset,
-                         Scalar scale,
-                         bool reverse)>;
-  using JoinProc =
-      std::function<void(VertexBufferBuilder<VS::PerVertexData>& vtx_builder,
-                         const Point& position,
-                         const Point& start_offset,
-                         const Point& end_offset,
-                         Scalar miter_limit,
-                         Scalar scale)>;
-
   // |Geometry|
   GeometryResult GetPositionBuffer(const ContentContext& renderer,
                                    const Entity& entity,
@@ -170,23 +216,11 @@ class StrokePathGeometry : public Geometry {
 
   bool SkipRendering() const;
 
-  static Scalar CreateBevelAndGetDirection(
-      VertexBufferBuilder<SolidFillVertexShader::PerVertexData>& vtx_builder,
-      const Point& position,
-      const Point& start_offset,
-      const Point& end_offset);
-
-  static VertexBufferBuilder<SolidFillVertexShader::PerVertexData>
-  CreateSolidStrokeVertices(const Path& path,
-                            Scalar stroke_width,
-                            Scalar scaled_miter_limit,
-                            const JoinProc& join_proc,
-                            const CapProc& cap_proc,
-                            Scalar scale);
-
-  static StrokePathGeometry::JoinProc GetJoinProc(Join stroke_join);
-
-  static StrokePathGeometry::CapProc GetCapProc(Cap stroke_cap);
+  std::optional<GeometryResult> GetComputePositionBuffer(
+      const ContentContext& renderer,
+      const Entity& entity,
+      RenderPass& pass,
+      Scalar stroke_width) const;
 
   Path path_;
   Scalar stroke_width_;
@@ -252,6 +286,12 @@ class RectGeometry : public Geometry {
                                      const Entity& entity,
                                      RenderPass& pass) override;
 
+  // |Geometry|
+  bool AppendTriangles(const ContentContext& renderer,
+                       const Matrix& transform,
+                       std::vector<Point>& vertices,
+                       std::vector<uint16_t>& indices) const override;
+
   Rect rect_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(RectGeometry);
@@ -276,13 +316,20 @@ class RRectGeometry : public Geometry {
                                      const Entity& entity,
                                      RenderPass& pass) override;
 
+  // |Geometry|
+  bool AppendTriangles(const ContentContext& renderer,
+                       const Matrix& transform,
+                       std::vector<Point>& vertices,
+                       std::vector<uint16_t>& indices) const override;
+
   // |Geometry|
   GeometryVertexType GetVertexType() const override;
 
   // |Geometry|
   std::optional<Rect> GetCoverage(const Matrix& transform) const override;
 
-  VertexBufferBuilder<Point> CreatePositionBuffer(const Entity& entity) const;
+  VertexBufferBuilder<Point> CreatePositionBuffer(
+      const Matrix& transform) const;
 
   Rect rect_;
   Scalar corner_radius_;
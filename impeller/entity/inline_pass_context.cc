@@ -18,9 +18,11 @@ InlinePassContext::InlinePassContext(
     std::shared_ptr<Context> context,
     EntityPassTarget& pass_target,
     uint32_t pass_texture_reads,
+    std::shared_ptr<HostBuffer> transients_buffer,
     std::optional<RenderPassResult> collapsed_parent_pass)
     : context_(std::move(context)),
       pass_target_(pass_target),
+      transients_buffer_(std::move(transients_buffer)),
       total_pass_reads_(pass_texture_reads),
       is_collapsed_(collapsed_parent_pass.has_value()) {
   if (collapsed_parent_pass.has_value()) {
@@ -58,7 +60,12 @@ bool InlinePassContext::EndPass() {
     return false;
   }
 
-  if (!command_buffer_->SubmitCommands()) {
+  // The device may still read the transient data of the pass after the
+  // frame ends.
+  auto fence =
+      transients_buffer_ ? transients_buffer_->GetFrameFence() : nullptr;
+  if (!command_buffer_->SubmitCommands(
+          [fence = std::move(fence)](CommandBuffer::Status) {})) {
     return false;
   }
 
@@ -97,6 +104,7 @@ InlinePassContext::RenderPassResult InlinePassContext::GetRenderPass(
   command_buffer_->SetLabel(
       "EntityPass Command Buffer: Depth=" + std::to_string(pass_depth) +
       " Count=" + std::to_string(pass_count_));
+  pass_->SetTransientsBuffer(transients_buffer_);
 
   RenderPassResult result;
 
@@ -143,6 +151,15 @@ InlinePassContext::RenderPassResult InlinePassContext::GetRenderPass(
                               : StoreAction::kStore;
   pass_target_.target_.SetStencilAttachment(stencil.value());
 
+  // The depth shares its texture with the stencil, and is loaded and stored
+  // along with it.
+  if (auto depth = pass_target_.GetRenderTarget().GetDepthAttachment();
+      depth.has_value()) {
+    depth->load_action = stencil->load_action;
+    depth->store_action = stencil->store_action;
+    pass_target_.target_.SetDepthAttachment(depth);
+  }
+
   pass_target_.target_.SetColorAttachment(color0, 0);
 
   pass_ = command_buffer_->CreateRenderPass(pass_target_.GetRenderTarget());
@@ -154,6 +171,7 @@ InlinePassContext::RenderPassResult InlinePassContext::GetRenderPass(
   pass_->SetLabel(
       "EntityPass Render Pass: Depth=" + std::to_string(pass_depth) +
       " Count=" + std::to_string(pass_count_));
+  pass_->SetTransientsBuffer(transients_buffer_);
 
   result.pass = pass_;
 
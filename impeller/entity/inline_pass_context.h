@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "impeller/core/host_buffer.h"
 #include "impeller/entity/entity_pass_target.h"
 #include "impeller/renderer/context.h"
 #include "impeller/renderer/render_pass.h"
@@ -23,6 +24,7 @@ class InlinePassContext {
       std::shared_ptr<Context> context,
       EntityPassTarget& pass_target,
       uint32_t pass_texture_reads,
+      std::shared_ptr<HostBuffer> transients_buffer = nullptr,
       std::optional<RenderPassResult> collapsed_parent_pass = std::nullopt);
   ~InlinePassContext();
 
@@ -38,6 +40,7 @@ class InlinePassContext {
  private:
   std::shared_ptr<Context> context_;
   EntityPassTarget& pass_target_;
+  std::shared_ptr<HostBuffer> transients_buffer_;
   std::shared_ptr<CommandBuffer> command_buffer_;
   std::shared_ptr<RenderPass> pass_;
   uint32_t pass_count_ = 0;
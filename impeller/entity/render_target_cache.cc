@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/render_target_cache.h"
+
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+#include "impeller/core/texture.h"
+
+namespace impeller {
+
+RenderTargetCache::RenderTargetCache(std::shared_ptr<Allocator> allocator)
+    : RenderTargetAllocator(std::move(allocator)) {}
+
+RenderTargetCache::~RenderTargetCache() = default;
+
+std::shared_ptr<Texture> RenderTargetCache::CreateTexture(
+    const TextureDescriptor& desc) {
+  // Without a frame there is no telling when the texture is done with.
+  if (frame_depth_ == 0u) {
+    return RenderTargetAllocator::CreateTexture(desc);
+  }
+
+  for (auto& data : textures_) {
+    // A texture is never handed out twice in a frame, and never while it is
+    // still referenced from outside of the cache.
+    if (data.last_used_frame == frame_ || data.texture.use_count() > 1 ||
+        data.texture->GetTextureDescriptor() != desc) {
+      continue;
+    }
+    data.last_used_frame = frame_;
+    frame_statistics_.reuse_count++;
+    return data.texture;
+  }
+
+  auto texture = RenderTargetAllocator::CreateTexture(desc);
+  if (!texture) {
+    return nullptr;
+  }
+  frame_statistics_.allocation_count++;
+  textures_.push_back({.texture = texture, .last_used_frame = frame_});
+  return texture;
+}
+
+void RenderTargetCache::Start() {
+  if (frame_depth_++ > 0u) {
+    return;
+  }
+  frame_++;
+  frame_statistics_ = {};
+}
+
+void RenderTargetCache::End() {
+  if (frame_depth_ == 0u || --frame_depth_ > 0u) {
+    return;
+  }
+
+  for (auto it = textures_.begin(); it != textures_.end();) {
+    if (frame_ - it->last_used_frame >= kMaxUnusedFrameCount) {
+      it = textures_.erase(it);
+      frame_statistics_.release_count++;
+    } else {
+      ++it;
+    }
+  }
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER(
+      "impeller",                                            //
+      "RenderTargetCache", reinterpret_cast<int64_t>(this),  //
+      "Allocations", frame_statistics_.allocation_count,     //
+      "Reuses", frame_statistics_.reuse_count,               //
+      "Releases", frame_statistics_.release_count,           //
+      "CachedTextures", textures_.size());
+#endif  // !FLUTTER_RELEASE
+}
+
+size_t RenderTargetCache::GetCachedTextureCount() const {
+  return textures_.size();
+}
+
+const RenderTargetCache::Statistics& RenderTargetCache::GetFrameStatistics()
+    const {
+  return frame_statistics_;
+}
+
+}  // namespace impeller
@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/renderer/render_target.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A render target allocator that recycles the textures of
+///             offscreen render targets from frame to frame.
+///
+///             A texture is only handed out once per frame. Textures that
+///             were not handed out for `kMaxUnusedFrameCount` frames are
+///             released.
+///
+///             This class is not thread safe.
+///
+class RenderTargetCache final : public RenderTargetAllocator {
+ public:
+  //----------------------------------------------------------------------------
+  /// The number of frames a cached texture may go unused for before it is
+  /// released.
+  ///
+  static constexpr uint64_t kMaxUnusedFrameCount = 3u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counters for the textures of a single frame.
+  ///
+  struct Statistics {
+    /// The number of textures that were allocated.
+    size_t allocation_count = 0u;
+    /// The number of textures that were recycled from previous frames.
+    size_t reuse_count = 0u;
+    /// The number of cached textures that were released.
+    size_t release_count = 0u;
+  };
+
+  explicit RenderTargetCache(std::shared_ptr<Allocator> allocator);
+
+  ~RenderTargetCache() override;
+
+  // |RenderTargetAllocator|
+  std::shared_ptr<Texture> CreateTexture(
+      const TextureDescriptor& desc) override;
+
+  // |RenderTargetAllocator|
+  void Start() override;
+
+  // |RenderTargetAllocator|
+  void End() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of textures kept by the cache.
+  ///
+  size_t GetCachedTextureCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The counters of the last frame that ended, or of the
+  ///             current frame if one is in progress.
+  ///
+  const Statistics& GetFrameStatistics() const;
+
+ private:
+  struct TextureData {
+    std::shared_ptr<Texture> texture;
+    uint64_t last_used_frame = 0u;
+  };
+
+  std::vector<TextureData> textures_;
+  uint64_t frame_ = 0u;
+  size_t frame_depth_ = 0u;
+  Statistics frame_statistics_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RenderTargetCache);
+};
+
+}  // namespace impeller
@@ -4,31 +4,31 @@
 
 // 1D (directional) gaussian blur.
 //
+// The kernel weights are computed host-side, and already reduced to half as
+// many taps by sampling between two texels with a linear filter. The same
+// shader also halves the resolution of the blur input for large blurs.
+//
 // Paths for future optimization:
 //   * Remove the uv bounds multiplier in SampleColor by adding optional
 //     support for SamplerAddressMode::ClampToBorder in the texture sampler.
-//   * Render both blur passes into a smaller texture than the source image
-//     (~1/radius size).
-//   * If doing the small texture render optimization, cache misses can be
-//     reduced in the first pass by sampling the source textures with a mip
-//     level of log2(min_radius).
-
-#include <impeller/constants.glsl>
-#include <impeller/gaussian.glsl>
+
 #include <impeller/texture.glsl>
 #include <impeller/types.glsl>
 
+// The maximum number of taps of a kernel. Must match
+// GaussianBlurKernel::kMaxTapCount.
+#define MAX_TAP_COUNT 32
+
 uniform f16sampler2D texture_sampler;
 
 uniform BlurInfo {
-  f16vec2 blur_uv_offset;
-
-  // The blur sigma and radius have a linear relationship which is defined
-  // host-side, but both are useful controls here. Sigma (pixels per standard
-  // deviation) is used to define the gaussian function itself, whereas the
-  // radius is used to limit how much of the function is integrated.
-  float blur_sigma;
-  float16_t blur_radius;
+  // The texture coordinate offset of one texel along the blur direction.
+  vec2 blur_uv_offset;
+  float tap_count;
+
+  // The offset of each tap, in texels, followed by its weight. The weights
+  // add up to one.
+  vec4 taps[MAX_TAP_COUNT];
 }
 blur_info;
 
@@ -58,24 +58,16 @@ out f16vec4 frag_color;
 
 void main() {
   f16vec4 total_color = f16vec4(0.0hf);
-  float16_t gaussian_integral = 0.0hf;
-
-  for (float16_t i = -blur_info.blur_radius; i <= blur_info.blur_radius;
-       i += 2.0hf) {
-    // Use the 32 bit Gaussian function because the 16 bit variation results in
-    // quality loss/visible banding. Also, 16 bit variation internally breaks
-    // down at a moderately high (but still reasonable) blur sigma of >255 when
-    // computing sigma^2 due to the exponent only having 5 bits.
-    float16_t gaussian = float16_t(IPGaussian(float(i), blur_info.blur_sigma));
-    gaussian_integral += gaussian;
-    total_color +=
-        gaussian * Sample(texture_sampler,  // sampler
-                          v_texture_coords + blur_info.blur_uv_offset *
-                                                 i  // texture coordinates
+
+  for (int i = 0; i < int(blur_info.tap_count); i++) {
+    vec2 offset = blur_info.blur_uv_offset * blur_info.taps[i].x;
+    total_color += float16_t(blur_info.taps[i].y) *
+                   Sample(texture_sampler,           // sampler
+                          v_texture_coords + offset  // texture coordinates
                    );
   }
 
-  frag_color = total_color / gaussian_integral;
+  frag_color = total_color;
 
 #if ENABLE_ALPHA_MASK
   f16vec4 src_color = Sample(alpha_mask_sampler,   // sampler
@@ -8,6 +8,10 @@ uniform sampler2D glyph_atlas_sampler;
 
 uniform FragInfo {
   vec4 text_color;
+  // Scales the sharpness of the anti-aliased edge. Larger values narrow it.
+  float edge_contrast;
+  // Applied to the coverage of the edge. Values below 1 embolden it.
+  float edge_gamma;
 }
 frag_info;
 
@@ -26,10 +30,14 @@ void main() {
   float sample_distance = texture(glyph_atlas_sampler, v_uv).a;
   // Use local automatic gradients to find anti-aliased anisotropic edge width,
   // cf. Gustavson 2012
-  float edge_width = length(vec2(dFdx(sample_distance), dFdy(sample_distance)));
+  float edge_width =
+      length(vec2(dFdx(sample_distance), dFdy(sample_distance))) * 0.7071 /
+      frag_info.edge_contrast;
   // Smooth the glyph edge by interpolating across the boundary in a band with
   // the width determined above
-  float insideness = smoothstep(edge_distance - edge_width,
-                                edge_distance + edge_width, sample_distance);
+  float insideness =
+      pow(smoothstep(edge_distance - edge_width, edge_distance + edge_width,
+                     sample_distance),
+          frag_info.edge_gamma);
   frag_color = frag_info.text_color * insideness;
 }
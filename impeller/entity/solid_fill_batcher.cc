@@ -0,0 +1,182 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/solid_fill_batcher.h"
+
+#include <optional>
+#include <utility>
+
+#include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/geometry.h"
+#include "impeller/renderer/render_pass.h"
+
+namespace impeller {
+
+SolidFillBatcher::SolidFillBatcher(const ContentContext& renderer)
+    : renderer_(renderer) {}
+
+SolidFillBatcher::~SolidFillBatcher() = default;
+
+static std::optional<Contents::SolidFill> GetSolidFill(const Entity& entity) {
+  const auto& contents = entity.GetContents();
+  if (!contents || entity.GetBlendMode() > Entity::kLastPipelineBlendMode ||
+      !entity.GetTransformation().IsAffine()) {
+    return std::nullopt;
+  }
+  auto fill = contents->AsSolidFill();
+  if (!fill.has_value() || fill->geometry == nullptr) {
+    return std::nullopt;
+  }
+  return fill;
+}
+
+bool SolidFillBatcher::Render(const Entity& entity, RenderPass& pass) {
+  if (pass_ != nullptr && pass_ != &pass && !Flush()) {
+    return false;
+  }
+
+  const auto fill = GetSolidFill(entity);
+  const auto coverage = entity.GetCoverage();
+
+  if (pass_ == nullptr) {
+    if (!fill.has_value() || !coverage.has_value()) {
+      return entity.Render(renderer_, pass);
+    }
+    pass_ = &pass;
+    first_ = entity;
+    first_geometry_ = fill->geometry;
+    color_ = fill->color;
+    solid_fill_count_ = 1u;
+    return true;
+  }
+
+  if (fill.has_value() && coverage.has_value() &&
+      CanJoin(entity, fill.value(), coverage.value())) {
+    if (solid_fill_count_ == 1u && !AppendTriangles(first_, *first_geometry_)) {
+      // The first solid fill can't be drawn in a batch after all.
+      if (!Flush()) {
+        return false;
+      }
+      return Render(entity, pass);
+    }
+    if (AppendTriangles(entity, *fill->geometry)) {
+      solid_fill_count_++;
+      return true;
+    }
+  } else if (coverage.has_value() &&
+             deferred_.size() < kMaxDeferredEntityCount) {
+    deferred_.push_back(entity);
+    deferred_coverage_.push_back(coverage.value());
+    return true;
+  }
+
+  // Draw everything that is pending and start over with this entity.
+  if (!Flush()) {
+    return false;
+  }
+  return Render(entity, pass);
+}
+
+bool SolidFillBatcher::Flush() {
+  if (pass_ == nullptr) {
+    return true;
+  }
+
+  auto& pass = *pass_;
+  // Everything batched leaves the stencil alone, so it may be skipped while
+  // its pipelines are pending.
+  ContentContext::PendingPipelineSkippingScope skipping_scope(renderer_, pass);
+  auto result = solid_fill_count_ > 1u ? RenderBatch(pass)
+                                       : first_.Render(renderer_, pass);
+  statistics_.solid_fill_count += solid_fill_count_;
+  statistics_.command_count++;
+  for (const auto& entity : deferred_) {
+    if (!result) {
+      break;
+    }
+    result = entity.Render(renderer_, pass);
+  }
+
+  pass_ = nullptr;
+  first_ = Entity();
+  first_geometry_ = nullptr;
+  solid_fill_count_ = 0u;
+  vertices_.clear();
+  indices_.clear();
+  deferred_.clear();
+  deferred_coverage_.clear();
+  return result;
+}
+
+const SolidFillBatcher::Statistics& SolidFillBatcher::GetStatistics() const {
+  return statistics_;
+}
+
+bool SolidFillBatcher::CanJoin(const Entity& entity,
+                               const Contents::SolidFill& fill,
+                               const Rect& coverage) const {
+  if (!(fill.color == color_) ||
+      entity.GetBlendMode() != first_.GetBlendMode() ||
+      entity.GetStencilDepth() != first_.GetStencilDepth()) {
+    return false;
+  }
+  // Joining draws the solid fill before the deferred entities.
+  for (const auto& deferred_coverage : deferred_coverage_) {
+    if (coverage.IntersectsWithRect(deferred_coverage)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SolidFillBatcher::AppendTriangles(const Entity& entity,
+                                       const Geometry& geometry) {
+  const auto vertex_count = vertices_.size();
+  const auto index_count = indices_.size();
+  if (geometry.AppendTriangles(renderer_, entity.GetTransformation(),
+                               vertices_, indices_) &&
+      vertices_.size() <= kMaxVertexCount) {
+    return true;
+  }
+  vertices_.resize(vertex_count);
+  indices_.resize(index_count);
+  return false;
+}
+
+bool SolidFillBatcher::RenderBatch(RenderPass& pass) const {
+  using VS = SolidFillPipeline::VertexShader;
+  using FS = SolidFillPipeline::FragmentShader;
+
+  auto& host_buffer = pass.GetTransientsBuffer();
+
+  Command cmd;
+  cmd.label = "Solid Fill Batch";
+  cmd.stencil_reference = first_.GetStencilDepth();
+
+  auto options = OptionsFromPassAndEntity(pass, first_);
+  options.primitive_type = PrimitiveType::kTriangle;
+  cmd.pipeline = renderer_.GetSolidFillPipeline(options);
+  cmd.BindVertices(VertexBuffer{
+      .vertex_buffer = host_buffer.Emplace(
+          vertices_.data(), vertices_.size() * sizeof(Point), alignof(Point)),
+      .index_buffer = host_buffer.Emplace(indices_.data(),
+                                          indices_.size() * sizeof(uint16_t),
+                                          alignof(uint16_t)),
+      .index_count = indices_.size(),
+      .index_type = IndexType::k16bit,
+  });
+
+  // The vertices are already transformed into the space of the pass.
+  VS::FrameInfo frame_info;
+  frame_info.mvp = Matrix::MakeOrthographic(pass.GetRenderTargetSize());
+  VS::BindFrameInfo(cmd, host_buffer.EmplaceUniform(frame_info));
+
+  FS::FragInfo frag_info;
+  frag_info.color = color_.Premultiply();
+  FS::BindFragInfo(cmd, host_buffer.EmplaceUniform(frag_info));
+
+  return pass.AddCommand(std::move(cmd));
+}
+
+}  // namespace impeller
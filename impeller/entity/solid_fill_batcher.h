@@ -0,0 +1,110 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/entity/contents/contents.h"
+#include "impeller/entity/entity.h"
+#include "impeller/geometry/color.h"
+#include "impeller/geometry/point.h"
+#include "impeller/geometry/rect.h"
+
+namespace impeller {
+
+class ContentContext;
+class Geometry;
+class RenderPass;
+
+//------------------------------------------------------------------------------
+/// @brief      Draws solid fills of the same color, blend mode and stencil
+///             depth with a single command.
+///
+///             Entities are handed to the batcher in draw order. A solid fill
+///             starts a batch that later matching solid fills join. Other
+///             entities are deferred until the batch is drawn, and a solid
+///             fill only joins the batch if it does not overlap any of them.
+///             The result is the same as drawing the entities one by one.
+///
+///             The batch and the entities deferred behind it are drawn by
+///             `Flush`, which must be called before the render pass ends and
+///             before anything that changes the stencil buffer is drawn.
+///
+///             This class is not thread safe.
+///
+class SolidFillBatcher {
+ public:
+  //----------------------------------------------------------------------------
+  /// The maximum number of vertices of a batch, which keeps them addressable
+  /// with 16 bit indices.
+  ///
+  static constexpr size_t kMaxVertexCount =
+      std::numeric_limits<uint16_t>::max();
+
+  //----------------------------------------------------------------------------
+  /// The maximum number of entities deferred behind a batch.
+  ///
+  static constexpr size_t kMaxDeferredEntityCount = 64u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counters for the solid fills drawn through the batcher.
+  ///
+  struct Statistics {
+    /// The number of solid fills, each of which would take a command of its
+    /// own without batching.
+    size_t solid_fill_count = 0u;
+    /// The number of commands the solid fills were drawn with.
+    size_t command_count = 0u;
+  };
+
+  explicit SolidFillBatcher(const ContentContext& renderer);
+
+  ~SolidFillBatcher();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draw an entity that does not change the stencil buffer, now
+  ///             or when the batch is flushed.
+  ///
+  /// @return     Whether the entity was drawn or will be drawn by `Flush`.
+  ///
+  [[nodiscard]] bool Render(const Entity& entity, RenderPass& pass);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draw the batch and the entities deferred behind it.
+  ///
+  [[nodiscard]] bool Flush();
+
+  const Statistics& GetStatistics() const;
+
+ private:
+  const ContentContext& renderer_;
+  RenderPass* pass_ = nullptr;
+  // The first solid fill of the batch. It is drawn on its own if nothing
+  // joins it, and only tessellated into the batch once something does.
+  Entity first_;
+  const Geometry* first_geometry_ = nullptr;
+  Color color_;
+  size_t solid_fill_count_ = 0u;
+  std::vector<Point> vertices_;
+  std::vector<uint16_t> indices_;
+  std::vector<Entity> deferred_;
+  std::vector<Rect> deferred_coverage_;
+  Statistics statistics_;
+
+  bool CanJoin(const Entity& entity,
+               const Contents::SolidFill& fill,
+               const Rect& coverage) const;
+
+  bool AppendTriangles(const Entity& entity, const Geometry& geometry);
+
+  bool RenderBatch(RenderPass& pass) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SolidFillBatcher);
+};
+
+}  // namespace impeller
@@ -4,10 +4,35 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 
+#include <atomic>
+#include <cstdlib>
+
+#include "impeller/entity/geometry.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/tessellator/tessellator.h"
 
+/// The number of allocations made by the benchmarks, which replace the global
+/// operator new to count them.
+static std::atomic<size_t> gAllocationCount = 0u;
+
+void* operator new(size_t size) {
+  gAllocationCount.fetch_add(1u, std::memory_order_relaxed);
+  void* allocation = std::malloc(size == 0u ? 1u : size);
+  if (!allocation) {
+    std::abort();
+  }
+  return allocation;
+}
+
+void operator delete(void* allocation) noexcept {
+  std::free(allocation);
+}
+
+void operator delete(void* allocation, size_t size) noexcept {
+  std::free(allocation);
+}
+
 namespace impeller {
 
 namespace {
@@ -16,6 +41,8 @@ namespace {
 Path CreateCubic();
 /// Similar to the path above, but with all cubics replaced by quadratics.
 Path CreateQuadratic();
+/// A single contour of many short lines, like the line of a chart.
+Path CreateChart();
 }  // namespace
 
 static Tessellator tess;
@@ -28,8 +55,13 @@ static void BM_Polyline(benchmark::State& state, Args&&... args) {
 
   size_t point_count = 0u;
   size_t single_point_count = 0u;
+  size_t allocation_count = 0u;
+  size_t single_allocation_count = 0u;
   while (state.KeepRunning()) {
+    const size_t allocations_before = gAllocationCount.load();
     auto polyline = path.CreatePolyline(1.0f);
+    single_allocation_count = gAllocationCount.load() - allocations_before;
+    allocation_count += single_allocation_count;
     single_point_count = polyline.points.size();
     point_count += single_point_count;
     if (tessellate) {
@@ -41,6 +73,8 @@ static void BM_Polyline(benchmark::State& state, Args&&... args) {
   }
   state.counters["SinglePointCount"] = single_point_count;
   state.counters["TotalPointCount"] = point_count;
+  state.counters["SingleAllocationCount"] = single_allocation_count;
+  state.counters["TotalAllocationCount"] = allocation_count;
 }
 
 BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline, CreateCubic(), false);
@@ -48,6 +82,75 @@ BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline_tess, CreateCubic(), true);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline, CreateQuadratic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline_tess, CreateQuadratic(), true);
 
+/// Like BM_Polyline, but flattens into the same polyline each iteration.
+template <class... Args>
+static void BM_ReusedPolyline(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple);
+  auto scale = std::get<Scalar>(args_tuple);
+
+  Path::Polyline polyline;
+  size_t point_count = 0u;
+  size_t single_point_count = 0u;
+  size_t allocation_count = 0u;
+  size_t single_allocation_count = 0u;
+  while (state.KeepRunning()) {
+    const size_t allocations_before = gAllocationCount.load();
+    path.CreatePolyline(scale, polyline);
+    single_allocation_count = gAllocationCount.load() - allocations_before;
+    allocation_count += single_allocation_count;
+    single_point_count = polyline.points.size();
+    point_count += single_point_count;
+  }
+  state.counters["SinglePointCount"] = single_point_count;
+  state.counters["TotalPointCount"] = point_count;
+  state.counters["SingleAllocationCount"] = single_allocation_count;
+  state.counters["TotalAllocationCount"] = allocation_count;
+}
+
+BENCHMARK_CAPTURE(BM_ReusedPolyline, cubic_polyline, CreateCubic(), 1.0f);
+BENCHMARK_CAPTURE(BM_ReusedPolyline, cubic_polyline_x4, CreateCubic(), 4.0f);
+BENCHMARK_CAPTURE(BM_ReusedPolyline, quad_polyline, CreateQuadratic(), 1.0f);
+
+template <class... Args>
+static void BM_StrokePolyline(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = std::get<Path>(args_tuple);
+  auto cap = std::get<Cap>(args_tuple);
+  auto join = std::get<Join>(args_tuple);
+
+  const Scalar stroke_width = 5.0f;
+  const Scalar miter_limit = 10.0f;
+  const Scalar scale = 1.0f;
+
+  size_t point_count = 0u;
+  size_t single_point_count = 0u;
+  while (state.KeepRunning()) {
+    auto vertices = StrokePathGeometry::CreateSolidStrokeVertices(
+        path, stroke_width, miter_limit * stroke_width * 0.5f, cap, join,
+        scale);
+    single_point_count = vertices.GetVertexCount();
+    point_count += single_point_count;
+  }
+  state.counters["SinglePointCount"] = single_point_count;
+  state.counters["TotalPointCount"] = point_count;
+}
+
+BENCHMARK_CAPTURE(BM_StrokePolyline, cubic_butt_bevel, CreateCubic(),
+                  Cap::kButt, Join::kBevel);
+BENCHMARK_CAPTURE(BM_StrokePolyline, cubic_square_miter, CreateCubic(),
+                  Cap::kSquare, Join::kMiter);
+BENCHMARK_CAPTURE(BM_StrokePolyline, cubic_round_round, CreateCubic(),
+                  Cap::kRound, Join::kRound);
+BENCHMARK_CAPTURE(BM_StrokePolyline, quad_butt_bevel, CreateQuadratic(),
+                  Cap::kButt, Join::kBevel);
+BENCHMARK_CAPTURE(BM_StrokePolyline, chart_butt_bevel, CreateChart(),
+                  Cap::kButt, Join::kBevel);
+BENCHMARK_CAPTURE(BM_StrokePolyline, chart_square_miter, CreateChart(),
+                  Cap::kSquare, Join::kMiter);
+BENCHMARK_CAPTURE(BM_StrokePolyline, chart_round_round, CreateChart(),
+                  Cap::kRound, Join::kRound);
+
 namespace {
 Path CreateCubic() {
   return PathBuilder{}
@@ -312,5 +415,19 @@ Path CreateQuadratic() {
       .TakePath();
 }
 
+Path CreateChart() {
+  static constexpr size_t kPointCount = 10000u;
+  PathBuilder builder;
+  builder.MoveTo({0, 500});
+  for (size_t i = 1; i < kPointCount; i++) {
+    // Deterministic noise on top of a slow wave.
+    auto x = static_cast<Scalar>(i) * 0.2f;
+    auto y = 500 + 200 * std::sin(x * 0.01f) + 40 * std::sin(x * 1.7f) +
+             15 * std::sin(x * 5.3f);
+    builder.LineTo({x, y});
+  }
+  return builder.TakePath();
+}
+
 }  // namespace
 }  // namespace impeller
@@ -4,6 +4,7 @@
 
 #include "impeller/geometry/geometry_asserts.h"
 
+#include <algorithm>
 #include <limits>
 #include <sstream>
 
@@ -1940,6 +1941,184 @@ TEST(GeometryTest, PathPolylineDuplicatesAreRemovedForSameContour) {
   ASSERT_EQ(polyline.points[6], Point(0, 100));
 }
 
+TEST(GeometryTest, PathCreatePolylineReusesPolyline) {
+  Path path = PathBuilder{}
+                  .MoveTo({10, 10})
+                  .CubicCurveTo({20, 35}, {35, 20}, {40, 40})
+                  .QuadraticCurveTo({60, 10}, {80, 40})
+                  .LineTo({80, 80})
+                  .Close()
+                  .AddCircle({100, 100}, 50)
+                  .TakePath();
+
+  Path::Polyline polyline;
+  for (auto scale : {4.0f, 1.0f, 0.25f, 1.0f}) {
+    path.CreatePolyline(scale, polyline);
+    auto expected = path.CreatePolyline(scale);
+    ASSERT_EQ(polyline.points, expected.points);
+    ASSERT_EQ(polyline.contours.size(), expected.contours.size());
+    for (size_t i = 0; i < expected.contours.size(); i++) {
+      ASSERT_EQ(polyline.contours[i].start_index,
+                expected.contours[i].start_index);
+      ASSERT_EQ(polyline.contours[i].is_closed,
+                expected.contours[i].is_closed);
+      ASSERT_EQ(polyline.contours[i].start_direction,
+                expected.contours[i].start_direction);
+      ASSERT_EQ(polyline.contours[i].end_direction,
+                expected.contours[i].end_direction);
+    }
+  }
+}
+
+TEST(GeometryTest, PathPolylineMatchesComponentPolylines) {
+  QuadraticPathComponent quad({10, 10}, {50, 80}, {90, 10});
+  CubicPathComponent cubic({90, 10}, {100, 100}, {0, 100}, {10, 20});
+  // A cusp, whose number of points depends on the scale.
+  QuadraticPathComponent cusp({10, 20}, {110, 120}, {10, 21});
+
+  Path path;
+  path.AddContourComponent(quad.p1);
+  path.AddQuadraticComponent(quad.p1, quad.cp, quad.p2);
+  path.AddCubicComponent(cubic.p1, cubic.cp1, cubic.cp2, cubic.p2);
+  path.AddQuadraticComponent(cusp.p1, cusp.cp, cusp.p2);
+
+  for (auto scale : {0.5f, 1.0f, 10.0f}) {
+    std::vector<Point> expected = {quad.p1};
+    for (const auto& points :
+         {quad.CreatePolyline(scale), cubic.CreatePolyline(scale),
+          cusp.CreatePolyline(scale)}) {
+      expected.insert(expected.end(), points.begin(), points.end());
+    }
+    ASSERT_EQ(path.CreatePolyline(scale).points, expected);
+  }
+
+  // The cached parameters are recomputed when components are updated.
+  CubicPathComponent updated({90, 10}, {500, 500}, {-400, 500}, {10, 20});
+  ASSERT_TRUE(path.UpdateCubicComponentAtIndex(2, updated));
+  auto polyline = path.CreatePolyline(1.0f);
+  auto updated_points = updated.CreatePolyline(1.0f);
+  auto quad_points = quad.CreatePolyline(1.0f);
+  ASSERT_TRUE(std::equal(updated_points.begin(), updated_points.end(),
+                         polyline.points.begin() + 1 + quad_points.size()));
+}
+
+TEST(GeometryTest, PolylinesMatchGoldenFlattening) {
+  QuadraticPathComponent quad({10, 10}, {50, 80}, {90, 10});
+  CubicPathComponent cubic({90, 10}, {100, 100}, {0, 100}, {10, 20});
+  QuadraticPathComponent cusp({10, 20}, {110, 120}, {10, 21});
+
+  // The point counts and some of the points of the polylines computed before
+  // the scale independent parts of flattening were cached.
+  struct Sample {
+    size_t index;
+    Point point;
+  };
+  struct Golden {
+    Scalar scale;
+    size_t point_count;
+    Sample samples[3];
+  };
+  // clang-format off
+  const Golden quad_goldens[] = {
+      {0.5f, 12, {{1, {22.0412f, 27.9004f}},
+                  {6, {57.3155f, 43.8293f}},
+                  {10, {84.1615f, 19.4717f}}}},
+      {1.0f, 17, {{1, {18.3478f, 23.0842f}},
+                  {8, {52.5898f, 44.8533f}},
+                  {15, {85.9158f, 16.7825f}}}},
+      {10.0f, 53, {{1, {12.5998f, 14.4018f}},
+                   {26, {50.8310f, 44.9849f}},
+                   {51, {88.7091f, 12.2227f}}}},
+  };
+  const Golden cubic_goldens[] = {
+      {0.5f, 20, {{1, {90.0169f, 33.5070f}},
+                  {10, {43.3551f, 78.4918f}},
+                  {18, {9.3798f, 30.7964f}}}},
+      {1.0f, 30, {{1, {90.5627f, 26.0076f}},
+                  {15, {45.5821f, 78.7206f}},
+                  {28, {9.4580f, 27.2646f}}}},
+      {10.0f, 86, {{1, {90.4166f, 15.4667f}},
+                   {43, {48.3699f, 78.8049f}},
+                   {84, {9.7642f, 22.4492f}}}},
+  };
+  const Golden cusp_goldens[] = {
+      {0.5f, 5, {{1, {52.1357f, 62.2267f}},
+                 {2, {52.2040f, 62.6904f}},
+                 {3, {31.6708f, 42.4388f}}}},
+      {1.0f, 6, {{1, {45.5268f, 55.5802f}},
+                 {3, {45.5816f, 56.1722f}},
+                 {4, {28.1098f, 38.9186f}}}},
+      {10.0f, 12, {{1, {28.0847f, 38.0948f}},
+                   {6, {53.7966f, 64.2538f}},
+                   {10, {19.1096f, 30.0162f}}}},
+  };
+  // clang-format on
+
+  auto expect_golden = [](const std::vector<Point>& points,
+                          const Golden& golden) {
+    ASSERT_EQ(points.size(), golden.point_count);
+    for (const auto& sample : golden.samples) {
+      ASSERT_POINT_NEAR(points[sample.index], sample.point);
+    }
+  };
+  for (const auto& golden : quad_goldens) {
+    expect_golden(quad.CreatePolyline(golden.scale), golden);
+  }
+  for (const auto& golden : cubic_goldens) {
+    expect_golden(cubic.CreatePolyline(golden.scale), golden);
+  }
+  for (const auto& golden : cusp_goldens) {
+    expect_golden(cusp.CreatePolyline(golden.scale), golden);
+  }
+
+  Path path;
+  path.AddContourComponent(quad.p1);
+  path.AddQuadraticComponent(quad.p1, quad.cp, quad.p2);
+  path.AddCubicComponent(cubic.p1, cubic.cp1, cubic.cp2, cubic.p2);
+  path.AddQuadraticComponent(cusp.p1, cusp.cp, cusp.p2);
+  for (size_t i = 0; i < 3; i++) {
+    auto polyline = path.CreatePolyline(quad_goldens[i].scale);
+    ASSERT_EQ(polyline.points.size(), 1 + quad_goldens[i].point_count +
+                                          cubic_goldens[i].point_count +
+                                          cusp_goldens[i].point_count);
+    auto cubic_start =
+        polyline.points.begin() + 1 + quad_goldens[i].point_count;
+    expect_golden(std::vector<Point>(
+                      cubic_start, cubic_start + cubic_goldens[i].point_count),
+                  cubic_goldens[i]);
+  }
+}
+
+TEST(GeometryTest, UpdatingCubicsKeepsOtherCubicsFlattened) {
+  CubicPathComponent first({10, 10}, {20, 35}, {35, 20}, {40, 40});
+  CubicPathComponent second({40, 40}, {100, 100}, {0, 100}, {10, 20});
+
+  Path path;
+  path.AddContourComponent(first.p1);
+  path.AddCubicComponent(first.p1, first.cp1, first.cp2, first.p2);
+  path.AddCubicComponent(second.p1, second.cp1, second.cp2, second.p2);
+
+  auto expect_polyline = [&path](const CubicPathComponent& a,
+                                 const CubicPathComponent& b) {
+    std::vector<Point> expected = {a.p1};
+    for (const auto& points :
+         {a.CreatePolyline(1.0f), b.CreatePolyline(1.0f)}) {
+      expected.insert(expected.end(), points.begin(), points.end());
+    }
+    ASSERT_EQ(path.CreatePolyline(1.0f).points, expected);
+  };
+
+  // Nudging the control points keeps the number of quadratics.
+  CubicPathComponent moved({10, 10}, {21, 37}, {36, 22}, {40, 40});
+  ASSERT_TRUE(path.UpdateCubicComponentAtIndex(1, moved));
+  expect_polyline(moved, second);
+
+  // Growing a cubic needs more quadratics and shifts the cubics after it.
+  CubicPathComponent grown({10, 10}, {500, 500}, {-400, 500}, {40, 40});
+  ASSERT_TRUE(path.UpdateCubicComponentAtIndex(1, grown));
+  expect_polyline(grown, second);
+}
+
 TEST(GeometryTest, MatrixPrinting) {
   {
     std::stringstream stream;
@@ -4,6 +4,7 @@
 
 #include "impeller/geometry/path.h"
 
+#include <algorithm>
 #include <optional>
 #include <variant>
 
@@ -61,16 +62,39 @@ Path& Path::AddLinearComponent(Point p1, Point p2) {
 
 Path& Path::AddQuadraticComponent(Point p1, Point cp, Point p2) {
   quads_.emplace_back(p1, cp, p2);
+  quad_parameters_.push_back(quads_.back().ComputePolylineParameters());
   components_.emplace_back(ComponentType::kQuadratic, quads_.size() - 1);
   return *this;
 }
 
 Path& Path::AddCubicComponent(Point p1, Point cp1, Point cp2, Point p2) {
   cubics_.emplace_back(p1, cp1, cp2, p2);
+  AppendCubicQuads(cubics_.back());
   components_.emplace_back(ComponentType::kCubic, cubics_.size() - 1);
   return *this;
 }
 
+void Path::AppendCubicQuads(const CubicPathComponent& cubic) {
+  QuadRange range;
+  range.start = cubic_quads_.size();
+  cubic.AppendQuadraticPathComponents(kCubicToQuadraticAccuracy, cubic_quads_);
+  range.count = cubic_quads_.size() - range.start;
+  for (size_t i = range.start; i < cubic_quads_.size(); i++) {
+    cubic_quad_parameters_.push_back(
+        cubic_quads_[i].ComputePolylineParameters());
+  }
+  cubic_quad_ranges_.push_back(range);
+}
+
+void Path::ComputeCubicQuads() {
+  cubic_quad_ranges_.clear();
+  cubic_quads_.clear();
+  cubic_quad_parameters_.clear();
+  for (const auto& cubic : cubics_) {
+    AppendCubicQuads(cubic);
+  }
+}
+
 Path& Path::AddContourComponent(Point destination, bool is_closed) {
   if (components_.size() > 0 &&
       components_.back().type == ComponentType::kContour) {
@@ -203,6 +227,8 @@ bool Path::UpdateQuadraticComponentAtIndex(
   }
 
   quads_[components_[index].index] = quadratic;
+  quad_parameters_[components_[index].index] =
+      quadratic.ComputePolylineParameters();
   return true;
 }
 
@@ -216,7 +242,26 @@ bool Path::UpdateCubicComponentAtIndex(size_t index,
     return false;
   }
 
-  cubics_[components_[index].index] = cubic;
+  const size_t cubic_index = components_[index].index;
+  cubics_[cubic_index] = cubic;
+
+  const auto& range = cubic_quad_ranges_[cubic_index];
+  if (cubic.CountQuadraticPathComponents(kCubicToQuadraticAccuracy) !=
+      range.count) {
+    // The ranges of all the cubics after this one move.
+    ComputeCubicQuads();
+    return true;
+  }
+  // The quadratics are appended past the end, where the storage is reused
+  // across updates, and then moved over those of the previous cubic.
+  const size_t end = cubic_quads_.size();
+  cubic.AppendQuadraticPathComponents(kCubicToQuadraticAccuracy, cubic_quads_);
+  std::move(cubic_quads_.begin() + end, cubic_quads_.end(),
+            cubic_quads_.begin() + range.start);
+  cubic_quads_.erase(cubic_quads_.begin() + end, cubic_quads_.end());
+  for (size_t i = range.start; i < range.start + range.count; i++) {
+    cubic_quad_parameters_[i] = cubic_quads_[i].ComputePolylineParameters();
+  }
   return true;
 }
 
@@ -234,25 +279,59 @@ bool Path::UpdateContourComponentAtIndex(size_t index,
   return true;
 }
 
+void Path::AppendPolylinePoints(const ComponentIndexPair& component,
+                                Scalar scale,
+                                std::vector<Point>& points) const {
+  switch (component.type) {
+    case ComponentType::kLinear:
+      // The polyline of a line is its end point.
+      points.push_back(linears_[component.index].p2);
+      return;
+    case ComponentType::kQuadratic:
+      quads_[component.index].FillPointsForPolyline(
+          quad_parameters_[component.index], points, scale);
+      return;
+    case ComponentType::kCubic: {
+      const auto& range = cubic_quad_ranges_[component.index];
+      for (size_t i = range.start; i < range.start + range.count; i++) {
+        cubic_quads_[i].FillPointsForPolyline(cubic_quad_parameters_[i],
+                                              points, scale);
+      }
+      return;
+    }
+    case ComponentType::kContour:
+      return;
+  }
+}
+
 Path::Polyline Path::CreatePolyline(Scalar scale) const {
   Polyline polyline;
+  CreatePolyline(scale, polyline);
+  return polyline;
+}
 
-  std::optional<Point> previous_contour_point;
-  auto collect_points = [&polyline, &previous_contour_point](
-                            const std::vector<Point>& collection) {
-    if (collection.empty()) {
-      return;
-    }
+void Path::CreatePolyline(Scalar scale, Polyline& polyline) const {
+  polyline.points.clear();
+  polyline.contours.clear();
 
-    for (const auto& point : collection) {
+  // The points of each component are appended to the polyline directly, and
+  // then compacted in place.
+  std::optional<Point> previous_contour_point;
+  auto remove_duplicate_points = [&polyline,
+                                  &previous_contour_point](size_t start_i) {
+    auto& points = polyline.points;
+    size_t end_i = start_i;
+    for (size_t point_i = start_i; point_i < points.size(); point_i++) {
+      const auto point = points[point_i];
       if (previous_contour_point.has_value() &&
           previous_contour_point.value() == point) {
         // Skip over duplicate points in the same contour.
         continue;
       }
       previous_contour_point = point;
-      polyline.points.push_back(point);
+      points[end_i++] = point;
     }
+    points.resize(end_i);
   };
 
   auto get_path_component = [this](size_t component_i) -> PathComponentVariant {
@@ -326,17 +405,13 @@ Path::Polyline Path::CreatePolyline(Scalar scale) const {
   for (size_t component_i = 0; component_i < components_.size();
        component_i++) {
     const auto& component = components_[component_i];
+    const auto start_i = polyline.points.size();
     switch (component.type) {
       case ComponentType::kLinear:
-        collect_points(linears_[component.index].CreatePolyline());
-        previous_path_component_index = component_i;
-        break;
       case ComponentType::kQuadratic:
-        collect_points(quads_[component.index].CreatePolyline(scale));
-        previous_path_component_index = component_i;
-        break;
       case ComponentType::kCubic:
-        collect_points(cubics_[component.index].CreatePolyline(scale));
+        AppendPolylinePoints(component, scale, polyline.points);
+        remove_duplicate_points(start_i);
         previous_path_component_index = component_i;
         break;
       case ComponentType::kContour:
@@ -353,12 +428,12 @@ Path::Polyline Path::CreatePolyline(Scalar scale) const {
                                      .is_closed = contour.is_closed,
                                      .start_direction = start_direction});
         previous_contour_point = std::nullopt;
-        collect_points({contour.destination});
+        polyline.points.push_back(contour.destination);
+        remove_duplicate_points(start_i);
         break;
     }
     end_contour();
   }
-  return polyline;
 }
 
 std::optional<Rect> Path::GetBoundingBox() const {
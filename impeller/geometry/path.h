@@ -142,6 +142,17 @@ class Path {
   /// the path. If the provided scale is 0, curves will revert to lines.
   Polyline CreatePolyline(Scalar scale) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Like `CreatePolyline`, but replaces the contents of
+  ///             `polyline`, reusing its storage.
+  ///
+  ///             The parts of flattening the curves that do not depend on the
+  ///             scale are computed when the curves are added to the path. So
+  ///             flattening into a polyline whose storage is large enough
+  ///             allocates nothing.
+  ///
+  void CreatePolyline(Scalar scale, Polyline& polyline) const;
+
   std::optional<Rect> GetBoundingBox() const;
 
   std::optional<Rect> GetTransformedBoundingBox(const Matrix& transform) const;
@@ -159,12 +170,34 @@ class Path {
         : type(a_type), index(a_index) {}
   };
 
+  /// The range of `cubic_quads_` that approximates a cubic.
+  struct QuadRange {
+    size_t start = 0;
+    size_t count = 0;
+  };
+
   FillType fill_ = FillType::kNonZero;
   std::vector<ComponentIndexPair> components_;
   std::vector<LinearPathComponent> linears_;
   std::vector<QuadraticPathComponent> quads_;
   std::vector<CubicPathComponent> cubics_;
   std::vector<ContourComponent> contours_;
+
+  // The scale independent parts of flattening the curves. Each of the vectors
+  // of parameters is parallel to the quadratics it is computed from.
+  std::vector<QuadraticPathComponent::PolylineParameters> quad_parameters_;
+  std::vector<QuadRange> cubic_quad_ranges_;
+  std::vector<QuadraticPathComponent> cubic_quads_;
+  std::vector<QuadraticPathComponent::PolylineParameters>
+      cubic_quad_parameters_;
+
+  void AppendCubicQuads(const CubicPathComponent& cubic);
+
+  void ComputeCubicQuads();
+
+  void AppendPolylinePoints(const ComponentIndexPair& component,
+                            Scalar scale,
+                            std::vector<Point>& points) const;
 };
 
 }  // namespace impeller
@@ -108,9 +108,31 @@ std::vector<Point> QuadraticPathComponent::CreatePolyline(Scalar scale) const {
 
 void QuadraticPathComponent::FillPointsForPolyline(std::vector<Point>& points,
                                                    Scalar scale_factor) const {
-  auto tolerance = kDefaultCurveTolerance / scale_factor;
-  auto sqrt_tolerance = sqrt(tolerance);
+  FillPointsForPolyline(ComputePolylineParameters(), points, scale_factor);
+}
 
+// The number of points of a cusp depends on the tolerance, and so on the
+// scale.
+static Scalar ComputeCuspVal(const QuadraticPathComponent& quad,
+                             Scalar sqrt_tolerance) {
+  auto d01 = quad.cp - quad.p1;
+  auto d12 = quad.p2 - quad.cp;
+  auto dd = d01 - d12;
+  auto cross = (quad.p2 - quad.p1).Cross(dd);
+  auto x0 = d01.Dot(dd) * 1 / cross;
+  auto x2 = d12.Dot(dd) * 1 / cross;
+  auto scale = std::abs(cross / (hypot(dd.x, dd.y) * (x2 - x0)));
+
+  auto a0 = ApproximateParabolaIntegral(x0);
+  auto a2 = ApproximateParabolaIntegral(x2);
+  auto da = std::abs(a2 - a0);
+  auto sqrt_scale = sqrt(scale);
+  auto xmin = sqrt_tolerance / sqrt_scale;
+  return sqrt_tolerance * da / ApproximateParabolaIntegral(xmin);
+}
+
+QuadraticPathComponent::PolylineParameters
+QuadraticPathComponent::ComputePolylineParameters() const {
   auto d01 = cp - p1;
   auto d12 = p2 - cp;
   auto dd = d01 - d12;
@@ -119,23 +141,37 @@ void QuadraticPathComponent::FillPointsForPolyline(std::vector<Point>& points,
   auto x2 = d12.Dot(dd) * 1 / cross;
   auto scale = std::abs(cross / (hypot(dd.x, dd.y) * (x2 - x0)));
 
-  auto a0 = ApproximateParabolaIntegral(x0);
-  auto a2 = ApproximateParabolaIntegral(x2);
-  Scalar val = 0.f;
+  PolylineParameters parameters;
+  parameters.a0 = ApproximateParabolaIntegral(x0);
+  parameters.a2 = ApproximateParabolaIntegral(x2);
   if (std::isfinite(scale)) {
-    auto da = std::abs(a2 - a0);
+    auto da = std::abs(parameters.a2 - parameters.a0);
     auto sqrt_scale = sqrt(scale);
     if ((x0 < 0 && x2 < 0) || (x0 >= 0 && x2 >= 0)) {
-      val = da * sqrt_scale;
+      parameters.val = da * sqrt_scale;
     } else {
-      // cusp case
-      auto xmin = sqrt_tolerance / sqrt_scale;
-      val = sqrt_tolerance * da / ApproximateParabolaIntegral(xmin);
+      parameters.is_cusp = true;
     }
   }
-  auto u0 = ApproximateParabolaIntegral(a0);
-  auto u2 = ApproximateParabolaIntegral(a2);
-  auto uscale = 1 / (u2 - u0);
+  parameters.u0 = ApproximateParabolaIntegral(parameters.a0);
+  auto u2 = ApproximateParabolaIntegral(parameters.a2);
+  parameters.uscale = 1 / (u2 - parameters.u0);
+  return parameters;
+}
+
+void QuadraticPathComponent::FillPointsForPolyline(
+    const PolylineParameters& parameters,
+    std::vector<Point>& points,
+    Scalar scale_factor) const {
+  auto tolerance = kDefaultCurveTolerance / scale_factor;
+  auto sqrt_tolerance = sqrt(tolerance);
+
+  const auto a0 = parameters.a0;
+  const auto a2 = parameters.a2;
+  const auto u0 = parameters.u0;
+  const auto uscale = parameters.uscale;
+  Scalar val = parameters.is_cusp ? ComputeCuspVal(*this, sqrt_tolerance)
+                                  : parameters.val;
 
   auto line_count = std::max(1., ceil(0.5 * val / sqrt_tolerance));
   auto step = 1 / line_count;
@@ -188,11 +224,8 @@ Point CubicPathComponent::SolveDerivative(Scalar time) const {
 }
 
 std::vector<Point> CubicPathComponent::CreatePolyline(Scalar scale) const {
-  auto quads = ToQuadraticPathComponents(.1);
   std::vector<Point> points;
-  for (const auto& quad : quads) {
-    quad.FillPointsForPolyline(points, scale);
-  }
+  FillPointsForPolyline(points, scale);
   return points;
 }
 
@@ -211,9 +244,8 @@ CubicPathComponent CubicPathComponent::Subsegment(Scalar t0, Scalar t1) const {
   return CubicPathComponent(p0, p1, p2, p3);
 }
 
-std::vector<QuadraticPathComponent>
-CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy) const {
-  std::vector<QuadraticPathComponent> quads;
+size_t CubicPathComponent::CountQuadraticPathComponents(
+    Scalar accuracy) const {
   // The maximum error, as a vector from the cubic to the best approximating
   // quadratic, is proportional to the third derivative, which is constant
   // across the segment. Thus, the error scales down as the third power of
@@ -230,20 +262,51 @@ CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy) const {
   auto p2x2 = 3.0 * cp2 - p2;
   auto p = p2x2 - p1x2;
   auto err = p.Dot(p);
-  auto quad_count = std::max(1., ceil(pow(err / max_hypot2, 1. / 6.0)));
+  return static_cast<size_t>(
+      std::max(1., ceil(pow(err / max_hypot2, 1. / 6.0))));
+}
 
+// Calls `visitor` with each of the quadratics that approximate `cubic`, so
+// that they can be consumed without being collected first.
+template <class Visitor>
+static void VisitQuadraticPathComponents(const CubicPathComponent& cubic,
+                                         Scalar accuracy,
+                                         Visitor&& visitor) {
+  const double quad_count = cubic.CountQuadraticPathComponents(accuracy);
   for (size_t i = 0; i < quad_count; i++) {
     auto t0 = i / quad_count;
     auto t1 = (i + 1) / quad_count;
-    auto seg = Subsegment(t0, t1);
+    auto seg = cubic.Subsegment(t0, t1);
     auto p1x2 = 3.0 * seg.cp1 - seg.p1;
     auto p2x2 = 3.0 * seg.cp2 - seg.p2;
-    quads.emplace_back(
-        QuadraticPathComponent(seg.p1, ((p1x2 + p2x2) / 4.0), seg.p2));
+    visitor(QuadraticPathComponent(seg.p1, ((p1x2 + p2x2) / 4.0), seg.p2));
   }
+}
+
+void CubicPathComponent::FillPointsForPolyline(std::vector<Point>& points,
+                                               Scalar scale_factor) const {
+  VisitQuadraticPathComponents(
+      *this, kCubicToQuadraticAccuracy,
+      [&points, scale_factor](const QuadraticPathComponent& quad) {
+        quad.FillPointsForPolyline(points, scale_factor);
+      });
+}
+
+std::vector<QuadraticPathComponent>
+CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy) const {
+  std::vector<QuadraticPathComponent> quads;
+  AppendQuadraticPathComponents(accuracy, quads);
   return quads;
 }
 
+void CubicPathComponent::AppendQuadraticPathComponents(
+    Scalar accuracy,
+    std::vector<QuadraticPathComponent>& quads) const {
+  VisitQuadraticPathComponents(
+      *this, accuracy,
+      [&quads](const QuadraticPathComponent& quad) { quads.push_back(quad); });
+}
+
 static inline bool NearEqual(Scalar a, Scalar b, Scalar epsilon) {
   return (a > (b - epsilon)) && (a < (b + epsilon));
 }
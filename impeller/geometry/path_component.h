@@ -24,6 +24,10 @@ namespace impeller {
 // points for the given scale.
 static constexpr Scalar kDefaultCurveTolerance = .1f;
 
+// The accuracy with which cubic curves are approximated by quadratic curves
+// before they are flattened. It does not depend on the scale.
+static constexpr Scalar kCubicToQuadraticAccuracy = .1f;
+
 struct LinearPathComponent {
   Point p1;
   Point p2;
@@ -76,6 +80,30 @@ struct QuadraticPathComponent {
   void FillPointsForPolyline(std::vector<Point>& points,
                              Scalar scale_factor) const;
 
+  /// The parts of flattening the curve that do not depend on the scale it is
+  /// flattened at.
+  struct PolylineParameters {
+    Scalar a0 = 0.0f;
+    Scalar a2 = 0.0f;
+    Scalar u0 = 0.0f;
+    Scalar uscale = 0.0f;
+    /// Proportional to the number of points at any scale. Unused for cusps,
+    /// whose number of points is not.
+    Scalar val = 0.0f;
+    bool is_cusp = false;
+  };
+
+  PolylineParameters ComputePolylineParameters() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Append the points of the polyline at the given scale, like
+  ///             `FillPointsForPolyline`, reusing the parameters returned by
+  ///             `ComputePolylineParameters`.
+  ///
+  void FillPointsForPolyline(const PolylineParameters& parameters,
+                             std::vector<Point>& points,
+                             Scalar scale_factor) const;
+
   std::vector<Point> Extrema() const;
 
   bool operator==(const QuadraticPathComponent& other) const {
@@ -114,11 +142,33 @@ struct CubicPathComponent {
   // See the note on QuadraticPathComponent::CreatePolyline for references.
   std::vector<Point> CreatePolyline(Scalar scale) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Append the points of `CreatePolyline` to `points`.
+  ///
+  ///             Nothing but `points` is allocated, so reusing `points` makes
+  ///             flattening free of allocations.
+  ///
+  void FillPointsForPolyline(std::vector<Point>& points,
+                             Scalar scale_factor) const;
+
   std::vector<Point> Extrema() const;
 
   std::vector<QuadraticPathComponent> ToQuadraticPathComponents(
       Scalar accuracy) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The number of quadratics `ToQuadraticPathComponents` returns.
+  ///
+  size_t CountQuadraticPathComponents(Scalar accuracy) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Append the quadratics of `ToQuadraticPathComponents` to
+  ///             `quads`.
+  ///
+  void AppendQuadraticPathComponents(
+      Scalar accuracy,
+      std::vector<QuadraticPathComponent>& quads) const;
+
   CubicPathComponent Subsegment(Scalar t0, Scalar t1) const;
 
   bool operator==(const CubicPathComponent& other) const {
@@ -155,6 +155,61 @@ bool BlitCopyTextureToBufferCommandGLES::Encode(
   return true;
 };
 
+BlitCopyBufferToTextureCommandGLES::~BlitCopyBufferToTextureCommandGLES() =
+    default;
+
+std::string BlitCopyBufferToTextureCommandGLES::GetLabel() const {
+  return label;
+}
+
+bool BlitCopyBufferToTextureCommandGLES::Encode(
+    const ReactorGLES& reactor) const {
+  GLenum format = GL_NONE;
+  const auto pixel_format = destination->GetTextureDescriptor().format;
+  if (pixel_format == PixelFormat::kA8UNormInt) {
+    format = GL_ALPHA;
+  } else if (pixel_format == PixelFormat::kR8G8B8A8UNormInt) {
+    format = GL_RGBA;
+  } else {
+    VALIDATION_LOG << "Only textures with pixel format A8 or RGBA are "
+                      "supported yet.";
+    return false;
+  }
+
+  const auto& texture = TextureGLES::Cast(*destination);
+  if (texture.GetType() != TextureGLES::Type::kTexture ||
+      texture.IsWrapped()) {
+    VALIDATION_LOG << "Cannot copy a buffer to this texture.";
+    return false;
+  }
+
+  // Binding the texture allocates its storage if it has none yet.
+  if (!texture.Bind()) {
+    return false;
+  }
+
+  const auto& gl = reactor.GetProcTable();
+  const auto& buffer =
+      DeviceBufferGLES::Cast(static_cast<const DeviceBuffer&>(*source.buffer));
+
+  // The rows of the source are tightly packed, which may not match the
+  // default alignment of four bytes.
+  gl.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  gl.TexSubImage2D(GL_TEXTURE_2D,                                // target
+                   0u,                                           // LOD level
+                   destination_region.origin.x,                  // xoffset
+                   destination_region.origin.y,                  // yoffset
+                   destination_region.size.width,                // width
+                   destination_region.size.height,               // height
+                   format,                                       // format
+                   GL_UNSIGNED_BYTE,                             // type
+                   buffer.GetBufferData() + source.range.offset  // data
+  );
+  gl.PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  return true;
+};
+
 BlitGenerateMipmapCommandGLES::~BlitGenerateMipmapCommandGLES() = default;
 
 std::string BlitGenerateMipmapCommandGLES::GetLabel() const {
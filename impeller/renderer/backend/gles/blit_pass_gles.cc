@@ -130,6 +130,22 @@ bool BlitPassGLES::OnCopyTextureToBufferCommand(
   return true;
 }
 
+// |BlitPass|
+bool BlitPassGLES::OnCopyBufferToTextureCommand(
+    BufferView source,
+    std::shared_ptr<Texture> destination,
+    IRect destination_region,
+    std::string label) {
+  auto command = std::make_unique<BlitCopyBufferToTextureCommandGLES>();
+  command->label = label;
+  command->source = std::move(source);
+  command->destination = std::move(destination);
+  command->destination_region = destination_region;
+
+  commands_.emplace_back(std::move(command));
+  return true;
+}
+
 // |BlitPass|
 bool BlitPassGLES::OnGenerateMipmapCommand(std::shared_ptr<Texture> texture,
                                            std::string label) {
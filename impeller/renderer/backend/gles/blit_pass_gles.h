@@ -54,11 +54,8 @@ class BlitPassGLES final : public BlitPass {
   // |BlitPass|
   bool OnCopyBufferToTextureCommand(BufferView source,
                                     std::shared_ptr<Texture> destination,
-                                    IPoint destination_origin,
-                                    std::string label) override {
-    IMPELLER_UNIMPLEMENTED;
-    return false;
-  }
+                                    IRect destination_region,
+                                    std::string label) override;
   // |BlitPass|
   bool OnGenerateMipmapCommand(std::shared_ptr<Texture> texture,
                                std::string label) override;
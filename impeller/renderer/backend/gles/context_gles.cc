@@ -70,6 +70,11 @@ ContextGLES::ContextGLES(std::unique_ptr<ProcTableGLES> gl,
             .SetSupportsFramebufferFetch(false)
             .SetDefaultColorFormat(PixelFormat::kB8G8R8A8UNormInt)
             .SetDefaultStencilFormat(PixelFormat::kS8UInt)
+            .SetDefaultDepthStencilFormat(
+                reactor_->GetProcTable().GetDescription()->HasExtension(
+                    "GL_OES_packed_depth_stencil")
+                    ? PixelFormat::kD24UnormS8Uint
+                    : PixelFormat::kUnknown)
             .SetSupportsCompute(false, false)
             .SetSupportsReadFromResolve(false)
             .Build();
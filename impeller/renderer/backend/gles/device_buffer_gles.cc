@@ -4,6 +4,7 @@
 
 #include "impeller/renderer/backend/gles/device_buffer_gles.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -52,11 +53,25 @@ bool DeviceBufferGLES::OnCopyHostBuffer(const uint8_t* source,
 
   std::memmove(backing_store_->GetBuffer() + offset,
                source + source_range.offset, source_range.length);
-  ++generation_;
+  MarkDirty(Range{offset, source_range.length});
 
   return true;
 }
 
+void DeviceBufferGLES::MarkDirty(Range range) {
+  if (range.length == 0u) {
+    return;
+  }
+  if (dirty_range_.length == 0u) {
+    dirty_range_ = range;
+    return;
+  }
+  const auto begin = std::min(dirty_range_.offset, range.offset);
+  const auto end = std::max(dirty_range_.offset + dirty_range_.length,
+                            range.offset + range.length);
+  dirty_range_ = Range{begin, end - begin};
+}
+
 static GLenum ToTarget(DeviceBufferGLES::BindingType type) {
   switch (type) {
     case DeviceBufferGLES::BindingType::kArrayBuffer:
@@ -82,13 +97,24 @@ bool DeviceBufferGLES::BindAndUploadDataIfNecessary(BindingType type) const {
 
   gl.BindBuffer(target_type, buffer.value());
 
-  if (upload_generation_ != generation_) {
+  if (dirty_range_.length == 0u) {
+    return true;
+  }
+  // Buffers written a bit at a time, like the blocks of a host buffer ring,
+  // only upload what changed since they were last bound.
+  if (!has_storage_) {
     TRACE_EVENT1("impeller", "BufferData", "Bytes",
                  std::to_string(backing_store_->GetLength()).c_str());
     gl.BufferData(target_type, backing_store_->GetLength(),
                   backing_store_->GetBuffer(), GL_STATIC_DRAW);
-    upload_generation_ = generation_;
+    has_storage_ = true;
+  } else {
+    TRACE_EVENT1("impeller", "BufferSubData", "Bytes",
+                 std::to_string(dirty_range_.length).c_str());
+    gl.BufferSubData(target_type, dirty_range_.offset, dirty_range_.length,
+                     backing_store_->GetBuffer() + dirty_range_.offset);
   }
+  dirty_range_ = Range{};
 
   return true;
 }
@@ -116,7 +142,7 @@ void DeviceBufferGLES::UpdateBufferData(
   if (update_buffer_data) {
     update_buffer_data(backing_store_->GetBuffer(),
                        backing_store_->GetLength());
-    ++generation_;
+    MarkDirty(Range{0u, backing_store_->GetLength()});
   }
 }
 
@@ -41,8 +41,12 @@ class DeviceBufferGLES final
   ReactorGLES::Ref reactor_;
   HandleGLES handle_;
   mutable std::shared_ptr<Allocation> backing_store_;
-  mutable uint32_t generation_ = 0;
-  mutable uint32_t upload_generation_ = 0;
+  // Whether the GL buffer holds storage for the whole backing store.
+  mutable bool has_storage_ = false;
+  // The range of the backing store written since the last upload.
+  mutable Range dirty_range_;
+
+  void MarkDirty(Range range);
 
   // |DeviceBuffer|
   uint8_t* OnGetContents() const override;
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "flutter/fml/container.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/promise.h"
 #include "impeller/renderer/backend/gles/pipeline_gles.h"
@@ -175,6 +176,7 @@ bool PipelineLibraryGLES::IsValid() const {
 // |PipelineLibrary|
 PipelineFuture<PipelineDescriptor> PipelineLibraryGLES::GetPipeline(
     PipelineDescriptor descriptor) {
+  Lock lock(pipelines_mutex_);
   if (auto found = pipelines_.find(descriptor); found != pipelines_.end()) {
     return found->second;
   }
@@ -205,7 +207,8 @@ PipelineFuture<PipelineDescriptor> PipelineLibraryGLES::GetPipeline(
 
   auto result = reactor_->AddOperation(
       [promise, weak_this, reactor_ptr = reactor_, descriptor, vert_function,
-       frag_function](const ReactorGLES& reactor) {
+       frag_function,
+       request_time = fml::TimePoint::Now()](const ReactorGLES& reactor) {
         auto strong_this = weak_this.lock();
         if (!strong_this) {
           promise->set_value(nullptr);
@@ -242,6 +245,13 @@ PipelineFuture<PipelineDescriptor> PipelineLibraryGLES::GetPipeline(
           VALIDATION_LOG << "Pipeline validation checks failed.";
           return;
         }
+#if !FLUTTER_RELEASE
+        FML_TRACE_COUNTER(
+            "impeller",                                                  //
+            "PipelineLibraryGLES", reinterpret_cast<int64_t>(&reactor),  //
+            "TimeToReadyMicroseconds",                                   //
+            (fml::TimePoint::Now() - request_time).ToMicroseconds());
+#endif  // !FLUTTER_RELEASE
         promise->set_value(std::move(pipeline));
       });
   FML_CHECK(result);
@@ -262,6 +272,7 @@ PipelineFuture<ComputePipelineDescriptor> PipelineLibraryGLES::GetPipeline(
 // |PipelineLibrary|
 void PipelineLibraryGLES::RemovePipelinesWithEntryPoint(
     std::shared_ptr<const ShaderFunction> function) {
+  Lock lock(pipelines_mutex_);
   fml::erase_if(pipelines_, [&](auto item) {
     return item->first.GetEntrypointForStage(function->GetStage())
         ->IsEqual(*function);
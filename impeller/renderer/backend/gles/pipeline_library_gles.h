@@ -5,6 +5,7 @@
 #pragma once
 
 #include "flutter/fml/macros.h"
+#include "impeller/base/thread.h"
 #include "impeller/renderer/backend/gles/reactor_gles.h"
 #include "impeller/renderer/pipeline_library.h"
 
@@ -21,7 +22,8 @@ class PipelineLibraryGLES final : public PipelineLibrary {
   friend ContextGLES;
 
   ReactorGLES::Ref reactor_;
-  PipelineMap pipelines_;
+  Mutex pipelines_mutex_;
+  PipelineMap pipelines_ IPLR_GUARDED_BY(pipelines_mutex_);
 
   PipelineLibraryGLES(ReactorGLES::Ref reactor);
 
@@ -5,6 +5,7 @@
 #include "impeller/renderer/backend/gles/reactor_gles.h"
 
 #include <algorithm>
+#include <map>
 
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/validation.h"
@@ -21,7 +22,18 @@ ReactorGLES::ReactorGLES(std::unique_ptr<ProcTableGLES> gl)
   is_valid_ = true;
 }
 
-ReactorGLES::~ReactorGLES() = default;
+ReactorGLES::~ReactorGLES() {
+  auto op = pending_ops_.exchange(nullptr, std::memory_order_acquire);
+  while (op) {
+    std::unique_ptr<PendingOperation> owned_op(op);
+    op = op->next;
+  }
+  // The pooled names were never handed out, so nothing else will delete them.
+  if (IsValid() && CanReactOnCurrentThread()) {
+    WriterLock handles_lock(handles_mutex_);
+    CollectPooledGLHandles();
+  }
+}
 
 bool ReactorGLES::IsValid() const {
   return is_valid_;
@@ -40,8 +52,7 @@ bool ReactorGLES::RemoveWorker(WorkerID worker) {
 }
 
 bool ReactorGLES::HasPendingOperations() const {
-  Lock ops_lock(ops_mutex_);
-  return !ops_.empty();
+  return pending_ops_.load(std::memory_order_acquire) != nullptr;
 }
 
 const ProcTableGLES& ReactorGLES::GetProcTable() const {
@@ -71,64 +82,115 @@ bool ReactorGLES::AddOperation(Operation operation) {
   if (!operation) {
     return false;
   }
-  {
-    Lock ops_lock(ops_mutex_);
-    ops_.emplace_back(std::move(operation));
+  auto op = new PendingOperation{.operation = std::move(operation)};
+  op->next = pending_ops_.load(std::memory_order_relaxed);
+  while (!pending_ops_.compare_exchange_weak(op->next, op,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
   }
   // Attempt a reaction if able but it is not an error if this isn't possible.
   [[maybe_unused]] auto result = React();
   return true;
 }
 
-static std::optional<GLuint> CreateGLHandle(const ProcTableGLES& gl,
-                                            HandleType type) {
-  GLuint handle = GL_NONE;
+// Framebuffers are not shared between contexts, so their names are only
+// generated on demand by whichever context the reactor reacts on.
+static bool IsPooledHandleType(HandleType type) {
   switch (type) {
+    case HandleType::kTexture:
+    case HandleType::kBuffer:
+    case HandleType::kRenderBuffer:
+      return true;
     case HandleType::kUnknown:
-      return std::nullopt;
+    case HandleType::kProgram:
+    case HandleType::kFrameBuffer:
+      return false;
+  }
+  return false;
+}
+
+static std::vector<GLuint> GenerateGLHandles(const ProcTableGLES& gl,
+                                             HandleType type,
+                                             GLsizei count) {
+  std::vector<GLuint> handles(count, GL_NONE);
+  switch (type) {
+    case HandleType::kUnknown:
+      return {};
     case HandleType::kTexture:
-      gl.GenTextures(1u, &handle);
-      return handle;
+      gl.GenTextures(count, handles.data());
+      return handles;
     case HandleType::kBuffer:
-      gl.GenBuffers(1u, &handle);
-      return handle;
+      gl.GenBuffers(count, handles.data());
+      return handles;
     case HandleType::kProgram:
-      return gl.CreateProgram();
+      for (auto& handle : handles) {
+        handle = gl.CreateProgram();
+      }
+      return handles;
     case HandleType::kRenderBuffer:
-      gl.GenRenderbuffers(1u, &handle);
-      return handle;
+      gl.GenRenderbuffers(count, handles.data());
+      return handles;
     case HandleType::kFrameBuffer:
-      gl.GenFramebuffers(1u, &handle);
-      return handle;
+      gl.GenFramebuffers(count, handles.data());
+      return handles;
   }
-  return std::nullopt;
+  return {};
 }
 
-static bool CollectGLHandle(const ProcTableGLES& gl,
-                            HandleType type,
-                            GLuint handle) {
+static bool CollectGLHandles(const ProcTableGLES& gl,
+                             HandleType type,
+                             const std::vector<GLuint>& handles) {
+  const auto count = static_cast<GLsizei>(handles.size());
   switch (type) {
     case HandleType::kUnknown:
       return false;
     case HandleType::kTexture:
-      gl.DeleteTextures(1u, &handle);
+      gl.DeleteTextures(count, handles.data());
       return true;
     case HandleType::kBuffer:
-      gl.DeleteBuffers(1u, &handle);
+      gl.DeleteBuffers(count, handles.data());
       return true;
     case HandleType::kProgram:
-      gl.DeleteProgram(handle);
+      for (auto handle : handles) {
+        gl.DeleteProgram(handle);
+      }
       return true;
     case HandleType::kRenderBuffer:
-      gl.DeleteRenderbuffers(1u, &handle);
+      gl.DeleteRenderbuffers(count, handles.data());
       return true;
     case HandleType::kFrameBuffer:
-      gl.DeleteFramebuffers(1u, &handle);
+      gl.DeleteFramebuffers(count, handles.data());
       return true;
   }
   return false;
 }
 
+void ReactorGLES::CollectPooledGLHandles() {
+  for (const auto& [type, names] : handle_pools_) {
+    if (!names.empty()) {
+      CollectGLHandles(GetProcTable(), type, names);
+    }
+  }
+  handle_pools_.clear();
+}
+
+std::optional<GLuint> ReactorGLES::CreateGLHandle(HandleType type) {
+  if (!IsPooledHandleType(type)) {
+    auto handles = GenerateGLHandles(GetProcTable(), type, 1);
+    return handles.empty() ? std::nullopt : std::optional(handles.front());
+  }
+  auto& pool = handle_pools_[type];
+  if (pool.empty()) {
+    pool = GenerateGLHandles(GetProcTable(), type, kHandlePoolBatchSize);
+    if (pool.empty()) {
+      return std::nullopt;
+    }
+  }
+  auto handle = pool.back();
+  pool.pop_back();
+  return handle;
+}
+
 HandleGLES ReactorGLES::CreateHandle(HandleType type) {
   if (type == HandleType::kUnknown) {
     return HandleGLES::DeadHandle();
@@ -138,9 +200,8 @@ HandleGLES ReactorGLES::CreateHandle(HandleType type) {
     return HandleGLES::DeadHandle();
   }
   WriterLock handles_lock(handles_mutex_);
-  auto gl_handle = CanReactOnCurrentThread()
-                       ? CreateGLHandle(GetProcTable(), type)
-                       : std::nullopt;
+  auto gl_handle =
+      CanReactOnCurrentThread() ? CreateGLHandle(type) : std::nullopt;
   handles_[new_handle] = LiveHandle{gl_handle};
   return new_handle;
 }
@@ -196,20 +257,23 @@ bool ReactorGLES::ConsolidateHandles() {
   const auto& gl = GetProcTable();
   WriterLock handles_lock(handles_mutex_);
   std::vector<HandleGLES> handles_to_delete;
+  // Names are deleted in one call per handle type.
+  std::map<HandleType, std::vector<GLuint>> names_to_collect;
   for (auto& handle : handles_) {
     // Collect dead handles.
     if (handle.second.pending_collection) {
       // This could be false if the handle was created and collected without
       // use. We still need to get rid of map entry.
       if (handle.second.name.has_value()) {
-        CollectGLHandle(gl, handle.first.type, handle.second.name.value());
+        names_to_collect[handle.first.type].push_back(
+            handle.second.name.value());
       }
       handles_to_delete.push_back(handle.first);
       continue;
     }
     // Create live handles.
     if (!handle.second.name.has_value()) {
-      auto gl_handle = CreateGLHandle(gl, handle.first.type);
+      auto gl_handle = CreateGLHandle(handle.first.type);
       if (!gl_handle) {
         VALIDATION_LOG << "Could not create GL handle.";
         return false;
@@ -225,6 +289,9 @@ bool ReactorGLES::ConsolidateHandles() {
       }
     }
   }
+  for (const auto& [type, names] : names_to_collect) {
+    CollectGLHandles(gl, type, names);
+  }
   for (const auto& handle_to_delete : handles_to_delete) {
     handles_.erase(handle_to_delete);
   }
@@ -233,16 +300,24 @@ bool ReactorGLES::ConsolidateHandles() {
 
 bool ReactorGLES::FlushOps() {
   TRACE_EVENT0("impeller", __FUNCTION__);
-  // Do NOT hold the ops or handles locks while performing operations in case
-  // the ops enqueue more ops.
-  decltype(ops_) ops;
-  {
-    Lock ops_lock(ops_mutex_);
-    std::swap(ops_, ops);
+  // Do NOT hold the handles lock while performing operations in case the ops
+  // enqueue more ops.
+  auto op = pending_ops_.exchange(nullptr, std::memory_order_acquire);
+
+  // The list is most recent first. Perform the operations in the order they
+  // were added.
+  PendingOperation* ops = nullptr;
+  while (op) {
+    auto next = op->next;
+    op->next = ops;
+    ops = op;
+    op = next;
   }
-  for (const auto& op : ops) {
+  while (ops) {
+    std::unique_ptr<PendingOperation> owned_op(ops);
+    ops = ops->next;
     TRACE_EVENT0("impeller", "ReactorGLES::Operation");
-    op(*this);
+    owned_op->operation(*this);
   }
   return true;
 }
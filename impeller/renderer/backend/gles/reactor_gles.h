@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -69,10 +71,22 @@ class ReactorGLES {
     constexpr bool IsLive() const { return name.has_value(); }
   };
 
+  struct PendingOperation {
+    Operation operation;
+    PendingOperation* next = nullptr;
+  };
+
+  //----------------------------------------------------------------------------
+  /// The number of GL names generated at once for handle types whose names
+  /// are pooled.
+  ///
+  static constexpr GLsizei kHandlePoolBatchSize = 16;
+
   std::unique_ptr<ProcTableGLES> proc_table_;
 
-  mutable Mutex ops_mutex_;
-  std::vector<Operation> ops_ IPLR_GUARDED_BY(ops_mutex_);
+  // Operations are pushed to the front of this list without taking a lock, so
+  // that threads adding operations don't contend with the reacting thread.
+  std::atomic<PendingOperation*> pending_ops_ = nullptr;
 
   // Make sure the container is one where erasing items during iteration doesn't
   // invalidate other iterators.
@@ -82,6 +96,9 @@ class ReactorGLES {
                                          HandleGLES::Equal>;
   mutable RWMutex handles_mutex_;
   LiveHandles handles_ IPLR_GUARDED_BY(handles_mutex_);
+  // GL names generated ahead of the handles that will use them.
+  std::map<HandleType, std::vector<GLuint>> handle_pools_
+      IPLR_GUARDED_BY(handles_mutex_);
 
   mutable Mutex workers_mutex_;
   mutable std::map<WorkerID, std::weak_ptr<Worker>> workers_
@@ -96,6 +113,11 @@ class ReactorGLES {
 
   bool CanReactOnCurrentThread() const;
 
+  std::optional<GLuint> CreateGLHandle(HandleType type)
+      IPLR_REQUIRES(handles_mutex_);
+
+  void CollectPooledGLHandles() IPLR_REQUIRES(handles_mutex_);
+
   bool ConsolidateHandles();
 
   bool FlushOps();
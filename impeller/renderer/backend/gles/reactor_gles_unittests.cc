@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/playground/playground_test.h"
+#include "impeller/renderer/backend/gles/context_gles.h"
+#include "impeller/renderer/backend/gles/reactor_gles.h"
+
+namespace impeller {
+namespace testing {
+
+using ReactorGLESTest = PlaygroundTest;
+INSTANTIATE_PLAYGROUND_SUITE(ReactorGLESTest);
+
+TEST_P(ReactorGLESTest, OperationsFromManyThreadsArePerformedInOrder) {
+  if (GetBackend() != PlaygroundBackend::kOpenGLES) {
+    GTEST_SKIP_("The reactor is only used by OpenGLES.");
+  }
+  const auto& reactor = ContextGLES::Cast(*GetContext()).GetReactor();
+
+  static constexpr size_t kThreadCount = 4u;
+  static constexpr size_t kOperationCount = 1000u;
+  // Operations are only performed on this thread.
+  std::vector<std::vector<size_t>> performed(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < kThreadCount; thread++) {
+    threads.emplace_back([&reactor, &performed, thread]() {
+      for (size_t i = 0; i < kOperationCount; i++) {
+        ASSERT_TRUE(reactor->AddOperation(
+            [&performed, thread, i](const ReactorGLES&) {
+              performed[thread].push_back(i);
+            }));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(reactor->React());
+
+  for (const auto& operations : performed) {
+    ASSERT_EQ(operations.size(), kOperationCount);
+    for (size_t i = 0; i < kOperationCount; i++) {
+      ASSERT_EQ(operations[i], i);
+    }
+  }
+}
+
+TEST_P(ReactorGLESTest, PooledHandlesHaveDistinctNames) {
+  if (GetBackend() != PlaygroundBackend::kOpenGLES) {
+    GTEST_SKIP_("The reactor is only used by OpenGLES.");
+  }
+  const auto& reactor = ContextGLES::Cast(*GetContext()).GetReactor();
+
+  // More than a batch of each type, to use more than one pooled range.
+  static constexpr size_t kHandleCount = 100u;
+  std::vector<HandleGLES> handles;
+  for (size_t i = 0; i < kHandleCount; i++) {
+    handles.push_back(reactor->CreateHandle(HandleType::kTexture));
+    handles.push_back(reactor->CreateHandle(HandleType::kBuffer));
+    handles.push_back(reactor->CreateHandle(HandleType::kRenderBuffer));
+    handles.push_back(reactor->CreateHandle(HandleType::kFrameBuffer));
+  }
+
+  std::set<std::pair<HandleType, GLuint>> names;
+  ASSERT_TRUE(reactor->AddOperation([&](const ReactorGLES& reactor_gles) {
+    for (const auto& handle : handles) {
+      auto name = reactor_gles.GetGLHandle(handle);
+      ASSERT_TRUE(name.has_value());
+      names.insert({handle.type, name.value()});
+    }
+  }));
+  ASSERT_TRUE(reactor->React());
+  EXPECT_EQ(names.size(), handles.size());
+
+  // The names are deleted in batches the next time the reactor reacts.
+  for (const auto& handle : handles) {
+    reactor->CollectHandle(handle);
+  }
+  ASSERT_TRUE(reactor->AddOperation([](const ReactorGLES&) {}));
+  ASSERT_TRUE(reactor->React());
+}
+
+}  // namespace testing
+}  // namespace impeller
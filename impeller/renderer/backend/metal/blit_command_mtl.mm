@@ -113,11 +113,11 @@ bool BlitCopyBufferToTextureCommandMTL::Encode(
     return false;
   }
 
-  auto destination_origin_mtl =
-      MTLOriginMake(destination_origin.x, destination_origin.y, 0);
+  auto destination_origin_mtl = MTLOriginMake(destination_region.origin.x,
+                                              destination_region.origin.y, 0);
 
-  auto image_size = destination->GetTextureDescriptor().size;
-  auto source_size_mtl = MTLSizeMake(image_size.width, image_size.height, 1);
+  auto source_size_mtl = MTLSizeMake(destination_region.size.width,
+                                     destination_region.size.height, 1);
 
   auto destination_bytes_per_pixel =
       BytesPerPixelForPixelFormat(destination->GetTextureDescriptor().format);
@@ -7,6 +7,7 @@
 #include "impeller/renderer/backend/metal/blit_pass_mtl.h"
 #include "impeller/renderer/backend/metal/compute_pass_mtl.h"
 #include "impeller/renderer/backend/metal/render_pass_mtl.h"
+#include "impeller/renderer/gpu_tracer.h"
 
 namespace impeller {
 
@@ -153,7 +154,38 @@ static CommandBuffer::Status ToCommitResult(MTLCommandBufferStatus status) {
   return CommandBufferMTL::Status::kError;
 }
 
+// Metal doesn't time the encoders of a command buffer without counter sample
+// buffers, so the time of the whole command buffer is attributed to its label.
+// Entity passes and filters create a command buffer per render pass.
+static void AddGPUTimeHandler(id<MTLCommandBuffer> buffer,
+                              std::shared_ptr<GPUTracer> tracer) {
+  if (!tracer || !tracer->IsPassTimingEnabled()) {
+    return;
+  }
+  if (@available(iOS 10.3, macOS 10.15, *)) {
+    const auto frame_number = tracer->AddPendingSubmission();
+    [buffer addCompletedHandler:^(id<MTLCommandBuffer> completed) {
+      std::vector<GPUPassTime> times;
+      if (completed.status == MTLCommandBufferStatusCompleted) {
+        times.push_back(GPUPassTime{
+            .label = completed.label.length > 0u
+                         ? completed.label.UTF8String
+                         : "CommandBuffer",
+            .time = fml::TimeDelta::FromSecondsF(completed.GPUEndTime -
+                                                 completed.GPUStartTime),
+            .pass_count = 1u,
+        });
+      }
+      tracer->RecordPassTimes(frame_number, std::move(times));
+    }];
+  }
+}
+
 bool CommandBufferMTL::OnSubmitCommands(CompletionCallback callback) {
+  if (auto context = context_.lock()) {
+    AddGPUTimeHandler(buffer_, context->GetGPUTracer());
+  }
+
   if (callback) {
     [buffer_
         addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
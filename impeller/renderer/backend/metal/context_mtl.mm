@@ -57,6 +57,7 @@ static std::unique_ptr<Capabilities> InferMetalCapabilities(
       .SetSupportsFramebufferFetch(DeviceSupportsFramebufferFetch(device))
       .SetDefaultColorFormat(color_format)
       .SetDefaultStencilFormat(PixelFormat::kS8UInt)
+      .SetDefaultDepthStencilFormat(PixelFormat::kD32FloatS8UInt)
       .SetSupportsCompute(true, DeviceSupportsComputeSubgroups(device))
       .SetSupportsReadFromResolve(true)
       .Build();
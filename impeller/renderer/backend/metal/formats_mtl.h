@@ -8,6 +8,7 @@
 
 #include <optional>
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/macros.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
@@ -35,6 +36,10 @@ constexpr PixelFormat FromMTLPixelFormat(MTLPixelFormat format) {
       return PixelFormat::kR16G16B16A16Float;
     case MTLPixelFormatStencil8:
       return PixelFormat::kS8UInt;
+#if !FML_OS_IOS
+    case MTLPixelFormatDepth24Unorm_Stencil8:
+      return PixelFormat::kD24UnormS8Uint;
+#endif  // FML_OS_IOS
     case MTLPixelFormatDepth32Float_Stencil8:
       return PixelFormat::kD32FloatS8UInt;
     case MTLPixelFormatBGR10_XR_sRGB:
@@ -86,6 +91,12 @@ constexpr MTLPixelFormat ToMTLPixelFormat(PixelFormat format) {
       return MTLPixelFormatRGBA16Float;
     case PixelFormat::kS8UInt:
       return MTLPixelFormatStencil8;
+    case PixelFormat::kD24UnormS8Uint:
+#if !FML_OS_IOS
+      return MTLPixelFormatDepth24Unorm_Stencil8;
+#else
+      return MTLPixelFormatInvalid;
+#endif  // FML_OS_IOS
     case PixelFormat::kD32FloatS8UInt:
       return MTLPixelFormatDepth32Float_Stencil8;
     case PixelFormat::kB10G10R10XRSRGB:
@@ -24,6 +24,9 @@ class GPUTracerMTL final : public GPUTracer,
   // |GPUTracer|
   bool StopCapturingFrame() override;
 
+  // |GPUTracer|
+  bool SupportsPassTiming() const override;
+
  private:
   friend class ContextMTL;
 
@@ -62,6 +62,13 @@ bool GPUTracerMTL::StopCapturingFrame() {
   return !captureManager.isCapturing;
 }
 
+bool GPUTracerMTL::SupportsPassTiming() const {
+  if (@available(iOS 10.3, macOS 10.15, *)) {
+    return true;
+  }
+  return false;
+}
+
 NSURL* GPUTracerMTL::GetUniqueGPUTraceSavedURL() const {
   NSURL* savedDictionaryURL = GetGPUTraceSavedDictionaryURL();
   NSString* uniqueID = [NSUUID UUID].UUIDString;
@@ -89,10 +89,32 @@ AllocatorVK::AllocatorVK(std::weak_ptr<Context> context,
     return;
   }
   allocator_ = allocator;
+  buffer_slabs_ = std::make_unique<BufferSlabAllocatorVK>(
+      [allocator](StorageMode storage_mode,
+                  size_t size) -> std::shared_ptr<BufferSlabVK> {
+        VkBuffer buffer = {};
+        VmaAllocation buffer_allocation = {};
+        VmaAllocationInfo buffer_allocation_info = {};
+        auto result = CreateBuffer(allocator, storage_mode, size, buffer,
+                                   buffer_allocation, buffer_allocation_info);
+        if (result != vk::Result::eSuccess) {
+          VALIDATION_LOG << "Unable to allocate a buffer slab: "
+                         << vk::to_string(result);
+          return nullptr;
+        }
+        return std::make_shared<BufferSlabVK>(allocator,               //
+                                              buffer_allocation,       //
+                                              buffer_allocation_info,  //
+                                              vk::Buffer{buffer},      //
+                                              size                     //
+        );
+      });
   is_valid_ = true;
 }
 
 AllocatorVK::~AllocatorVK() {
+  // Slabs that are not in use must be released before the allocator.
+  buffer_slabs_.reset();
   if (allocator_) {
     ::vmaDestroyAllocator(allocator_);
   }
@@ -343,36 +365,59 @@ std::shared_ptr<Texture> AllocatorVK::OnCreateTexture(
   return std::make_shared<TextureVK>(context_, std::move(source));
 }
 
-// |Allocator|
-std::shared_ptr<DeviceBuffer> AllocatorVK::OnCreateBuffer(
-    const DeviceBufferDescriptor& desc) {
+vk::Result AllocatorVK::CreateBuffer(VmaAllocator allocator,
+                                     StorageMode storage_mode,
+                                     size_t size,
+                                     VkBuffer& buffer,
+                                     VmaAllocation& allocation,
+                                     VmaAllocationInfo& allocation_info) {
   vk::BufferCreateInfo buffer_info;
   buffer_info.usage = vk::BufferUsageFlagBits::eVertexBuffer |
                       vk::BufferUsageFlagBits::eIndexBuffer |
                       vk::BufferUsageFlagBits::eUniformBuffer |
                       vk::BufferUsageFlagBits::eTransferSrc |
                       vk::BufferUsageFlagBits::eTransferDst;
-  buffer_info.size = desc.size;
+  buffer_info.size = size;
   buffer_info.sharingMode = vk::SharingMode::eExclusive;
   auto buffer_info_native =
       static_cast<vk::BufferCreateInfo::NativeType>(buffer_info);
 
-  VmaAllocationCreateInfo allocation_info = {};
-  allocation_info.usage = ToVMAMemoryUsage();
-  allocation_info.preferredFlags =
-      ToVKMemoryPropertyFlags(desc.storage_mode, false);
-  allocation_info.flags = ToVmaAllocationCreateFlags(desc.storage_mode, false);
+  VmaAllocationCreateInfo allocation_create_info = {};
+  allocation_create_info.usage = ToVMAMemoryUsage();
+  allocation_create_info.preferredFlags =
+      ToVKMemoryPropertyFlags(storage_mode, false);
+  allocation_create_info.flags =
+      ToVmaAllocationCreateFlags(storage_mode, false);
+
+  return vk::Result{::vmaCreateBuffer(allocator,                //
+                                      &buffer_info_native,      //
+                                      &allocation_create_info,  //
+                                      &buffer,                  //
+                                      &allocation,              //
+                                      &allocation_info          //
+                                      )};
+}
+
+// |Allocator|
+std::shared_ptr<DeviceBuffer> AllocatorVK::OnCreateBuffer(
+    const DeviceBufferDescriptor& desc) {
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  if (auto suballocation =
+          buffer_slabs_->Allocate(desc.storage_mode, desc.size);
+      suballocation.has_value()) {
+    return std::make_shared<DeviceBufferVK>(desc,      //
+                                            context_,  //
+                                            std::move(suballocation.value()));
+  }
 
   VkBuffer buffer = {};
   VmaAllocation buffer_allocation = {};
   VmaAllocationInfo buffer_allocation_info = {};
-  auto result = vk::Result{::vmaCreateBuffer(allocator_,              //
-                                             &buffer_info_native,     //
-                                             &allocation_info,        //
-                                             &buffer,                 //
-                                             &buffer_allocation,      //
-                                             &buffer_allocation_info  //
-                                             )};
+  auto result = CreateBuffer(allocator_, desc.storage_mode, desc.size, buffer,
+                             buffer_allocation, buffer_allocation_info);
 
   if (result != vk::Result::eSuccess) {
     VALIDATION_LOG << "Unable to allocate a device buffer: "
@@ -8,6 +8,7 @@
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/vulkan/procs/vulkan_proc_table.h"
 #include "impeller/core/allocator.h"
+#include "impeller/renderer/backend/vulkan/buffer_slab_allocator_vk.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/device_buffer_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
@@ -28,6 +29,7 @@ class AllocatorVK final : public Allocator {
   VmaAllocator allocator_ = {};
   std::weak_ptr<Context> context_;
   vk::Device device_;
+  std::unique_ptr<BufferSlabAllocatorVK> buffer_slabs_;
   ISize max_texture_size_;
   bool is_valid_ = false;
 
@@ -39,6 +41,13 @@ class AllocatorVK final : public Allocator {
               PFN_vkGetInstanceProcAddr get_instance_proc_address,
               PFN_vkGetDeviceProcAddr get_device_proc_address);
 
+  static vk::Result CreateBuffer(VmaAllocator allocator,
+                                 StorageMode storage_mode,
+                                 size_t size,
+                                 VkBuffer& buffer,
+                                 VmaAllocation& allocation,
+                                 VmaAllocationInfo& allocation_info);
+
   // |Allocator|
   bool IsValid() const;
 
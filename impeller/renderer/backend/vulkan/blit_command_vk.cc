@@ -112,7 +112,7 @@ bool BlitCopyTextureToBufferCommandVK::Encode(CommandEncoderVK& encoder) const {
   const auto& dst = DeviceBufferVK::Cast(*destination);
 
   vk::BufferImageCopy image_copy;
-  image_copy.setBufferOffset(destination_offset);
+  image_copy.setBufferOffset(dst.GetBufferOffset() + destination_offset);
   image_copy.setBufferRowLength(0);
   image_copy.setBufferImageHeight(0);
   image_copy.setImageSubresource(
@@ -136,6 +136,64 @@ bool BlitCopyTextureToBufferCommandVK::Encode(CommandEncoderVK& encoder) const {
   return true;
 }
 
+//------------------------------------------------------------------------------
+/// BlitCopyBufferToTextureCommandVK
+///
+
+BlitCopyBufferToTextureCommandVK::~BlitCopyBufferToTextureCommandVK() = default;
+
+std::string BlitCopyBufferToTextureCommandVK::GetLabel() const {
+  return label;
+}
+
+bool BlitCopyBufferToTextureCommandVK::Encode(CommandEncoderVK& encoder) const {
+  const auto& cmd_buffer = encoder.GetCommandBuffer();
+
+  const auto& dst = TextureVK::Cast(*destination);
+  auto buffer = std::static_pointer_cast<const DeviceBuffer>(source.buffer);
+  const auto& src = DeviceBufferVK::Cast(*buffer);
+
+  LayoutTransition transition;
+  transition.cmd_buffer = cmd_buffer;
+  transition.new_layout = vk::ImageLayout::eTransferDstOptimal;
+  transition.src_access = vk::AccessFlagBits::eShaderRead |
+                          vk::AccessFlagBits::eTransferWrite;
+  transition.src_stage = vk::PipelineStageFlagBits::eFragmentShader |
+                         vk::PipelineStageFlagBits::eTransfer;
+  transition.dst_access = vk::AccessFlagBits::eTransferWrite;
+  transition.dst_stage = vk::PipelineStageFlagBits::eTransfer;
+
+  vk::BufferImageCopy image_copy;
+  image_copy.setBufferOffset(src.GetBufferOffset() + source.range.offset);
+  image_copy.setBufferRowLength(0);
+  image_copy.setBufferImageHeight(0);
+  image_copy.setImageSubresource(
+      vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1));
+  image_copy.setImageOffset(vk::Offset3D(destination_region.origin.x,
+                                         destination_region.origin.y, 0));
+  image_copy.setImageExtent(vk::Extent3D(destination_region.size.width,
+                                         destination_region.size.height, 1));
+
+  if (!dst.SetLayout(transition)) {
+    VALIDATION_LOG << "Could not encode layout transition.";
+    return false;
+  }
+
+  cmd_buffer.copyBufferToImage(src.GetBuffer(),        //
+                               dst.GetImage(),         //
+                               transition.new_layout,  //
+                               image_copy              //
+  );
+
+  // The staging buffer must outlive the copy, which only happens once the
+  // command buffer is done executing.
+  if (!encoder.Track(buffer) || !encoder.Track(destination)) {
+    return false;
+  }
+
+  return true;
+}
+
 //------------------------------------------------------------------------------
 /// BlitGenerateMipmapCommandVK
 ///
@@ -4,8 +4,10 @@
 
 #include "impeller/renderer/backend/vulkan/blit_pass_vk.h"
 
+#include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
+#include "impeller/renderer/backend/vulkan/command_encoder_vk.h"
 
 namespace impeller {
 
@@ -40,6 +42,10 @@ bool BlitPassVK::EncodeCommands(
     return false;
   }
 
+  encoder->BeginPassTimer(label_.empty() ? "BlitPass" : label_);
+  fml::ScopedCleanupClosure end_pass_timer(
+      [&encoder]() { encoder->EndPassTimer(); });
+
   for (auto& command : commands_) {
     if (!command->Encode(*encoder)) {
       return false;
@@ -87,6 +93,23 @@ bool BlitPassVK::OnCopyTextureToBufferCommand(
   return true;
 }
 
+// |BlitPass|
+bool BlitPassVK::OnCopyBufferToTextureCommand(
+    BufferView source,
+    std::shared_ptr<Texture> destination,
+    IRect destination_region,
+    std::string label) {
+  auto command = std::make_unique<BlitCopyBufferToTextureCommandVK>();
+
+  command->source = std::move(source);
+  command->destination = std::move(destination);
+  command->destination_region = destination_region;
+  command->label = std::move(label);
+
+  commands_.push_back(std::move(command));
+  return true;
+}
+
 // |BlitPass|
 bool BlitPassVK::OnGenerateMipmapCommand(std::shared_ptr<Texture> texture,
                                          std::string label) {
@@ -0,0 +1,247 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/buffer_slab_allocator_vk.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+BufferSlabVK::BufferSlabVK(VmaAllocator allocator,
+                           VmaAllocation allocation,
+                           VmaAllocationInfo info,
+                           vk::Buffer buffer,
+                           size_t capacity)
+    : allocator_(allocator),
+      allocation_(allocation),
+      info_(info),
+      buffer_(buffer),
+      capacity_(capacity) {}
+
+BufferSlabVK::~BufferSlabVK() {
+  if (buffer_) {
+    ::vmaDestroyBuffer(allocator_,
+                       static_cast<decltype(buffer_)::NativeType>(buffer_),
+                       allocation_);
+  }
+}
+
+vk::Buffer BufferSlabVK::GetBuffer() const {
+  return buffer_;
+}
+
+uint8_t* BufferSlabVK::GetContents() const {
+  return static_cast<uint8_t*>(info_.pMappedData);
+}
+
+size_t BufferSlabVK::GetCapacity() const {
+  return capacity_;
+}
+
+static size_t AlignOffset(size_t offset, size_t alignment) {
+  return ((offset + alignment - 1u) / alignment) * alignment;
+}
+
+std::optional<size_t> BufferSlabVK::Allocate(size_t length, size_t alignment) {
+  Lock lock(mutex_);
+  auto offset = AllocateFromFreeRanges(length, alignment);
+  if (!offset.has_value()) {
+    const auto aligned_offset = AlignOffset(offset_, alignment);
+    if (aligned_offset + length > capacity_) {
+      return std::nullopt;
+    }
+    // The padding can be handed out once a neighbor is freed.
+    if (aligned_offset > offset_) {
+      AddFreeRange(offset_, aligned_offset - offset_);
+    }
+    offset_ = aligned_offset + length;
+    offset = aligned_offset;
+  }
+  live_count_++;
+  live_bytes_ += length;
+  return offset;
+}
+
+std::optional<size_t> BufferSlabVK::AllocateFromFreeRanges(size_t length,
+                                                           size_t alignment) {
+  // Ranges that are long enough may still be too short once aligned.
+  for (auto it = free_range_lengths_.lower_bound({length, 0u});
+       it != free_range_lengths_.end(); ++it) {
+    const auto [range_length, range_offset] = *it;
+    const auto offset = AlignOffset(range_offset, alignment);
+    if (offset + length > range_offset + range_length) {
+      continue;
+    }
+    EraseFreeRange(free_ranges_.find(range_offset));
+    if (offset > range_offset) {
+      InsertFreeRange(range_offset, offset - range_offset);
+    }
+    if (offset + length < range_offset + range_length) {
+      InsertFreeRange(offset + length,
+                      range_offset + range_length - offset - length);
+    }
+    return offset;
+  }
+  return std::nullopt;
+}
+
+void BufferSlabVK::AddFreeRange(size_t offset, size_t length) {
+  auto next = free_ranges_.lower_bound(offset);
+  if (next != free_ranges_.end() && next->first == offset + length) {
+    length += next->second;
+    next = EraseFreeRange(next);
+  }
+  if (next != free_ranges_.begin()) {
+    auto previous = std::prev(next);
+    if (previous->first + previous->second == offset) {
+      offset = previous->first;
+      length += previous->second;
+      EraseFreeRange(previous);
+    }
+  }
+  if (offset + length == offset_) {
+    offset_ = offset;
+    return;
+  }
+  InsertFreeRange(offset, length);
+}
+
+void BufferSlabVK::InsertFreeRange(size_t offset, size_t length) {
+  free_ranges_[offset] = length;
+  free_range_lengths_.insert({length, offset});
+}
+
+std::map<size_t, size_t>::iterator BufferSlabVK::EraseFreeRange(
+    std::map<size_t, size_t>::iterator range) {
+  free_range_lengths_.erase({range->second, range->first});
+  return free_ranges_.erase(range);
+}
+
+void BufferSlabVK::Free(size_t offset, size_t length) {
+  Lock lock(mutex_);
+  FML_DCHECK(live_count_ > 0u && live_bytes_ >= length);
+  FML_DCHECK(offset + length <= offset_);
+  live_count_--;
+  live_bytes_ -= length;
+  AddFreeRange(offset, length);
+  FML_DCHECK(live_count_ > 0u || (offset_ == 0u && free_ranges_.empty()));
+}
+
+bool BufferSlabVK::IsEmpty() const {
+  Lock lock(mutex_);
+  return live_count_ == 0u;
+}
+
+size_t BufferSlabVK::GetLiveBytes() const {
+  Lock lock(mutex_);
+  return live_bytes_;
+}
+
+size_t BufferSlabVK::GetDeadBytes() const {
+  Lock lock(mutex_);
+  return offset_ - live_bytes_;
+}
+
+Scalar BufferSlabAllocatorVK::Statistics::GetOccupancy() const {
+  return capacity == 0u ? 0.0f : static_cast<Scalar>(live_bytes) / capacity;
+}
+
+Scalar BufferSlabAllocatorVK::Statistics::GetFragmentation() const {
+  const auto used_bytes = live_bytes + dead_bytes;
+  return used_bytes == 0u ? 0.0f
+                          : static_cast<Scalar>(dead_bytes) / used_bytes;
+}
+
+BufferSlabAllocatorVK::BufferSlabAllocatorVK(SlabFactory factory)
+    : factory_(std::move(factory)) {}
+
+BufferSlabAllocatorVK::~BufferSlabAllocatorVK() = default;
+
+std::optional<BufferSuballocationVK> BufferSlabAllocatorVK::Allocate(
+    StorageMode storage_mode,
+    size_t length) {
+  if (length == 0u || length > kMaxSuballocationSize || !factory_) {
+    return std::nullopt;
+  }
+
+  Lock lock(slabs_mutex_);
+  auto& slabs = slabs_[storage_mode];
+  if (ReleaseEmptySlabs(slabs)) {
+    ReportStatistics();
+  }
+  for (const auto& slab : slabs) {
+    if (auto offset = slab->Allocate(length, kAlignment); offset.has_value()) {
+      return BufferSuballocationVK{.slab = slab, .offset = offset.value()};
+    }
+  }
+
+  if (slabs.size() >= kMaxSlabCount) {
+    return std::nullopt;
+  }
+  auto slab = factory_(storage_mode, kSlabSize);
+  if (!slab) {
+    return std::nullopt;
+  }
+  auto offset = slab->Allocate(length, kAlignment);
+  if (!offset.has_value()) {
+    return std::nullopt;
+  }
+  slabs.push_back(slab);
+  ReportStatistics();
+  return BufferSuballocationVK{.slab = std::move(slab),
+                               .offset = offset.value()};
+}
+
+bool BufferSlabAllocatorVK::ReleaseEmptySlabs(
+    std::vector<std::shared_ptr<BufferSlabVK>>& slabs) {
+  const auto slab_count = slabs.size();
+  size_t empty_slab_count = 0u;
+  slabs.erase(std::remove_if(slabs.begin(), slabs.end(),
+                             [&empty_slab_count](const auto& slab) {
+                               return slab->IsEmpty() &&
+                                      ++empty_slab_count > kMaxEmptySlabCount;
+                             }),
+              slabs.end());
+  return slabs.size() != slab_count;
+}
+
+BufferSlabAllocatorVK::Statistics BufferSlabAllocatorVK::GetStatistics()
+    const {
+  Lock lock(slabs_mutex_);
+  return ComputeStatistics();
+}
+
+BufferSlabAllocatorVK::Statistics BufferSlabAllocatorVK::ComputeStatistics()
+    const {
+  Statistics statistics;
+  for (const auto& [_, slabs] : slabs_) {
+    for (const auto& slab : slabs) {
+      statistics.slab_count++;
+      statistics.capacity += slab->GetCapacity();
+      statistics.live_bytes += slab->GetLiveBytes();
+      statistics.dead_bytes += slab->GetDeadBytes();
+    }
+  }
+  return statistics;
+}
+
+void BufferSlabAllocatorVK::ReportStatistics() const {
+#if !FLUTTER_RELEASE
+  const auto statistics = ComputeStatistics();
+  FML_TRACE_COUNTER(
+      "impeller",                                                          //
+      "BufferSlabAllocatorVK", reinterpret_cast<int64_t>(this),            //
+      "Slabs", statistics.slab_count,                                      //
+      "OccupancyPercent",                                                  //
+      static_cast<int64_t>(statistics.GetOccupancy() * 100.0f),            //
+      "FragmentationPercent",                                              //
+      static_cast<int64_t>(statistics.GetFragmentation() * 100.0f));
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace impeller
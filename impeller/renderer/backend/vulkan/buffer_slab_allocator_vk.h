@@ -0,0 +1,221 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/base/thread.h"
+#include "impeller/core/formats.h"
+#include "impeller/geometry/scalar.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A large buffer that the memory of many small device buffers is
+///             carved out of.
+///
+///             Space is handed out by bumping an offset. The space of device
+///             buffers that are gone, which is after the last command buffer
+///             that uses them has completed, is kept in a list of free
+///             ranges. Adjacent free ranges are merged, and new device
+///             buffers are placed in the smallest free range they fit in
+///             before the offset is bumped. That way, a long lived device
+///             buffer does not keep the rest of its slab from being reused.
+///
+///             This class is thread safe.
+///
+class BufferSlabVK {
+ public:
+  BufferSlabVK(VmaAllocator allocator,
+               VmaAllocation allocation,
+               VmaAllocationInfo info,
+               vk::Buffer buffer,
+               size_t capacity);
+
+  ~BufferSlabVK();
+
+  vk::Buffer GetBuffer() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The contents of the slab, or nullptr if it is not host
+  ///             visible.
+  ///
+  uint8_t* GetContents() const;
+
+  size_t GetCapacity() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Carve out space for a device buffer.
+  ///
+  /// @return     The offset of the space, or std::nullopt if the slab is full.
+  ///
+  std::optional<size_t> Allocate(size_t length, size_t alignment);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Return the space of a device buffer, so that it can be
+  ///             handed out again.
+  ///
+  /// @param[in]  offset  The offset returned by `Allocate`.
+  /// @param[in]  length  The length passed to `Allocate`.
+  ///
+  void Free(size_t offset, size_t length);
+
+  bool IsEmpty() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of bytes held by live device buffers.
+  ///
+  size_t GetLiveBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of bytes below the offset that are not held by
+  ///             live device buffers, including alignment padding. They are
+  ///             handed out again to the device buffers that fit in them.
+  ///
+  size_t GetDeadBytes() const;
+
+ private:
+  const VmaAllocator allocator_ = {};
+  const VmaAllocation allocation_ = {};
+  const VmaAllocationInfo info_ = {};
+  const vk::Buffer buffer_ = {};
+  const size_t capacity_ = 0u;
+  mutable Mutex mutex_;
+  size_t offset_ IPLR_GUARDED_BY(mutex_) = 0u;
+  size_t live_count_ IPLR_GUARDED_BY(mutex_) = 0u;
+  size_t live_bytes_ IPLR_GUARDED_BY(mutex_) = 0u;
+  // The free ranges below the offset, by offset. They are never adjacent to
+  // each other or to the offset.
+  std::map<size_t, size_t> free_ranges_ IPLR_GUARDED_BY(mutex_);
+  // The same free ranges, by length and then offset.
+  std::set<std::pair<size_t, size_t>> free_range_lengths_
+      IPLR_GUARDED_BY(mutex_);
+
+  std::optional<size_t> AllocateFromFreeRanges(size_t length,
+                                               size_t alignment)
+      IPLR_REQUIRES(mutex_);
+
+  void AddFreeRange(size_t offset, size_t length) IPLR_REQUIRES(mutex_);
+
+  void InsertFreeRange(size_t offset, size_t length) IPLR_REQUIRES(mutex_);
+
+  std::map<size_t, size_t>::iterator EraseFreeRange(
+      std::map<size_t, size_t>::iterator range) IPLR_REQUIRES(mutex_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BufferSlabVK);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Space in a buffer slab.
+///
+struct BufferSuballocationVK {
+  std::shared_ptr<BufferSlabVK> slab;
+  size_t offset = 0u;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Hands out the memory of small device buffers from slabs, one
+///             set of slabs per storage mode.
+///
+///             This avoids a buffer creation and a memory allocation per
+///             device buffer, which adds up for the many small buffers of
+///             vertices, indices and uniforms created every frame.
+///
+///             This class is thread safe.
+///
+class BufferSlabAllocatorVK {
+ public:
+  //----------------------------------------------------------------------------
+  /// The size of each slab.
+  ///
+  static constexpr size_t kSlabSize = 4u * 1024u * 1024u;
+
+  //----------------------------------------------------------------------------
+  /// Device buffers larger than this get buffers of their own.
+  ///
+  static constexpr size_t kMaxSuballocationSize = 64u * 1024u;
+
+  //----------------------------------------------------------------------------
+  /// The alignment of suballocations. This is the largest minimum uniform
+  /// buffer offset alignment allowed by the Vulkan specification, so that
+  /// uniforms may be bound at any offset that is aligned for them within the
+  /// device buffer.
+  ///
+  static constexpr size_t kAlignment = 256u;
+
+  //----------------------------------------------------------------------------
+  /// The maximum number of slabs per storage mode. Once reached, device
+  /// buffers get buffers of their own.
+  ///
+  static constexpr size_t kMaxSlabCount = 32u;
+
+  //----------------------------------------------------------------------------
+  /// The number of empty slabs kept per storage mode. Additional slabs are
+  /// released once they are empty.
+  ///
+  static constexpr size_t kMaxEmptySlabCount = 2u;
+
+  struct Statistics {
+    size_t slab_count = 0u;
+    /// The number of bytes of all slabs.
+    size_t capacity = 0u;
+    /// The number of bytes held by live device buffers.
+    size_t live_bytes = 0u;
+    /// The number of bytes that were handed out but are not held by live
+    /// device buffers. They are reused by device buffers that fit in them.
+    size_t dead_bytes = 0u;
+
+    /// The fraction of the slabs held by live device buffers.
+    Scalar GetOccupancy() const;
+
+    /// The fraction of the used bytes of the slabs that are dead.
+    Scalar GetFragmentation() const;
+  };
+
+  using SlabFactory = std::function<std::shared_ptr<BufferSlabVK>(
+      StorageMode storage_mode,
+      size_t size)>;
+
+  explicit BufferSlabAllocatorVK(SlabFactory factory);
+
+  ~BufferSlabAllocatorVK();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find space for a device buffer.
+  ///
+  /// @return     The space, or std::nullopt if the device buffer should get a
+  ///             buffer of its own.
+  ///
+  std::optional<BufferSuballocationVK> Allocate(StorageMode storage_mode,
+                                                size_t length);
+
+  Statistics GetStatistics() const;
+
+ private:
+  const SlabFactory factory_;
+  mutable Mutex slabs_mutex_;
+  std::map<StorageMode, std::vector<std::shared_ptr<BufferSlabVK>>> slabs_
+      IPLR_GUARDED_BY(slabs_mutex_);
+
+  bool ReleaseEmptySlabs(std::vector<std::shared_ptr<BufferSlabVK>>& slabs)
+      IPLR_REQUIRES(slabs_mutex_);
+
+  Statistics ComputeStatistics() const IPLR_REQUIRES(slabs_mutex_);
+
+  void ReportStatistics() const IPLR_REQUIRES(slabs_mutex_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BufferSlabAllocatorVK);
+};
+
+}  // namespace impeller
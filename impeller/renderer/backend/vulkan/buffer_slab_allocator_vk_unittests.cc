@@ -0,0 +1,182 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/renderer/backend/vulkan/buffer_slab_allocator_vk.h"
+
+namespace impeller {
+namespace testing {
+
+// Slabs without a buffer, which is all the bookkeeping needs.
+static BufferSlabAllocatorVK::SlabFactory MakeSlabFactory(
+    size_t& slab_creation_count) {
+  return [&slab_creation_count](StorageMode storage_mode, size_t size) {
+    slab_creation_count++;
+    return std::make_shared<BufferSlabVK>(VmaAllocator{}, VmaAllocation{},
+                                          VmaAllocationInfo{}, vk::Buffer{},
+                                          size);
+  };
+}
+
+TEST(BufferSlabAllocatorVKTest, SmallBuffersShareASlab) {
+  size_t slab_creation_count = 0u;
+  BufferSlabAllocatorVK allocator(MakeSlabFactory(slab_creation_count));
+
+  auto first = allocator.Allocate(StorageMode::kHostVisible, 100u);
+  auto second = allocator.Allocate(StorageMode::kHostVisible, 300u);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(first->slab, second->slab);
+  EXPECT_EQ(first->offset, 0u);
+  EXPECT_EQ(second->offset, BufferSlabAllocatorVK::kAlignment);
+  EXPECT_EQ(slab_creation_count, 1u);
+
+  // Each storage mode has slabs of its own.
+  auto third = allocator.Allocate(StorageMode::kDevicePrivate, 100u);
+  ASSERT_TRUE(third.has_value());
+  EXPECT_NE(third->slab, first->slab);
+  EXPECT_EQ(slab_creation_count, 2u);
+}
+
+TEST(BufferSlabAllocatorVKTest, LargeBuffersAreNotSuballocated) {
+  size_t slab_creation_count = 0u;
+  BufferSlabAllocatorVK allocator(MakeSlabFactory(slab_creation_count));
+
+  EXPECT_FALSE(allocator
+                   .Allocate(StorageMode::kHostVisible,
+                             BufferSlabAllocatorVK::kMaxSuballocationSize + 1u)
+                   .has_value());
+  EXPECT_FALSE(allocator.Allocate(StorageMode::kHostVisible, 0u).has_value());
+  EXPECT_EQ(slab_creation_count, 0u);
+}
+
+TEST(BufferSlabAllocatorVKTest, FreedSpaceIsReused) {
+  size_t slab_creation_count = 0u;
+  BufferSlabAllocatorVK allocator(MakeSlabFactory(slab_creation_count));
+
+  std::vector<BufferSuballocationVK> suballocations;
+  const size_t length = BufferSlabAllocatorVK::kMaxSuballocationSize;
+  const size_t count = BufferSlabAllocatorVK::kSlabSize / length;
+  for (size_t i = 0; i < count; i++) {
+    auto suballocation = allocator.Allocate(StorageMode::kHostVisible, length);
+    ASSERT_TRUE(suballocation.has_value());
+    suballocations.push_back(std::move(suballocation.value()));
+  }
+  EXPECT_EQ(slab_creation_count, 1u);
+
+  // Free every other device buffer.
+  for (size_t i = 0; i < count; i += 2u) {
+    suballocations[i].slab->Free(suballocations[i].offset, length);
+  }
+  auto statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.live_bytes, length * (count / 2u));
+  EXPECT_EQ(statistics.dead_bytes, length * (count / 2u));
+  EXPECT_FLOAT_EQ(statistics.GetFragmentation(), 0.5f);
+
+  // The freed space is handed out again, lowest offset first.
+  for (size_t i = 0; i < count; i += 2u) {
+    auto reused = allocator.Allocate(StorageMode::kHostVisible, length);
+    ASSERT_TRUE(reused.has_value());
+    EXPECT_EQ(reused->slab, suballocations[0].slab);
+    EXPECT_EQ(reused->offset, suballocations[i].offset);
+  }
+  EXPECT_EQ(allocator.GetStatistics().dead_bytes, 0u);
+  EXPECT_EQ(slab_creation_count, 1u);
+}
+
+TEST(BufferSlabAllocatorVKTest, LongLivedBuffersDoNotPinSlabs) {
+  size_t slab_creation_count = 0u;
+  BufferSlabAllocatorVK allocator(MakeSlabFactory(slab_creation_count));
+
+  const size_t length = 1000u;
+  auto long_lived = allocator.Allocate(StorageMode::kHostVisible, length);
+  ASSERT_TRUE(long_lived.has_value());
+
+  // With padding, each device buffer takes up 1024 bytes. Many frames that
+  // fill the rest of the slab fit in the same slab.
+  const size_t count = BufferSlabAllocatorVK::kSlabSize / 1024u - 1u;
+  for (size_t frame = 0; frame < 3u; frame++) {
+    std::vector<BufferSuballocationVK> suballocations;
+    for (size_t i = 0; i < count; i++) {
+      auto suballocation =
+          allocator.Allocate(StorageMode::kHostVisible, length);
+      ASSERT_TRUE(suballocation.has_value());
+      suballocations.push_back(std::move(suballocation.value()));
+    }
+    for (const auto& suballocation : suballocations) {
+      suballocation.slab->Free(suballocation.offset, length);
+    }
+  }
+  EXPECT_EQ(slab_creation_count, 1u);
+
+  // Only the long lived device buffer remains.
+  auto statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.live_bytes, length);
+  EXPECT_EQ(statistics.dead_bytes, 0u);
+
+  long_lived->slab->Free(long_lived->offset, length);
+  EXPECT_TRUE(long_lived->slab->IsEmpty());
+  EXPECT_EQ(allocator.GetStatistics().dead_bytes, 0u);
+}
+
+TEST(BufferSlabAllocatorVKTest, AdjacentFreeRangesAreMerged) {
+  size_t slab_creation_count = 0u;
+  BufferSlabAllocatorVK allocator(MakeSlabFactory(slab_creation_count));
+
+  const size_t length = 100u;
+  std::vector<BufferSuballocationVK> suballocations;
+  for (size_t i = 0; i < 4u; i++) {
+    auto suballocation = allocator.Allocate(StorageMode::kHostVisible, length);
+    ASSERT_TRUE(suballocation.has_value());
+    suballocations.push_back(std::move(suballocation.value()));
+  }
+
+  // Free the two in the middle, in either order.
+  suballocations[2].slab->Free(suballocations[2].offset, length);
+  suballocations[1].slab->Free(suballocations[1].offset, length);
+
+  // Together with their padding, they fit a device buffer that neither fits
+  // in on its own.
+  auto merged = allocator.Allocate(StorageMode::kHostVisible,
+                                   BufferSlabAllocatorVK::kAlignment * 2u);
+  ASSERT_TRUE(merged.has_value());
+  EXPECT_EQ(merged->offset, suballocations[1].offset);
+}
+
+TEST(BufferSlabAllocatorVKTest, SlabCountIsBounded) {
+  size_t slab_creation_count = 0u;
+  BufferSlabAllocatorVK allocator(MakeSlabFactory(slab_creation_count));
+
+  const size_t length = BufferSlabAllocatorVK::kMaxSuballocationSize;
+  const size_t count = BufferSlabAllocatorVK::kSlabSize / length *
+                       BufferSlabAllocatorVK::kMaxSlabCount;
+  std::vector<BufferSuballocationVK> suballocations;
+  for (size_t i = 0; i < count; i++) {
+    auto suballocation = allocator.Allocate(StorageMode::kHostVisible, length);
+    ASSERT_TRUE(suballocation.has_value());
+    suballocations.push_back(std::move(suballocation.value()));
+  }
+  EXPECT_FALSE(
+      allocator.Allocate(StorageMode::kHostVisible, length).has_value());
+
+  auto statistics = allocator.GetStatistics();
+  EXPECT_EQ(statistics.slab_count, BufferSlabAllocatorVK::kMaxSlabCount);
+  EXPECT_FLOAT_EQ(statistics.GetOccupancy(), 1.0f);
+
+  // Only a few of the slabs are kept once they are empty.
+  for (const auto& suballocation : suballocations) {
+    suballocation.slab->Free(suballocation.offset, length);
+  }
+  suballocations.clear();
+  EXPECT_TRUE(
+      allocator.Allocate(StorageMode::kHostVisible, length).has_value());
+  EXPECT_EQ(allocator.GetStatistics().slab_count,
+            BufferSlabAllocatorVK::kMaxEmptySlabCount);
+  EXPECT_EQ(slab_creation_count, BufferSlabAllocatorVK::kMaxSlabCount);
+}
+
+}  // namespace testing
+}  // namespace impeller
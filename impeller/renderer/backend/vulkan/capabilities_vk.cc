@@ -284,11 +284,19 @@ bool CapabilitiesVK::SetDevice(const vk::PhysicalDevice& device) {
     return false;
   }
 
-  if (HasSuitableDepthStencilFormat(device, vk::Format::eS8Uint)) {
-    depth_stencil_format_ = PixelFormat::kS8UInt;
+  if (HasSuitableDepthStencilFormat(device, vk::Format::eD32SfloatS8Uint)) {
+    depth_stencil_format_ = PixelFormat::kD32FloatS8UInt;
   } else if (HasSuitableDepthStencilFormat(device,
                                            vk::Format::eD24UnormS8Uint)) {
-    depth_stencil_format_ = PixelFormat::kD32FloatS8UInt;
+    depth_stencil_format_ = PixelFormat::kD24UnormS8Uint;
+  } else {
+    depth_stencil_format_ = PixelFormat::kUnknown;
+  }
+
+  if (HasSuitableDepthStencilFormat(device, vk::Format::eS8Uint)) {
+    stencil_format_ = PixelFormat::kS8UInt;
+  } else if (depth_stencil_format_ != PixelFormat::kUnknown) {
+    stencil_format_ = depth_stencil_format_;
   } else {
     return false;
   }
@@ -349,6 +357,11 @@ PixelFormat CapabilitiesVK::GetDefaultColorFormat() const {
 
 // |Capabilities|
 PixelFormat CapabilitiesVK::GetDefaultStencilFormat() const {
+  return stencil_format_;
+}
+
+// |Capabilities|
+PixelFormat CapabilitiesVK::GetDefaultDepthStencilFormat() const {
   return depth_stencil_format_;
 }
 
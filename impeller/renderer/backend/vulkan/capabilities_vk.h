@@ -79,10 +79,14 @@ class CapabilitiesVK final : public Capabilities,
   // |Capabilities|
   PixelFormat GetDefaultStencilFormat() const override;
 
+  // |Capabilities|
+  PixelFormat GetDefaultDepthStencilFormat() const override;
+
  private:
   const bool enable_validations_;
   std::map<std::string, std::set<std::string>> exts_;
   PixelFormat color_format_ = PixelFormat::kUnknown;
+  PixelFormat stencil_format_ = PixelFormat::kUnknown;
   PixelFormat depth_stencil_format_ = PixelFormat::kUnknown;
   vk::PhysicalDeviceProperties device_properties_;
   bool is_valid_ = false;
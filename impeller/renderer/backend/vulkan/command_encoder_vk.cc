@@ -8,15 +8,18 @@
 #include "flutter/fml/trace_event.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/fence_waiter_vk.h"
+#include "impeller/renderer/backend/vulkan/gpu_tracer_vk.h"
 #include "impeller/renderer/backend/vulkan/texture_vk.h"
 
 namespace impeller {
 
 class TrackedObjectsVK {
  public:
-  explicit TrackedObjectsVK(const vk::Device& device,
-                            const std::shared_ptr<CommandPoolVK>& pool)
-      : desc_pool_(device) {
+  TrackedObjectsVK(
+      const vk::Device& device,
+      const std::shared_ptr<CommandPoolVK>& pool,
+      std::weak_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler)
+      : desc_pool_(device, std::move(descriptor_pool_recycler)) {
     if (!pool) {
       return;
     }
@@ -29,10 +32,45 @@ class TrackedObjectsVK {
     is_valid_ = true;
   }
 
+  TrackedObjectsVK(
+      const vk::Device& device,
+      const std::shared_ptr<CommandPoolRecyclerVK>& pool_recycler,
+      std::weak_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler)
+      : desc_pool_(device, std::move(descriptor_pool_recycler)) {
+    if (!pool_recycler) {
+      return;
+    }
+    auto own_pool = pool_recycler->Get();
+    if (!own_pool) {
+      return;
+    }
+    vk::CommandBufferAllocateInfo alloc_info;
+    alloc_info.commandPool = own_pool.get();
+    alloc_info.commandBufferCount = 1u;
+    alloc_info.level = vk::CommandBufferLevel::eSecondary;
+    auto [result, buffers] = device.allocateCommandBuffersUnique(alloc_info);
+    if (result != vk::Result::eSuccess) {
+      pool_recycler->Reclaim(std::move(own_pool));
+      return;
+    }
+    pool_recycler_ = pool_recycler;
+    own_pool_ = std::move(own_pool);
+    buffer_ = std::move(buffers[0]);
+    is_valid_ = true;
+  }
+
   ~TrackedObjectsVK() {
     if (!buffer_) {
       return;
     }
+    if (own_pool_) {
+      // Nothing else uses the pool, so it can be reset on this thread.
+      buffer_.reset();
+      if (auto pool_recycler = pool_recycler_.lock()) {
+        pool_recycler->Reclaim(std::move(own_pool_));
+      }
+      return;
+    }
     auto pool = pool_.lock();
     if (!pool) {
       VALIDATION_LOG
@@ -65,6 +103,13 @@ class TrackedObjectsVK {
     tracked_textures_.insert(std::move(texture));
   }
 
+  void Track(std::shared_ptr<TrackedObjectsVK> secondary) {
+    if (!secondary) {
+      return;
+    }
+    tracked_secondaries_.push_back(std::move(secondary));
+  }
+
   vk::CommandBuffer GetCommandBuffer() const { return *buffer_; }
 
   DescriptorPoolVK& GetDescriptorPool() { return desc_pool_; }
@@ -72,26 +117,135 @@ class TrackedObjectsVK {
  private:
   DescriptorPoolVK desc_pool_;
   std::weak_ptr<CommandPoolVK> pool_;
+  // The pool of a secondary command buffer, which is allocated from a pool of
+  // its own.
+  std::weak_ptr<CommandPoolRecyclerVK> pool_recycler_;
+  vk::UniqueCommandPool own_pool_;
   vk::UniqueCommandBuffer buffer_;
   std::set<std::shared_ptr<SharedObjectVK>> tracked_objects_;
   std::set<std::shared_ptr<const DeviceBuffer>> tracked_buffers_;
   std::set<std::shared_ptr<const TextureSourceVK>> tracked_textures_;
+  std::vector<std::shared_ptr<TrackedObjectsVK>> tracked_secondaries_;
   bool is_valid_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(TrackedObjectsVK);
 };
 
-CommandEncoderVK::CommandEncoderVK(vk::Device device,
-                                   const std::shared_ptr<QueueVK>& queue,
-                                   const std::shared_ptr<CommandPoolVK>& pool,
-                                   std::shared_ptr<FenceWaiterVK> fence_waiter)
+class PassTimersVK {
+ public:
+  PassTimersVK(const vk::Device& device, std::shared_ptr<GPUTracerVK> tracer)
+      : device_(device), tracer_(std::move(tracer)) {}
+
+  ~PassTimersVK() = default;
+
+  bool IsEmpty() const { return labels_.empty(); }
+
+  void Begin(vk::CommandBuffer buffer, std::string label) {
+    if (!tracer_ || !tracer_->IsPassTimingEnabled() || is_open_ ||
+        labels_.size() >= kMaxTimerCount) {
+      return;
+    }
+    if (!pool_) {
+      vk::QueryPoolCreateInfo pool_info;
+      pool_info.queryType = vk::QueryType::eTimestamp;
+      pool_info.queryCount = kMaxTimerCount * 2u;
+      auto [result, pool] = device_.createQueryPoolUnique(pool_info);
+      if (result != vk::Result::eSuccess) {
+        VALIDATION_LOG << "Could not create timestamp query pool: "
+                       << vk::to_string(result);
+        return;
+      }
+      pool_ = std::move(pool);
+      buffer.resetQueryPool(*pool_, 0u, pool_info.queryCount);
+    }
+    buffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *pool_,
+                          labels_.size() * 2u);
+    labels_.push_back(std::move(label));
+    is_open_ = true;
+  }
+
+  void End(vk::CommandBuffer buffer) {
+    if (!is_open_) {
+      return;
+    }
+    buffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *pool_,
+                          labels_.size() * 2u - 1u);
+    is_open_ = false;
+  }
+
+  uint64_t AddPendingSubmission() { return tracer_->AddPendingSubmission(); }
+
+  // Must only be called once the command buffer is done executing.
+  void Report(uint64_t frame_number) const {
+    std::vector<GPUPassTime> times;
+    std::vector<uint64_t> timestamps(labels_.size() * 2u);
+    auto result = device_.getQueryPoolResults(
+        *pool_, 0u, timestamps.size(), timestamps.size() * sizeof(uint64_t),
+        timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result == vk::Result::eSuccess) {
+      for (size_t i = 0; i < labels_.size(); i++) {
+        const auto ticks = timestamps[i * 2u + 1u] - timestamps[i * 2u];
+        times.push_back(GPUPassTime{
+            .label = labels_[i],
+            .time = fml::TimeDelta::FromNanoseconds(
+                static_cast<int64_t>(ticks * tracer_->GetTimestampPeriod())),
+            .pass_count = 1u,
+        });
+      }
+    } else {
+      VALIDATION_LOG << "Could not read pass timestamps: "
+                     << vk::to_string(result);
+    }
+    tracer_->RecordPassTimes(frame_number, std::move(times));
+  }
+
+  void Cancel(uint64_t frame_number) const {
+    tracer_->RecordPassTimes(frame_number, {});
+  }
+
+ private:
+  static constexpr uint32_t kMaxTimerCount = 64u;
+
+  const vk::Device device_;
+  const std::shared_ptr<GPUTracerVK> tracer_;
+  vk::UniqueQueryPool pool_;
+  std::vector<std::string> labels_;
+  bool is_open_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PassTimersVK);
+};
+
+CommandEncoderVK::CommandEncoderVK(
+    vk::Device device,
+    const std::shared_ptr<QueueVK>& queue,
+    const std::shared_ptr<CommandPoolVK>& pool,
+    std::shared_ptr<FenceWaiterVK> fence_waiter,
+    std::shared_ptr<GPUTracerVK> gpu_tracer,
+    std::weak_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler,
+    std::optional<vk::CommandBufferInheritanceInfo> inheritance_info,
+    const std::shared_ptr<CommandPoolRecyclerVK>& secondary_pool_recycler)
     : fence_waiter_(std::move(fence_waiter)),
-      tracked_objects_(std::make_shared<TrackedObjectsVK>(device, pool)) {
+      tracked_objects_(
+          inheritance_info.has_value()
+              ? std::make_shared<TrackedObjectsVK>(
+                    device, secondary_pool_recycler,
+                    std::move(descriptor_pool_recycler))
+              : std::make_shared<TrackedObjectsVK>(
+                    device, pool, std::move(descriptor_pool_recycler))),
+      pass_timers_(std::make_shared<PassTimersVK>(device,
+                                                  std::move(gpu_tracer))),
+      is_secondary_(inheritance_info.has_value()) {
   if (!fence_waiter_ || !tracked_objects_->IsValid() || !queue) {
     return;
   }
   vk::CommandBufferBeginInfo begin_info;
   begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  if (inheritance_info.has_value()) {
+    // Secondary command buffers are recorded entirely within the render pass
+    // they are executed in.
+    begin_info.flags |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+    begin_info.pInheritanceInfo = &inheritance_info.value();
+  }
   if (tracked_objects_->GetCommandBuffer().begin(begin_info) !=
       vk::Result::eSuccess) {
     VALIDATION_LOG << "Could not begin command buffer.";
@@ -112,6 +266,10 @@ bool CommandEncoderVK::Submit() {
   if (!IsValid()) {
     return false;
   }
+  if (is_secondary_) {
+    VALIDATION_LOG << "Secondary command buffers cannot be submitted.";
+    return false;
+  }
 
   // Success or failure, you only get to submit once.
   fml::ScopedCleanupClosure reset([&]() { Reset(); });
@@ -120,6 +278,8 @@ bool CommandEncoderVK::Submit() {
 
   auto command_buffer = GetCommandBuffer();
 
+  pass_timers_->End(command_buffer);
+
   if (command_buffer.end() != vk::Result::eSuccess) {
     return false;
   }
@@ -135,10 +295,56 @@ bool CommandEncoderVK::Submit() {
     return false;
   }
 
-  return fence_waiter_->AddFence(
-      std::move(fence), [tracked_objects = std::move(tracked_objects_)] {
-        // Nothing to do, we just drop the tracked objects on the floor.
-      });
+  if (pass_timers_->IsEmpty()) {
+    return fence_waiter_->AddFence(
+        std::move(fence), [tracked_objects = std::move(tracked_objects_)] {
+          // Nothing to do, we just drop the tracked objects on the floor.
+        });
+  }
+
+  const auto frame_number = pass_timers_->AddPendingSubmission();
+  auto pass_timers = pass_timers_;
+  if (!fence_waiter_->AddFence(
+          std::move(fence), [tracked_objects = std::move(tracked_objects_),
+                             pass_timers, frame_number] {
+            pass_timers->Report(frame_number);
+          })) {
+    // The tracer still waits for the times of the passes.
+    pass_timers->Cancel(frame_number);
+    return false;
+  }
+  return true;
+}
+
+bool CommandEncoderVK::ExecuteSecondary(
+    std::unique_ptr<CommandEncoderVK> secondary) {
+  if (!IsValid() || is_secondary_) {
+    return false;
+  }
+  if (!secondary || !secondary->IsValid() || !secondary->is_secondary_) {
+    VALIDATION_LOG << "Invalid secondary command buffer.";
+    return false;
+  }
+  GetCommandBuffer().executeCommands(secondary->GetCommandBuffer());
+  // The secondary command buffer and everything it references must outlive
+  // the execution of this one.
+  tracked_objects_->Track(std::move(secondary->tracked_objects_));
+  secondary->Reset();
+  return true;
+}
+
+void CommandEncoderVK::BeginPassTimer(std::string label) {
+  if (!IsValid() || is_secondary_) {
+    return;
+  }
+  pass_timers_->Begin(GetCommandBuffer(), std::move(label));
+}
+
+void CommandEncoderVK::EndPassTimer() {
+  if (!IsValid() || is_secondary_) {
+    return;
+  }
+  pass_timers_->End(GetCommandBuffer());
 }
 
 vk::CommandBuffer CommandEncoderVK::GetCommandBuffer() const {
@@ -150,6 +356,7 @@ vk::CommandBuffer CommandEncoderVK::GetCommandBuffer() const {
 
 void CommandEncoderVK::Reset() {
   tracked_objects_.reset();
+  pass_timers_.reset();
 
   queue_ = nullptr;
   device_ = nullptr;
@@ -198,6 +405,23 @@ std::optional<vk::DescriptorSet> CommandEncoderVK::AllocateDescriptorSet(
   return tracked_objects_->GetDescriptorPool().AllocateDescriptorSet(layout);
 }
 
+std::optional<vk::DescriptorSet> CommandEncoderVK::FindDescriptorSet(
+    const DescriptorSetKeyVK& key) {
+  if (!IsValid()) {
+    return std::nullopt;
+  }
+  return tracked_objects_->GetDescriptorPool().FindDescriptorSet(key);
+}
+
+void CommandEncoderVK::CacheDescriptorSet(DescriptorSetKeyVK key,
+                                          vk::DescriptorSet set) {
+  if (!IsValid()) {
+    return;
+  }
+  tracked_objects_->GetDescriptorPool().CacheDescriptorSet(std::move(key),
+                                                           set);
+}
+
 void CommandEncoderVK::PushDebugGroup(const char* label) const {
   if (!HasValidationLayers()) {
     return;
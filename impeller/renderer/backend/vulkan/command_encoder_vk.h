@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <set>
+#include <string>
 
 #include "flutter/fml/macros.h"
 #include "impeller/renderer/backend/vulkan/command_pool_vk.h"
@@ -22,6 +24,8 @@ class Texture;
 class TextureSourceVK;
 class TrackedObjectsVK;
 class FenceWaiterVK;
+class GPUTracerVK;
+class PassTimersVK;
 
 class CommandEncoderVK {
  public:
@@ -50,6 +54,46 @@ class CommandEncoderVK {
   std::optional<vk::DescriptorSet> AllocateDescriptorSet(
       const vk::DescriptorSetLayout& layout);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find a descriptor set allocated by this encoder that was
+  ///             already updated with the same bindings.
+  ///
+  std::optional<vk::DescriptorSet> FindDescriptorSet(
+      const DescriptorSetKeyVK& key);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Remember the bindings of a descriptor set allocated by this
+  ///             encoder so that later commands with the same bindings can
+  ///             use it too.
+  ///
+  void CacheDescriptorSet(DescriptorSetKeyVK key, vk::DescriptorSet set);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Execute the commands of a secondary encoder from this one.
+  ///
+  ///             The secondary command buffer must have been ended. It is
+  ///             kept alive, along with everything it tracks, until this
+  ///             encoder's command buffer is done executing.
+  ///
+  /// @param[in]  secondary  An encoder created with
+  ///                        `ContextVK::CreateSecondaryGraphicsCommandEncoder`.
+  ///
+  bool ExecuteSecondary(std::unique_ptr<CommandEncoderVK> secondary);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Time the GPU work recorded from now on until the call to
+  ///             `EndPassTimer`, if pass timing is enabled on the GPU tracer.
+  ///             The time is reported to the tracer once the command buffer
+  ///             is done executing.
+  ///
+  ///             Must not be called within a render pass. Timers don't nest.
+  ///
+  /// @param[in]  label  The label the time is attributed to.
+  ///
+  void BeginPassTimer(std::string label);
+
+  void EndPassTimer();
+
  private:
   friend class ContextVK;
 
@@ -57,12 +101,21 @@ class CommandEncoderVK {
   std::shared_ptr<QueueVK> queue_;
   std::shared_ptr<FenceWaiterVK> fence_waiter_;
   std::shared_ptr<TrackedObjectsVK> tracked_objects_;
+  std::shared_ptr<PassTimersVK> pass_timers_;
+  bool is_secondary_ = false;
   bool is_valid_ = false;
 
   CommandEncoderVK(vk::Device device,
                    const std::shared_ptr<QueueVK>& queue,
                    const std::shared_ptr<CommandPoolVK>& pool,
-                   std::shared_ptr<FenceWaiterVK> fence_waiter);
+                   std::shared_ptr<FenceWaiterVK> fence_waiter,
+                   std::shared_ptr<GPUTracerVK> gpu_tracer,
+                   std::weak_ptr<DescriptorPoolRecyclerVK>
+                       descriptor_pool_recycler,
+                   std::optional<vk::CommandBufferInheritanceInfo>
+                       inheritance_info = std::nullopt,
+                   const std::shared_ptr<CommandPoolRecyclerVK>&
+                       secondary_pool_recycler = nullptr);
 
   void Reset();
 
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/fml/thread_local.h"
+#include "flutter/fml/trace_event.h"
 #include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 
@@ -132,4 +133,60 @@ void CommandPoolVK::GarbageCollectBuffersIfAble() {
   buffers_to_collect_.clear();
 }
 
+CommandPoolRecyclerVK::CommandPoolRecyclerVK(vk::Device device,
+                                             uint32_t queue_family_index)
+    : device_(device), queue_family_index_(queue_family_index) {}
+
+CommandPoolRecyclerVK::~CommandPoolRecyclerVK() = default;
+
+vk::UniqueCommandPool CommandPoolRecyclerVK::Get() {
+  {
+    Lock lock(pools_mutex_);
+    if (!recycled_pools_.empty()) {
+      auto pool = std::move(recycled_pools_.back());
+      recycled_pools_.pop_back();
+      statistics_.pool_reuse_count++;
+      return pool;
+    }
+    statistics_.pool_creation_count++;
+  }
+  TRACE_EVENT0("impeller", "CreateCommandPool");
+  vk::CommandPoolCreateInfo pool_info;
+  pool_info.queueFamilyIndex = queue_family_index_;
+  pool_info.flags = vk::CommandPoolCreateFlagBits::eTransient;
+  auto [result, pool] = device_.createCommandPoolUnique(pool_info);
+  if (result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Could not create a command pool: "
+                   << vk::to_string(result);
+    return {};
+  }
+  return std::move(pool);
+}
+
+void CommandPoolRecyclerVK::Reclaim(vk::UniqueCommandPool pool) {
+  if (!pool) {
+    return;
+  }
+  TRACE_EVENT0("impeller", "ReclaimCommandPool");
+  // Keep the memory of the pool for the command buffers it is handed out to
+  // next.
+  if (device_.resetCommandPool(pool.get()) != vk::Result::eSuccess) {
+    return;
+  }
+  Lock lock(pools_mutex_);
+  if (recycled_pools_.size() < kMaxRecycledPoolCount) {
+    recycled_pools_.push_back(std::move(pool));
+  }
+}
+
+CommandPoolRecyclerVK::Statistics CommandPoolRecyclerVK::GetStatistics() const {
+  Lock lock(pools_mutex_);
+  return statistics_;
+}
+
+size_t CommandPoolRecyclerVK::GetRecycledPoolCount() const {
+  Lock lock(pools_mutex_);
+  return recycled_pools_.size();
+}
+
 }  // namespace impeller
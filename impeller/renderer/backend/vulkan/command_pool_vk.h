@@ -7,6 +7,7 @@
 #include <memory>
 #include <set>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/base/thread.h"
@@ -52,4 +53,64 @@ class CommandPoolVK {
   FML_DISALLOW_COPY_AND_ASSIGN(CommandPoolVK);
 };
 
+//------------------------------------------------------------------------------
+/// @brief      Keeps the command pools of secondary command buffers that are
+///             done executing, and hands them out again to new ones.
+///
+///             Each secondary command buffer is allocated from a pool of its
+///             own, as they are recorded on worker threads whose thread local
+///             pools could only free them on those threads, whenever they
+///             happen to record again. A pool that only its command buffer
+///             uses can be reset on the thread that waits for the command
+///             buffer to complete instead.
+///
+///             This class is thread safe.
+///
+class CommandPoolRecyclerVK {
+ public:
+  //----------------------------------------------------------------------------
+  /// The maximum number of pools kept for reuse. Pools reclaimed beyond that
+  /// are destroyed.
+  ///
+  static constexpr size_t kMaxRecycledPoolCount = 32u;
+
+  struct Statistics {
+    /// The number of pools that were created.
+    size_t pool_creation_count = 0u;
+    /// The number of pools that were handed out again after being reset.
+    size_t pool_reuse_count = 0u;
+  };
+
+  CommandPoolRecyclerVK(vk::Device device, uint32_t queue_family_index);
+
+  ~CommandPoolRecyclerVK();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get a pool, reusing a reclaimed one if there is one.
+  ///
+  vk::UniqueCommandPool Get();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reset a pool and keep it for reuse.
+  ///
+  ///             The command buffers allocated from the pool must have been
+  ///             freed, and the pool may not be used by any other thread.
+  ///
+  void Reclaim(vk::UniqueCommandPool pool);
+
+  Statistics GetStatistics() const;
+
+  size_t GetRecycledPoolCount() const;
+
+ private:
+  const vk::Device device_;
+  const uint32_t queue_family_index_;
+  mutable Mutex pools_mutex_;
+  std::vector<vk::UniqueCommandPool> recycled_pools_
+      IPLR_GUARDED_BY(pools_mutex_);
+  Statistics statistics_ IPLR_GUARDED_BY(pools_mutex_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(CommandPoolRecyclerVK);
+};
+
 }  // namespace impeller
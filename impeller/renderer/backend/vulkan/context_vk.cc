@@ -21,8 +21,10 @@
 #include "impeller/renderer/backend/vulkan/command_encoder_vk.h"
 #include "impeller/renderer/backend/vulkan/command_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/debug_report_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/fence_waiter_vk.h"
 #include "impeller/renderer/backend/vulkan/formats_vk.h"
+#include "impeller/renderer/backend/vulkan/gpu_tracer_vk.h"
 #include "impeller/renderer/backend/vulkan/surface_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 #include "impeller/renderer/capabilities.h"
@@ -358,6 +360,12 @@ void ContextVK::Setup(Settings settings) {
   queues_ = std::move(queues);
   device_capabilities_ = std::move(caps);
   fence_waiter_ = std::move(fence_waiter);
+  gpu_tracer_ = std::make_shared<GPUTracerVK>(physical_device_);
+  descriptor_pool_recycler_ =
+      std::make_shared<DescriptorPoolRecyclerVK>(device_.get());
+  command_pool_recycler_ = std::make_shared<CommandPoolRecyclerVK>(
+      device_.get(), queues_.graphics_queue->GetIndex().family);
+  worker_task_runner_ = settings.worker_task_runner;
   is_valid_ = true;
 
   //----------------------------------------------------------------------------
@@ -451,6 +459,15 @@ const std::shared_ptr<const Capabilities>& ContextVK::GetCapabilities() const {
   return device_capabilities_;
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner>
+ContextVK::GetConcurrentWorkerTaskRunner() const {
+  return worker_task_runner_;
+}
+
+std::shared_ptr<GPUTracer> ContextVK::GetGPUTracer() const {
+  return gpu_tracer_;
+}
+
 const std::shared_ptr<QueueVK>& ContextVK::GetGraphicsQueue() const {
   return queues_.graphics_queue;
 }
@@ -463,6 +480,16 @@ std::shared_ptr<FenceWaiterVK> ContextVK::GetFenceWaiter() const {
   return fence_waiter_;
 }
 
+const std::shared_ptr<DescriptorPoolRecyclerVK>&
+ContextVK::GetDescriptorPoolRecycler() const {
+  return descriptor_pool_recycler_;
+}
+
+const std::shared_ptr<CommandPoolRecyclerVK>&
+ContextVK::GetCommandPoolRecycler() const {
+  return command_pool_recycler_;
+}
+
 std::unique_ptr<CommandEncoderVK> ContextVK::CreateGraphicsCommandEncoder()
     const {
   auto tls_pool = CommandPoolVK::GetThreadLocal(this);
@@ -470,10 +497,36 @@ std::unique_ptr<CommandEncoderVK> ContextVK::CreateGraphicsCommandEncoder()
     return nullptr;
   }
   auto encoder = std::unique_ptr<CommandEncoderVK>(new CommandEncoderVK(
-      *device_,                //
-      queues_.graphics_queue,  //
-      tls_pool,                //
-      fence_waiter_            //
+      *device_,                  //
+      queues_.graphics_queue,    //
+      tls_pool,                  //
+      fence_waiter_,             //
+      gpu_tracer_,               //
+      descriptor_pool_recycler_  //
+      ));
+  if (!encoder->IsValid()) {
+    return nullptr;
+  }
+  return encoder;
+}
+
+std::unique_ptr<CommandEncoderVK>
+ContextVK::CreateSecondaryGraphicsCommandEncoder(
+    vk::RenderPass render_pass,
+    vk::Framebuffer framebuffer) const {
+  vk::CommandBufferInheritanceInfo inheritance_info;
+  inheritance_info.renderPass = render_pass;
+  inheritance_info.subpass = 0u;
+  inheritance_info.framebuffer = framebuffer;
+  auto encoder = std::unique_ptr<CommandEncoderVK>(new CommandEncoderVK(
+      *device_,                   //
+      queues_.graphics_queue,     //
+      nullptr,                    //
+      fence_waiter_,              //
+      nullptr,                    //
+      descriptor_pool_recycler_,  //
+      inheritance_info,           //
+      command_pool_recycler_      //
       ));
   if (!encoder->IsValid()) {
     return nullptr;
@@ -481,4 +534,12 @@ std::unique_ptr<CommandEncoderVK> ContextVK::CreateGraphicsCommandEncoder()
   return encoder;
 }
 
+void ContextVK::SetParallelEncodingEnabled(bool enabled) {
+  parallel_encoding_enabled_ = enabled;
+}
+
+bool ContextVK::IsParallelEncodingEnabled() const {
+  return parallel_encoding_enabled_;
+}
+
 }  // namespace impeller
@@ -27,8 +27,11 @@ namespace impeller {
 bool HasValidationLayers();
 
 class CommandEncoderVK;
+class CommandPoolRecyclerVK;
 class DebugReportVK;
+class DescriptorPoolRecyclerVK;
 class FenceWaiterVK;
+class GPUTracerVK;
 
 class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
  public:
@@ -70,6 +73,13 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
   // |Context|
   const std::shared_ptr<const Capabilities>& GetCapabilities() const override;
 
+  // |Context|
+  std::shared_ptr<fml::ConcurrentTaskRunner> GetConcurrentWorkerTaskRunner()
+      const override;
+
+  // |Context|
+  std::shared_ptr<GPUTracer> GetGPUTracer() const override;
+
   template <typename T>
   bool SetDebugName(T handle, std::string_view label) const {
     return SetDebugName(*device_, handle, label);
@@ -117,6 +127,33 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
 
   std::shared_ptr<FenceWaiterVK> GetFenceWaiter() const;
 
+  const std::shared_ptr<DescriptorPoolRecyclerVK>& GetDescriptorPoolRecycler()
+      const;
+
+  const std::shared_ptr<CommandPoolRecyclerVK>& GetCommandPoolRecycler() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Create an encoder for a secondary command buffer that
+  ///             continues the first subpass of a render pass.
+  ///
+  ///             The command buffer is allocated from a pool of its own, which
+  ///             is handed back to the command pool recycler once the command
+  ///             buffer is done executing. It may be recorded on any thread,
+  ///             but only on one at a time.
+  ///
+  std::unique_ptr<CommandEncoderVK> CreateSecondaryGraphicsCommandEncoder(
+      vk::RenderPass render_pass,
+      vk::Framebuffer framebuffer) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether large render passes are split into secondary command
+  ///             buffers that are recorded on the concurrent worker task
+  ///             runner. Enabled by default.
+  ///
+  void SetParallelEncodingEnabled(bool enabled);
+
+  bool IsParallelEncodingEnabled() const;
+
  private:
   vk::UniqueInstance instance_;
   std::unique_ptr<DebugReportVK> debug_report_;
@@ -130,6 +167,11 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
   std::shared_ptr<SwapchainVK> swapchain_;
   std::shared_ptr<const Capabilities> device_capabilities_;
   std::shared_ptr<FenceWaiterVK> fence_waiter_;
+  std::shared_ptr<GPUTracerVK> gpu_tracer_;
+  std::shared_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler_;
+  std::shared_ptr<CommandPoolRecyclerVK> command_pool_recycler_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  bool parallel_encoding_enabled_ = true;
 
   bool is_valid_ = false;
 
@@ -4,15 +4,15 @@
 
 #include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
 
+#include <algorithm>
+
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
+#include "impeller/base/validation.h"
 
 namespace impeller {
 
-DescriptorPoolVK::DescriptorPoolVK(vk::Device device) : device_(device) {}
-
-DescriptorPoolVK::~DescriptorPoolVK() = default;
-
 static vk::UniqueDescriptorPool CreatePool(const vk::Device& device,
                                            uint32_t pool_count) {
   TRACE_EVENT0("impeller", "CreateDescriptorPool");
@@ -35,6 +35,92 @@ static vk::UniqueDescriptorPool CreatePool(const vk::Device& device,
   return std::move(pool);
 }
 
+DescriptorPoolRecyclerVK::DescriptorPoolRecyclerVK(vk::Device device)
+    : device_(device) {}
+
+DescriptorPoolRecyclerVK::~DescriptorPoolRecyclerVK() = default;
+
+SizedDescriptorPoolVK DescriptorPoolRecyclerVK::Get(uint32_t minimum_size) {
+  {
+    Lock lock(pools_mutex_);
+    // Prefer the smallest pool that is large enough.
+    auto found = recycled_pools_.end();
+    for (auto it = recycled_pools_.begin(); it != recycled_pools_.end(); ++it) {
+      if (it->size >= minimum_size &&
+          (found == recycled_pools_.end() || it->size < found->size)) {
+        found = it;
+      }
+    }
+    if (found != recycled_pools_.end()) {
+      auto pool = std::move(*found);
+      recycled_pools_.erase(found);
+      statistics_.pool_reuse_count++;
+      return pool;
+    }
+    statistics_.pool_creation_count++;
+  }
+  return {.pool = CreatePool(device_, minimum_size), .size = minimum_size};
+}
+
+void DescriptorPoolRecyclerVK::Reclaim(
+    std::vector<SizedDescriptorPoolVK> pools) {
+  TRACE_EVENT0("impeller", "ReclaimDescriptorPools");
+  for (auto& pool : pools) {
+    if (!pool.pool) {
+      continue;
+    }
+    // Resetting frees all descriptor sets of the pool at once.
+    device_.resetDescriptorPool(pool.pool.get());
+
+    Lock lock(pools_mutex_);
+    if (recycled_pools_.size() < kMaxRecycledPoolCount) {
+      recycled_pools_.push_back(std::move(pool));
+      continue;
+    }
+    // Keep the larger pools, they are the ones that are expensive to grow
+    // into.
+    auto smallest = std::min_element(
+        recycled_pools_.begin(), recycled_pools_.end(),
+        [](const auto& a, const auto& b) { return a.size < b.size; });
+    if (smallest->size < pool.size) {
+      std::swap(*smallest, pool);
+    }
+  }
+}
+
+DescriptorPoolRecyclerVK::Statistics DescriptorPoolRecyclerVK::GetStatistics()
+    const {
+  Lock lock(pools_mutex_);
+  return statistics_;
+}
+
+size_t DescriptorPoolRecyclerVK::GetRecycledPoolCount() const {
+  Lock lock(pools_mutex_);
+  return recycled_pools_.size();
+}
+
+std::size_t DescriptorSetKeyVK::Hash::operator()(
+    const DescriptorSetKeyVK& key) const {
+  auto seed = fml::HashCombine();
+  for (const auto word : key.words) {
+    fml::HashCombineSeed(seed, word);
+  }
+  return seed;
+}
+
+DescriptorPoolVK::DescriptorPoolVK(
+    vk::Device device,
+    std::weak_ptr<DescriptorPoolRecyclerVK> recycler)
+    : device_(device), recycler_(std::move(recycler)) {}
+
+DescriptorPoolVK::~DescriptorPoolVK() {
+  auto recycler = recycler_.lock();
+  if (!recycler) {
+    return;
+  }
+  recycler->Reclaim(std::move(pools_));
+}
+
 std::optional<vk::DescriptorSet> DescriptorPoolVK::AllocateDescriptorSet(
     const vk::DescriptorSetLayout& layout) {
   auto pool = GetDescriptorPool();
@@ -53,24 +139,50 @@ std::optional<vk::DescriptorSet> DescriptorPoolVK::AllocateDescriptorSet(
                    << vk::to_string(result);
     return std::nullopt;
   }
+  statistics_.set_allocation_count++;
   return sets[0];
 }
 
+std::optional<vk::DescriptorSet> DescriptorPoolVK::FindDescriptorSet(
+    const DescriptorSetKeyVK& key) {
+  auto found = cached_sets_.find(key);
+  if (found == cached_sets_.end()) {
+    return std::nullopt;
+  }
+  statistics_.set_reuse_count++;
+  return found->second;
+}
+
+void DescriptorPoolVK::CacheDescriptorSet(DescriptorSetKeyVK key,
+                                          vk::DescriptorSet set) {
+  cached_sets_[std::move(key)] = set;
+}
+
+const DescriptorPoolVK::Statistics& DescriptorPoolVK::GetStatistics() const {
+  return statistics_;
+}
+
 std::optional<vk::DescriptorPool> DescriptorPoolVK::GetDescriptorPool() {
   if (pools_.empty()) {
     return GrowPool() ? GetDescriptorPool() : std::nullopt;
   }
-  return *pools_.back();
+  return *pools_.back().pool;
 }
 
 bool DescriptorPoolVK::GrowPool() {
   const auto new_pool_size = Allocation::NextPowerOfTwoSize(pool_size_ + 1u);
-  auto new_pool = CreatePool(device_, new_pool_size);
-  if (!new_pool) {
+  SizedDescriptorPoolVK new_pool;
+  if (auto recycler = recycler_.lock()) {
+    new_pool = recycler->Get(new_pool_size);
+  } else {
+    new_pool = {.pool = CreatePool(device_, new_pool_size),
+                .size = new_pool_size};
+  }
+  if (!new_pool.pool) {
     return false;
   }
-  pool_size_ = new_pool_size;
-  pools_.push(std::move(new_pool));
+  pool_size_ = new_pool.size;
+  pools_.push_back(std::move(new_pool));
   return true;
 }
 
@@ -4,14 +4,104 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <optional>
-#include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      A descriptor pool along with the number of descriptors of each
+///             type it was created for.
+///
+struct SizedDescriptorPoolVK {
+  vk::UniqueDescriptorPool pool;
+  uint32_t size = 0u;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps the descriptor pools of command buffers that are done
+///             executing, and hands them out again to new command buffers.
+///
+///             Pools are reset in bulk when they are reclaimed, which frees
+///             all of their descriptor sets at once, instead of destroying
+///             them and creating new ones for every command buffer.
+///
+///             This class is thread safe. Pools are reclaimed on the thread
+///             that waits for command buffers to complete.
+///
+class DescriptorPoolRecyclerVK {
+ public:
+  //----------------------------------------------------------------------------
+  /// The maximum number of pools kept for reuse. Pools reclaimed beyond that
+  /// are destroyed.
+  ///
+  static constexpr size_t kMaxRecycledPoolCount = 32u;
+
+  struct Statistics {
+    /// The number of pools that were created.
+    size_t pool_creation_count = 0u;
+    /// The number of pools that were handed out again after being reset.
+    size_t pool_reuse_count = 0u;
+  };
+
+  explicit DescriptorPoolRecyclerVK(vk::Device device);
+
+  ~DescriptorPoolRecyclerVK();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get a pool with room for at least `minimum_size` descriptors
+  ///             of each type, reusing a reclaimed pool if there is one.
+  ///
+  SizedDescriptorPoolVK Get(uint32_t minimum_size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reset pools and keep them for reuse.
+  ///
+  ///             The command buffers that use descriptor sets from the pools
+  ///             must have completed.
+  ///
+  void Reclaim(std::vector<SizedDescriptorPoolVK> pools);
+
+  Statistics GetStatistics() const;
+
+  size_t GetRecycledPoolCount() const;
+
+ private:
+  const vk::Device device_;
+  mutable Mutex pools_mutex_;
+  std::vector<SizedDescriptorPoolVK> recycled_pools_
+      IPLR_GUARDED_BY(pools_mutex_);
+  Statistics statistics_ IPLR_GUARDED_BY(pools_mutex_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DescriptorPoolRecyclerVK);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Identifies the contents of a descriptor set: its layout and
+///             the handles, offsets and ranges of each of its bindings.
+///
+struct DescriptorSetKeyVK {
+  std::vector<uint64_t> words;
+
+  struct Hash {
+    std::size_t operator()(const DescriptorSetKeyVK& key) const;
+  };
+
+  struct Equal {
+    bool operator()(const DescriptorSetKeyVK& lhs,
+                    const DescriptorSetKeyVK& rhs) const {
+      return lhs.words == rhs.words;
+    }
+  };
+};
+
 //------------------------------------------------------------------------------
 /// @brief      A short-lived dynamically-sized descriptor pool. Descriptors
 ///             from this pool don't need to be freed individually. Instead, the
@@ -22,21 +112,53 @@ namespace impeller {
 ///             threads.
 ///
 ///             Encoders create pools as necessary as they have the same
-///             threading and lifecycle restrictions.
+///             threading and lifecycle restrictions. When the pool is
+///             collected, the underlying Vulkan pools are handed back to the
+///             recycler.
 ///
 class DescriptorPoolVK {
  public:
-  explicit DescriptorPoolVK(vk::Device device);
+  struct Statistics {
+    /// The number of descriptor sets allocated from the pool.
+    size_t set_allocation_count = 0u;
+    /// The number of times a set was used again for identical bindings.
+    size_t set_reuse_count = 0u;
+  };
+
+  DescriptorPoolVK(vk::Device device,
+                   std::weak_ptr<DescriptorPoolRecyclerVK> recycler);
 
   ~DescriptorPoolVK();
 
   std::optional<vk::DescriptorSet> AllocateDescriptorSet(
       const vk::DescriptorSetLayout& layout);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find a descriptor set of this pool that was already updated
+  ///             with the same bindings.
+  ///
+  std::optional<vk::DescriptorSet> FindDescriptorSet(
+      const DescriptorSetKeyVK& key);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Remember the bindings a descriptor set of this pool was
+  ///             updated with, so that it can be found and used again.
+  ///
+  void CacheDescriptorSet(DescriptorSetKeyVK key, vk::DescriptorSet set);
+
+  const Statistics& GetStatistics() const;
+
  private:
   const vk::Device device_;
+  std::weak_ptr<DescriptorPoolRecyclerVK> recycler_;
   uint32_t pool_size_ = 31u;
-  std::queue<vk::UniqueDescriptorPool> pools_;
+  std::vector<SizedDescriptorPoolVK> pools_;
+  std::unordered_map<DescriptorSetKeyVK,
+                     vk::DescriptorSet,
+                     DescriptorSetKeyVK::Hash,
+                     DescriptorSetKeyVK::Equal>
+      cached_sets_;
+  Statistics statistics_;
 
   std::optional<vk::DescriptorPool> GetDescriptorPool();
 
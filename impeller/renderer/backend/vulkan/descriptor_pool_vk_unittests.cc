@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/playground/playground_test.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
+
+namespace impeller {
+namespace testing {
+
+using DescriptorPoolVKTest = PlaygroundTest;
+INSTANTIATE_PLAYGROUND_SUITE(DescriptorPoolVKTest);
+
+static vk::UniqueDescriptorSetLayout CreateUniformBufferLayout(
+    const vk::Device& device) {
+  vk::DescriptorSetLayoutBinding binding;
+  binding.binding = 0u;
+  binding.descriptorType = vk::DescriptorType::eUniformBuffer;
+  binding.descriptorCount = 1u;
+  binding.stageFlags = vk::ShaderStageFlagBits::eVertex;
+
+  vk::DescriptorSetLayoutCreateInfo layout_info;
+  layout_info.setBindings(binding);
+  auto [result, layout] = device.createDescriptorSetLayoutUnique(layout_info);
+  if (result != vk::Result::eSuccess) {
+    return {};
+  }
+  return std::move(layout);
+}
+
+TEST_P(DescriptorPoolVKTest, ReclaimedPoolsAreReused) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Descriptor pools are only used by the Vulkan backend.");
+  }
+  auto device = ContextVK::Cast(*GetContext()).GetDevice();
+  auto layout = CreateUniformBufferLayout(device);
+  ASSERT_TRUE(layout);
+
+  auto recycler = std::make_shared<DescriptorPoolRecyclerVK>(device);
+  for (size_t i = 0; i < 3u; i++) {
+    DescriptorPoolVK pool(device, recycler);
+    for (size_t j = 0; j < 8u; j++) {
+      ASSERT_TRUE(pool.AllocateDescriptorSet(layout.get()).has_value());
+    }
+  }
+
+  // The pool of the first frame is reset and handed out to the next ones.
+  auto statistics = recycler->GetStatistics();
+  EXPECT_EQ(statistics.pool_creation_count, 1u);
+  EXPECT_EQ(statistics.pool_reuse_count, 2u);
+  EXPECT_EQ(recycler->GetRecycledPoolCount(), 1u);
+}
+
+TEST_P(DescriptorPoolVKTest, RecyclerKeepsABoundedNumberOfPools) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Descriptor pools are only used by the Vulkan backend.");
+  }
+  auto device = ContextVK::Cast(*GetContext()).GetDevice();
+
+  auto recycler = std::make_shared<DescriptorPoolRecyclerVK>(device);
+  std::vector<SizedDescriptorPoolVK> pools;
+  for (size_t i = 0; i < DescriptorPoolRecyclerVK::kMaxRecycledPoolCount + 4u;
+       i++) {
+    pools.push_back(recycler->Get(32u + i));
+    ASSERT_TRUE(pools.back().pool);
+  }
+  recycler->Reclaim(std::move(pools));
+  EXPECT_EQ(recycler->GetRecycledPoolCount(),
+            DescriptorPoolRecyclerVK::kMaxRecycledPoolCount);
+
+  // Only the larger pools are kept.
+  auto pool = recycler->Get(33u);
+  EXPECT_EQ(pool.size, 36u);
+  EXPECT_EQ(recycler->GetStatistics().pool_reuse_count, 1u);
+}
+
+TEST_P(DescriptorPoolVKTest, PoolsOutliveTheirRecycler) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Descriptor pools are only used by the Vulkan backend.");
+  }
+  auto device = ContextVK::Cast(*GetContext()).GetDevice();
+  auto layout = CreateUniformBufferLayout(device);
+  ASSERT_TRUE(layout);
+
+  auto recycler = std::make_shared<DescriptorPoolRecyclerVK>(device);
+  DescriptorPoolVK pool(device, recycler);
+  ASSERT_TRUE(pool.AllocateDescriptorSet(layout.get()).has_value());
+  recycler.reset();
+  ASSERT_TRUE(pool.AllocateDescriptorSet(layout.get()).has_value());
+}
+
+TEST_P(DescriptorPoolVKTest, IdenticalBindingsShareDescriptorSets) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Descriptor pools are only used by the Vulkan backend.");
+  }
+  auto device = ContextVK::Cast(*GetContext()).GetDevice();
+  auto layout = CreateUniformBufferLayout(device);
+  ASSERT_TRUE(layout);
+
+  auto recycler = std::make_shared<DescriptorPoolRecyclerVK>(device);
+  DescriptorPoolVK pool(device, recycler);
+
+  DescriptorSetKeyVK key = {.words = {1u, 2u, 3u, 0u, 256u}};
+  DescriptorSetKeyVK other_key = {.words = {1u, 2u, 3u, 256u, 256u}};
+  ASSERT_FALSE(pool.FindDescriptorSet(key).has_value());
+
+  auto set = pool.AllocateDescriptorSet(layout.get());
+  ASSERT_TRUE(set.has_value());
+  pool.CacheDescriptorSet(key, set.value());
+
+  auto found = pool.FindDescriptorSet(key);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found.value(), set.value());
+  EXPECT_FALSE(pool.FindDescriptorSet(other_key).has_value());
+
+  EXPECT_EQ(pool.GetStatistics().set_allocation_count, 1u);
+  EXPECT_EQ(pool.GetStatistics().set_reuse_count, 1u);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -22,7 +22,19 @@ DeviceBufferVK::DeviceBufferVK(DeviceBufferDescriptor desc,
       info_(info),
       buffer_(buffer) {}
 
+DeviceBufferVK::DeviceBufferVK(DeviceBufferDescriptor desc,
+                               std::weak_ptr<Context> context,
+                               BufferSuballocationVK suballocation)
+    : DeviceBuffer(desc),
+      context_(std::move(context)),
+      suballocation_(std::move(suballocation)) {}
+
 DeviceBufferVK::~DeviceBufferVK() {
+  if (suballocation_.slab) {
+    suballocation_.slab->Free(suballocation_.offset,
+                              GetDeviceBufferDescriptor().size);
+    return;
+  }
   if (buffer_) {
     ::vmaDestroyBuffer(allocator_,
                        static_cast<decltype(buffer_)::NativeType>(buffer_),
@@ -31,6 +43,10 @@ DeviceBufferVK::~DeviceBufferVK() {
 }
 
 uint8_t* DeviceBufferVK::OnGetContents() const {
+  if (suballocation_.slab) {
+    auto contents = suballocation_.slab->GetContents();
+    return contents ? contents + suballocation_.offset : nullptr;
+  }
   return static_cast<uint8_t*>(info_.pMappedData);
 }
 
@@ -51,6 +67,11 @@ bool DeviceBufferVK::OnCopyHostBuffer(const uint8_t* source,
 }
 
 bool DeviceBufferVK::SetLabel(const std::string& label) {
+  if (suballocation_.slab) {
+    // The slab is shared with other device buffers, don't name it after any
+    // one of them.
+    return true;
+  }
   auto context = context_.lock();
   if (!context || !buffer_) {
     // The context could have died at this point.
@@ -68,7 +89,14 @@ bool DeviceBufferVK::SetLabel(const std::string& label, Range range) {
 }
 
 vk::Buffer DeviceBufferVK::GetBuffer() const {
+  if (suballocation_.slab) {
+    return suballocation_.slab->GetBuffer();
+  }
   return buffer_;
 }
 
+vk::DeviceSize DeviceBufferVK::GetBufferOffset() const {
+  return suballocation_.offset;
+}
+
 }  // namespace impeller
@@ -9,6 +9,7 @@
 #include "flutter/fml/macros.h"
 #include "impeller/base/backend_cast.h"
 #include "impeller/core/device_buffer.h"
+#include "impeller/renderer/backend/vulkan/buffer_slab_allocator_vk.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 
 namespace impeller {
@@ -23,11 +24,31 @@ class DeviceBufferVK final : public DeviceBuffer,
                  VmaAllocationInfo info,
                  vk::Buffer buffer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Create a device buffer in space carved out of a buffer slab.
+  ///
+  DeviceBufferVK(DeviceBufferDescriptor desc,
+                 std::weak_ptr<Context> context,
+                 BufferSuballocationVK suballocation);
+
   // |DeviceBuffer|
   ~DeviceBufferVK() override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The buffer that holds the contents of this device buffer.
+  ///
+  ///             Suballocated device buffers share this with others. Offsets
+  ///             into the device buffer must be adjusted by
+  ///             `GetBufferOffset` when passed to Vulkan.
+  ///
   vk::Buffer GetBuffer() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The offset of the contents of this device buffer in the
+  ///             buffer returned by `GetBuffer`.
+  ///
+  vk::DeviceSize GetBufferOffset() const;
+
  private:
   friend class AllocatorVK;
 
@@ -36,6 +57,7 @@ class DeviceBufferVK final : public DeviceBuffer,
   VmaAllocation allocation_ = {};
   VmaAllocationInfo info_ = {};
   vk::Buffer buffer_ = {};
+  BufferSuballocationVK suballocation_;
 
   // |DeviceBuffer|
   uint8_t* OnGetContents() const override;
@@ -0,0 +1,30 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/gpu_tracer_vk.h"
+
+namespace impeller {
+
+GPUTracerVK::GPUTracerVK(const vk::PhysicalDevice& physical_device) {
+  if (!physical_device) {
+    return;
+  }
+  const auto limits = physical_device.getProperties().limits;
+  // Without this, the graphics queue may not support timestamps at all.
+  supports_pass_timing_ =
+      limits.timestampComputeAndGraphics && limits.timestampPeriod > 0.0f;
+  timestamp_period_ = limits.timestampPeriod;
+}
+
+GPUTracerVK::~GPUTracerVK() = default;
+
+bool GPUTracerVK::SupportsPassTiming() const {
+  return supports_pass_timing_;
+}
+
+float GPUTracerVK::GetTimestampPeriod() const {
+  return timestamp_period_;
+}
+
+}  // namespace impeller
@@ -0,0 +1,42 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include "flutter/fml/macros.h"
+#include "impeller/base/backend_cast.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
+#include "impeller/renderer/gpu_tracer.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Times passes with timestamp queries written around them. See
+///             `CommandEncoderVK::BeginPassTimer`.
+///
+class GPUTracerVK final : public GPUTracer,
+                          public BackendCast<GPUTracerVK, GPUTracer> {
+ public:
+  explicit GPUTracerVK(const vk::PhysicalDevice& physical_device);
+
+  // |GPUTracer|
+  ~GPUTracerVK() override;
+
+  // |GPUTracer|
+  bool SupportsPassTiming() const override;
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of nanoseconds it takes for a timestamp to be
+  ///             incremented by 1.
+  ///
+  float GetTimestampPeriod() const;
+
+ private:
+  bool supports_pass_timing_ = false;
+  float timestamp_period_ = 0.0f;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(GPUTracerVK);
+};
+
+}  // namespace impeller
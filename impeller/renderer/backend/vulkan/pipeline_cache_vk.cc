@@ -6,50 +6,283 @@
 
 #include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <optional>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
-#include "flutter/fml/mapping.h"
+#include "flutter/fml/trace_event.h"
+#include "impeller/renderer/backend/vulkan/capabilities_vk.h"
+#include "impeller/renderer/shader_function.h"
+#include "impeller/renderer/vertex_descriptor.h"
 
 namespace impeller {
 
+/// The single file the whole cache used to be persisted to.
 static constexpr const char* kPipelineCacheFileName =
     "flutter.impeller.vkcache";
 
-static bool VerifyExistingCache(const fml::Mapping& mapping,
-                                const CapabilitiesVK& caps) {
-  return true;
-}
+static constexpr const char* kPipelineCacheShardDirectoryName =
+    "flutter.impeller.vkcache.shards";
+
+static constexpr const char* kPipelineCacheShardExtension = ".shard";
+
+/// The launches the persisted pipelines were last created in.
+static constexpr const char* kPipelineCacheLaunchesFileName =
+    "flutter.impeller.vkcache.launches";
+
+/// 'IPCS'
+static constexpr uint32_t kPipelineCacheShardMagic = 0x49504353;
 
-static std::shared_ptr<fml::Mapping> DecorateCacheWithMetadata(
-    std::shared_ptr<fml::Mapping> data) {
-  return data;
+static constexpr uint32_t kPipelineCacheShardVersion = 2u;
+
+struct PipelineCacheShardHeader {
+  uint32_t magic = kPipelineCacheShardMagic;
+  uint32_t version = kPipelineCacheShardVersion;
+  // The device the data was created on, and the format of the pipeline cache
+  // of its driver. The data of other devices and drivers would be rejected by
+  // the driver, or worse, never be used.
+  uint32_t vendor_id = 0u;
+  uint32_t device_id = 0u;
+  uint8_t pipeline_cache_uuid[VK_UUID_SIZE] = {};
+  uint64_t data_size = 0u;
+  uint64_t checksum = 0u;
+};
+
+// FNV-1a.
+static uint64_t ComputeChecksum(const uint8_t* data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
 }
 
-static std::unique_ptr<fml::Mapping> RemoveMetadataFromCache(
-    std::unique_ptr<fml::Mapping> data) {
-  return data;
+std::unique_ptr<fml::Mapping> EncodePipelineCacheShard(
+    const fml::Mapping& data,
+    const vk::PhysicalDeviceProperties& properties) {
+  PipelineCacheShardHeader header;
+  header.vendor_id = properties.vendorID;
+  header.device_id = properties.deviceID;
+  std::memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID.data(),
+              sizeof(header.pipeline_cache_uuid));
+  header.data_size = data.GetSize();
+  header.checksum = ComputeChecksum(data.GetMapping(), data.GetSize());
+
+  std::vector<uint8_t> shard(sizeof(header) + data.GetSize());
+  std::memcpy(shard.data(), &header, sizeof(header));
+  if (data.GetSize() > 0u) {
+    std::memcpy(shard.data() + sizeof(header), data.GetMapping(),
+                data.GetSize());
+  }
+  return std::make_unique<fml::DataMapping>(std::move(shard));
 }
 
-static std::unique_ptr<fml::Mapping> OpenCacheFile(
-    const fml::UniqueFD& base_directory,
-    const std::string& cache_file_name,
-    const CapabilitiesVK& caps) {
-  if (!base_directory.is_valid()) {
+std::unique_ptr<fml::Mapping> DecodePipelineCacheShard(
+    std::unique_ptr<fml::Mapping> shard,
+    const vk::PhysicalDeviceProperties& properties) {
+  if (!shard || shard->GetSize() < sizeof(PipelineCacheShardHeader)) {
     return nullptr;
   }
-  std::unique_ptr<fml::Mapping> mapping =
-      fml::FileMapping::CreateReadOnly(base_directory, cache_file_name);
-  if (!mapping) {
+  PipelineCacheShardHeader header;
+  std::memcpy(&header, shard->GetMapping(), sizeof(header));
+  if (header.magic != kPipelineCacheShardMagic ||
+      header.version != kPipelineCacheShardVersion ||
+      header.data_size != shard->GetSize() - sizeof(header)) {
     return nullptr;
   }
-  if (!VerifyExistingCache(*mapping, caps)) {
+  if (header.vendor_id != properties.vendorID ||
+      header.device_id != properties.deviceID ||
+      std::memcmp(header.pipeline_cache_uuid,
+                  properties.pipelineCacheUUID.data(),
+                  sizeof(header.pipeline_cache_uuid)) != 0) {
     return nullptr;
   }
-  mapping = RemoveMetadataFromCache(std::move(mapping));
-  if (!mapping) {
+  const auto data = shard->GetMapping() + sizeof(header);
+  if (header.checksum != ComputeChecksum(data, header.data_size)) {
     return nullptr;
   }
-  return mapping;
+  std::shared_ptr<fml::Mapping> shared_shard = std::move(shard);
+  return std::make_unique<fml::NonOwnedMapping>(
+      data, header.data_size, [shared_shard](auto, auto) {});
+}
+
+uint64_t ComputeShaderCodeHash(const fml::Mapping& code) {
+  return ComputeChecksum(code.GetMapping(), code.GetSize());
+}
+
+template <class T>
+static void AppendValueToKeyData(std::vector<uint8_t>& key_data, T value) {
+  const auto widened = static_cast<uint64_t>(value);
+  const auto bytes = reinterpret_cast<const uint8_t*>(&widened);
+  key_data.insert(key_data.end(), bytes, bytes + sizeof(widened));
+}
+
+static void AppendStringToKeyData(std::vector<uint8_t>& key_data,
+                                  std::string_view string) {
+  AppendValueToKeyData(key_data, string.size());
+  key_data.insert(key_data.end(), string.begin(), string.end());
+}
+
+static void AppendStencilToKeyData(
+    std::vector<uint8_t>& key_data,
+    const std::optional<StencilAttachmentDescriptor>& stencil) {
+  AppendValueToKeyData(key_data, stencil.has_value());
+  if (stencil.has_value()) {
+    AppendValueToKeyData(key_data, stencil->stencil_compare);
+    AppendValueToKeyData(key_data, stencil->stencil_failure);
+    AppendValueToKeyData(key_data, stencil->depth_failure);
+    AppendValueToKeyData(key_data, stencil->depth_stencil_pass);
+    AppendValueToKeyData(key_data, stencil->read_mask);
+    AppendValueToKeyData(key_data, stencil->write_mask);
+  }
+}
+
+uint64_t ComputePipelineCacheKey(const PipelineDescriptor& desc) {
+  std::vector<uint8_t> key_data;
+  AppendValueToKeyData(key_data, desc.GetSampleCount());
+  for (const auto& [stage, function] : desc.GetStageEntrypoints()) {
+    AppendValueToKeyData(key_data, stage);
+    AppendStringToKeyData(key_data, function ? function->GetName() : "");
+    AppendValueToKeyData(key_data, function ? function->GetCodeHash() : 0u);
+  }
+  if (const auto& vertex_descriptor = desc.GetVertexDescriptor()) {
+    for (const auto& input : vertex_descriptor->GetStageInputs()) {
+      AppendStringToKeyData(key_data, input.name ? input.name : "");
+      AppendValueToKeyData(key_data, input.location);
+      AppendValueToKeyData(key_data, input.set);
+      AppendValueToKeyData(key_data, input.binding);
+      AppendValueToKeyData(key_data, input.type);
+      AppendValueToKeyData(key_data, input.bit_width);
+      AppendValueToKeyData(key_data, input.vec_size);
+      AppendValueToKeyData(key_data, input.columns);
+    }
+    for (const auto& layout : vertex_descriptor->GetDescriptorSetLayouts()) {
+      AppendValueToKeyData(key_data, layout.binding);
+      AppendValueToKeyData(key_data, layout.descriptor_type);
+      AppendValueToKeyData(key_data, layout.shader_stage);
+    }
+  }
+  for (const auto& [index, color] : desc.GetColorAttachmentDescriptors()) {
+    AppendValueToKeyData(key_data, index);
+    AppendValueToKeyData(key_data, color.format);
+    AppendValueToKeyData(key_data, color.blending_enabled);
+    AppendValueToKeyData(key_data, color.src_color_blend_factor);
+    AppendValueToKeyData(key_data, color.color_blend_op);
+    AppendValueToKeyData(key_data, color.dst_color_blend_factor);
+    AppendValueToKeyData(key_data, color.src_alpha_blend_factor);
+    AppendValueToKeyData(key_data, color.alpha_blend_op);
+    AppendValueToKeyData(key_data, color.dst_alpha_blend_factor);
+    AppendValueToKeyData(key_data, color.write_mask);
+  }
+  AppendValueToKeyData(key_data, desc.GetDepthPixelFormat());
+  AppendValueToKeyData(key_data, desc.GetStencilPixelFormat());
+  const auto depth = desc.GetDepthStencilAttachmentDescriptor();
+  AppendValueToKeyData(key_data, depth.has_value());
+  if (depth.has_value()) {
+    AppendValueToKeyData(key_data, depth->depth_compare);
+    AppendValueToKeyData(key_data, depth->depth_write_enabled);
+  }
+  AppendStencilToKeyData(key_data, desc.GetFrontStencilAttachmentDescriptor());
+  AppendStencilToKeyData(key_data, desc.GetBackStencilAttachmentDescriptor());
+  AppendValueToKeyData(key_data, desc.GetWindingOrder());
+  AppendValueToKeyData(key_data, desc.GetCullMode());
+  AppendValueToKeyData(key_data, desc.GetPrimitiveType());
+  AppendValueToKeyData(key_data, desc.GetPolygonMode());
+  return ComputeChecksum(key_data.data(), key_data.size());
+}
+
+static std::string GetShardFileName(uint64_t key) {
+  std::stringstream stream;
+  stream << std::hex << key << kPipelineCacheShardExtension;
+  return stream.str();
+}
+
+static std::optional<uint64_t> GetShardKey(const std::string& file_name) {
+  const auto extension_length = std::strlen(kPipelineCacheShardExtension);
+  if (file_name.size() <= extension_length ||
+      file_name.compare(file_name.size() - extension_length, extension_length,
+                        kPipelineCacheShardExtension) != 0) {
+    return std::nullopt;
+  }
+  const auto key_string =
+      file_name.substr(0, file_name.size() - extension_length);
+  char* end = nullptr;
+  const auto key = std::strtoull(key_string.c_str(), &end, 16);
+  if (end != key_string.c_str() + key_string.size()) {
+    return std::nullopt;
+  }
+  return key;
+}
+
+struct PipelineCacheLaunches {
+  /// The last launch the cache was persisted in.
+  uint64_t launch = 0u;
+  /// The launches the persisted pipelines were last created in, by key.
+  std::map<uint64_t, uint64_t> last_launches;
+};
+
+static PipelineCacheLaunches ReadLaunches(
+    const fml::UniqueFD& cache_directory,
+    const vk::PhysicalDeviceProperties& properties) {
+  PipelineCacheLaunches launches;
+  if (!cache_directory.is_valid() ||
+      !fml::FileExists(cache_directory, kPipelineCacheLaunchesFileName)) {
+    return launches;
+  }
+  // The launch, followed by key and last launch pairs.
+  auto data = DecodePipelineCacheShard(
+      fml::FileMapping::CreateReadOnly(cache_directory,
+                                       kPipelineCacheLaunchesFileName),
+      properties);
+  if (!data || data->GetSize() % (sizeof(uint64_t) * 2u) != sizeof(uint64_t)) {
+    FML_LOG(INFO) << "Ignoring corrupt pipeline cache launches.";
+    return launches;
+  }
+  std::vector<uint64_t> values(data->GetSize() / sizeof(uint64_t));
+  std::memcpy(values.data(), data->GetMapping(), data->GetSize());
+  launches.launch = values[0];
+  for (size_t i = 1u; i + 1u < values.size(); i += 2u) {
+    launches.last_launches[values[i]] = values[i + 1u];
+  }
+  return launches;
+}
+
+static bool WriteLaunches(const fml::UniqueFD& cache_directory,
+                          const PipelineCacheLaunches& launches,
+                          const vk::PhysicalDeviceProperties& properties) {
+  std::vector<uint64_t> values;
+  values.reserve(1u + launches.last_launches.size() * 2u);
+  values.push_back(launches.launch);
+  for (const auto& [key, last_launch] : launches.last_launches) {
+    values.push_back(key);
+    values.push_back(last_launch);
+  }
+  auto data = EncodePipelineCacheShard(
+      fml::NonOwnedMapping(reinterpret_cast<const uint8_t*>(values.data()),
+                           values.size() * sizeof(uint64_t)),
+      properties);
+  return fml::WriteAtomically(cache_directory, kPipelineCacheLaunchesFileName,
+                              *data);
+}
+
+static fml::UniqueFD OpenShardDirectory(const fml::UniqueFD& cache_directory) {
+  if (!cache_directory.is_valid()) {
+    return {};
+  }
+  // Superseded by the shards. It is no longer read or written.
+  if (fml::FileExists(cache_directory, kPipelineCacheFileName)) {
+    fml::UnlinkFile(cache_directory, kPipelineCacheFileName);
+  }
+  return fml::OpenDirectory(cache_directory,                   //
+                            kPipelineCacheShardDirectoryName,  //
+                            true,                              //
+                            fml::FilePermission::kReadWrite    //
+  );
 }
 
 PipelineCacheVK::PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
@@ -57,16 +290,12 @@ PipelineCacheVK::PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
                                  fml::UniqueFD cache_directory)
     : caps_(std::move(caps)),
       device_(device),
-      cache_directory_(std::move(cache_directory)) {
+      cache_directory_(std::move(cache_directory)),
+      shard_directory_(OpenShardDirectory(cache_directory_)) {
   if (!caps_ || !device_) {
     return;
   }
 
-  const auto& vk_caps = CapabilitiesVK::Cast(*caps_);
-
-  auto existing_cache_data =
-      OpenCacheFile(cache_directory_, kPipelineCacheFileName, vk_caps);
-
   vk::PipelineCacheCreateInfo cache_info;
 
   // TODO(csg): VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT is behind
@@ -75,33 +304,37 @@ PipelineCacheVK::PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
   // cache_info.flags =
   // vk::PipelineCacheCreateFlagBits::eExternallySynchronized;
 
-  if (existing_cache_data) {
-    cache_info.initialDataSize = existing_cache_data->GetSize();
-    cache_info.pInitialData = existing_cache_data->GetMapping();
-  }
-
-  auto [result, existing_cache] = device_.createPipelineCacheUnique(cache_info);
-
-  if (result == vk::Result::eSuccess) {
-    cache_ = std::move(existing_cache);
-  } else {
-    // Even though we perform consistency checks because we don't trust the
-    // driver, the driver may have additional information that may cause it to
-    // reject the cache too.
-    FML_LOG(INFO) << "Existing pipeline cache was invalid: "
-                  << vk::to_string(result) << ". Starting with a fresh cache.";
-    cache_info.pInitialData = nullptr;
-    cache_info.initialDataSize = 0u;
-    auto [result2, new_cache] = device_.createPipelineCacheUnique(cache_info);
-    if (result2 == vk::Result::eSuccess) {
-      cache_ = std::move(new_cache);
-    } else {
-      VALIDATION_LOG << "Could not create new pipeline cache: "
-                     << vk::to_string(result2);
+  auto [result, cache] = device_.createPipelineCacheUnique(cache_info);
+  if (result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Could not create new pipeline cache: "
+                   << vk::to_string(result);
+    return;
+  }
+
+  auto launches = ReadLaunches(cache_directory_, GetDeviceProperties());
+  launch_ = launches.launch + 1u;
+  auto shard_caches = LoadShards(launches.last_launches);
+  if (!shard_caches.empty()) {
+    std::vector<vk::PipelineCache> shard_cache_handles;
+    for (const auto& shard_cache : shard_caches) {
+      shard_cache_handles.push_back(*shard_cache);
+    }
+    auto merge_result =
+        device_.mergePipelineCaches(*cache, shard_cache_handles);
+    if (merge_result != vk::Result::eSuccess) {
+      FML_LOG(INFO) << "Could not merge the persisted pipeline caches: "
+                    << vk::to_string(merge_result)
+                    << ". Starting with a fresh cache.";
+      Lock lock(shards_mutex_);
+      persisted_keys_.clear();
     }
   }
 
-  is_valid_ = !!cache_;
+  {
+    Lock lock(cache_mutex_);
+    cache_ = std::move(cache);
+  }
+  is_valid_ = true;
 }
 
 PipelineCacheVK::~PipelineCacheVK() = default;
@@ -110,52 +343,197 @@ bool PipelineCacheVK::IsValid() const {
   return is_valid_;
 }
 
+const vk::PhysicalDeviceProperties& PipelineCacheVK::GetDeviceProperties()
+    const {
+  return CapabilitiesVK::Cast(*caps_).GetPhysicalDeviceProperties();
+}
+
+std::vector<vk::UniquePipelineCache> PipelineCacheVK::LoadShards(
+    const std::map<uint64_t, uint64_t>& last_launches) {
+  TRACE_EVENT0("impeller", "PipelineCacheVK::LoadShards");
+  std::vector<vk::UniquePipelineCache> shard_caches;
+  if (!shard_directory_.is_valid()) {
+    return shard_caches;
+  }
+
+  std::vector<std::string> file_names;
+  fml::VisitFiles(shard_directory_,
+                  [&file_names](const auto& directory, const auto& file_name) {
+                    file_names.push_back(file_name);
+                    return true;
+                  });
+
+  for (const auto& file_name : file_names) {
+    auto key = GetShardKey(file_name);
+
+    // Shards without a launch were written before launches were tracked, or
+    // by a launch that did not get to persist them. Count them as used now.
+    auto last_launch = launch_;
+    if (auto found = key.has_value() ? last_launches.find(key.value())
+                                     : last_launches.end();
+        found != last_launches.end()) {
+      last_launch = found->second;
+    }
+    if (launch_ - last_launch > kMaxIdleLaunches) {
+      FML_LOG(INFO) << "Removing unused pipeline cache shard: " << file_name;
+      fml::UnlinkFile(shard_directory_, file_name.c_str());
+      continue;
+    }
+
+    auto data = key.has_value()
+                    ? DecodePipelineCacheShard(
+                          fml::FileMapping::CreateReadOnly(shard_directory_,
+                                                           file_name),
+                          GetDeviceProperties())
+                    : nullptr;
+    if (!data) {
+      // That includes shards of another device or driver, such as the one
+      // before a driver update, which would otherwise never be removed.
+      FML_LOG(INFO) << "Removing corrupt or stale pipeline cache shard: "
+                    << file_name;
+      fml::UnlinkFile(shard_directory_, file_name.c_str());
+      continue;
+    }
+
+    vk::PipelineCacheCreateInfo cache_info;
+    cache_info.initialDataSize = data->GetSize();
+    cache_info.pInitialData = data->GetMapping();
+    auto [result, shard_cache] = device_.createPipelineCacheUnique(cache_info);
+    if (result != vk::Result::eSuccess) {
+      // Even though the shards are checked for corruption, the driver may
+      // reject them for reasons of its own.
+      FML_LOG(INFO) << "Removing pipeline cache shard rejected by the driver: "
+                    << file_name << " (" << vk::to_string(result) << ")";
+      fml::UnlinkFile(shard_directory_, file_name.c_str());
+      continue;
+    }
+    shard_caches.push_back(std::move(shard_cache));
+    Lock lock(shards_mutex_);
+    persisted_keys_[key.value()] = last_launch;
+  }
+
+  // Persist the new launch even if no pipeline is created in it.
+  Lock lock(shards_mutex_);
+  launches_changed_ = true;
+  return shard_caches;
+}
+
+bool PipelineCacheVK::TouchKey(uint64_t key) {
+  Lock lock(shards_mutex_);
+  if (auto found = persisted_keys_.find(key); found != persisted_keys_.end()) {
+    if (found->second != launch_) {
+      found->second = launch_;
+      launches_changed_ = true;
+    }
+    return true;
+  }
+  return pending_shards_.count(key) > 0u;
+}
+
 vk::UniquePipeline PipelineCacheVK::CreatePipeline(
-    const vk::GraphicsPipelineCreateInfo& info) {
-  Lock lock(cache_mutex_);
-  auto [result, pipeline] = device_.createGraphicsPipelineUnique(*cache_, info);
+    const vk::GraphicsPipelineCreateInfo& info,
+    uint64_t key) {
+  vk::UniquePipelineCache shard_cache;
+  if (shard_directory_.is_valid() && !TouchKey(key)) {
+    auto [result, cache] = device_.createPipelineCacheUnique(
+        vk::PipelineCacheCreateInfo{});
+    if (result == vk::Result::eSuccess) {
+      shard_cache = std::move(cache);
+    }
+  }
+
+  if (!shard_cache) {
+    Lock lock(cache_mutex_);
+    auto [result, pipeline] =
+        device_.createGraphicsPipelineUnique(*cache_, info);
+    if (result != vk::Result::eSuccess) {
+      VALIDATION_LOG << "Could not create graphics pipeline: "
+                     << vk::to_string(result);
+    }
+    return std::move(pipeline);
+  }
+
+  // The pipeline is new. Its shard cache does not need to be locked as no
+  // other pipeline is created against it.
+  auto [result, pipeline] =
+      device_.createGraphicsPipelineUnique(*shard_cache, info);
   if (result != vk::Result::eSuccess) {
     VALIDATION_LOG << "Could not create graphics pipeline: "
                    << vk::to_string(result);
+    return std::move(pipeline);
   }
-  return std::move(pipeline);
-}
 
-std::shared_ptr<fml::Mapping> PipelineCacheVK::CopyPipelineCacheData() const {
-  if (!IsValid()) {
-    return nullptr;
-  }
-  Lock lock(cache_mutex_);
-  auto [result, data] = device_.getPipelineCacheData(*cache_);
-  if (result != vk::Result::eSuccess) {
-    VALIDATION_LOG << "Could not get pipeline cache data to persist.";
-    return nullptr;
+  {
+    Lock lock(cache_mutex_);
+    auto merge_result = device_.mergePipelineCaches(*cache_, *shard_cache);
+    if (merge_result != vk::Result::eSuccess) {
+      FML_LOG(INFO) << "Could not merge a pipeline cache: "
+                    << vk::to_string(merge_result);
+    }
   }
-  auto shared_data = std::make_shared<std::vector<uint8_t>>();
-  std::swap(*shared_data, data);
-  return std::make_shared<fml::NonOwnedMapping>(
-      shared_data->data(), shared_data->size(), [shared_data](auto, auto) {});
+
+  Lock lock(shards_mutex_);
+  pending_shards_.try_emplace(key, std::move(shard_cache));
+  return std::move(pipeline);
 }
 
-void PipelineCacheVK::PersistCacheToDisk() const {
-  if (!cache_directory_.is_valid()) {
+void PipelineCacheVK::PersistCacheToDisk() {
+  if (!shard_directory_.is_valid()) {
     return;
   }
-  auto data = CopyPipelineCacheData();
-  if (!data) {
-    VALIDATION_LOG << "Could not copy pipeline cache data.";
-    return;
+  TRACE_EVENT0("impeller", "PipelineCacheVK::PersistCacheToDisk");
+
+  std::map<uint64_t, vk::UniquePipelineCache> shards;
+  {
+    Lock lock(shards_mutex_);
+    std::swap(shards, pending_shards_);
   }
-  data = DecorateCacheWithMetadata(std::move(data));
-  if (!data) {
-    VALIDATION_LOG
-        << "Could not decorate pipeline cache with additional metadata.";
-    return;
+
+  for (const auto& [key, shard_cache] : shards) {
+    auto [result, data] = device_.getPipelineCacheData(*shard_cache);
+    if (result != vk::Result::eSuccess) {
+      VALIDATION_LOG << "Could not get pipeline cache data to persist.";
+      continue;
+    }
+    auto shard = EncodePipelineCacheShard(
+        fml::NonOwnedMapping(data.data(), data.size()), GetDeviceProperties());
+    if (!fml::WriteAtomically(shard_directory_, GetShardFileName(key).c_str(),
+                              *shard)) {
+      VALIDATION_LOG << "Could not persist pipeline cache shard to disk.";
+      continue;
+    }
+    Lock lock(shards_mutex_);
+    persisted_keys_[key] = launch_;
+    launches_changed_ = true;
   }
-  if (!fml::WriteAtomically(cache_directory_, kPipelineCacheFileName, *data)) {
-    VALIDATION_LOG << "Could not persist pipeline cache to disk.";
-    return;
+
+  PersistLaunches();
+}
+
+void PipelineCacheVK::PersistLaunches() {
+  PipelineCacheLaunches launches;
+  launches.launch = launch_;
+  {
+    Lock lock(shards_mutex_);
+    if (!launches_changed_) {
+      return;
+    }
+    launches_changed_ = false;
+    launches.last_launches = persisted_keys_;
+  }
+  if (!WriteLaunches(cache_directory_, launches, GetDeviceProperties())) {
+    VALIDATION_LOG << "Could not persist pipeline cache launches to disk.";
   }
 }
 
+size_t PipelineCacheVK::GetPersistedPipelineCount() const {
+  Lock lock(shards_mutex_);
+  return persisted_keys_.size();
+}
+
+size_t PipelineCacheVK::GetPendingPipelineCount() const {
+  Lock lock(shards_mutex_);
+  return pending_shards_.size();
+}
+
 }  // namespace impeller
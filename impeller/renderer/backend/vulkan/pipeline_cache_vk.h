@@ -4,16 +4,82 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+
 #include "flutter/fml/file.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
 #include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/capabilities_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
+#include "impeller/renderer/pipeline_descriptor.h"
 
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      Prefix pipeline cache data with a header that lets corrupt data
+///             be detected when it is read back.
+///
+///             The header also identifies the device and pipeline cache
+///             format of the driver the data was created by, from its
+///             properties.
+///
+std::unique_ptr<fml::Mapping> EncodePipelineCacheShard(
+    const fml::Mapping& data,
+    const vk::PhysicalDeviceProperties& properties);
+
+//------------------------------------------------------------------------------
+/// @brief      Check and strip the header added by `EncodePipelineCacheShard`.
+///
+/// @return     The pipeline cache data, or null if the shard is corrupt or was
+///             created by another device or driver than the one with these
+///             properties.
+///
+std::unique_ptr<fml::Mapping> DecodePipelineCacheShard(
+    std::unique_ptr<fml::Mapping> shard,
+    const vk::PhysicalDeviceProperties& properties);
+
+//------------------------------------------------------------------------------
+/// @brief      Compute the hash of shader code that is part of the keys of
+///             the pipelines using the shader.
+///
+uint64_t ComputeShaderCodeHash(const fml::Mapping& code);
+
+//------------------------------------------------------------------------------
+/// @brief      Compute the key a pipeline is persisted under.
+///
+///             Unlike `PipelineDescriptor::GetHash`, the key is the same in
+///             every launch. It only depends on the names and code hashes of
+///             the shader entrypoints and on the state of the pipeline, not on
+///             the identities of the shader libraries or the addresses of the
+///             names of the stage inputs. The label is not part of it either,
+///             as the labels of variants depend on the order they are
+///             requested in. As the code is part of the key, the pipelines of
+///             shaders that changed in an update are not mistaken for the ones
+///             persisted before it.
+///
+uint64_t ComputePipelineCacheKey(const PipelineDescriptor& desc);
+
+//------------------------------------------------------------------------------
+/// @brief      The pipeline cache, persisted as one file per pipeline.
+///
+///             Pipelines that were not loaded from disk are created against a
+///             cache of their own, whose data is written to disk by the next
+///             call to `PersistCacheToDisk`. That way, persisting only writes
+///             the data of new pipelines. All files are merged into a single
+///             cache when it is created.
+///
+///             The launch each persisted pipeline was last created in is
+///             persisted along with the files. Files of pipelines that were
+///             not created in the last `kMaxIdleLaunches` launches are
+///             removed instead of being merged, so that pipelines the
+///             application no longer uses do not pile up.
+///
 class PipelineCacheVK {
  public:
+  static constexpr uint64_t kMaxIdleLaunches = 8u;
+
   explicit PipelineCacheVK(std::shared_ptr<const Capabilities> caps,
                            vk::Device device,
                            fml::UniqueFD cache_directory);
@@ -22,19 +88,58 @@ class PipelineCacheVK {
 
   bool IsValid() const;
 
-  vk::UniquePipeline CreatePipeline(const vk::GraphicsPipelineCreateInfo& info);
+  //----------------------------------------------------------------------------
+  /// @brief      Create a graphics pipeline.
+  ///
+  /// @param[in]  info  The pipeline create info.
+  /// @param[in]  key   Identifies the pipeline across launches. See
+  ///                   `ComputePipelineCacheKey`.
+  ///
+  vk::UniquePipeline CreatePipeline(const vk::GraphicsPipelineCreateInfo& info,
+                                    uint64_t key);
 
-  void PersistCacheToDisk() const;
+  //----------------------------------------------------------------------------
+  /// @brief      Write the data of the pipelines created since the last call
+  ///             to disk, along with the launches the persisted pipelines
+  ///             were last created in if they changed.
+  ///
+  void PersistCacheToDisk();
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of pipelines whose data is on disk.
+  ///
+  size_t GetPersistedPipelineCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of pipelines whose data is yet to be written to
+  ///             disk.
+  ///
+  size_t GetPendingPipelineCount() const;
 
  private:
   const std::shared_ptr<const Capabilities> caps_;
   const vk::Device device_;
   const fml::UniqueFD cache_directory_;
+  fml::UniqueFD shard_directory_;
   mutable Mutex cache_mutex_;
   vk::UniquePipelineCache cache_ IPLR_GUARDED_BY(cache_mutex_);
+  uint64_t launch_ = 0u;
+  mutable Mutex shards_mutex_;
+  // The launches the persisted pipelines were last created in, by key.
+  std::map<uint64_t, uint64_t> persisted_keys_ IPLR_GUARDED_BY(shards_mutex_);
+  std::map<uint64_t, vk::UniquePipelineCache> pending_shards_
+      IPLR_GUARDED_BY(shards_mutex_);
+  bool launches_changed_ IPLR_GUARDED_BY(shards_mutex_) = false;
   bool is_valid_ = false;
 
-  std::shared_ptr<fml::Mapping> CopyPipelineCacheData() const;
+  std::vector<vk::UniquePipelineCache> LoadShards(
+      const std::map<uint64_t, uint64_t>& last_launches);
+
+  const vk::PhysicalDeviceProperties& GetDeviceProperties() const;
+
+  bool TouchKey(uint64_t key);
+
+  void PersistLaunches();
 
   FML_DISALLOW_COPY_AND_ASSIGN(PipelineCacheVK);
 };
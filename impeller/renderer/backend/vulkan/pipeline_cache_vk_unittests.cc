@@ -0,0 +1,366 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/testing/testing.h"
+#include "impeller/fixtures/simple.vert.h"
+#include "impeller/playground/playground_test.h"
+#include "impeller/renderer/backend/vulkan/capabilities_vk.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
+#include "impeller/renderer/backend/vulkan/shader_function_vk.h"
+#include "impeller/renderer/shader_function.h"
+#include "impeller/renderer/vertex_descriptor.h"
+
+namespace impeller {
+namespace testing {
+
+static std::vector<uint8_t> ToVector(const fml::Mapping& mapping) {
+  return std::vector<uint8_t>(mapping.GetMapping(),
+                              mapping.GetMapping() + mapping.GetSize());
+}
+
+static vk::PhysicalDeviceProperties MakeDeviceProperties(uint8_t uuid_byte) {
+  vk::PhysicalDeviceProperties properties;
+  properties.vendorID = 0x13b5;
+  properties.deviceID = 0x92020010;
+  properties.pipelineCacheUUID.fill(uuid_byte);
+  return properties;
+}
+
+TEST(PipelineCacheVKTest, ShardsRoundTrip) {
+  const auto properties = MakeDeviceProperties(0xab);
+  const std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+  auto shard = EncodePipelineCacheShard(
+      fml::NonOwnedMapping(data.data(), data.size()), properties);
+  ASSERT_TRUE(shard);
+  EXPECT_GT(shard->GetSize(), data.size());
+
+  auto decoded = DecodePipelineCacheShard(std::move(shard), properties);
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(ToVector(*decoded), data);
+}
+
+TEST(PipelineCacheVKTest, CorruptShardsAreRejected) {
+  const auto properties = MakeDeviceProperties(0xab);
+  const std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+  const auto shard = ToVector(*EncodePipelineCacheShard(
+      fml::NonOwnedMapping(data.data(), data.size()), properties));
+
+  auto decode = [&properties](std::vector<uint8_t> bytes) {
+    return DecodePipelineCacheShard(
+        std::make_unique<fml::DataMapping>(std::move(bytes)), properties);
+  };
+
+  EXPECT_FALSE(DecodePipelineCacheShard(nullptr, properties));
+  EXPECT_FALSE(decode({}));
+
+  // Truncated.
+  EXPECT_FALSE(decode({shard.begin(), shard.end() - 1}));
+  EXPECT_FALSE(decode({shard.begin(), shard.begin() + 4}));
+
+  // Extended.
+  auto extended = shard;
+  extended.push_back(0u);
+  EXPECT_FALSE(decode(extended));
+
+  // A flipped bit anywhere is detected.
+  for (size_t i = 0; i < shard.size(); i++) {
+    auto flipped = shard;
+    flipped[i] ^= 0x10;
+    EXPECT_FALSE(decode(flipped)) << "Byte " << i;
+  }
+
+  EXPECT_TRUE(decode(shard));
+}
+
+TEST(PipelineCacheVKTest, ShardsOfOtherDevicesAndDriversAreRejected) {
+  const auto properties = MakeDeviceProperties(0xab);
+  const std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+  auto encode = [&data](const vk::PhysicalDeviceProperties& properties) {
+    return EncodePipelineCacheShard(
+        fml::NonOwnedMapping(data.data(), data.size()), properties);
+  };
+
+  EXPECT_TRUE(DecodePipelineCacheShard(encode(properties), properties));
+
+  // An updated driver with another pipeline cache format.
+  EXPECT_FALSE(DecodePipelineCacheShard(encode(MakeDeviceProperties(0xcd)),
+                                        properties));
+
+  auto other_vendor = properties;
+  other_vendor.vendorID++;
+  EXPECT_FALSE(DecodePipelineCacheShard(encode(other_vendor), properties));
+
+  auto other_device = properties;
+  other_device.deviceID++;
+  EXPECT_FALSE(DecodePipelineCacheShard(encode(other_device), properties));
+}
+
+class TestShaderFunction final : public ShaderFunction {
+ public:
+  TestShaderFunction(std::string name,
+                     ShaderStage stage,
+                     uint64_t code_hash = 0u)
+      : ShaderFunction(UniqueID{}, std::move(name), stage),
+        code_hash_(code_hash) {}
+
+  // |ShaderFunction|
+  uint64_t GetCodeHash() const override { return code_hash_; }
+
+ private:
+  const uint64_t code_hash_;
+};
+
+static PipelineDescriptor MakeKeyDescriptor(const std::string& label,
+                                            const std::string& input_name) {
+  ShaderStageIOSlot position = {
+      .name = input_name.c_str(),
+      .location = 0u,
+      .set = 0u,
+      .binding = 0u,
+      .type = ShaderType::kFloat,
+      .bit_width = 32u,
+      .vec_size = 2u,
+      .columns = 1u,
+  };
+  const ShaderStageIOSlot* const inputs[] = {&position};
+  auto vertex_descriptor = std::make_shared<VertexDescriptor>();
+  vertex_descriptor->SetStageInputs(inputs, 1u);
+
+  PipelineDescriptor desc;
+  desc.SetLabel(label);
+  desc.AddStageEntrypoint(std::make_shared<TestShaderFunction>(
+      "vertex_main", ShaderStage::kVertex));
+  desc.AddStageEntrypoint(std::make_shared<TestShaderFunction>(
+      "fragment_main", ShaderStage::kFragment));
+  desc.SetVertexDescriptor(std::move(vertex_descriptor));
+  desc.SetColorAttachmentDescriptor(
+      0u, ColorAttachmentDescriptor{.format = PixelFormat::kB8G8R8A8UNormInt});
+  return desc;
+}
+
+TEST(PipelineCacheVKTest, KeysAreStableAcrossLaunches) {
+  // Each descriptor has shader functions from a library of its own, and its
+  // own copy of the stage input names, as a later launch would.
+  const std::string input_name = "position";
+  const std::string same_input_name = input_name;
+  const auto desc = MakeKeyDescriptor("Pipeline V#1", input_name);
+  const auto same_desc = MakeKeyDescriptor("Pipeline V#2", same_input_name);
+  EXPECT_NE(desc.GetHash(), same_desc.GetHash());
+  EXPECT_EQ(ComputePipelineCacheKey(desc), ComputePipelineCacheKey(same_desc));
+
+  auto blended_desc = MakeKeyDescriptor("Pipeline V#1", input_name);
+  blended_desc.SetColorAttachmentDescriptor(
+      0u, ColorAttachmentDescriptor{.format = PixelFormat::kB8G8R8A8UNormInt,
+                                    .blending_enabled = true});
+  EXPECT_NE(ComputePipelineCacheKey(desc),
+            ComputePipelineCacheKey(blended_desc));
+
+  auto other_shader_desc = MakeKeyDescriptor("Pipeline V#1", input_name);
+  other_shader_desc.AddStageEntrypoint(std::make_shared<TestShaderFunction>(
+      "other_fragment_main", ShaderStage::kFragment));
+  EXPECT_NE(ComputePipelineCacheKey(desc),
+            ComputePipelineCacheKey(other_shader_desc));
+
+  // The same shader, changed by an update.
+  auto updated_shader_desc = MakeKeyDescriptor("Pipeline V#1", input_name);
+  updated_shader_desc.AddStageEntrypoint(std::make_shared<TestShaderFunction>(
+      "fragment_main", ShaderStage::kFragment, 0x1234u));
+  EXPECT_NE(ComputePipelineCacheKey(desc),
+            ComputePipelineCacheKey(updated_shader_desc));
+}
+
+TEST(PipelineCacheVKTest, ShaderCodeHashesAreStable) {
+  const std::vector<uint8_t> code = {0x03, 0x02, 0x23, 0x07, 1, 2, 3, 4};
+  auto other_code = code;
+  other_code.back()++;
+  EXPECT_EQ(ComputeShaderCodeHash(fml::NonOwnedMapping(code.data(),
+                                                       code.size())),
+            ComputeShaderCodeHash(fml::DataMapping(code)));
+  EXPECT_NE(ComputeShaderCodeHash(fml::DataMapping(code)),
+            ComputeShaderCodeHash(fml::DataMapping(other_code)));
+}
+
+using PipelineCacheVKPlaygroundTest = PlaygroundTest;
+INSTANTIATE_PLAYGROUND_SUITE(PipelineCacheVKPlaygroundTest);
+
+/// The create info of a pipeline that rasterizes nothing, so that it needs
+/// neither a fragment shader nor attachments.
+struct DiscardPipelineInfo {
+  vk::UniqueRenderPass render_pass;
+  vk::UniquePipelineLayout layout;
+  vk::PipelineShaderStageCreateInfo stage;
+  vk::PipelineVertexInputStateCreateInfo vertex_input;
+  vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+  vk::PipelineRasterizationStateCreateInfo rasterization;
+  vk::GraphicsPipelineCreateInfo info;
+};
+
+static std::unique_ptr<DiscardPipelineInfo> MakeDiscardPipelineInfo(
+    const Context& context) {
+  const auto device = ContextVK::Cast(context).GetDevice();
+  auto function = context.GetShaderLibrary()->GetFunction(
+      SimpleVertexShader::kEntrypointName, ShaderStage::kVertex);
+  if (!function) {
+    return nullptr;
+  }
+
+  auto pipeline_info = std::make_unique<DiscardPipelineInfo>();
+  vk::SubpassDescription subpass;
+  subpass.setPipelineBindPoint(vk::PipelineBindPoint::eGraphics);
+  vk::RenderPassCreateInfo render_pass_info;
+  render_pass_info.setSubpasses(subpass);
+  auto [render_pass_result, render_pass] =
+      device.createRenderPassUnique(render_pass_info);
+  auto [layout_result, layout] =
+      device.createPipelineLayoutUnique(vk::PipelineLayoutCreateInfo{});
+  if (render_pass_result != vk::Result::eSuccess ||
+      layout_result != vk::Result::eSuccess) {
+    return nullptr;
+  }
+  pipeline_info->render_pass = std::move(render_pass);
+  pipeline_info->layout = std::move(layout);
+
+  pipeline_info->stage.setStage(vk::ShaderStageFlagBits::eVertex);
+  pipeline_info->stage.setPName("main");
+  pipeline_info->stage.setModule(ShaderFunctionVK::Cast(*function).GetModule());
+  pipeline_info->input_assembly.setTopology(
+      vk::PrimitiveTopology::eTriangleList);
+  pipeline_info->rasterization.setRasterizerDiscardEnable(true);
+  pipeline_info->rasterization.setLineWidth(1.0f);
+
+  auto& info = pipeline_info->info;
+  info.setStages(pipeline_info->stage);
+  info.setPVertexInputState(&pipeline_info->vertex_input);
+  info.setPInputAssemblyState(&pipeline_info->input_assembly);
+  info.setPRasterizationState(&pipeline_info->rasterization);
+  info.setLayout(*pipeline_info->layout);
+  info.setRenderPass(*pipeline_info->render_pass);
+  return pipeline_info;
+}
+
+TEST_P(PipelineCacheVKPlaygroundTest, LoadsValidShardsAndRemovesCorruptOnes) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Pipeline cache shards are only used by Vulkan.");
+  }
+  const auto& context_vk = ContextVK::Cast(*GetContext());
+  auto device = context_vk.GetDevice();
+  const auto& properties = CapabilitiesVK::Cast(*context_vk.GetCapabilities())
+                               .GetPhysicalDeviceProperties();
+
+  // Valid cache data as the driver sees it.
+  auto [result, cache] =
+      device.createPipelineCacheUnique(vk::PipelineCacheCreateInfo{});
+  ASSERT_EQ(result, vk::Result::eSuccess);
+  auto [data_result, data] = device.getPipelineCacheData(*cache);
+  ASSERT_EQ(data_result, vk::Result::eSuccess);
+
+  fml::ScopedTemporaryDirectory temp_dir;
+  auto shard_dir =
+      fml::OpenDirectory(temp_dir.fd(), "flutter.impeller.vkcache.shards",
+                         true, fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(shard_dir.is_valid());
+
+  static constexpr size_t kValidShardCount = 64u;
+  for (size_t i = 0; i < kValidShardCount; i++) {
+    auto shard = EncodePipelineCacheShard(
+        fml::NonOwnedMapping(data.data(), data.size()), properties);
+    const auto file_name = std::to_string(i + 1u) + ".shard";
+    ASSERT_TRUE(fml::WriteAtomically(shard_dir, file_name.c_str(), *shard));
+  }
+
+  auto corrupt = ToVector(*EncodePipelineCacheShard(
+      fml::NonOwnedMapping(data.data(), data.size()), properties));
+  corrupt.back() ^= 0xff;
+  ASSERT_TRUE(fml::WriteAtomically(shard_dir, "abc.shard",
+                                   fml::DataMapping(std::move(corrupt))));
+  ASSERT_TRUE(fml::WriteAtomically(shard_dir, "not-a-key.shard",
+                                   fml::DataMapping("garbage")));
+
+  const auto load_start = fml::TimePoint::Now();
+  PipelineCacheVK pipeline_cache(
+      context_vk.GetCapabilities(), device,
+      fml::OpenDirectory(temp_dir.path().c_str(), false,
+                         fml::FilePermission::kReadWrite));
+  const auto load_time = fml::TimePoint::Now() - load_start;
+
+  ASSERT_TRUE(pipeline_cache.IsValid());
+  EXPECT_EQ(pipeline_cache.GetPersistedPipelineCount(), kValidShardCount);
+  EXPECT_EQ(pipeline_cache.GetPendingPipelineCount(), 0u);
+  EXPECT_TRUE(fml::FileExists(shard_dir, "1.shard"));
+  EXPECT_FALSE(fml::FileExists(shard_dir, "abc.shard"));
+  EXPECT_FALSE(fml::FileExists(shard_dir, "not-a-key.shard"));
+
+  // Pipelines with new keys are written to shards of their own. The keys are
+  // clear of the ones the file names of the valid shards parse to.
+  auto pipeline_info = MakeDiscardPipelineInfo(*GetContext());
+  ASSERT_TRUE(pipeline_info);
+  static constexpr size_t kNewPipelineCount = 16u;
+  for (size_t i = 0; i < kNewPipelineCount; i++) {
+    ASSERT_TRUE(pipeline_cache.CreatePipeline(pipeline_info->info,
+                                              0x1000u + i));
+  }
+  EXPECT_EQ(pipeline_cache.GetPendingPipelineCount(), kNewPipelineCount);
+
+  const auto persist_start = fml::TimePoint::Now();
+  pipeline_cache.PersistCacheToDisk();
+  const auto persist_time = fml::TimePoint::Now() - persist_start;
+  EXPECT_EQ(pipeline_cache.GetPersistedPipelineCount(),
+            kValidShardCount + kNewPipelineCount);
+  EXPECT_EQ(pipeline_cache.GetPendingPipelineCount(), 0u);
+  EXPECT_TRUE(fml::FileExists(shard_dir, "1000.shard"));
+  EXPECT_TRUE(fml::FileExists(shard_dir, "100f.shard"));
+
+  RecordProperty("LoadMicroseconds", load_time.ToMicroseconds());
+  RecordProperty("PersistMicroseconds", persist_time.ToMicroseconds());
+}
+
+TEST_P(PipelineCacheVKPlaygroundTest, RemovesShardsOfUnusedPipelines) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Pipeline cache shards are only used by Vulkan.");
+  }
+  const auto& context_vk = ContextVK::Cast(*GetContext());
+  auto pipeline_info = MakeDiscardPipelineInfo(*GetContext());
+  ASSERT_TRUE(pipeline_info);
+
+  fml::ScopedTemporaryDirectory temp_dir;
+  auto launch = [&](const std::vector<uint64_t>& used_keys) {
+    PipelineCacheVK pipeline_cache(
+        context_vk.GetCapabilities(), context_vk.GetDevice(),
+        fml::OpenDirectory(temp_dir.path().c_str(), false,
+                           fml::FilePermission::kReadWrite));
+    EXPECT_TRUE(pipeline_cache.IsValid());
+    for (auto key : used_keys) {
+      EXPECT_TRUE(pipeline_cache.CreatePipeline(pipeline_info->info, key));
+    }
+    pipeline_cache.PersistCacheToDisk();
+  };
+
+  launch({1u, 2u});
+  auto shard_dir =
+      fml::OpenDirectory(temp_dir.fd(), "flutter.impeller.vkcache.shards",
+                         false, fml::FilePermission::kRead);
+  ASSERT_TRUE(shard_dir.is_valid());
+  EXPECT_TRUE(fml::FileExists(shard_dir, "1.shard"));
+  EXPECT_TRUE(fml::FileExists(shard_dir, "2.shard"));
+
+  // The shard of the pipeline that is no longer created is kept for the idle
+  // launches, and removed in the launch after.
+  for (size_t i = 0; i < PipelineCacheVK::kMaxIdleLaunches; i++) {
+    launch({2u});
+    EXPECT_TRUE(fml::FileExists(shard_dir, "1.shard")) << "Launch " << i;
+  }
+  launch({2u});
+  EXPECT_FALSE(fml::FileExists(shard_dir, "1.shard"));
+  EXPECT_TRUE(fml::FileExists(shard_dir, "2.shard"));
+}
+
+}  // namespace testing
+}  // namespace impeller
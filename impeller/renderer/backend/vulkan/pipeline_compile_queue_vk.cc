@@ -0,0 +1,139 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/pipeline_compile_queue_vk.h"
+
+#include <algorithm>
+
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+std::shared_ptr<PipelineCompileQueueVK> PipelineCompileQueueVK::Create(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  if (!worker_task_runner) {
+    return nullptr;
+  }
+  return std::shared_ptr<PipelineCompileQueueVK>(
+      new PipelineCompileQueueVK(std::move(worker_task_runner)));
+}
+
+PipelineCompileQueueVK::PipelineCompileQueueVK(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    : worker_task_runner_(std::move(worker_task_runner)) {}
+
+PipelineCompileQueueVK::~PipelineCompileQueueVK() = default;
+
+bool PipelineCompileQueueVK::PostJobForDescriptor(
+    const PipelineDescriptor& desc,
+    const fml::closure& job) {
+  if (!job) {
+    return false;
+  }
+
+  {
+    Lock lock(pending_jobs_mutex_);
+    auto [_, inserted] = pending_jobs_.try_emplace(
+        desc, PendingJob{.job = job, .post_time = fml::TimePoint::Now()});
+    if (!inserted) {
+      return false;
+    }
+    pending_job_order_.push_back(desc);
+  }
+
+  // Each task performs whichever job is next once it runs, so jobs that were
+  // performed eagerly in the meantime are not waited on.
+  worker_task_runner_->PostTask([weak_this = weak_from_this()]() {
+    if (auto thiz = weak_this.lock()) {
+      thiz->DoOneJob();
+    }
+  });
+  return true;
+}
+
+void PipelineCompileQueueVK::PerformJobEagerly(const PipelineDescriptor& desc) {
+  if (auto job = TakeJob(desc); job.has_value()) {
+    TRACE_EVENT0("impeller", "PipelineCompileQueueVK::PerformJobEagerly");
+    PerformJob(std::move(job.value()), true);
+  }
+}
+
+void PipelineCompileQueueVK::MoveJobToFront(const PipelineDescriptor& desc) {
+  Lock lock(pending_jobs_mutex_);
+  if (pending_jobs_.find(desc) == pending_jobs_.end()) {
+    return;
+  }
+  // The descriptor left further back is passed over once its job is taken.
+  pending_job_order_.push_front(desc);
+}
+
+PipelineCompileQueueVK::Statistics PipelineCompileQueueVK::GetStatistics()
+    const {
+  Lock lock(pending_jobs_mutex_);
+  auto statistics = statistics_;
+  statistics.pending_job_count = pending_jobs_.size();
+  return statistics;
+}
+
+std::optional<PipelineCompileQueueVK::PendingJob>
+PipelineCompileQueueVK::TakeJob(const PipelineDescriptor& desc) {
+  Lock lock(pending_jobs_mutex_);
+  auto found = pending_jobs_.find(desc);
+  if (found == pending_jobs_.end()) {
+    return std::nullopt;
+  }
+  auto job = std::move(found->second);
+  pending_jobs_.erase(found);
+  return job;
+}
+
+std::optional<PipelineCompileQueueVK::PendingJob>
+PipelineCompileQueueVK::TakeNextJob() {
+  Lock lock(pending_jobs_mutex_);
+  while (!pending_job_order_.empty()) {
+    auto desc = std::move(pending_job_order_.front());
+    pending_job_order_.pop_front();
+    // Jobs performed eagerly leave their descriptors behind.
+    if (auto found = pending_jobs_.find(desc); found != pending_jobs_.end()) {
+      auto job = std::move(found->second);
+      pending_jobs_.erase(found);
+      return job;
+    }
+  }
+  return std::nullopt;
+}
+
+void PipelineCompileQueueVK::PerformJob(PendingJob job, bool eager) {
+  job.job();
+  const auto time_to_ready = fml::TimePoint::Now() - job.post_time;
+
+  Lock lock(pending_jobs_mutex_);
+  statistics_.finished_job_count++;
+  if (eager) {
+    statistics_.eager_job_count++;
+  }
+  statistics_.max_time_to_ready =
+      std::max(statistics_.max_time_to_ready, time_to_ready);
+  statistics_.total_time_to_ready =
+      statistics_.total_time_to_ready + time_to_ready;
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER(
+      "impeller",                                                 //
+      "PipelineCompileQueueVK", reinterpret_cast<int64_t>(this),  //
+      "PendingJobs", pending_jobs_.size(),                        //
+      "TimeToReadyMicroseconds", time_to_ready.ToMicroseconds(),  //
+      "MaxTimeToReadyMicroseconds",                               //
+      statistics_.max_time_to_ready.ToMicroseconds());
+#endif  // !FLUTTER_RELEASE
+}
+
+void PipelineCompileQueueVK::DoOneJob() {
+  if (auto job = TakeNextJob(); job.has_value()) {
+    TRACE_EVENT0("impeller", "PipelineCompileQueueVK::DoOneJob");
+    PerformJob(std::move(job.value()), false);
+  }
+}
+
+}  // namespace impeller
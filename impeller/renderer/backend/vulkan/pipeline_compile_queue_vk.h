@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+#include "impeller/base/comparable.h"
+#include "impeller/base/thread.h"
+#include "impeller/renderer/pipeline_descriptor.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Creates pipelines on worker threads in the order they were
+///             requested, unless a pipeline is needed right away.
+///
+///             A pipeline that is about to be waited on can be created
+///             eagerly on the waiting thread. That way, it does not wait for
+///             all the pipelines requested before it to be created first.
+///
+///             This class is thread safe.
+///
+class PipelineCompileQueueVK final
+    : public std::enable_shared_from_this<PipelineCompileQueueVK> {
+ public:
+  struct Statistics {
+    /// The number of jobs that have finished.
+    size_t finished_job_count = 0u;
+    /// The number of jobs that were performed eagerly.
+    size_t eager_job_count = 0u;
+    /// The number of jobs that have not started yet.
+    size_t pending_job_count = 0u;
+    /// The longest time from a job being posted to it finishing.
+    fml::TimeDelta max_time_to_ready;
+    /// The sum of the times from the jobs being posted to them finishing.
+    fml::TimeDelta total_time_to_ready;
+  };
+
+  static std::shared_ptr<PipelineCompileQueueVK> Create(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
+  ~PipelineCompileQueueVK();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Post a job that creates the pipeline for a descriptor.
+  ///
+  /// @return     If the job was posted. Only one job may be pending per
+  ///             descriptor.
+  ///
+  bool PostJobForDescriptor(const PipelineDescriptor& desc,
+                            const fml::closure& job);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Perform the pending job for a descriptor on the calling
+  ///             thread. Does nothing if the job has already started.
+  ///
+  void PerformJobEagerly(const PipelineDescriptor& desc);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Move the pending job for a descriptor to the front of the
+  ///             queue without waiting for it. Does nothing if the job has
+  ///             already started.
+  ///
+  void MoveJobToFront(const PipelineDescriptor& desc);
+
+  Statistics GetStatistics() const;
+
+ private:
+  struct PendingJob {
+    fml::closure job;
+    fml::TimePoint post_time;
+  };
+
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  mutable Mutex pending_jobs_mutex_;
+  std::unordered_map<PipelineDescriptor,
+                     PendingJob,
+                     ComparableHash<PipelineDescriptor>,
+                     ComparableEqual<PipelineDescriptor>>
+      pending_jobs_ IPLR_GUARDED_BY(pending_jobs_mutex_);
+  std::deque<PipelineDescriptor> pending_job_order_
+      IPLR_GUARDED_BY(pending_jobs_mutex_);
+  Statistics statistics_ IPLR_GUARDED_BY(pending_jobs_mutex_);
+
+  explicit PipelineCompileQueueVK(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
+  std::optional<PendingJob> TakeJob(const PipelineDescriptor& desc);
+
+  std::optional<PendingJob> TakeNextJob();
+
+  void PerformJob(PendingJob job, bool eager);
+
+  void DoOneJob();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PipelineCompileQueueVK);
+};
+
+}  // namespace impeller
@@ -0,0 +1,152 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/testing/testing.h"
+#include "impeller/renderer/backend/vulkan/pipeline_compile_queue_vk.h"
+
+namespace impeller {
+namespace testing {
+
+static PipelineDescriptor MakeDescriptor(const std::string& label) {
+  PipelineDescriptor desc;
+  desc.SetLabel(label);
+  return desc;
+}
+
+TEST(PipelineCompileQueueVKTest, EagerJobsSkipTheQueue) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  auto queue = PipelineCompileQueueVK::Create(loop->GetTaskRunner());
+  ASSERT_TRUE(queue);
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  fml::CountDownLatch done(4u);
+  auto make_job = [&](const std::string& label) {
+    return [&, label]() {
+      {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(label);
+      }
+      done.CountDown();
+    };
+  };
+
+  // Keep the only worker busy until all jobs are posted.
+  fml::AutoResetWaitableEvent blocker;
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("Blocker"), [&]() {
+    blocker.Wait();
+    make_job("Blocker")();
+  }));
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("A"), make_job("A")));
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("B"), make_job("B")));
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("C"), make_job("C")));
+
+  queue->PerformJobEagerly(MakeDescriptor("C"));
+  {
+    std::scoped_lock lock(order_mutex);
+    ASSERT_EQ(order.size(), 1u);
+    EXPECT_EQ(order[0], "C");
+  }
+
+  blocker.Signal();
+  done.Wait();
+  loop->Terminate();
+
+  EXPECT_EQ(order, (std::vector<std::string>{"C", "Blocker", "A", "B"}));
+  auto statistics = queue->GetStatistics();
+  EXPECT_EQ(statistics.finished_job_count, 4u);
+  EXPECT_EQ(statistics.eager_job_count, 1u);
+  EXPECT_EQ(statistics.pending_job_count, 0u);
+  EXPECT_GE(statistics.total_time_to_ready, statistics.max_time_to_ready);
+}
+
+TEST(PipelineCompileQueueVKTest, JobsMovedToFrontRunNextWithoutWaiting) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  auto queue = PipelineCompileQueueVK::Create(loop->GetTaskRunner());
+  ASSERT_TRUE(queue);
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  fml::CountDownLatch done(4u);
+  auto make_job = [&](const std::string& label) {
+    return [&, label]() {
+      {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(label);
+      }
+      done.CountDown();
+    };
+  };
+
+  // Keep the only worker busy in the first job until all jobs are posted.
+  fml::AutoResetWaitableEvent blocker_started;
+  fml::AutoResetWaitableEvent blocker;
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("Blocker"), [&]() {
+    blocker_started.Signal();
+    blocker.Wait();
+    make_job("Blocker")();
+  }));
+  blocker_started.Wait();
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("A"), make_job("A")));
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("B"), make_job("B")));
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("C"), make_job("C")));
+
+  // The worker is still blocked, so nothing may have run on this thread.
+  queue->MoveJobToFront(MakeDescriptor("C"));
+  {
+    std::scoped_lock lock(order_mutex);
+    EXPECT_TRUE(order.empty());
+  }
+
+  blocker.Signal();
+  done.Wait();
+  loop->Terminate();
+
+  EXPECT_EQ(order, (std::vector<std::string>{"Blocker", "C", "A", "B"}));
+  auto statistics = queue->GetStatistics();
+  EXPECT_EQ(statistics.finished_job_count, 4u);
+  EXPECT_EQ(statistics.eager_job_count, 0u);
+  EXPECT_EQ(statistics.pending_job_count, 0u);
+}
+
+TEST(PipelineCompileQueueVKTest, OnlyOneJobIsPendingPerDescriptor) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  auto queue = PipelineCompileQueueVK::Create(loop->GetTaskRunner());
+  ASSERT_TRUE(queue);
+
+  fml::AutoResetWaitableEvent blocker;
+  ASSERT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("Blocker"),
+                                          [&]() { blocker.Wait(); }));
+
+  size_t run_count = 0u;
+  auto job = [&run_count]() { run_count++; };
+  EXPECT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("A"), job));
+  EXPECT_FALSE(queue->PostJobForDescriptor(MakeDescriptor("A"), job));
+  EXPECT_EQ(queue->GetStatistics().pending_job_count, 1u);
+
+  queue->PerformJobEagerly(MakeDescriptor("A"));
+  EXPECT_EQ(run_count, 1u);
+  // The job is no longer pending, so neither of these run it again.
+  queue->PerformJobEagerly(MakeDescriptor("A"));
+  EXPECT_EQ(run_count, 1u);
+
+  // Once a job has been taken, the descriptor may be posted again.
+  EXPECT_TRUE(queue->PostJobForDescriptor(MakeDescriptor("A"), job));
+  queue->PerformJobEagerly(MakeDescriptor("A"));
+  EXPECT_EQ(run_count, 2u);
+
+  blocker.Signal();
+  loop->Terminate();
+  EXPECT_EQ(queue->GetStatistics().eager_job_count, 2u);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -18,6 +18,8 @@
 
 namespace impeller {
 
+static constexpr size_t kFramesPerPipelineCachePersist = 50u;
+
 PipelineLibraryVK::PipelineLibraryVK(
     const vk::Device& device,
     std::shared_ptr<const Capabilities> caps,
@@ -27,8 +29,9 @@ PipelineLibraryVK::PipelineLibraryVK(
       pso_cache_(std::make_shared<PipelineCacheVK>(std::move(caps),
                                                    device,
                                                    std::move(cache_directory))),
-      worker_task_runner_(std::move(worker_task_runner)) {
-  if (!pso_cache_->IsValid() || !worker_task_runner_) {
+      worker_task_runner_(std::move(worker_task_runner)),
+      compile_queue_(PipelineCompileQueueVK::Create(worker_task_runner_)) {
+  if (!pso_cache_->IsValid() || !worker_task_runner_ || !compile_queue_) {
     return;
   }
 
@@ -315,7 +318,8 @@ std::unique_ptr<PipelineVK> PipelineLibraryVK::CreatePipeline(
   //----------------------------------------------------------------------------
   /// Finally, all done with the setup info. Create the pipeline itself.
   ///
-  auto pipeline = pso_cache_->CreatePipeline(pipeline_info);
+  auto pipeline =
+      pso_cache_->CreatePipeline(pipeline_info, ComputePipelineCacheKey(desc));
   if (!pipeline) {
     VALIDATION_LOG << "Could not create graphics pipeline: " << desc.GetLabel();
     return nullptr;
@@ -356,7 +360,7 @@ PipelineFuture<PipelineDescriptor> PipelineLibraryVK::GetPipeline(
 
   auto weak_this = weak_from_this();
 
-  worker_task_runner_->PostTask([descriptor, weak_this, promise]() {
+  auto job = [descriptor, weak_this, promise]() {
     auto thiz = weak_this.lock();
     if (!thiz) {
       promise->set_value(nullptr);
@@ -373,11 +377,30 @@ PipelineFuture<PipelineDescriptor> PipelineLibraryVK::GetPipeline(
     }
 
     promise->set_value(std::move(pipeline));
-  });
+  };
+  if (!compile_queue_->PostJobForDescriptor(descriptor, job)) {
+    // Only one job may be pending per descriptor. The pipeline must have been
+    // removed from the library before the pending job ran.
+    worker_task_runner_->PostTask(job);
+  }
 
   return pipeline_future;
 }
 
+// |PipelineLibrary|
+void PipelineLibraryVK::PrioritizePipeline(
+    const PipelineDescriptor& descriptor,
+    bool will_wait) {
+  if (!compile_queue_) {
+    return;
+  }
+  if (will_wait) {
+    compile_queue_->PerformJobEagerly(descriptor);
+  } else {
+    compile_queue_->MoveJobToFront(descriptor);
+  }
+}
+
 // |PipelineLibrary|
 PipelineFuture<ComputePipelineDescriptor> PipelineLibraryVK::GetPipeline(
     ComputePipelineDescriptor descriptor) {
@@ -399,7 +422,10 @@ void PipelineLibraryVK::RemovePipelinesWithEntryPoint(
 }
 
 void PipelineLibraryVK::DidAcquireSurfaceFrame() {
-  if (++frames_acquired_ == 50u) {
+  // Only pipelines created since the cache was last persisted are written, so
+  // this is cheap enough to do periodically.
+  if (++frames_acquired_ % kFramesPerPipelineCachePersist == 0u &&
+      pso_cache_->GetPendingPipelineCount() > 0u) {
     PersistPipelineCacheToDisk();
   }
 }
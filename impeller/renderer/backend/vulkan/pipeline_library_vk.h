@@ -13,6 +13,7 @@
 #include "impeller/base/backend_cast.h"
 #include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_compile_queue_vk.h"
 #include "impeller/renderer/backend/vulkan/pipeline_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 #include "impeller/renderer/pipeline_library.h"
@@ -37,6 +38,7 @@ class PipelineLibraryVK final
   vk::Device device_;
   std::shared_ptr<PipelineCacheVK> pso_cache_;
   std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  std::shared_ptr<PipelineCompileQueueVK> compile_queue_;
   Mutex pipelines_mutex_;
   PipelineMap pipelines_ IPLR_GUARDED_BY(pipelines_mutex_);
   std::atomic_size_t frames_acquired_ = 0u;
@@ -59,6 +61,10 @@ class PipelineLibraryVK final
   PipelineFuture<ComputePipelineDescriptor> GetPipeline(
       ComputePipelineDescriptor descriptor) override;
 
+  // |PipelineLibrary|
+  void PrioritizePipeline(const PipelineDescriptor& descriptor,
+                          bool will_wait) override;
+
   // |PipelineLibrary|
   void RemovePipelinesWithEntryPoint(
       std::shared_ptr<const ShaderFunction> function) override;
@@ -4,12 +4,15 @@
 
 #include "impeller/renderer/backend/vulkan/render_pass_vk.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
@@ -279,26 +282,30 @@ static bool UpdateBindingLayouts(const std::vector<Command>& commands,
   return true;
 }
 
+template <class VulkanHandle>
+static uint64_t GetHandleKey(VulkanHandle handle) {
+  return reinterpret_cast<uint64_t>(
+      static_cast<typename VulkanHandle::CType>(handle));
+}
+
 static bool AllocateAndBindDescriptorSets(const ContextVK& context,
                                           const Command& command,
                                           CommandEncoderVK& encoder,
                                           const PipelineVK& pipeline) {
-  auto desc_set =
-      encoder.AllocateDescriptorSet(pipeline.GetDescriptorSetLayout());
-  if (!desc_set) {
-    return false;
-  }
-
   auto& allocator = *context.GetResourceAllocator();
 
   std::unordered_map<uint32_t, vk::DescriptorBufferInfo> buffers;
   std::unordered_map<uint32_t, vk::DescriptorImageInfo> images;
   std::vector<vk::WriteDescriptorSet> writes;
 
+  // Commands with the same bindings can share a descriptor set.
+  DescriptorSetKeyVK key;
+  key.words.push_back(GetHandleKey(pipeline.GetDescriptorSetLayout()));
+
   auto bind_images = [&encoder,  //
                       &images,   //
                       &writes,   //
-                      &desc_set  //
+                      &key       //
   ](const Bindings& bindings) -> bool {
     for (const auto& [index, sampler_handle] : bindings.samplers) {
       if (bindings.textures.find(index) == bindings.textures.end()) {
@@ -321,8 +328,13 @@ static bool AllocateAndBindDescriptorSets(const ContextVK& context,
       image_info.sampler = sampler.GetSampler();
       image_info.imageView = texture_vk.GetImageView();
 
+      key.words.insert(
+          key.words.end(),
+          {static_cast<uint64_t>(vk::DescriptorType::eCombinedImageSampler),
+           slot.binding, GetHandleKey(image_info.sampler),
+           GetHandleKey(image_info.imageView)});
+
       vk::WriteDescriptorSet write_set;
-      write_set.dstSet = desc_set.value();
       write_set.dstBinding = slot.binding;
       write_set.descriptorCount = 1u;
       write_set.descriptorType = vk::DescriptorType::eCombinedImageSampler;
@@ -338,7 +350,7 @@ static bool AllocateAndBindDescriptorSets(const ContextVK& context,
                        &encoder,    //
                        &buffers,    //
                        &writes,     //
-                       &desc_set    //
+                       &key         //
   ](const Bindings& bindings) -> bool {
     for (const auto& [buffer_index, view] : bindings.buffers) {
       const auto& buffer_view = view.resource.buffer;
@@ -349,7 +361,8 @@ static bool AllocateAndBindDescriptorSets(const ContextVK& context,
         return false;
       }
 
-      auto buffer = DeviceBufferVK::Cast(*device_buffer).GetBuffer();
+      const auto& device_buffer_vk = DeviceBufferVK::Cast(*device_buffer);
+      auto buffer = device_buffer_vk.GetBuffer();
       if (!buffer) {
         return false;
       }
@@ -363,7 +376,8 @@ static bool AllocateAndBindDescriptorSets(const ContextVK& context,
         return false;
       }
 
-      uint32_t offset = view.resource.range.offset;
+      const auto offset =
+          device_buffer_vk.GetBufferOffset() + view.resource.range.offset;
 
       vk::DescriptorBufferInfo buffer_info;
       buffer_info.buffer = buffer;
@@ -372,8 +386,13 @@ static bool AllocateAndBindDescriptorSets(const ContextVK& context,
 
       const ShaderUniformSlot& uniform = bindings.uniforms.at(buffer_index);
 
+      key.words.insert(
+          key.words.end(),
+          {static_cast<uint64_t>(vk::DescriptorType::eUniformBuffer),
+           uniform.binding, GetHandleKey(buffer_info.buffer),
+           buffer_info.offset, buffer_info.range});
+
       vk::WriteDescriptorSet write_set;
-      write_set.dstSet = desc_set.value();
       write_set.dstBinding = uniform.binding;
       write_set.descriptorCount = 1u;
       write_set.descriptorType = vk::DescriptorType::eUniformBuffer;
@@ -390,7 +409,18 @@ static bool AllocateAndBindDescriptorSets(const ContextVK& context,
     return false;
   }
 
-  context.GetDevice().updateDescriptorSets(writes, {});
+  auto desc_set = encoder.FindDescriptorSet(key);
+  if (!desc_set.has_value()) {
+    desc_set = encoder.AllocateDescriptorSet(pipeline.GetDescriptorSetLayout());
+    if (!desc_set.has_value()) {
+      return false;
+    }
+    for (auto& write : writes) {
+      write.dstSet = desc_set.value();
+    }
+    context.GetDevice().updateDescriptorSets(writes, {});
+    encoder.CacheDescriptorSet(std::move(key), desc_set.value());
+  }
 
   encoder.GetCommandBuffer().bindDescriptorSets(
       vk::PipelineBindPoint::eGraphics,  // bind point
@@ -412,8 +442,8 @@ static void SetViewportAndScissor(const Command& command,
                               .setWidth(vp.rect.size.width)
                               .setHeight(-vp.rect.size.height)
                               .setY(vp.rect.size.height)
-                              .setMinDepth(0.0f)
-                              .setMaxDepth(1.0f);
+                              .setMinDepth(vp.depth_range.z_near)
+                              .setMaxDepth(vp.depth_range.z_far);
   cmd_buffer.setViewport(0, 1, &viewport);
 
   // Set the scissor rect.
@@ -488,16 +518,18 @@ static bool EncodeCommand(const Context& context,
   }
 
   // Bind the vertex buffer.
-  auto vertex_buffer_handle = DeviceBufferVK::Cast(*vertex_buffer).GetBuffer();
-  vk::Buffer vertex_buffers[] = {vertex_buffer_handle};
-  vk::DeviceSize vertex_buffer_offsets[] = {vertex_buffer_view.range.offset};
+  const auto& vertex_buffer_vk = DeviceBufferVK::Cast(*vertex_buffer);
+  vk::Buffer vertex_buffers[] = {vertex_buffer_vk.GetBuffer()};
+  vk::DeviceSize vertex_buffer_offsets[] = {
+      vertex_buffer_vk.GetBufferOffset() + vertex_buffer_view.range.offset};
   cmd_buffer.bindVertexBuffers(0u, 1u, vertex_buffers, vertex_buffer_offsets);
 
   // Bind the index buffer.
-  auto index_buffer_handle = DeviceBufferVK::Cast(*index_buffer).GetBuffer();
-  cmd_buffer.bindIndexBuffer(index_buffer_handle,
-                             index_buffer_view.range.offset,
-                             ToVKIndexType(command.index_type));
+  const auto& index_buffer_vk = DeviceBufferVK::Cast(*index_buffer);
+  cmd_buffer.bindIndexBuffer(
+      index_buffer_vk.GetBuffer(),
+      index_buffer_vk.GetBufferOffset() + index_buffer_view.range.offset,
+      ToVKIndexType(command.index_type));
 
   // Engage!
   cmd_buffer.drawIndexed(command.index_count,     // index count
@@ -509,6 +541,133 @@ static bool EncodeCommand(const Context& context,
   return true;
 }
 
+static std::unique_ptr<CommandEncoderVK> EncodeSecondaryCommandBuffer(
+    const ContextVK& context,
+    const std::vector<Command>& commands,
+    size_t begin,
+    size_t end,
+    vk::RenderPass render_pass,
+    vk::Framebuffer framebuffer,
+    const ISize& target_size) {
+  TRACE_EVENT0("impeller", "EncodeSecondaryCommandBuffer");
+  auto encoder =
+      context.CreateSecondaryGraphicsCommandEncoder(render_pass, framebuffer);
+  if (!encoder) {
+    return nullptr;
+  }
+  for (auto i = begin; i < end; i++) {
+    const auto& command = commands[i];
+    if (!command.pipeline) {
+      continue;
+    }
+    if (!EncodeCommand(context, command, *encoder, target_size)) {
+      return nullptr;
+    }
+  }
+  if (encoder->GetCommandBuffer().end() != vk::Result::eSuccess) {
+    return nullptr;
+  }
+  return encoder;
+}
+
+static size_t GetSecondaryCommandBufferCount(const ContextVK& context,
+                                             size_t command_count) {
+  if (!context.IsParallelEncodingEnabled() ||
+      !context.GetConcurrentWorkerTaskRunner()) {
+    return 0u;
+  }
+  const auto count =
+      command_count / RenderPassVK::kMinCommandsPerSecondaryCommandBuffer;
+  if (count < 2u) {
+    return 0u;
+  }
+  return std::min(count, RenderPassVK::kMaxSecondaryCommandBufferCount);
+}
+
+// Host buffers create their device buffers lazily, which is not thread safe.
+// Create them up front so that workers only ever read them.
+static bool PrepareDeviceBuffers(const std::vector<Command>& commands,
+                                 Allocator& allocator) {
+  auto prepare = [&allocator](const BufferView& view) -> bool {
+    return !view.buffer || view.buffer->GetDeviceBuffer(allocator);
+  };
+  auto prepare_bindings = [&prepare](const Bindings& bindings) -> bool {
+    for (const auto& [_, view] : bindings.buffers) {
+      if (!prepare(view.resource)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (const auto& command : commands) {
+    if (!prepare(command.GetVertexBuffer()) ||
+        !prepare(command.index_buffer) ||
+        !prepare_bindings(command.vertex_bindings) ||
+        !prepare_bindings(command.fragment_bindings)) {
+      VALIDATION_LOG << "Failed to get device buffers for command: "
+                     << command.label;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RenderPassVK::EncodeCommandsInParallel(const ContextVK& context,
+                                            CommandEncoderVK& encoder,
+                                            vk::RenderPass render_pass,
+                                            vk::Framebuffer framebuffer,
+                                            size_t secondary_count) const {
+  TRACE_EVENT0("impeller", "EncodeCommandsInParallel");
+
+  struct Recording {
+    explicit Recording(size_t count) : secondaries(count), latch(count) {}
+
+    std::atomic_size_t next_index = 0u;
+    std::vector<std::unique_ptr<CommandEncoderVK>> secondaries;
+    fml::CountDownLatch latch;
+  };
+  auto recording = std::make_shared<Recording>(secondary_count);
+
+  // Each secondary command buffer records a contiguous range of commands, so
+  // executing them in order draws in the order of the pass. The ranges only
+  // depend on the number of commands.
+  //
+  // Every thread, including this one, records ranges until none are left.
+  // Workers that get to run after that return right away, which keeps this
+  // from waiting on workers that are busy with other tasks.
+  const auto& commands = commands_;
+  const auto target_size = render_target_.GetRenderTargetSize();
+  auto record = [recording, &context, &commands, render_pass, framebuffer,
+                 target_size, secondary_count]() {
+    for (size_t index = recording->next_index++; index < secondary_count;
+         index = recording->next_index++) {
+      const auto begin = commands.size() * index / secondary_count;
+      const auto end = commands.size() * (index + 1u) / secondary_count;
+      recording->secondaries[index] =
+          EncodeSecondaryCommandBuffer(context, commands, begin, end,
+                                       render_pass, framebuffer, target_size);
+      recording->latch.CountDown();
+    }
+  };
+  auto worker_task_runner = context.GetConcurrentWorkerTaskRunner();
+  for (size_t i = 1u; i < secondary_count; i++) {
+    worker_task_runner->PostTask(record);
+  }
+  record();
+  recording->latch.Wait();
+
+  for (auto& secondary : recording->secondaries) {
+    if (!secondary) {
+      VALIDATION_LOG << "Could not encode secondary command buffer.";
+      return false;
+    }
+    if (!encoder.ExecuteSecondary(std::move(secondary))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool RenderPassVK::OnEncodeCommands(const Context& context) const {
   TRACE_EVENT0("impeller", "RenderPassVK::OnEncodeCommands");
   if (!IsValid()) {
@@ -572,13 +731,32 @@ bool RenderPassVK::OnEncodeCommands(const Context& context) const {
       static_cast<uint32_t>(target_size.height);
   pass_info.setClearValues(clear_values);
 
+  const auto secondary_count =
+      GetSecondaryCommandBufferCount(vk_context, commands_.size());
+  if (secondary_count > 0u &&
+      !PrepareDeviceBuffers(commands_, *vk_context.GetResourceAllocator())) {
+    return false;
+  }
+
+  encoder->BeginPassTimer(debug_label_.empty() ? "RenderPass" : debug_label_);
+  fml::ScopedCleanupClosure end_pass_timer(
+      [&encoder]() { encoder->EndPassTimer(); });
+
   {
     TRACE_EVENT0("impeller", "EncodeRenderPassCommands");
-    cmd_buffer.beginRenderPass(pass_info, vk::SubpassContents::eInline);
+    cmd_buffer.beginRenderPass(
+        pass_info, secondary_count > 0u
+                       ? vk::SubpassContents::eSecondaryCommandBuffers
+                       : vk::SubpassContents::eInline);
 
     fml::ScopedCleanupClosure end_render_pass(
         [cmd_buffer]() { cmd_buffer.endRenderPass(); });
 
+    if (secondary_count > 0u) {
+      return EncodeCommandsInParallel(vk_context, *encoder, *render_pass,
+                                      *framebuffer, secondary_count);
+    }
+
     for (const auto& command : commands_) {
       if (!command.pipeline) {
         continue;
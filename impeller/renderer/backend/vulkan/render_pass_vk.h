@@ -17,6 +17,17 @@ namespace impeller {
 
 class RenderPassVK final : public RenderPass {
  public:
+  //----------------------------------------------------------------------------
+  /// Passes with at least twice this many commands are split into secondary
+  /// command buffers that are recorded concurrently.
+  ///
+  static constexpr size_t kMinCommandsPerSecondaryCommandBuffer = 1024u;
+
+  //----------------------------------------------------------------------------
+  /// The largest number of secondary command buffers a pass is split into.
+  ///
+  static constexpr size_t kMaxSecondaryCommandBufferCount = 8u;
+
   // |RenderPass|
   ~RenderPassVK() override;
 
@@ -47,6 +58,12 @@ class RenderPassVK final : public RenderPass {
       const ContextVK& context,
       const vk::RenderPass& pass) const;
 
+  bool EncodeCommandsInParallel(const ContextVK& context,
+                                CommandEncoderVK& encoder,
+                                vk::RenderPass render_pass,
+                                vk::Framebuffer framebuffer,
+                                size_t secondary_count) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(RenderPassVK);
 };
 
@@ -0,0 +1,287 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/testing/testing.h"
+#include "impeller/fixtures/colors.frag.h"
+#include "impeller/fixtures/colors.vert.h"
+#include "impeller/playground/playground_test.h"
+#include "impeller/renderer/backend/vulkan/command_pool_vk.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/render_pass_vk.h"
+#include "impeller/renderer/command.h"
+#include "impeller/renderer/command_buffer.h"
+#include "impeller/renderer/gpu_tracer.h"
+#include "impeller/renderer/pipeline_builder.h"
+#include "impeller/renderer/pipeline_library.h"
+#include "impeller/renderer/render_target.h"
+
+namespace impeller {
+namespace testing {
+
+using RenderPassVKTest = PlaygroundTest;
+INSTANTIATE_PLAYGROUND_SUITE(RenderPassVKTest);
+
+// Adds draws of overlapping quads to the pass, so that the result depends on
+// the order in which they are drawn.
+static bool AddQuads(const std::shared_ptr<Context>& context,
+                     RenderPass& pass,
+                     size_t quad_count) {
+  using VS = ColorsVertexShader;
+  using FS = ColorsFragmentShader;
+
+  auto desc = PipelineBuilder<VS, FS>::MakeDefaultPipelineDescriptor(*context);
+  if (!desc.has_value()) {
+    return false;
+  }
+  auto pipeline =
+      context->GetPipelineLibrary()->GetPipeline(std::move(desc)).Get();
+  if (!pipeline) {
+    return false;
+  }
+
+  struct Quads {
+    VS::PerVertexData vertices[16] = {
+        {{0, 0, 0}, Color::Red()},    {{1, 0, 0}, Color::Red()},
+        {{0, 1, 0}, Color::Red()},    {{1, 1, 0}, Color::Red()},
+        {{0, 0, 0}, Color::Green()},  {{1, 0, 0}, Color::Green()},
+        {{0, 1, 0}, Color::Green()},  {{1, 1, 0}, Color::Green()},
+        {{0, 0, 0}, Color::Blue()},   {{1, 0, 0}, Color::Blue()},
+        {{0, 1, 0}, Color::Blue()},   {{1, 1, 0}, Color::Blue()},
+        {{0, 0, 0}, Color::Yellow()}, {{1, 0, 0}, Color::Yellow()},
+        {{0, 1, 0}, Color::Yellow()}, {{1, 1, 0}, Color::Yellow()},
+    };
+    uint16_t indices[6] = {0, 1, 2, 2, 1, 3};
+  } quads;
+
+  VertexBuffer vertex_buffer;
+  {
+    auto device_buffer = context->GetResourceAllocator()->CreateBufferWithCopy(
+        reinterpret_cast<uint8_t*>(&quads), sizeof(quads));
+    vertex_buffer.vertex_buffer = {
+        .buffer = device_buffer,
+        .range = Range(offsetof(Quads, vertices), sizeof(Quads::vertices))};
+    vertex_buffer.index_buffer = {
+        .buffer = device_buffer,
+        .range = Range(offsetof(Quads, indices), sizeof(Quads::indices))};
+    vertex_buffer.index_count = 6;
+    vertex_buffer.index_type = IndexType::k16bit;
+  }
+
+  const auto size = pass.GetRenderTargetSize();
+  for (size_t i = 0; i < quad_count; i++) {
+    Command cmd;
+    cmd.pipeline = pipeline;
+    cmd.BindVertices(vertex_buffer);
+    cmd.base_vertex = (i % 4u) * 4u;
+
+    const Vector3 offset(static_cast<Scalar>(i % 97u) * 2.5f,
+                         static_cast<Scalar>(i % 89u) * 2.5f, 0.0f);
+    VS::UniformBuffer uniforms;
+    uniforms.mvp = Matrix::MakeOrthographic(size) *
+                   Matrix::MakeTranslation(offset) *
+                   Matrix::MakeScale(Vector3(16.0f, 16.0f, 1.0f));
+    VS::BindUniformBuffer(cmd,
+                          pass.GetTransientsBuffer().EmplaceUniform(uniforms));
+    if (!pass.AddCommand(std::move(cmd))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static constexpr ISize kQuadsSize(256, 256);
+
+// Draws overlapping quads and reads back the result.
+static std::vector<uint8_t> RenderQuads(const std::shared_ptr<Context>& context,
+                                        size_t quad_count,
+                                        fml::TimeDelta& encode_time) {
+  auto render_target =
+      RenderTarget::CreateOffscreen(*context, kQuadsSize, "Quads");
+  auto command_buffer = context->CreateCommandBuffer();
+  auto pass = command_buffer->CreateRenderPass(render_target);
+  if (!pass || !AddQuads(context, *pass, quad_count)) {
+    return {};
+  }
+
+  const auto encode_start = fml::TimePoint::Now();
+  if (!pass->EncodeCommands()) {
+    return {};
+  }
+  encode_time = fml::TimePoint::Now() - encode_start;
+  if (!command_buffer->SubmitCommands()) {
+    return {};
+  }
+
+  auto texture = render_target.GetRenderTargetTexture();
+  DeviceBufferDescriptor buffer_desc;
+  buffer_desc.storage_mode = StorageMode::kHostVisible;
+  buffer_desc.size =
+      texture->GetTextureDescriptor().GetByteSizeOfBaseMipLevel();
+  auto buffer = context->GetResourceAllocator()->CreateBuffer(buffer_desc);
+  auto blit_command_buffer = context->CreateCommandBuffer();
+  auto blit_pass = blit_command_buffer->CreateBlitPass();
+  fml::AutoResetWaitableEvent latch;
+  if (!buffer || !blit_pass || !blit_pass->AddCopy(texture, buffer) ||
+      !blit_pass->EncodeCommands(context->GetResourceAllocator()) ||
+      !blit_command_buffer->SubmitCommands(
+          [&latch](CommandBuffer::Status) { latch.Signal(); })) {
+    return {};
+  }
+  latch.Wait();
+  auto contents = buffer->OnGetContents();
+  return std::vector<uint8_t>(contents, contents + buffer_desc.size);
+}
+
+TEST_P(RenderPassVKTest, ParallelEncodingMatchesSerialEncoding) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Secondary command buffers are only used by Vulkan.");
+  }
+  auto& context_vk = ContextVK::Cast(*GetContext());
+  if (!context_vk.GetConcurrentWorkerTaskRunner()) {
+    GTEST_SKIP_("The context has no worker task runner.");
+  }
+  static constexpr size_t kQuadCount = 10000u;
+  static_assert(kQuadCount >=
+                2u * RenderPassVK::kMinCommandsPerSecondaryCommandBuffer);
+
+  fml::TimeDelta serial_encode_time;
+  context_vk.SetParallelEncodingEnabled(false);
+  auto expected = RenderQuads(GetContext(), kQuadCount, serial_encode_time);
+  ASSERT_FALSE(expected.empty());
+
+  fml::TimeDelta parallel_encode_time;
+  context_vk.SetParallelEncodingEnabled(true);
+  auto actual = RenderQuads(GetContext(), kQuadCount, parallel_encode_time);
+  ASSERT_EQ(actual.size(), expected.size());
+  EXPECT_TRUE(actual == expected);
+
+  RecordProperty("SerialEncodeMicroseconds",
+                 serial_encode_time.ToMicroseconds());
+  RecordProperty("ParallelEncodeMicroseconds",
+                 parallel_encode_time.ToMicroseconds());
+}
+
+// Encodes draws of quads without submitting them, which only takes time on
+// the CPU. Everything the encoder allocated is released on return.
+static std::optional<fml::TimeDelta> EncodeQuads(
+    const std::shared_ptr<Context>& context,
+    size_t quad_count) {
+  auto render_target =
+      RenderTarget::CreateOffscreen(*context, kQuadsSize, "Quads");
+  auto command_buffer = context->CreateCommandBuffer();
+  auto pass = command_buffer->CreateRenderPass(render_target);
+  if (!pass || !AddQuads(context, *pass, quad_count)) {
+    return std::nullopt;
+  }
+  const auto encode_start = fml::TimePoint::Now();
+  if (!pass->EncodeCommands()) {
+    return std::nullopt;
+  }
+  return fml::TimePoint::Now() - encode_start;
+}
+
+TEST_P(RenderPassVKTest, EncodingTenThousandDrawsOnTheCPU) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Secondary command buffers are only used by Vulkan.");
+  }
+  auto& context_vk = ContextVK::Cast(*GetContext());
+  if (!context_vk.GetConcurrentWorkerTaskRunner()) {
+    GTEST_SKIP_("The context has no worker task runner.");
+  }
+  static constexpr size_t kQuadCount = 10000u;
+  static constexpr size_t kFrameCount = 20u;
+
+  auto average_encode_time = [&](bool parallel) {
+    context_vk.SetParallelEncodingEnabled(parallel);
+    fml::TimeDelta total;
+    for (size_t i = 0; i < kFrameCount; i++) {
+      auto encode_time = EncodeQuads(GetContext(), kQuadCount);
+      EXPECT_TRUE(encode_time.has_value());
+      total = total + encode_time.value_or(fml::TimeDelta::Zero());
+    }
+    return total.ToMicroseconds() / static_cast<int64_t>(kFrameCount);
+  };
+  RecordProperty("SerialEncodeMicroseconds", average_encode_time(false));
+  RecordProperty("ParallelEncodeMicroseconds", average_encode_time(true));
+  context_vk.SetParallelEncodingEnabled(true);
+}
+
+TEST_P(RenderPassVKTest, SecondaryCommandPoolsAreReused) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Secondary command buffers are only used by Vulkan.");
+  }
+  auto& context_vk = ContextVK::Cast(*GetContext());
+  if (!context_vk.GetConcurrentWorkerTaskRunner()) {
+    GTEST_SKIP_("The context has no worker task runner.");
+  }
+  static constexpr size_t kQuadCount = 10000u;
+  const auto& recycler = context_vk.GetCommandPoolRecycler();
+  ASSERT_TRUE(recycler);
+
+  // The secondary command buffers are never submitted, so their pools are
+  // reclaimed as soon as the encoder is gone, whichever threads recorded
+  // them.
+  context_vk.SetParallelEncodingEnabled(true);
+  ASSERT_TRUE(EncodeQuads(GetContext(), kQuadCount).has_value());
+  const auto pool_count = recycler->GetRecycledPoolCount();
+  EXPECT_GT(pool_count, 1u);
+  const auto created_count = recycler->GetStatistics().pool_creation_count;
+
+  for (size_t i = 0; i < 10u; i++) {
+    ASSERT_TRUE(EncodeQuads(GetContext(), kQuadCount).has_value());
+  }
+  EXPECT_EQ(recycler->GetRecycledPoolCount(), pool_count);
+  EXPECT_EQ(recycler->GetStatistics().pool_creation_count, created_count);
+  EXPECT_LE(recycler->GetRecycledPoolCount(),
+            CommandPoolRecyclerVK::kMaxRecycledPoolCount);
+}
+
+TEST_P(RenderPassVKTest, PassesAreTimedWhenEnabled) {
+  if (GetBackend() != PlaygroundBackend::kVulkan) {
+    GTEST_SKIP_("Timestamp queries are specific to Vulkan.");
+  }
+  auto context = GetContext();
+  auto tracer = context->GetGPUTracer();
+  ASSERT_TRUE(tracer);
+  if (!tracer->SupportsPassTiming()) {
+    GTEST_SKIP_("The device doesn't support timestamp queries.");
+  }
+
+  fml::AutoResetWaitableEvent latch;
+  std::optional<GPUFrameTime> frame_time;
+  tracer->SetFrameTimeCallback([&](const GPUFrameTime& time) {
+    frame_time = time;
+    latch.Signal();
+  });
+  tracer->SetPassTimingEnabled(true);
+
+  auto render_target =
+      RenderTarget::CreateOffscreen(*context, ISize(64, 64), "Timed");
+  auto command_buffer = context->CreateCommandBuffer();
+  auto pass = command_buffer->CreateRenderPass(render_target);
+  ASSERT_TRUE(pass);
+  pass->SetLabel("Timed Render Pass");
+  ASSERT_TRUE(pass->EncodeCommands());
+  ASSERT_TRUE(command_buffer->SubmitCommands());
+  tracer->MarkFrameEnd();
+  latch.Wait();
+
+  tracer->SetPassTimingEnabled(false);
+  tracer->SetFrameTimeCallback(nullptr);
+
+  ASSERT_TRUE(frame_time.has_value());
+  ASSERT_EQ(frame_time->passes.size(), 1u);
+  EXPECT_EQ(frame_time->passes[0].label, "Timed Render Pass");
+  EXPECT_EQ(frame_time->passes[0].pass_count, 1u);
+  EXPECT_EQ(frame_time->total_time, frame_time->passes[0].time);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -9,9 +9,11 @@ namespace impeller {
 ShaderFunctionVK::ShaderFunctionVK(UniqueID parent_library_id,
                                    std::string name,
                                    ShaderStage stage,
-                                   vk::UniqueShaderModule module)
+                                   vk::UniqueShaderModule module,
+                                   uint64_t code_hash)
     : ShaderFunction(parent_library_id, std::move(name), stage),
-      module_(std::move(module)) {}
+      module_(std::move(module)),
+      code_hash_(code_hash) {}
 
 ShaderFunctionVK::~ShaderFunctionVK() = default;
 
@@ -19,4 +21,9 @@ const vk::ShaderModule& ShaderFunctionVK::GetModule() const {
   return module_.get();
 }
 
+// |ShaderFunction|
+uint64_t ShaderFunctionVK::GetCodeHash() const {
+  return code_hash_;
+}
+
 }  // namespace impeller
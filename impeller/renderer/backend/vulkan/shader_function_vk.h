@@ -21,15 +21,20 @@ class ShaderFunctionVK final
 
   const vk::ShaderModule& GetModule() const;
 
+  // |ShaderFunction|
+  uint64_t GetCodeHash() const override;
+
  private:
   friend class ShaderLibraryVK;
 
   vk::UniqueShaderModule module_;
+  uint64_t code_hash_ = 0u;
 
   ShaderFunctionVK(UniqueID parent_library_id,
                    std::string name,
                    ShaderStage stage,
-                   vk::UniqueShaderModule module);
+                   vk::UniqueShaderModule module,
+                   uint64_t code_hash);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ShaderFunctionVK);
 };
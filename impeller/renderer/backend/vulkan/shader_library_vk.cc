@@ -8,6 +8,7 @@
 #include "flutter/fml/trace_event.h"
 #include "impeller/blobcat/blob_library.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
 #include "impeller/renderer/backend/vulkan/shader_function_vk.h"
 
 namespace impeller {
@@ -160,10 +161,11 @@ bool ShaderLibraryVK::RegisterFunction(
 
   WriterLock lock(functions_mutex_);
   functions_[ShaderKey{key_name, stage}] = std::shared_ptr<ShaderFunctionVK>(
-      new ShaderFunctionVK(library_id_,              //
-                           key_name,                 //
-                           stage,                    //
-                           std::move(shader_module)  //
+      new ShaderFunctionVK(library_id_,                  //
+                           key_name,                     //
+                           stage,                        //
+                           std::move(shader_module),     //
+                           ComputeShaderCodeHash(*code)  //
                            ));
 
   return true;
@@ -84,7 +84,7 @@ bool TextureVK::OnSetContents(const uint8_t* contents,
   }
 
   vk::BufferImageCopy copy;
-  copy.bufferOffset = 0u;
+  copy.bufferOffset = DeviceBufferVK::Cast(*staging_buffer).GetBufferOffset();
   copy.bufferRowLength = 0u;    // 0u means tightly packed per spec.
   copy.bufferImageHeight = 0u;  // 0u means tightly packed per spec.
   copy.imageOffset.x = 0u;
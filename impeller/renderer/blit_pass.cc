@@ -118,17 +118,27 @@ bool BlitPass::AddCopy(std::shared_ptr<Texture> source,
 
 bool BlitPass::AddCopy(BufferView source,
                        std::shared_ptr<Texture> destination,
-                       IPoint destination_origin,
+                       std::optional<IRect> destination_region,
                        std::string label) {
   if (!destination) {
     VALIDATION_LOG << "Attempted to add a texture blit with no destination.";
     return false;
   }
 
+  if (!destination_region.has_value()) {
+    destination_region = IRect::MakeSize(destination->GetSize());
+  }
+
+  if (!IRect::MakeSize(destination->GetSize())
+           .Contains(destination_region.value())) {
+    VALIDATION_LOG
+        << "Attempted to add a texture blit outside of the destination.";
+    return false;
+  }
+
   auto bytes_per_pixel =
       BytesPerPixelForPixelFormat(destination->GetTextureDescriptor().format);
-  auto bytes_per_image =
-      destination->GetTextureDescriptor().size.Area() * bytes_per_pixel;
+  auto bytes_per_image = destination_region->size.Area() * bytes_per_pixel;
 
   if (source.range.length != bytes_per_image) {
     VALIDATION_LOG
@@ -136,8 +146,13 @@ bool BlitPass::AddCopy(BufferView source,
     return false;
   }
 
+  if (destination_region->IsEmpty()) {
+    return true;  // Nothing to blit.
+  }
+
   return OnCopyBufferToTextureCommand(std::move(source), std::move(destination),
-                                      destination_origin, std::move(label));
+                                      destination_region.value(),
+                                      std::move(label));
 }
 
 bool BlitPass::GenerateMipmap(std::shared_ptr<Texture> texture,
@@ -66,6 +66,11 @@ class StandardCapabilities final : public Capabilities {
     return default_stencil_format_;
   }
 
+  // |Capabilities|
+  PixelFormat GetDefaultDepthStencilFormat() const override {
+    return default_depth_stencil_format_;
+  }
+
  private:
   StandardCapabilities(bool has_threading_restrictions,
                        bool supports_offscreen_msaa,
@@ -77,7 +82,8 @@ class StandardCapabilities final : public Capabilities {
                        bool supports_read_from_resolve,
                        bool supports_decal_tile_mode,
                        PixelFormat default_color_format,
-                       PixelFormat default_stencil_format)
+                       PixelFormat default_stencil_format,
+                       PixelFormat default_depth_stencil_format)
       : has_threading_restrictions_(has_threading_restrictions),
         supports_offscreen_msaa_(supports_offscreen_msaa),
         supports_ssbo_(supports_ssbo),
@@ -88,7 +94,8 @@ class StandardCapabilities final : public Capabilities {
         supports_read_from_resolve_(supports_read_from_resolve),
         supports_decal_tile_mode_(supports_decal_tile_mode),
         default_color_format_(default_color_format),
-        default_stencil_format_(default_stencil_format) {}
+        default_stencil_format_(default_stencil_format),
+        default_depth_stencil_format_(default_depth_stencil_format) {}
 
   friend class CapabilitiesBuilder;
 
@@ -103,6 +110,7 @@ class StandardCapabilities final : public Capabilities {
   bool supports_decal_tile_mode_ = false;
   PixelFormat default_color_format_ = PixelFormat::kUnknown;
   PixelFormat default_stencil_format_ = PixelFormat::kUnknown;
+  PixelFormat default_depth_stencil_format_ = PixelFormat::kUnknown;
 
   FML_DISALLOW_COPY_AND_ASSIGN(StandardCapabilities);
 };
@@ -164,6 +172,12 @@ CapabilitiesBuilder& CapabilitiesBuilder::SetDefaultStencilFormat(
   return *this;
 }
 
+CapabilitiesBuilder& CapabilitiesBuilder::SetDefaultDepthStencilFormat(
+    PixelFormat value) {
+  default_depth_stencil_format_ = value;
+  return *this;
+}
+
 CapabilitiesBuilder& CapabilitiesBuilder::SetSupportsDecalTileMode(bool value) {
   supports_decal_tile_mode_ = value;
   return *this;
@@ -181,7 +195,8 @@ std::unique_ptr<Capabilities> CapabilitiesBuilder::Build() {
       supports_read_from_resolve_,                                        //
       supports_decal_tile_mode_,                                          //
       *default_color_format_,                                             //
-      *default_stencil_format_                                            //
+      *default_stencil_format_,                                           //
+      default_depth_stencil_format_                                       //
       ));
 }
 
@@ -37,6 +37,13 @@ class Capabilities {
 
   virtual PixelFormat GetDefaultStencilFormat() const = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The combined depth-stencil format to use for attachments that
+  ///             need a depth buffer, or `PixelFormat::kUnknown` if the
+  ///             device has no renderable combined format.
+  ///
+  virtual PixelFormat GetDefaultDepthStencilFormat() const = 0;
+
  protected:
   Capabilities();
 
@@ -67,6 +74,8 @@ class CapabilitiesBuilder {
 
   CapabilitiesBuilder& SetDefaultStencilFormat(PixelFormat value);
 
+  CapabilitiesBuilder& SetDefaultDepthStencilFormat(PixelFormat value);
+
   CapabilitiesBuilder& SetSupportsDecalTileMode(bool value);
 
   std::unique_ptr<Capabilities> Build();
@@ -83,6 +92,7 @@ class CapabilitiesBuilder {
   bool supports_decal_tile_mode_ = false;
   std::optional<PixelFormat> default_color_format_ = std::nullopt;
   std::optional<PixelFormat> default_stencil_format_ = std::nullopt;
+  PixelFormat default_depth_stencil_format_ = PixelFormat::kUnknown;
 
   FML_DISALLOW_COPY_AND_ASSIGN(CapabilitiesBuilder);
 };
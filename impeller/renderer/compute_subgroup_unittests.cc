@@ -258,7 +258,11 @@ TEST_P(ComputeSubgroupTest, HeartCubicsToStrokeVertices) {
     cmd.label = "Compute Stroke";
     cmd.pipeline = compute_pipeline;
 
-    SS::Config config{.width = 1.0f, .cap = 1, .join = 1, .miter_limit = 4.0f};
+    SS::Config config{.width = 1.0f,
+                      .cap = 1,
+                      .join = 1,
+                      .miter_limit = 4.0f,
+                      .point_capacity = kCubicCount * 10 * 10};
     SS::BindConfig(cmd, pass->GetTransientsBuffer().EmplaceUniform(config));
 
     SS::BindPolyline(cmd, polyline->AsBufferView());
@@ -444,5 +448,121 @@ TEST_P(ComputeSubgroupTest, QuadsToPolyline) {
   latch.Wait();
 }
 
+TEST_P(ComputeSubgroupTest, LongPolylineStrokeMatchesCPUReference) {
+  using SS = StrokeComputeShader;
+
+  auto context = GetContext();
+  ASSERT_TRUE(context);
+  ASSERT_TRUE(context->GetCapabilities()->SupportsComputeSubgroups());
+
+  static constexpr size_t kLineCount = 512;
+  static constexpr size_t kVertexCount = kLineCount * 4 + 2;
+  static constexpr Scalar kStrokeWidth = 4.0f;
+
+  std::vector<Point> points;
+  PathBuilder builder;
+  for (size_t i = 0; i <= kLineCount; i++) {
+    points.emplace_back(i * 2.0f, (i % 2) * 10.0f);
+  }
+  builder.MoveTo(points.front());
+  for (size_t i = 1; i < points.size(); i++) {
+    builder.LineTo(points[i]);
+  }
+  auto path = builder.TakePath();
+  ASSERT_EQ(ComputeTessellator::ComputeStrokeVertexCount(path), kVertexCount);
+
+  auto vertex_buffer =
+      CreateHostVisibleDeviceBuffer<SS::VertexBuffer<kVertexCount>>(
+          context, "VertexBuffer");
+  auto vertex_buffer_count =
+      CreateHostVisibleDeviceBuffer<SS::VertexBufferCount>(context,
+                                                           "VertexBufferCount");
+
+  fml::AutoResetWaitableEvent latch;
+  const auto start = fml::TimePoint::Now();
+  auto status = ComputeTessellator{}
+                    .SetStrokeWidth(kStrokeWidth)
+                    .SetStrokeJoin(Join::kBevel)
+                    .Tessellate(path, context, vertex_buffer->AsBufferView(),
+                                vertex_buffer_count->AsBufferView(),
+                                [&latch](CommandBuffer::Status status) {
+                                  EXPECT_EQ(status,
+                                            CommandBuffer::Status::kCompleted);
+                                  latch.Signal();
+                                });
+  ASSERT_EQ(status, ComputeTessellator::Status::kOk);
+  latch.Wait();
+  RecordProperty("TessellationMicroseconds",
+                 (fml::TimePoint::Now() - start).ToMicroseconds());
+
+  // Each line is a quad offset by half the stroke width on either side.
+  std::vector<Point> expected;
+  Point offset;
+  for (size_t i = 0; i < kLineCount; i++) {
+    auto direction = (points[i + 1] - points[i]).Normalize();
+    offset = Point(-direction.y, direction.x) * kStrokeWidth * 0.5f;
+    expected.push_back(points[i] + offset);
+    expected.push_back(points[i] - offset);
+    expected.push_back(points[i + 1] + offset);
+    expected.push_back(points[i + 1] - offset);
+  }
+  expected.push_back(points.back() + offset);
+  expected.push_back(points.back() - offset);
+
+  auto vertex_count = reinterpret_cast<SS::VertexBufferCount*>(
+                          vertex_buffer_count->AsBufferView().contents)
+                          ->count;
+  ASSERT_EQ(vertex_count, expected.size());
+  auto* v = reinterpret_cast<SS::VertexBuffer<kVertexCount>*>(
+      vertex_buffer->AsBufferView().contents);
+  for (size_t i = 0; i < vertex_count; i++) {
+    EXPECT_LT(std::abs(expected[i].x - v->position[i].x), 1e-3);
+    EXPECT_LT(std::abs(expected[i].y - v->position[i].y), 1e-3);
+  }
+}
+
+TEST_P(ComputeSubgroupTest, StrokeVertexBufferIsPaddedWithLastPoint) {
+  using SS = StrokeComputeShader;
+
+  auto context = GetContext();
+  ASSERT_TRUE(context);
+  ASSERT_TRUE(context->GetCapabilities()->SupportsComputeSubgroups());
+
+  // A quadratic is estimated to be flattened to more lines than this one is.
+  auto path =
+      PathBuilder{}.AddQuadraticCurve({0, 0}, {5, 5}, {10, 0}).TakePath();
+  static constexpr size_t kVertexCount = 10 * 4 + 2;
+  ASSERT_EQ(ComputeTessellator::ComputeStrokeVertexCount(path), kVertexCount);
+
+  auto vertex_buffer =
+      CreateHostVisibleDeviceBuffer<SS::VertexBuffer<kVertexCount>>(
+          context, "VertexBuffer");
+  auto vertex_buffer_count =
+      CreateHostVisibleDeviceBuffer<SS::VertexBufferCount>(context,
+                                                           "VertexBufferCount");
+
+  fml::AutoResetWaitableEvent latch;
+  auto status = ComputeTessellator{}.Tessellate(
+      path, context, vertex_buffer->AsBufferView(),
+      vertex_buffer_count->AsBufferView(),
+      [&latch](CommandBuffer::Status status) {
+        EXPECT_EQ(status, CommandBuffer::Status::kCompleted);
+        latch.Signal();
+      });
+  ASSERT_EQ(status, ComputeTessellator::Status::kOk);
+  latch.Wait();
+
+  auto vertex_count = reinterpret_cast<SS::VertexBufferCount*>(
+                          vertex_buffer_count->AsBufferView().contents)
+                          ->count;
+  ASSERT_LT(vertex_count, kVertexCount);
+  auto* v = reinterpret_cast<SS::VertexBuffer<kVertexCount>*>(
+      vertex_buffer->AsBufferView().contents);
+  for (size_t i = vertex_count; i < kVertexCount; i++) {
+    EXPECT_LT(std::abs(v->position[i].x - 10), 1e-3);
+    EXPECT_LT(std::abs(v->position[i].y - 0), 1e-3);
+  }
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -4,6 +4,8 @@
 
 #include "impeller/renderer/compute_tessellator.h"
 
+#include <optional>
+
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/path_polyline.comp.h"
 #include "impeller/renderer/pipeline_library.h"
@@ -57,6 +59,33 @@ ComputeTessellator& ComputeTessellator::SetQuadraticTolerance(Scalar value) {
   return *this;
 }
 
+// The number of lines the path is estimated to be flattened to, or nullopt if
+// it has too many components.
+static std::optional<size_t> ComputeLineCount(const Path& path) {
+  using CT = ComputeTessellator;
+  auto cubic_count = path.GetComponentCount(Path::ComponentType::kCubic);
+  auto quad_count = path.GetComponentCount(Path::ComponentType::kQuadratic) +
+                    (cubic_count * 10);
+  auto line_count =
+      path.GetComponentCount(Path::ComponentType::kLinear) + (quad_count * 10);
+  // The stroke is computed by a thread per polyline point, which is one more
+  // than the lines.
+  if (cubic_count > CT::kMaxCubicCount || quad_count > CT::kMaxQuadCount ||
+      line_count + 1 > CT::kMaxLineCount) {
+    return std::nullopt;
+  }
+  return line_count;
+}
+
+size_t ComputeTessellator::ComputeStrokeVertexCount(const Path& path) {
+  auto line_count = ComputeLineCount(path);
+  if (!line_count.has_value() || line_count.value() == 0) {
+    return 0;
+  }
+  // Four vertices for each line, and two to end the strip.
+  return line_count.value() * 4 + 2;
+}
+
 ComputeTessellator::Status ComputeTessellator::Tessellate(
     const Path& path,
     const std::shared_ptr<Context>& context,
@@ -67,15 +96,11 @@ ComputeTessellator::Status ComputeTessellator::Tessellate(
   using PS = PathPolylineComputeShader;
   using SS = StrokeComputeShader;
 
-  auto cubic_count = path.GetComponentCount(Path::ComponentType::kCubic);
-  auto quad_count = path.GetComponentCount(Path::ComponentType::kQuadratic) +
-                    (cubic_count * 10);
-  auto line_count =
-      path.GetComponentCount(Path::ComponentType::kLinear) + (quad_count * 10);
-  if (cubic_count > kMaxCubicCount || quad_count > kMaxQuadCount ||
-      line_count > kMaxLineCount) {
+  auto estimated_line_count = ComputeLineCount(path);
+  if (!estimated_line_count.has_value()) {
     return Status::kTooManyComponents;
   }
+  auto line_count = estimated_line_count.value();
   PS::Cubics<kMaxCubicCount> cubics{.count = 0};
   PS::Quads<kMaxQuadCount> quads{.count = 0};
   PS::Lines<kMaxLineCount> lines{.count = 0};
@@ -147,8 +172,8 @@ ComputeTessellator::Status ComputeTessellator::Tessellate(
         context->GetPipelineLibrary()->GetPipeline(pipeline_desc).Get();
     FML_DCHECK(compute_pipeline);
 
-    pass->SetGridSize(ISize(line_count, 1));
-    pass->SetThreadGroupSize(ISize(line_count, 1));
+    pass->SetGridSize(ISize(line_count + 1, 1));
+    pass->SetThreadGroupSize(ISize(line_count + 1, 1));
 
     ComputeCommand cmd;
     cmd.label = "Compute Stroke";
@@ -159,6 +184,7 @@ ComputeTessellator::Status ComputeTessellator::Tessellate(
         .cap = static_cast<uint32_t>(stroke_cap_),
         .join = static_cast<uint32_t>(stroke_join_),
         .miter_limit = miter_limit_,
+        .point_capacity = static_cast<uint32_t>(line_count + 1),
     };
     SS::BindConfig(cmd, pass->GetTransientsBuffer().EmplaceUniform(config));
 
@@ -47,6 +47,23 @@ class ComputeTessellator {
   ComputeTessellator& SetCubicAccuracy(Scalar value);
   ComputeTessellator& SetQuadraticTolerance(Scalar value);
 
+  //----------------------------------------------------------------------------
+  /// @brief      The number of vertices written to the vertex buffer when the
+  ///             path is stroked.
+  ///
+  ///             The stroke is a triangle strip. Past its end, the vertex
+  ///             buffer is padded with degenerate triangles, so that all of
+  ///             these vertices may be drawn without waiting for the vertex
+  ///             count to be read back.
+  ///
+  ///             Curves are estimated to be flattened to ten lines each, so
+  ///             the count is only an upper bound for paths of lines.
+  ///
+  /// @return     The vertex count, or 0 if the path is empty or has too many
+  ///             components.
+  ///
+  static size_t ComputeStrokeVertexCount(const Path& path);
+
   //----------------------------------------------------------------------------
   /// @brief      Generates triangles from the path.
   ///             If the data needs to be synchronized back to the CPU, e.g.
@@ -57,6 +74,8 @@ class ComputeTessellator {
   ///             On Metal, no additional synchronization is needed as long as
   ///             the buffers are not heap allocated, so no additional
   ///             synchronization mechanism is provided.
+  ///             The vertex buffer must have room for the number of vertices
+  ///             returned by `ComputeStrokeVertexCount`.
   ///
   /// @return  A |Status| value indicating success or failure of the submission.
   ///
@@ -14,6 +14,11 @@ std::shared_ptr<GPUTracer> Context::GetGPUTracer() const {
   return nullptr;
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner>
+Context::GetConcurrentWorkerTaskRunner() const {
+  return nullptr;
+}
+
 bool Context::UpdateOffscreenLayerPixelFormat(PixelFormat format) {
   return false;
 }
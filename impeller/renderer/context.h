@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "impeller/core/formats.h"
 #include "impeller/renderer/capabilities.h"
@@ -43,6 +44,17 @@ class Context : public std::enable_shared_from_this<Context> {
 
   virtual std::shared_ptr<GPUTracer> GetGPUTracer() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      A task runner for worker threads that CPU work done on
+  ///             behalf of the context, like rasterizing glyphs, may be
+  ///             spread over.
+  ///
+  /// @return     The worker task runner, or nullptr if the context does not
+  ///             have one.
+  ///
+  virtual std::shared_ptr<fml::ConcurrentTaskRunner>
+  GetConcurrentWorkerTaskRunner() const;
+
  protected:
   Context();
 
@@ -4,6 +4,12 @@
 
 #include "gpu_tracer.h"
 
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+
 namespace impeller {
 
 GPUTracer::GPUTracer() = default;
@@ -18,4 +24,122 @@ bool GPUTracer::StopCapturingFrame() {
   return false;
 }
 
+bool GPUTracer::SupportsPassTiming() const {
+  return false;
+}
+
+void GPUTracer::SetPassTimingEnabled(bool enabled) {
+  pass_timing_enabled_ = enabled && SupportsPassTiming();
+}
+
+bool GPUTracer::IsPassTimingEnabled() const {
+  return pass_timing_enabled_;
+}
+
+void GPUTracer::SetFrameTimeCallback(
+    std::function<void(const GPUFrameTime&)> callback) {
+  Lock lock(frames_mutex_);
+  frame_time_callback_ = std::move(callback);
+}
+
+uint64_t GPUTracer::AddPendingSubmission() {
+  Lock lock(frames_mutex_);
+  pending_frames_[current_frame_number_].pending_submissions++;
+  return current_frame_number_;
+}
+
+void GPUTracer::RecordPassTimes(uint64_t frame_number,
+                                std::vector<GPUPassTime> times) {
+  // The time the passes ended on the GPU isn't known in terms of the CPU
+  // clock, so their trace events end when they are known to be done.
+  const auto now = fml::TimePoint::Now();
+  for (const auto& time : times) {
+    fml::tracing::TraceEventAsyncComplete("impeller", time.label.c_str(),
+                                          now - time.time, now);
+  }
+
+  std::vector<GPUFrameTime> frame_times;
+  std::function<void(const GPUFrameTime&)> callback;
+  {
+    Lock lock(frames_mutex_);
+    auto found = pending_frames_.find(frame_number);
+    if (found == pending_frames_.end() ||
+        found->second.pending_submissions == 0u) {
+      FML_DLOG(ERROR) << "Pass times recorded for a frame without pending "
+                         "submissions.";
+      return;
+    }
+    auto& frame = found->second;
+    frame.pending_submissions--;
+    for (auto& time : times) {
+      auto& pass = frame.passes[time.label];
+      pass.label = std::move(time.label);
+      pass.time = pass.time + time.time;
+      pass.pass_count += std::max<size_t>(time.pass_count, 1u);
+    }
+    frame_times = TakeCompleteFrames();
+    callback = frame_time_callback_;
+  }
+  PublishFrameTimes(frame_times, callback);
+}
+
+void GPUTracer::MarkFrameEnd() {
+  std::vector<GPUFrameTime> frame_times;
+  std::function<void(const GPUFrameTime&)> callback;
+  {
+    Lock lock(frames_mutex_);
+    current_frame_number_++;
+    frame_times = TakeCompleteFrames();
+    callback = frame_time_callback_;
+  }
+  PublishFrameTimes(frame_times, callback);
+}
+
+std::optional<GPUFrameTime> GPUTracer::GetLastFrameTime() const {
+  Lock lock(frames_mutex_);
+  return last_frame_time_;
+}
+
+std::vector<GPUFrameTime> GPUTracer::TakeCompleteFrames() {
+  // Frames are complete once they have ended and the GPU is done with all of
+  // their passes. They are published in order, so a frame waits for the ones
+  // before it.
+  std::vector<GPUFrameTime> frame_times;
+  for (auto it = pending_frames_.begin(); it != pending_frames_.end();) {
+    if (it->first >= current_frame_number_ ||
+        it->second.pending_submissions > 0u) {
+      break;
+    }
+    GPUFrameTime frame_time;
+    frame_time.frame_number = it->first;
+    for (auto& [label, pass] : it->second.passes) {
+      frame_time.total_time = frame_time.total_time + pass.time;
+      frame_time.passes.push_back(std::move(pass));
+    }
+    std::sort(frame_time.passes.begin(), frame_time.passes.end(),
+              [](const auto& a, const auto& b) { return a.time > b.time; });
+    last_frame_time_ = frame_time;
+    frame_times.push_back(std::move(frame_time));
+    it = pending_frames_.erase(it);
+  }
+  return frame_times;
+}
+
+void GPUTracer::PublishFrameTimes(
+    const std::vector<GPUFrameTime>& frame_times,
+    const std::function<void(const GPUFrameTime&)>& callback) const {
+  for (const auto& frame_time : frame_times) {
+#if !FLUTTER_RELEASE
+    FML_TRACE_COUNTER(
+        "impeller",                                                   //
+        "GPUFrameTime", reinterpret_cast<int64_t>(this),              //
+        "TotalMicroseconds", frame_time.total_time.ToMicroseconds(),  //
+        "PassCount", frame_time.passes.size());
+#endif  // !FLUTTER_RELEASE
+    if (callback) {
+      callback(frame_time);
+    }
+  }
+}
+
 }  // namespace impeller
@@ -2,7 +2,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "impeller/base/thread.h"
 
 namespace impeller {
 
@@ -18,6 +29,25 @@ struct GPUTracerConfiguration {
   bool mtl_frame_capture_save_trace_as_document = false;
 };
 
+//------------------------------------------------------------------------------
+/// @brief      The time the GPU spent on the passes with the same label.
+///
+struct GPUPassTime {
+  std::string label;
+  fml::TimeDelta time;
+  size_t pass_count = 0u;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The time the GPU spent on the passes of a frame.
+///
+struct GPUFrameTime {
+  uint64_t frame_number = 0u;
+  fml::TimeDelta total_time;
+  /// The passes with the same label are summed, from most to least time.
+  std::vector<GPUPassTime> passes;
+};
+
 //------------------------------------------------------------------------------
 /// @brief      A GPU tracer to trace gpu workflow during rendering.
 ///
@@ -43,10 +73,85 @@ class GPUTracer {
   ///
   virtual bool StopCapturingFrame();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the backend can measure the time the GPU spends on
+  ///             each pass.
+  ///
+  virtual bool SupportsPassTiming() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Measure the time the GPU spends on each pass, if supported.
+  ///             Passes are attributed to frames by their labels, which makes
+  ///             it possible to tell which layer or filter dominates the GPU
+  ///             time of a frame. Disabled by default.
+  ///
+  ///             Each pass time is emitted as a trace event that ends when
+  ///             the pass was known to be done, and each frame time as a
+  ///             trace counter.
+  ///
+  void SetPassTimingEnabled(bool enabled);
+
+  bool IsPassTimingEnabled() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Set a callback invoked with the time of each frame once the
+  ///             time of all of its passes is known. It may be invoked on any
+  ///             thread.
+  ///
+  void SetFrameTimeCallback(std::function<void(const GPUFrameTime&)> callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by backends when they submit timed passes to the GPU.
+  ///
+  /// @return     The number of the frame to report the pass times for.
+  ///
+  uint64_t AddPendingSubmission();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by backends once the GPU is done with the passes of a
+  ///             submission. Must be called exactly once for each call to
+  ///             `AddPendingSubmission`, even if the passes could not be
+  ///             timed.
+  ///
+  void RecordPassTimes(uint64_t frame_number, std::vector<GPUPassTime> times);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the end of the current frame. Passes submitted after
+  ///             this are attributed to the next frame.
+  ///
+  void MarkFrameEnd();
+
+  //----------------------------------------------------------------------------
+  /// @return     The time of the last frame for which the time of all passes
+  ///             is known, if any.
+  ///
+  std::optional<GPUFrameTime> GetLastFrameTime() const;
+
  protected:
   GPUTracer();
 
  private:
+  struct PendingFrame {
+    size_t pending_submissions = 0u;
+    std::map<std::string, GPUPassTime> passes;
+  };
+
+  std::atomic_bool pass_timing_enabled_ = false;
+  mutable Mutex frames_mutex_;
+  uint64_t current_frame_number_ IPLR_GUARDED_BY(frames_mutex_) = 0u;
+  std::map<uint64_t, PendingFrame> pending_frames_
+      IPLR_GUARDED_BY(frames_mutex_);
+  std::optional<GPUFrameTime> last_frame_time_ IPLR_GUARDED_BY(frames_mutex_);
+  std::function<void(const GPUFrameTime&)> frame_time_callback_
+      IPLR_GUARDED_BY(frames_mutex_);
+
+  std::vector<GPUFrameTime> TakeCompleteFrames()
+      IPLR_REQUIRES(frames_mutex_);
+
+  void PublishFrameTimes(
+      const std::vector<GPUFrameTime>& frame_times,
+      const std::function<void(const GPUFrameTime&)>& callback) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(GPUTracer);
 };
 
@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/renderer/gpu_tracer.h"
+
+namespace impeller {
+namespace testing {
+
+class TestGPUTracer final : public GPUTracer {
+ public:
+  explicit TestGPUTracer(bool supports_pass_timing)
+      : supports_pass_timing_(supports_pass_timing) {}
+
+  // |GPUTracer|
+  bool SupportsPassTiming() const override { return supports_pass_timing_; }
+
+ private:
+  const bool supports_pass_timing_;
+};
+
+static GPUPassTime MakePassTime(std::string label, int64_t milliseconds) {
+  return GPUPassTime{
+      .label = std::move(label),
+      .time = fml::TimeDelta::FromMilliseconds(milliseconds),
+      .pass_count = 1u,
+  };
+}
+
+TEST(GPUTracerTest, PassTimingIsOnlyEnabledWhenSupported) {
+  TestGPUTracer unsupported(false);
+  unsupported.SetPassTimingEnabled(true);
+  EXPECT_FALSE(unsupported.IsPassTimingEnabled());
+
+  TestGPUTracer supported(true);
+  EXPECT_FALSE(supported.IsPassTimingEnabled());
+  supported.SetPassTimingEnabled(true);
+  EXPECT_TRUE(supported.IsPassTimingEnabled());
+  supported.SetPassTimingEnabled(false);
+  EXPECT_FALSE(supported.IsPassTimingEnabled());
+}
+
+TEST(GPUTracerTest, PassTimesAreSummedByLabel) {
+  TestGPUTracer tracer(true);
+  std::vector<GPUFrameTime> frame_times;
+  tracer.SetFrameTimeCallback([&frame_times](const GPUFrameTime& frame_time) {
+    frame_times.push_back(frame_time);
+  });
+
+  auto frame_number = tracer.AddPendingSubmission();
+  tracer.RecordPassTimes(frame_number, {
+                                           MakePassTime("Root", 2),
+                                           MakePassTime("Blur", 3),
+                                       });
+  frame_number = tracer.AddPendingSubmission();
+  tracer.RecordPassTimes(frame_number, {MakePassTime("Blur", 4)});
+  tracer.MarkFrameEnd();
+
+  ASSERT_EQ(frame_times.size(), 1u);
+  const auto& frame_time = frame_times.front();
+  EXPECT_EQ(frame_time.frame_number, frame_number);
+  EXPECT_EQ(frame_time.total_time, fml::TimeDelta::FromMilliseconds(9));
+  ASSERT_EQ(frame_time.passes.size(), 2u);
+  EXPECT_EQ(frame_time.passes[0].label, "Blur");
+  EXPECT_EQ(frame_time.passes[0].time, fml::TimeDelta::FromMilliseconds(7));
+  EXPECT_EQ(frame_time.passes[0].pass_count, 2u);
+  EXPECT_EQ(frame_time.passes[1].label, "Root");
+  EXPECT_EQ(frame_time.passes[1].time, fml::TimeDelta::FromMilliseconds(2));
+  EXPECT_EQ(frame_time.passes[1].pass_count, 1u);
+
+  ASSERT_TRUE(tracer.GetLastFrameTime().has_value());
+  EXPECT_EQ(tracer.GetLastFrameTime()->frame_number, frame_number);
+}
+
+TEST(GPUTracerTest, FramesArePublishedInOrderOnceAllPassesAreTimed) {
+  TestGPUTracer tracer(true);
+  std::vector<uint64_t> frame_numbers;
+  tracer.SetFrameTimeCallback([&frame_numbers](const GPUFrameTime& frame_time) {
+    frame_numbers.push_back(frame_time.frame_number);
+  });
+
+  auto first_frame = tracer.AddPendingSubmission();
+  tracer.MarkFrameEnd();
+  auto second_frame = tracer.AddPendingSubmission();
+  tracer.MarkFrameEnd();
+  EXPECT_FALSE(tracer.GetLastFrameTime().has_value());
+
+  // The second frame waits for the first.
+  tracer.RecordPassTimes(second_frame, {MakePassTime("Root", 1)});
+  EXPECT_TRUE(frame_numbers.empty());
+
+  // Passes that could not be timed still complete their frame.
+  tracer.RecordPassTimes(first_frame, {});
+  ASSERT_EQ(frame_numbers.size(), 2u);
+  EXPECT_EQ(frame_numbers[0], first_frame);
+  EXPECT_EQ(frame_numbers[1], second_frame);
+
+  // A frame isn't published before it ends.
+  auto third_frame = tracer.AddPendingSubmission();
+  tracer.RecordPassTimes(third_frame, {MakePassTime("Root", 1)});
+  EXPECT_EQ(frame_numbers.size(), 2u);
+  tracer.MarkFrameEnd();
+  ASSERT_EQ(frame_numbers.size(), 3u);
+  EXPECT_EQ(frame_numbers[2], third_frame);
+}
+
+}  // namespace testing
+}  // namespace impeller
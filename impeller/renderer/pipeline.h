@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <future>
 
 #include "compute_pipeline_descriptor.h"
@@ -28,6 +29,14 @@ struct PipelineFuture {
   const std::shared_ptr<Pipeline<T>> Get() const { return future.get(); }
 
   bool IsValid() const { return future.valid(); }
+
+  //----------------------------------------------------------------------------
+  /// @return     If `Get` returns without waiting.
+  ///
+  bool IsReady() const {
+    return future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
 };
 
 //------------------------------------------------------------------------------
@@ -114,6 +123,14 @@ class RenderPipelineT {
     return pipeline_;
   }
 
+  //----------------------------------------------------------------------------
+  /// @return     If `WaitAndGet` returns without waiting.
+  ///
+  bool IsReady() const {
+    return did_wait_ || !pipeline_future_.IsValid() ||
+           pipeline_future_.IsReady();
+  }
+
   std::optional<PipelineDescriptor> GetDescriptor() const {
     return pipeline_future_.descriptor;
   }
@@ -32,4 +32,7 @@ PipelineFuture<ComputePipelineDescriptor> PipelineLibrary::GetPipeline(
   return {descriptor, promise->get_future()};
 }
 
+void PipelineLibrary::PrioritizePipeline(const PipelineDescriptor& descriptor,
+                                         bool will_wait) {}
+
 }  // namespace impeller
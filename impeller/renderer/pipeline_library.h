@@ -44,6 +44,21 @@ class PipelineLibrary : public std::enable_shared_from_this<PipelineLibrary> {
   virtual PipelineFuture<ComputePipelineDescriptor> GetPipeline(
       ComputePipelineDescriptor descriptor) = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Hint that the pipeline for the descriptor is needed soon.
+  ///             Backends that create pipelines in the background may create
+  ///             it ahead of the others that are still pending.
+  ///
+  /// @param[in]  descriptor  The descriptor of a previously requested
+  ///                         pipeline.
+  /// @param[in]  will_wait   Whether the caller is about to wait on the
+  ///                         pipeline. If so, it may be created on the
+  ///                         calling thread. Otherwise, the caller is never
+  ///                         blocked.
+  ///
+  virtual void PrioritizePipeline(const PipelineDescriptor& descriptor,
+                                  bool will_wait);
+
   virtual void RemovePipelinesWithEntryPoint(
       std::shared_ptr<const ShaderFunction> function) = 0;
 
@@ -26,15 +26,35 @@ HostBuffer& RenderPass::GetTransientsBuffer() {
   return *transients_buffer_;
 }
 
+void RenderPass::SetTransientsBuffer(
+    std::shared_ptr<HostBuffer> transients_buffer) {
+  if (!transients_buffer) {
+    return;
+  }
+  transients_buffer_ = std::move(transients_buffer);
+  owns_transients_buffer_ = false;
+}
+
 void RenderPass::SetLabel(std::string label) {
   if (label.empty()) {
     return;
   }
-  transients_buffer_->SetLabel(SPrintF("%s Transients", label.c_str()));
+  if (owns_transients_buffer_) {
+    transients_buffer_->SetLabel(SPrintF("%s Transients", label.c_str()));
+  }
   OnSetLabel(std::move(label));
 }
 
 bool RenderPass::AddCommand(Command command) {
+  if (!command.pipeline) {
+    if (skip_commands_without_pipeline_) {
+      return true;
+    }
+    VALIDATION_LOG << "Attempted to add a command without a pipeline to the "
+                      "render pass.";
+    return false;
+  }
+
   if (!command) {
     VALIDATION_LOG << "Attempted to add an invalid command to the render pass.";
     return false;
@@ -61,10 +81,38 @@ bool RenderPass::AddCommand(Command command) {
     return true;
   }
 
+  if (command_depth_.has_value()) {
+    auto viewport = command.viewport.value_or(
+        Viewport{.rect = Rect::MakeSize(render_target_.GetRenderTargetSize())});
+    viewport.depth_range = DepthRange{.z_near = command_depth_->depth,
+                                      .z_far = command_depth_->depth};
+    command.viewport = viewport;
+  }
+
   commands_.emplace_back(std::move(command));
   return true;
 }
 
+void RenderPass::SetCommandDepth(std::optional<CommandDepth> depth) {
+  command_depth_ = depth;
+}
+
+const std::optional<CommandDepth>& RenderPass::GetCommandDepth() const {
+  return command_depth_;
+}
+
+void RenderPass::SetSkipCommandsWithoutPipeline(bool skip) {
+  skip_commands_without_pipeline_ = skip;
+}
+
+bool RenderPass::GetSkipCommandsWithoutPipeline() const {
+  return skip_commands_without_pipeline_;
+}
+
+const std::vector<Command>& RenderPass::GetCommands() const {
+  return commands_;
+}
+
 bool RenderPass::EncodeCommands() const {
   auto context = context_.lock();
   // The context could have been collected in the meantime.
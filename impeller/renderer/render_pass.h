@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 
+#include "impeller/core/formats.h"
 #include "impeller/renderer/command.h"
 #include "impeller/renderer/render_target.h"
 
@@ -14,6 +16,16 @@ namespace impeller {
 class HostBuffer;
 class Allocator;
 
+//------------------------------------------------------------------------------
+/// @brief      The depth that commands are drawn at, and how they test against
+///             and write to the depth attachment.
+///
+struct CommandDepth {
+  /// The depth of every fragment of the commands.
+  Scalar depth = 0.0f;
+  DepthAttachmentDescriptor descriptor;
+};
+
 //------------------------------------------------------------------------------
 /// @brief      Render passes encode render commands directed as one specific
 ///             render target into an underlying command buffer.
@@ -37,6 +49,41 @@ class RenderPass {
 
   HostBuffer& GetTransientsBuffer();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the buffer transient data of the commands of this
+  ///             render pass is emplaced onto, so that it can be shared with
+  ///             other render passes of the frame.
+  ///
+  ///             The label of this render pass is not applied to the buffer.
+  ///
+  /// @param[in]  transients_buffer  The buffer. Ignored if null.
+  ///
+  void SetTransientsBuffer(std::shared_ptr<HostBuffer> transients_buffer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draw the commands added from now on at a single depth.
+  ///
+  ///             The depth is applied through the depth range of the viewport
+  ///             of the commands, so the vertex shaders are unaware of it. The
+  ///             pipelines of the commands must be built with the depth test
+  ///             of `depth`.
+  ///
+  /// @param[in]  depth  The depth, or std::nullopt to leave the viewport of
+  ///                    the commands as it is.
+  ///
+  void SetCommandDepth(std::optional<CommandDepth> depth);
+
+  const std::optional<CommandDepth>& GetCommandDepth() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Leave out commands without a pipeline instead of failing to
+  ///             add them. This lets a frame omit what it would draw with
+  ///             pipelines that are still being created.
+  ///
+  void SetSkipCommandsWithoutPipeline(bool skip);
+
+  bool GetSkipCommandsWithoutPipeline() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Record a command for subsequent encoding to the underlying
   ///             command buffer. No work is encoded into the command buffer at
@@ -48,6 +95,11 @@ class RenderPass {
   ///
   bool AddCommand(Command command);
 
+  //----------------------------------------------------------------------------
+  /// @brief      The commands recorded so far.
+  ///
+  const std::vector<Command>& GetCommands() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Encode the recorded commands to the underlying command buffer.
   ///
@@ -60,6 +112,9 @@ class RenderPass {
   const std::weak_ptr<const Context> context_;
   const RenderTarget render_target_;
   std::shared_ptr<HostBuffer> transients_buffer_;
+  bool owns_transients_buffer_ = true;
+  std::optional<CommandDepth> command_depth_;
+  bool skip_commands_without_pipeline_ = false;
   std::vector<Command> commands_;
 
   RenderPass(std::weak_ptr<const Context> context, const RenderTarget& target);
@@ -4,6 +4,8 @@
 
 #include "impeller/renderer/render_target.h"
 
+#include <utility>
+
 #include "impeller/base/strings.h"
 #include "impeller/base/validation.h"
 #include "impeller/core/allocator.h"
@@ -12,6 +14,24 @@
 
 namespace impeller {
 
+RenderTargetAllocator::RenderTargetAllocator(
+    std::shared_ptr<Allocator> allocator)
+    : allocator_(std::move(allocator)) {}
+
+RenderTargetAllocator::~RenderTargetAllocator() = default;
+
+std::shared_ptr<Texture> RenderTargetAllocator::CreateTexture(
+    const TextureDescriptor& desc) {
+  if (!allocator_) {
+    return nullptr;
+  }
+  return allocator_->CreateTexture(desc);
+}
+
+void RenderTargetAllocator::Start() {}
+
+void RenderTargetAllocator::End() {}
+
 RenderTarget::RenderTarget() = default;
 
 RenderTarget::~RenderTarget() = default;
@@ -205,6 +225,18 @@ RenderTarget RenderTarget::CreateOffscreen(
     const std::string& label,
     AttachmentConfig color_attachment_config,
     std::optional<AttachmentConfig> stencil_attachment_config) {
+  RenderTargetAllocator allocator(context.GetResourceAllocator());
+  return CreateOffscreen(context, allocator, size, label,
+                         color_attachment_config, stencil_attachment_config);
+}
+
+RenderTarget RenderTarget::CreateOffscreen(
+    const Context& context,
+    RenderTargetAllocator& allocator,
+    ISize size,
+    const std::string& label,
+    AttachmentConfig color_attachment_config,
+    std::optional<AttachmentConfig> stencil_attachment_config) {
   if (size.IsEmpty()) {
     return {};
   }
@@ -222,7 +254,7 @@ RenderTarget RenderTarget::CreateOffscreen(
   color0.clear_color = Color::BlackTransparent();
   color0.load_action = color_attachment_config.load_action;
   color0.store_action = color_attachment_config.store_action;
-  color0.texture = context.GetResourceAllocator()->CreateTexture(color_tex0);
+  color0.texture = allocator.CreateTexture(color_tex0);
 
   if (!color0.texture) {
     return {};
@@ -242,8 +274,7 @@ RenderTarget RenderTarget::CreateOffscreen(
     stencil0.load_action = stencil_attachment_config->load_action;
     stencil0.store_action = stencil_attachment_config->store_action;
     stencil0.clear_stencil = 0u;
-    stencil0.texture =
-        context.GetResourceAllocator()->CreateTexture(stencil_tex0);
+    stencil0.texture = allocator.CreateTexture(stencil_tex0);
 
     if (!stencil0.texture) {
       return {};
@@ -263,6 +294,19 @@ RenderTarget RenderTarget::CreateOffscreenMSAA(
     const std::string& label,
     AttachmentConfigMSAA color_attachment_config,
     std::optional<AttachmentConfig> stencil_attachment_config) {
+  RenderTargetAllocator allocator(context.GetResourceAllocator());
+  return CreateOffscreenMSAA(context, allocator, size, label,
+                             color_attachment_config,
+                             stencil_attachment_config);
+}
+
+RenderTarget RenderTarget::CreateOffscreenMSAA(
+    const Context& context,
+    RenderTargetAllocator& allocator,
+    ISize size,
+    const std::string& label,
+    AttachmentConfigMSAA color_attachment_config,
+    std::optional<AttachmentConfig> stencil_attachment_config) {
   if (size.IsEmpty()) {
     return {};
   }
@@ -280,8 +324,7 @@ RenderTarget RenderTarget::CreateOffscreenMSAA(
   color0_tex_desc.size = size;
   color0_tex_desc.usage = static_cast<uint64_t>(TextureUsage::kRenderTarget);
 
-  auto color0_msaa_tex =
-      context.GetResourceAllocator()->CreateTexture(color0_tex_desc);
+  auto color0_msaa_tex = allocator.CreateTexture(color0_tex_desc);
   if (!color0_msaa_tex) {
     VALIDATION_LOG << "Could not create multisample color texture.";
     return {};
@@ -301,8 +344,7 @@ RenderTarget RenderTarget::CreateOffscreenMSAA(
       static_cast<uint64_t>(TextureUsage::kRenderTarget) |
       static_cast<uint64_t>(TextureUsage::kShaderRead);
 
-  auto color0_resolve_tex =
-      context.GetResourceAllocator()->CreateTexture(color0_resolve_tex_desc);
+  auto color0_resolve_tex = allocator.CreateTexture(color0_resolve_tex_desc);
   if (!color0_resolve_tex) {
     VALIDATION_LOG << "Could not create color texture.";
     return {};
@@ -336,8 +378,7 @@ RenderTarget RenderTarget::CreateOffscreenMSAA(
     stencil0.load_action = stencil_attachment_config->load_action;
     stencil0.store_action = stencil_attachment_config->store_action;
     stencil0.clear_stencil = 0u;
-    stencil0.texture =
-        context.GetResourceAllocator()->CreateTexture(stencil_tex0);
+    stencil0.texture = allocator.CreateTexture(stencil_tex0);
 
     if (!stencil0.texture) {
       return {};
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
 
 #include "flutter/fml/macros.h"
@@ -17,6 +18,39 @@ namespace impeller {
 
 class Context;
 
+//------------------------------------------------------------------------------
+/// @brief      Allocates the textures of render targets. The default
+///             implementation allocates new textures from the resource
+///             allocator every time, subclasses may recycle them.
+///
+class RenderTargetAllocator {
+ public:
+  explicit RenderTargetAllocator(std::shared_ptr<Allocator> allocator);
+
+  virtual ~RenderTargetAllocator();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Create a texture for an attachment of a render target.
+  ///
+  virtual std::shared_ptr<Texture> CreateTexture(const TextureDescriptor& desc);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the beginning of a frame. Textures handed out after
+  ///             this may be in use until the matching call to `End`.
+  ///
+  virtual void Start();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the end of a frame.
+  ///
+  virtual void End();
+
+ private:
+  std::shared_ptr<Allocator> allocator_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RenderTargetAllocator);
+};
+
 class RenderTarget final {
  public:
   struct AttachmentConfig {
@@ -61,8 +95,27 @@ class RenderTarget final {
       std::optional<AttachmentConfig> stencil_attachment_config =
           kDefaultStencilAttachmentConfig);
 
+  static RenderTarget CreateOffscreen(
+      const Context& context,
+      RenderTargetAllocator& allocator,
+      ISize size,
+      const std::string& label = "Offscreen",
+      AttachmentConfig color_attachment_config = kDefaultColorAttachmentConfig,
+      std::optional<AttachmentConfig> stencil_attachment_config =
+          kDefaultStencilAttachmentConfig);
+
+  static RenderTarget CreateOffscreenMSAA(
+      const Context& context,
+      ISize size,
+      const std::string& label = "Offscreen MSAA",
+      AttachmentConfigMSAA color_attachment_config =
+          kDefaultColorAttachmentConfigMSAA,
+      std::optional<AttachmentConfig> stencil_attachment_config =
+          kDefaultStencilAttachmentConfig);
+
   static RenderTarget CreateOffscreenMSAA(
       const Context& context,
+      RenderTargetAllocator& allocator,
       ISize size,
       const std::string& label = "Offscreen MSAA",
       AttachmentConfigMSAA color_attachment_config =
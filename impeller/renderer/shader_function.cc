@@ -19,6 +19,14 @@ ShaderStage ShaderFunction::GetStage() const {
   return stage_;
 }
 
+const std::string& ShaderFunction::GetName() const {
+  return name_;
+}
+
+uint64_t ShaderFunction::GetCodeHash() const {
+  return 0u;
+}
+
 // |Comparable<ShaderFunction>|
 std::size_t ShaderFunction::GetHash() const {
   return fml::HashCombine(parent_library_id_, name_, stage_);
@@ -18,6 +18,14 @@ class ShaderFunction : public Comparable<ShaderFunction> {
 
   ShaderStage GetStage() const;
 
+  const std::string& GetName() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     A hash of the code of the function that is the same in every
+  ///             launch, or 0 if the backend does not compute one.
+  ///
+  virtual uint64_t GetCodeHash() const;
+
   // |Comparable<ShaderFunction>|
   std::size_t GetHash() const override;
 
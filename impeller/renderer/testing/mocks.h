@@ -64,7 +64,7 @@ class MockBlitPass : public BlitPass {
   MOCK_METHOD4(OnCopyBufferToTextureCommand,
                bool(BufferView source,
                     std::shared_ptr<Texture> destination,
-                    IPoint destination_origin,
+                    IRect destination_region,
                     std::string label));
   MOCK_METHOD2(OnGenerateMipmapCommand,
                bool(std::shared_ptr<Texture> texture, std::string label));
@@ -44,6 +44,8 @@ TextFrame TextFrameFromTextBlob(const sk_sp<SkTextBlob>& blob, Scalar scale) {
   }
 
   TextFrame frame;
+  // Text blobs are immutable, so their unique ID identifies their glyphs.
+  frame.SetIdentity(blob->uniqueID());
 
   for (SkTextBlobRunIterator run(blob.get()); !run.done(); run.next()) {
     TextRun text_run(ToFont(run, scale));
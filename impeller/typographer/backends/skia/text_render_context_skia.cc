@@ -4,12 +4,25 @@
 
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <string>
 #include <utility>
 
+#include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
 #include "impeller/core/allocator.h"
+#include "impeller/core/host_buffer.h"
+#include "impeller/core/platform.h"
+#include "impeller/renderer/blit_pass.h"
+#include "impeller/renderer/command_buffer.h"
+#include "impeller/renderer/context.h"
 #include "impeller/typographer/backends/skia/typeface_skia.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -19,6 +32,7 @@
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/src/core/SkIPoint16.h"   // nogncheck
 #include "third_party/skia/src/gpu/GrRectanizer.h"  // nogncheck
+#include "third_party/skia/src/gpu/RectanizerSkyline.h"  // nogncheck
 
 namespace impeller {
 
@@ -38,10 +52,7 @@ static FontGlyphPair::Set CollectUniqueFontGlyphPairsSet(
   FontGlyphPair::Set set;
   while (auto frame = frame_iterator()) {
     for (const auto& run : frame->GetRuns()) {
-      auto font = run.GetFont();
-      // TODO(dnfield): If we're doing SDF here, we should be using a consistent
-      // point size.
-      // https://github.com/flutter/flutter/issues/112016
+      auto font = GlyphAtlas::GetAtlasFont(type, run.GetFont());
       for (const auto& glyph_position : run.GetGlyphPositions()) {
         set.insert({font, glyph_position.glyph});
       }
@@ -63,8 +74,69 @@ static FontGlyphPair::Vector CollectUniqueFontGlyphPairs(
   return vector;
 }
 
+namespace {
+
+// The location in the atlas chosen for a font-glyph pair.
+struct GlyphPlacement {
+  FontGlyphPair pair;
+  size_t page;
+  Rect bounds;
+};
+
+// The state of a page of an atlas context that appending glyphs changes.
+struct SavedPage {
+  std::shared_ptr<SkBitmap> bitmap;
+  std::shared_ptr<GrRectanizer> rect_packer;
+};
+
+}  // namespace
+
+// The room reserved on each side of a glyph in an atlas of the given type,
+// beyond the padding between glyphs. Glyphs of signed-distance-field atlases
+// need room for the field outside of their outlines.
+static int GetGlyphMargin(GlyphAtlas::Type type) {
+  return type == GlyphAtlas::Type::kSignedDistanceField
+             ? GlyphAtlas::kSignedDistanceFieldSpread
+             : 0;
+}
+
+static std::optional<Rect> PackGlyph(const FontGlyphPair& pair,
+                                     GlyphAtlas::Type type,
+                                     GrRectanizer& rect_packer) {
+  const auto glyph_size =
+      ISize::Ceil((pair.glyph.bounds * pair.font.GetMetrics().scale).size);
+  const auto margin = GetGlyphMargin(type);
+  SkIPoint16 location_in_atlas;
+  if (!rect_packer.addRect(glyph_size.width + kPadding + 2 * margin,   //
+                           glyph_size.height + kPadding + 2 * margin,  //
+                           &location_in_atlas                          //
+                           )) {
+    return std::nullopt;
+  }
+  return Rect::MakeXYWH(location_in_atlas.x() + margin,  //
+                        location_in_atlas.y() + margin,  //
+                        glyph_size.width,                //
+                        glyph_size.height                //
+  );
+}
+
+static std::shared_ptr<GrRectanizer> CreateRectPacker(const ISize& size) {
+  return std::make_shared<skgpu::RectanizerSkyline>(size.width, size.height);
+}
+
+static std::shared_ptr<GrRectanizer> CopyRectPacker(
+    const std::shared_ptr<GrRectanizer>& rect_packer) {
+  if (!rect_packer) {
+    return nullptr;
+  }
+  // All rect packers are created by |CreateRectPacker|.
+  return std::make_shared<skgpu::RectanizerSkyline>(
+      static_cast<const skgpu::RectanizerSkyline&>(*rect_packer));
+}
+
 static size_t PairsFitInAtlasOfSize(
     const FontGlyphPair::Vector& pairs,
+    GlyphAtlas::Type type,
     const ISize& atlas_size,
     std::vector<Rect>& glyph_positions,
     const std::shared_ptr<GrRectanizer>& rect_packer) {
@@ -76,84 +148,34 @@ static size_t PairsFitInAtlasOfSize(
   glyph_positions.reserve(pairs.size());
 
   for (size_t i = 0; i < pairs.size(); i++) {
-    const auto& pair = pairs[i];
-
-    const auto glyph_size =
-        ISize::Ceil((pair.glyph.bounds * pair.font.GetMetrics().scale).size);
-    SkIPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
+    auto location_in_atlas = PackGlyph(pairs[i], type, *rect_packer);
+    if (!location_in_atlas.has_value()) {
       return pairs.size() - i;
     }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
-                                                ));
+    glyph_positions.emplace_back(location_in_atlas.value());
   }
 
   return 0;
 }
 
-static bool CanAppendToExistingAtlas(
-    const std::shared_ptr<GlyphAtlas>& atlas,
-    const FontGlyphPair::Vector& extra_pairs,
-    std::vector<Rect>& glyph_positions,
-    ISize atlas_size,
-    const std::shared_ptr<GrRectanizer>& rect_packer) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!rect_packer || atlas_size.IsEmpty()) {
-    return false;
-  }
-
-  // We assume that all existing glyphs will fit. After all, they fit before.
-  // The glyph_positions only contains the values for the additional glyphs
-  // from extra_pairs.
-  FML_DCHECK(glyph_positions.size() == 0);
-  glyph_positions.reserve(extra_pairs.size());
-  for (size_t i = 0; i < extra_pairs.size(); i++) {
-    const auto& pair = extra_pairs[i];
-
-    const auto glyph_size =
-        ISize::Ceil((pair.glyph.bounds * pair.font.GetMetrics().scale).size);
-    SkIPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
-      return false;
-    }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
-                                                ));
-  }
-
-  return true;
-}
-
 static ISize OptimumAtlasSizeForFontGlyphPairs(
     const FontGlyphPair::Vector& pairs,
+    GlyphAtlas::Type type,
     std::vector<Rect>& glyph_positions,
-    const std::shared_ptr<GlyphAtlasContext>& atlas_context) {
+    const ISize& max_atlas_size,
+    std::shared_ptr<GrRectanizer>& rect_packer) {
   static constexpr auto kMinAtlasSize = 8u;
-  static constexpr auto kMaxAtlasSize = 4096u;
 
   TRACE_EVENT0("impeller", __FUNCTION__);
 
   ISize current_size(kMinAtlasSize, kMinAtlasSize);
   size_t total_pairs = pairs.size() + 1;
   do {
-    auto rect_packer = std::shared_ptr<GrRectanizer>(
-        GrRectanizer::Factory(current_size.width, current_size.height));
+    rect_packer = CreateRectPacker(current_size);
 
-    auto remaining_pairs = PairsFitInAtlasOfSize(pairs, current_size,
-                                                 glyph_positions, rect_packer);
+    auto remaining_pairs = PairsFitInAtlasOfSize(
+        pairs, type, current_size, glyph_positions, rect_packer);
     if (remaining_pairs == 0) {
-      atlas_context->UpdateRectPacker(rect_packer);
       return current_size;
     } else if (remaining_pairs < std::ceil(total_pairs / 2)) {
       current_size = ISize::MakeWH(
@@ -165,17 +187,183 @@ static ISize OptimumAtlasSizeForFontGlyphPairs(
           Allocation::NextPowerOfTwoSize(current_size.width + 1),
           Allocation::NextPowerOfTwoSize(current_size.height + 1));
     }
-  } while (current_size.width <= kMaxAtlasSize &&
-           current_size.height <= kMaxAtlasSize);
+  } while (current_size.width <= max_atlas_size.width &&
+           current_size.height <= max_atlas_size.height);
+  rect_packer = nullptr;
   return ISize{0, 0};
 }
 
+// Packs each pair into the first page that has room for it. If none does and
+// |allow_new_pages| is set, pages of the maximum size are added to the
+// context until it holds the maximum number of pages.
+//
+// Returns the pairs that could not be packed.
+static FontGlyphPair::Vector PackPairsIntoPages(
+    const FontGlyphPair::Vector& pairs,
+    GlyphAtlas::Type type,
+    bool allow_new_pages,
+    GlyphAtlasContext& atlas_context,
+    std::vector<GlyphPlacement>& placements) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  FontGlyphPair::Vector remaining_pairs;
+  for (const auto& pair : pairs) {
+    bool packed = false;
+    for (size_t page = 0; page < atlas_context.GetPageCount(); page++) {
+      auto location_in_atlas =
+          PackGlyph(pair, type, *atlas_context.GetRectPacker(page));
+      if (location_in_atlas.has_value()) {
+        placements.push_back({pair, page, location_in_atlas.value()});
+        packed = true;
+        break;
+      }
+    }
+    if (!packed && allow_new_pages &&
+        atlas_context.GetPageCount() < atlas_context.GetMaxPageCount()) {
+      const auto& page_size = atlas_context.GetMaxPageSize();
+      auto rect_packer = CreateRectPacker(page_size);
+      auto location_in_atlas = PackGlyph(pair, type, *rect_packer);
+      auto page = atlas_context.AddPage(page_size, std::move(rect_packer));
+      if (location_in_atlas.has_value()) {
+        placements.push_back({pair, page, location_in_atlas.value()});
+        packed = true;
+      }
+    }
+    if (!packed) {
+      remaining_pairs.push_back(pair);
+    }
+  }
+  return remaining_pairs;
+}
+
+// Picks the page to evict glyphs from when all pages are full. Pages whose
+// glyphs are used by the current frame are the most expensive to repack, so
+// the page with the fewest such pixels is picked, and the one that was used
+// least recently among those. Pages without any cold glyph are skipped as
+// repacking them would not free any space.
+static std::optional<size_t> FindPageToEvict(
+    const GlyphAtlas& atlas,
+    const GlyphAtlasContext& atlas_context,
+    const std::vector<bool>& excluded_pages) {
+  const auto frame = atlas_context.GetFrame();
+  std::optional<size_t> result;
+  std::pair<Scalar, uint64_t> result_cost;
+  for (size_t page = 0; page < atlas.GetPageCount(); page++) {
+    if (excluded_pages[page]) {
+      continue;
+    }
+    Scalar warm_area = 0;
+    uint64_t last_used_frame = 0;
+    bool has_cold_glyphs = false;
+    atlas.IteratePageGlyphs(
+        page, [&](const FontGlyphPair& pair, const Rect& rect) {
+          auto glyph_frame = atlas_context.GetGlyphLastUsedFrame(pair);
+          if (glyph_frame == frame) {
+            warm_area += rect.size.Area();
+          } else {
+            has_cold_glyphs = true;
+          }
+          last_used_frame = std::max(last_used_frame, glyph_frame);
+          return true;
+        });
+    std::pair<Scalar, uint64_t> cost = {warm_area, last_used_frame};
+    if (has_cold_glyphs && (!result.has_value() || cost < result_cost)) {
+      result = page;
+      result_cost = cost;
+    }
+  }
+  return result;
+}
+
+// Repacks a page from scratch. The glyphs on the page that are used by the
+// current frame are packed first, then as many of |pairs| as fit, then the
+// remaining glyphs of the page from the most to the least recently used.
+// The glyphs that no longer fit are evicted from the page.
+//
+// Returns the pairs that could not be packed, or std::nullopt if the glyphs
+// of the current frame no longer fit in the page.
+static std::optional<FontGlyphPair::Vector> RepackPage(
+    size_t page,
+    const GlyphAtlas& atlas,
+    const FontGlyphPair::Vector& pairs,
+    GlyphAtlasContext& atlas_context,
+    std::vector<GlyphPlacement>& placements) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  const auto frame = atlas_context.GetFrame();
+
+  // Glyphs placed on the page earlier in this frame are packed again.
+  FontGlyphPair::Vector warm_pairs;
+  auto placed_on_page = std::stable_partition(
+      placements.begin(), placements.end(),
+      [page](const GlyphPlacement& placement) {
+        return placement.page != page;
+      });
+  for (auto it = placed_on_page; it != placements.end(); ++it) {
+    warm_pairs.push_back(it->pair);
+  }
+  placements.erase(placed_on_page, placements.end());
+
+  std::vector<std::pair<uint64_t, FontGlyphPair>> cold_pairs;
+  atlas.IteratePageGlyphs(page, [&](const FontGlyphPair& pair, const Rect&) {
+    auto last_used_frame = atlas_context.GetGlyphLastUsedFrame(pair);
+    if (last_used_frame == frame) {
+      warm_pairs.push_back(pair);
+    } else {
+      cold_pairs.emplace_back(last_used_frame, pair);
+    }
+    return true;
+  });
+  std::stable_sort(
+      cold_pairs.begin(), cold_pairs.end(),
+      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  auto rect_packer = CreateRectPacker(atlas_context.GetAtlasSize(page));
+  atlas_context.UpdateRectPacker(rect_packer, page);
+
+  for (const auto& pair : warm_pairs) {
+    auto location_in_atlas = PackGlyph(pair, atlas.GetType(), *rect_packer);
+    if (!location_in_atlas.has_value()) {
+      return std::nullopt;
+    }
+    placements.push_back({pair, page, location_in_atlas.value()});
+  }
+
+  FontGlyphPair::Vector remaining_pairs;
+  for (const auto& pair : pairs) {
+    auto location_in_atlas = PackGlyph(pair, atlas.GetType(), *rect_packer);
+    if (location_in_atlas.has_value()) {
+      placements.push_back({pair, page, location_in_atlas.value()});
+    } else {
+      remaining_pairs.push_back(pair);
+    }
+  }
+
+  size_t evicted_count = 0u;
+  for (const auto& cold_pair : cold_pairs) {
+    const auto& pair = cold_pair.second;
+    auto location_in_atlas = PackGlyph(pair, atlas.GetType(), *rect_packer);
+    if (location_in_atlas.has_value()) {
+      placements.push_back({pair, page, location_in_atlas.value()});
+    } else {
+      atlas_context.ForgetGlyph(pair);
+      evicted_count++;
+    }
+  }
+  atlas_context.RecordEviction(evicted_count);
+
+  return remaining_pairs;
+}
+
 /// Compute signed-distance field for an 8-bpp grayscale image (values greater
 /// than 127 are considered "on") For details of this algorithm, see "The 'dead
 /// reckoning' signed distance transform" [Grevera 2004]
+///
+/// The image may be part of a larger one whose rows are |row_bytes| apart.
+/// Distances of |spread| pixels or more from the outline saturate.
 static void ConvertBitmapToSignedDistanceField(uint8_t* pixels,
                                                uint16_t width,
-                                               uint16_t height) {
+                                               uint16_t height,
+                                               size_t row_bytes,
+                                               Scalar spread) {
   if (!pixels || width == 0 || height == 0) {
     return;
   }
@@ -188,7 +376,7 @@ static void ConvertBitmapToSignedDistanceField(uint8_t* pixels,
   std::vector<ShortPoint> boundary_point_map(width * height);
 
   // Some helpers for manipulating the above arrays
-#define image(_x, _y) (pixels[(_y)*width + (_x)] > 0x7f)
+#define image(_x, _y) (pixels[(_y)*row_bytes + (_x)] > 0x7f)
 #define distance(_x, _y) distance_map[(_y)*width + (_x)]
 #define nearestpt(_x, _y) boundary_point_map[(_y)*width + (_x)]
 
@@ -271,12 +459,12 @@ static void ConvertBitmapToSignedDistanceField(uint8_t* pixels,
         distance(x, y) = -distance(x, y);
       }
 
-      float norm_factor = 13.5;
+      float norm_factor = spread;
       float dist = distance(x, y);
       float clamped_dist = fmax(-norm_factor, fmin(dist, norm_factor));
       float scaled_dist = clamped_dist / norm_factor;
       uint8_t quantized_value = ((scaled_dist + 1) / 2) * UINT8_MAX;
-      pixels[y * width + x] = quantized_value;
+      pixels[y * row_bytes + x] = quantized_value;
     }
   }
 
@@ -318,35 +506,167 @@ static void DrawGlyph(SkCanvas* canvas,
   );
 }
 
-static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
-                              const std::shared_ptr<SkBitmap>& bitmap,
-                              const FontGlyphPair::Vector& new_pairs) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  FML_DCHECK(bitmap != nullptr);
+// The area around the location of a glyph that the glyph may be drawn into.
+// Each glyph owns its margin and half of the padding between it and its
+// neighbors, which keeps glyphs that are drawn by different threads from
+// touching the same pixels.
+static Rect GetGlyphDrawBounds(const Rect& location, GlyphAtlas::Type type) {
+  const Scalar outset = kPadding / 2 + GetGlyphMargin(type);
+  return Rect::MakeLTRB(location.GetLeft() - outset,
+                        location.GetTop() - outset,
+                        location.GetRight() + outset,
+                        location.GetBottom() + outset);
+}
 
-  auto surface = SkSurface::MakeRasterDirect(bitmap->pixmap());
-  if (!surface) {
-    return false;
+static IRect RoundOut(const Rect& rect) {
+  return IRect::MakeLTRB(static_cast<int64_t>(std::floor(rect.GetLeft())),
+                         static_cast<int64_t>(std::floor(rect.GetTop())),
+                         static_cast<int64_t>(std::ceil(rect.GetRight())),
+                         static_cast<int64_t>(std::ceil(rect.GetBottom())));
+}
+
+// The number of glyphs a thread claims at once when glyphs are drawn in
+// parallel, so that threads do not contend for every small glyph.
+static constexpr size_t kGlyphsPerRasterBatch = 16u;
+
+namespace {
+
+// The work of drawing glyphs into a bitmap, which the calling thread shares
+// with worker threads. It is reference counted as workers that only start
+// once all glyphs are drawn still look at it.
+struct GlyphRasterization {
+  GlyphRasterization(std::shared_ptr<SkBitmap> p_bitmap,
+                     std::vector<GlyphPlacement> p_glyphs,
+                     GlyphAtlas::Type p_type)
+      : bitmap(std::move(p_bitmap)),
+        glyphs(std::move(p_glyphs)),
+        type(p_type),
+        batch_count((glyphs.size() + kGlyphsPerRasterBatch - 1) /
+                    kGlyphsPerRasterBatch),
+        pending_batches(batch_count) {}
+
+  const std::shared_ptr<SkBitmap> bitmap;
+  const std::vector<GlyphPlacement> glyphs;
+  const GlyphAtlas::Type type;
+  const size_t batch_count;
+  std::atomic_size_t next_batch = 0u;
+  std::atomic_bool failed = false;
+  fml::CountDownLatch pending_batches;
+};
+
+}  // namespace
+
+// Draws batches of glyphs until none are left. Every thread draws through
+// its own canvas, and every glyph is clipped to its own part of the bitmap.
+// The glyphs of signed-distance-field atlases are turned into distance
+// fields right after they are drawn, which only touches their own part too.
+static void DrawGlyphBatches(GlyphRasterization& rasterization) {
+  const auto has_color =
+      rasterization.type == GlyphAtlas::Type::kColorBitmap;
+  const auto is_sdf =
+      rasterization.type == GlyphAtlas::Type::kSignedDistanceField;
+  const auto bitmap_bounds = IRect::MakeSize(
+      ISize(rasterization.bitmap->width(), rasterization.bitmap->height()));
+  sk_sp<SkSurface> surface;
+  for (size_t batch = rasterization.next_batch++;
+       batch < rasterization.batch_count;
+       batch = rasterization.next_batch++) {
+    if (!surface) {
+      surface = SkSurface::MakeRasterDirect(rasterization.bitmap->pixmap());
+    }
+    if (surface) {
+      auto canvas = surface->getCanvas();
+      const auto begin = batch * kGlyphsPerRasterBatch;
+      const auto end = std::min(begin + kGlyphsPerRasterBatch,
+                                rasterization.glyphs.size());
+      for (auto i = begin; i < end; i++) {
+        const auto& glyph = rasterization.glyphs[i];
+        const auto clip = GetGlyphDrawBounds(glyph.bounds, rasterization.type);
+        canvas->save();
+        canvas->resetMatrix();
+        canvas->clipRect(SkRect::MakeLTRB(clip.GetLeft(), clip.GetTop(),
+                                          clip.GetRight(), clip.GetBottom()));
+        DrawGlyph(canvas, glyph.pair, glyph.bounds, has_color);
+        canvas->restore();
+        if (is_sdf) {
+          auto region = RoundOut(clip).Intersection(bitmap_bounds);
+          if (region.has_value() && !region->IsEmpty()) {
+            ConvertBitmapToSignedDistanceField(
+                reinterpret_cast<uint8_t*>(rasterization.bitmap->getAddr(
+                    region->origin.x, region->origin.y)),
+                region->size.width, region->size.height,
+                rasterization.bitmap->rowBytes(),
+                GlyphAtlas::kSignedDistanceFieldSpread);
+          }
+        }
+      }
+    } else {
+      rasterization.failed = true;
+    }
+    rasterization.pending_batches.CountDown();
   }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
-    return false;
+}
+
+// Draws glyphs into a bitmap. The glyphs are split into batches that the
+// calling thread draws along with the workers of the atlas context, if any.
+// Only the batches that were picked up are waited for, so tasks that a busy
+// worker pool has yet to start never hold up the calling thread.
+static bool DrawGlyphs(const std::shared_ptr<SkBitmap>& bitmap,
+                       std::vector<GlyphPlacement> glyphs,
+                       GlyphAtlas::Type type,
+                       GlyphAtlasContext& atlas_context) {
+  TRACE_EVENT1("impeller", __FUNCTION__, "Glyphs",
+               std::to_string(glyphs.size()).c_str());
+  atlas_context.RecordRasterization(glyphs.size());
+  auto rasterization = std::make_shared<GlyphRasterization>(
+      bitmap, std::move(glyphs), type);
+
+  const auto& worker_task_runner = atlas_context.GetWorkerTaskRunner();
+  const size_t helper_count =
+      rasterization->batch_count == 0u
+          ? 0u
+          : std::min(atlas_context.GetWorkerCount(),
+                     rasterization->batch_count - 1u);
+  for (size_t i = 0; i < helper_count; i++) {
+    worker_task_runner->PostTask(
+        [rasterization]() { DrawGlyphBatches(*rasterization); });
   }
+  DrawGlyphBatches(*rasterization);
+  rasterization->pending_batches.Wait();
+  return !rasterization->failed;
+}
 
-  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+// Draws the new glyphs of a page into the existing bitmap of the page and
+// marks the parts of the page that the glyphs cover as dirty in the atlas.
+//
+// Returns false if the glyphs could not be drawn.
+static bool UpdateAtlasBitmap(GlyphAtlas& atlas,
+                              size_t page,
+                              const std::shared_ptr<SkBitmap>& bitmap,
+                              std::vector<GlyphPlacement> new_glyphs,
+                              GlyphAtlasContext& atlas_context) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  FML_DCHECK(bitmap != nullptr);
 
-  for (const auto& pair : new_pairs) {
-    auto pos = atlas.FindFontGlyphBounds(pair);
-    if (!pos.has_value()) {
-      continue;
+  const auto page_bounds =
+      IRect::MakeSize(ISize(bitmap->width(), bitmap->height()));
+  for (const auto& glyph : new_glyphs) {
+    auto region = RoundOut(GetGlyphDrawBounds(glyph.bounds, atlas.GetType()))
+                      .Intersection(page_bounds);
+    if (region.has_value()) {
+      atlas.AddDirtyRegion(page, region.value());
     }
-    DrawGlyph(canvas, pair, pos.value(), has_color);
   }
-  return true;
+
+  return DrawGlyphs(bitmap, std::move(new_glyphs), atlas.GetType(),
+                    atlas_context);
 }
 
-static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
-                                                   const ISize& atlas_size) {
+static std::shared_ptr<SkBitmap> CreateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    size_t page,
+    const ISize& atlas_size,
+    GlyphAtlasContext& atlas_context) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   auto bitmap = std::make_shared<SkBitmap>();
   SkImageInfo image_info;
@@ -365,24 +685,20 @@ static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
   if (!bitmap->tryAllocPixels(image_info)) {
     return nullptr;
   }
+  bitmap->eraseColor(SK_ColorTRANSPARENT);
 
-  auto surface = SkSurface::MakeRasterDirect(bitmap->pixmap());
-  if (!surface) {
-    return nullptr;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
+  std::vector<GlyphPlacement> glyphs;
+  atlas.IteratePageGlyphs(
+      page, [&glyphs, page](const FontGlyphPair& font_glyph,
+                            const Rect& location) -> bool {
+        glyphs.push_back({font_glyph, page, location});
+        return true;
+      });
+
+  if (!DrawGlyphs(bitmap, std::move(glyphs), atlas.GetType(), atlas_context)) {
     return nullptr;
   }
 
-  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
-
-  atlas.IterateGlyphs([canvas, has_color](const FontGlyphPair& font_glyph,
-                                          const Rect& location) -> bool {
-    DrawGlyph(canvas, font_glyph, location, has_color);
-    return true;
-  });
-
   return bitmap;
 }
 
@@ -402,6 +718,114 @@ static bool UpdateGlyphTextureAtlas(std::shared_ptr<SkBitmap> bitmap,
   return texture->SetContents(mapping);
 }
 
+namespace {
+
+// A dirty region of a page along with the part of the staging buffer that
+// holds its pixels.
+struct RegionUpload {
+  size_t page;
+  IRect region;
+  Range range;
+};
+
+}  // namespace
+
+// Uploads the dirty regions of all pages of the atlas to the textures of the
+// pages through a single blit pass, which leaves the rest of the textures
+// untouched. If the context cannot create command buffers, the pages that
+// have dirty regions are uploaded whole.
+//
+// Returns false on failure.
+static bool UploadDirtyRegions(const Context& context,
+                               GlyphAtlas& atlas,
+                               GlyphAtlasContext& atlas_context) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  const size_t page_count = atlas.GetPageCount();
+  size_t region_count = 0u;
+  for (size_t page = 0; page < page_count; page++) {
+    region_count += atlas.GetDirtyRegions(page).size();
+  }
+  if (region_count == 0u) {
+    return true;
+  }
+
+  auto allocator = context.GetResourceAllocator();
+  auto command_buffer = context.CreateCommandBuffer();
+  if (!allocator || !command_buffer) {
+    for (size_t page = 0; page < page_count; page++) {
+      if (atlas.GetDirtyRegions(page).empty()) {
+        continue;
+      }
+      auto bitmap = atlas_context.GetBitmap(page);
+      if (!UpdateGlyphTextureAtlas(bitmap, atlas.GetTexture(page))) {
+        return false;
+      }
+      atlas_context.RecordUpload(bitmap->computeByteSize());
+    }
+    atlas.ClearDirtyRegions();
+    return true;
+  }
+
+  // Blits read tightly packed rows, so the rows of every region are gathered
+  // from the bitmaps of the pages into a staging buffer, one region after the
+  // other. The staging buffer is moved to the device once for all regions.
+  auto staging_buffer = HostBuffer::Create();
+  staging_buffer->SetLabel("Glyph Atlas Staging");
+  std::vector<RegionUpload> uploads;
+  uploads.reserve(region_count);
+  size_t uploaded_bytes = 0u;
+  for (size_t page = 0; page < page_count; page++) {
+    const auto& regions = atlas.GetDirtyRegions(page);
+    if (regions.empty()) {
+      continue;
+    }
+    const auto& pixmap = atlas_context.GetBitmap(page)->pixmap();
+    for (const auto& region : regions) {
+      const size_t row_bytes =
+          region.size.width * pixmap.info().bytesPerPixel();
+      const size_t region_bytes = row_bytes * region.size.height;
+      auto view = staging_buffer->Emplace(nullptr, region_bytes,
+                                          DefaultUniformAlignment());
+      if (!view) {
+        return false;
+      }
+      for (int64_t row = 0; row < region.size.height; row++) {
+        std::memcpy(view.contents + view.range.offset + row * row_bytes,
+                    pixmap.addr(region.origin.x, region.origin.y + row),
+                    row_bytes);
+      }
+      uploads.push_back({page, region, view.range});
+      uploaded_bytes += region_bytes;
+    }
+  }
+
+  auto device_buffer =
+      static_cast<const Buffer&>(*staging_buffer).GetDeviceBuffer(*allocator);
+  if (!device_buffer) {
+    return false;
+  }
+
+  auto blit_pass = command_buffer->CreateBlitPass();
+  if (!blit_pass) {
+    return false;
+  }
+  blit_pass->SetLabel("Glyph Atlas Upload");
+  for (const auto& upload : uploads) {
+    BufferView source{device_buffer, nullptr, upload.range};
+    if (!blit_pass->AddCopy(source, atlas.GetTexture(upload.page),
+                            upload.region)) {
+      return false;
+    }
+  }
+  if (!blit_pass->EncodeCommands(allocator) ||
+      !command_buffer->SubmitCommands()) {
+    return false;
+  }
+  atlas_context.RecordUpload(uploaded_bytes, uploads.size());
+  atlas.ClearDirtyRegions();
+  return true;
+}
+
 static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
     const std::shared_ptr<Allocator>& allocator,
     std::shared_ptr<SkBitmap> bitmap,
@@ -443,139 +867,325 @@ static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
   return texture;
 }
 
-std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
-    GlyphAtlas::Type type,
-    std::shared_ptr<GlyphAtlasContext> atlas_context,
-    FrameIterator frame_iterator) const {
+// Draws all glyphs of a page into a new bitmap and uploads it as a new
+// texture for the page.
+static bool CreatePageTexture(GlyphAtlas& atlas,
+                              size_t page,
+                              GlyphAtlasContext& atlas_context,
+                              const std::shared_ptr<Allocator>& allocator) {
+  const auto atlas_size = atlas_context.GetAtlasSize(page);
+  auto bitmap = CreateAtlasBitmap(atlas, page, atlas_size, atlas_context);
+  if (!bitmap) {
+    return false;
+  }
+  atlas_context.UpdateBitmap(bitmap, page);
+
+  PixelFormat format;
+  switch (atlas.GetType()) {
+    case GlyphAtlas::Type::kSignedDistanceField:
+    case GlyphAtlas::Type::kAlphaBitmap:
+      format = PixelFormat::kA8UNormInt;
+      break;
+    case GlyphAtlas::Type::kColorBitmap:
+      format = PixelFormat::kR8G8B8A8UNormInt;
+      break;
+  }
+  auto texture = UploadGlyphTextureAtlas(allocator, bitmap, atlas_size, format);
+  if (!texture) {
+    return false;
+  }
+  atlas_context.RecordUpload(bitmap->computeByteSize());
+  atlas.SetTexture(page, std::move(texture));
+  return true;
+}
+
+// Adds glyphs to the pages of the current atlas, adding pages while the
+// context allows and then evicting cold glyphs from the least valuable pages.
+// Only the pages that changed are drawn, and only the regions of existing
+// pages that the new glyphs cover are uploaded.
+//
+// Returns null if the glyphs do not fit and the atlas must be rebuilt.
+static std::shared_ptr<GlyphAtlas> AppendToExistingAtlas(
+    const std::shared_ptr<GlyphAtlas>& last_atlas,
+    const FontGlyphPair::Vector& new_glyphs,
+    GlyphAtlasContext& atlas_context,
+    const Context& context) {
   TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!IsValid()) {
+  const size_t old_page_count = atlas_context.GetPageCount();
+  if (old_page_count == 0u || old_page_count != last_atlas->GetPageCount()) {
     return nullptr;
   }
-  auto last_atlas = atlas_context->GetGlyphAtlas();
+
+  // Glyphs are packed into the rect packers of the pages in place before it
+  // is known whether all of them fit. Restore the pages as they were if the
+  // glyphs end up not being added so that they still match the last atlas.
+  std::vector<SavedPage> saved_pages;
+  saved_pages.reserve(old_page_count);
+  for (size_t page = 0; page < old_page_count; page++) {
+    saved_pages.push_back({
+        .bitmap = atlas_context.GetBitmap(page),
+        .rect_packer = CopyRectPacker(atlas_context.GetRectPacker(page)),
+    });
+  }
+  fml::ScopedCleanupClosure restore_pages([&saved_pages, &atlas_context]() {
+    atlas_context.TruncatePages(saved_pages.size());
+    for (size_t page = 0; page < saved_pages.size(); page++) {
+      atlas_context.UpdateBitmap(std::move(saved_pages[page].bitmap), page);
+      atlas_context.UpdateRectPacker(std::move(saved_pages[page].rect_packer),
+                                     page);
+    }
+  });
 
   // ---------------------------------------------------------------------------
-  // Step 1: Collect unique font-glyph pairs in the frame.
+  // Step 1: Pack the new glyphs into the free space of the existing pages.
+  //         While the first page is smaller than the maximum page size,
+  //         rebuilding it at a larger size is cheaper than adding pages.
   // ---------------------------------------------------------------------------
-
-  auto font_glyph_pairs = CollectUniqueFontGlyphPairs(type, frame_iterator);
-  if (font_glyph_pairs.empty()) {
-    return last_atlas;
+  const bool can_add_pages =
+      old_page_count > 1u ||
+      atlas_context.GetAtlasSize(0u) == atlas_context.GetMaxPageSize();
+  std::vector<GlyphPlacement> placements;
+  auto remaining_pairs =
+      PackPairsIntoPages(new_glyphs, last_atlas->GetType(), can_add_pages,
+                         atlas_context, placements);
+  if (!remaining_pairs.empty() && !can_add_pages) {
+    return nullptr;
+  }
+  const size_t page_count = atlas_context.GetPageCount();
+  for (size_t page = old_page_count; page < page_count; page++) {
+    atlas_context.RecordPageAdded();
   }
 
   // ---------------------------------------------------------------------------
-  // Step 2: Determine if the atlas type and font glyph pairs are compatible
-  //         with the current atlas and reuse if possible.
+  // Step 2: If all pages are full, make room by evicting the glyphs that the
+  //         current frame does not use from pages.
   // ---------------------------------------------------------------------------
-  auto new_glyphs = last_atlas->HasSamePairs(font_glyph_pairs);
-  if (last_atlas->GetType() == type && new_glyphs.size() == 0) {
-    return last_atlas;
+  std::vector<bool> repacked_pages(page_count, false);
+  while (!remaining_pairs.empty()) {
+    auto page = FindPageToEvict(*last_atlas, atlas_context, repacked_pages);
+    if (!page.has_value()) {
+      return nullptr;
+    }
+    repacked_pages[page.value()] = true;
+    auto pairs = RepackPage(page.value(), *last_atlas, remaining_pairs,
+                            atlas_context, placements);
+    if (!pairs.has_value()) {
+      return nullptr;
+    }
+    remaining_pairs = std::move(pairs.value());
   }
 
   // ---------------------------------------------------------------------------
-  // Step 3: Determine if the additional missing glyphs can be appended to the
-  //         existing bitmap without recreating the atlas. This requires that
-  //         the type is identical.
+  // Step 3: Record the positions of the glyphs. Repacked pages get new
+  //         textures, so a new atlas is created that shares the textures of
+  //         the untouched pages. This leaves the previous atlas intact for any
+  //         text that was already drawn with it.
   // ---------------------------------------------------------------------------
-  std::vector<Rect> glyph_positions;
-  if (last_atlas->GetType() == type &&
-      CanAppendToExistingAtlas(last_atlas, new_glyphs, glyph_positions,
-                               atlas_context->GetAtlasSize(),
-                               atlas_context->GetRectPacker())) {
-    // The old bitmap will be reused and only the additional glyphs will be
-    // added.
-
-    // ---------------------------------------------------------------------------
-    // Step 4: Record the positions in the glyph atlas of the newly added
-    // glyphs.
-    // ---------------------------------------------------------------------------
-    for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
-      last_atlas->AddTypefaceGlyphPosition(new_glyphs[i], glyph_positions[i]);
+  auto atlas = last_atlas;
+  if (std::find(repacked_pages.begin(), repacked_pages.end(), true) !=
+      repacked_pages.end()) {
+    atlas = std::make_shared<GlyphAtlas>(last_atlas->GetType());
+    for (size_t page = 0; page < old_page_count; page++) {
+      if (repacked_pages[page]) {
+        continue;
+      }
+      atlas->SetTexture(page, last_atlas->GetTexture(page));
+      last_atlas->IteratePageGlyphs(
+          page, [&atlas, page](const FontGlyphPair& pair, const Rect& rect) {
+            atlas->AddTypefaceGlyphPosition(pair, rect, page);
+            return true;
+          });
     }
+  }
+  for (const auto& placement : placements) {
+    atlas->AddTypefaceGlyphPosition(placement.pair, placement.bounds,
+                                    placement.page);
+  }
 
-    // ---------------------------------------------------------------------------
-    // Step 5: Draw new font-glyph pairs into the existing bitmap.
-    // ---------------------------------------------------------------------------
-    auto bitmap = atlas_context->GetBitmap();
-    if (!UpdateAtlasBitmap(*last_atlas, bitmap, new_glyphs)) {
-      return nullptr;
+  // ---------------------------------------------------------------------------
+  // Step 4: Draw the glyphs into the pages that changed and upload them. New
+  //         and repacked pages are uploaded whole, while only the dirty
+  //         regions of the other pages are uploaded, all in one blit pass.
+  // ---------------------------------------------------------------------------
+  for (size_t page = 0; page < page_count; page++) {
+    if (page >= old_page_count || repacked_pages[page]) {
+      if (!CreatePageTexture(*atlas, page, atlas_context,
+                             context.GetResourceAllocator())) {
+        return nullptr;
+      }
+      continue;
     }
-
-    // ---------------------------------------------------------------------------
-    // Step 6: Update the existing texture with the updated bitmap.
-    // ---------------------------------------------------------------------------
-    if (!UpdateGlyphTextureAtlas(bitmap, last_atlas->GetTexture())) {
+    std::vector<GlyphPlacement> page_glyphs;
+    for (const auto& placement : placements) {
+      if (placement.page == page) {
+        page_glyphs.push_back(placement);
+      }
+    }
+    if (page_glyphs.empty()) {
+      continue;
+    }
+    if (!UpdateAtlasBitmap(*atlas, page, atlas_context.GetBitmap(page),
+                           std::move(page_glyphs), atlas_context)) {
       return nullptr;
     }
-    return last_atlas;
   }
-  // A new glyph atlas must be created.
+  if (!UploadDirtyRegions(context, *atlas, atlas_context)) {
+    return nullptr;
+  }
+
+  restore_pages.Release();
+  atlas_context.UpdateGlyphAtlas(atlas);
+  return atlas;
+}
+
+// Packs the pairs into new pages, as few as possible, and draws and uploads
+// the pages.
+//
+// Returns null if the pairs do not fit in the maximum number of pages.
+static std::shared_ptr<GlyphAtlas> RebuildAtlas(
+    GlyphAtlas::Type type,
+    const std::shared_ptr<GlyphAtlas>& last_atlas,
+    const FontGlyphPair::Vector& font_glyph_pairs,
+    GlyphAtlasContext& atlas_context,
+    const std::shared_ptr<Allocator>& allocator) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
 
   // ---------------------------------------------------------------------------
-  // Step 4: Get the optimum size of the texture atlas.
+  // Step 1: Get the optimum size of the texture atlas. If the glyphs do not
+  //         fit in a single page, spread them over pages of the maximum size.
   // ---------------------------------------------------------------------------
   auto glyph_atlas = std::make_shared<GlyphAtlas>(type);
-  auto atlas_size = OptimumAtlasSizeForFontGlyphPairs(
-      font_glyph_pairs, glyph_positions, atlas_context);
+  atlas_context.UpdateGlyphAtlas(glyph_atlas);
+  atlas_context.ResetPages();
 
-  atlas_context->UpdateGlyphAtlas(glyph_atlas, atlas_size);
-  if (atlas_size.IsEmpty()) {
+  std::vector<GlyphPlacement> placements;
+  std::vector<Rect> glyph_positions;
+  std::shared_ptr<GrRectanizer> rect_packer;
+  auto atlas_size = OptimumAtlasSizeForFontGlyphPairs(
+      font_glyph_pairs, type, glyph_positions, atlas_context.GetMaxPageSize(),
+      rect_packer);
+  if (!atlas_size.IsEmpty()) {
+    atlas_context.AddPage(atlas_size, std::move(rect_packer));
+    // -------------------------------------------------------------------------
+    // Step 2: Find location of font-glyph pairs in the atlas. We have this from
+    // the last step. So no need to do create another rect packer. But just do
+    // a sanity check of counts. This could also be just an assertion as only a
+    // construction issue would cause such a failure.
+    // -------------------------------------------------------------------------
+    if (glyph_positions.size() != font_glyph_pairs.size()) {
+      return nullptr;
+    }
+    for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
+      placements.push_back({font_glyph_pairs[i], 0u, glyph_positions[i]});
+    }
+  } else if (!PackPairsIntoPages(font_glyph_pairs, type,
+                                 /*allow_new_pages=*/true, atlas_context,
+                                 placements)
+                  .empty()) {
     return nullptr;
   }
+
   // ---------------------------------------------------------------------------
-  // Step 5: Find location of font-glyph pairs in the atlas. We have this from
-  // the last step. So no need to do create another rect packer. But just do a
-  // sanity check of counts. This could also be just an assertion as only a
-  // construction issue would cause such a failure.
+  // Step 3: Record the positions in the glyph atlas and stop tracking the
+  //         glyphs of the previous atlas that were left out.
   // ---------------------------------------------------------------------------
-  if (glyph_positions.size() != font_glyph_pairs.size()) {
-    return nullptr;
+  for (const auto& placement : placements) {
+    glyph_atlas->AddTypefaceGlyphPosition(placement.pair, placement.bounds,
+                                          placement.page);
   }
+  last_atlas->IterateGlyphs([&](const FontGlyphPair& pair, const Rect&) {
+    if (!glyph_atlas->FindFontGlyphBounds(pair).has_value()) {
+      atlas_context.ForgetGlyph(pair);
+    }
+    return true;
+  });
 
   // ---------------------------------------------------------------------------
-  // Step 6: Record the positions in the glyph atlas.
+  // Step 4: Draw font-glyph pairs in the correct spot in each page and upload
+  //         the pages as textures.
   // ---------------------------------------------------------------------------
-  for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
-    glyph_atlas->AddTypefaceGlyphPosition(font_glyph_pairs[i],
-                                          glyph_positions[i]);
+  for (size_t page = 0; page < atlas_context.GetPageCount(); page++) {
+    if (!CreatePageTexture(*glyph_atlas, page, atlas_context, allocator)) {
+      return nullptr;
+    }
   }
 
-  // ---------------------------------------------------------------------------
-  // Step 7: Draw font-glyph pairs in the correct spot in the atlas.
-  // ---------------------------------------------------------------------------
-  auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
-  if (!bitmap) {
+  atlas_context.RecordRebuild();
+  return glyph_atlas;
+}
+
+std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
+    GlyphAtlas::Type type,
+    std::shared_ptr<GlyphAtlasContext> atlas_context,
+    FrameIterator frame_iterator) const {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  if (!IsValid()) {
     return nullptr;
   }
-  atlas_context->UpdateBitmap(bitmap);
+  auto last_atlas = atlas_context->GetGlyphAtlas();
+  const auto& context = GetContext();
+  auto allocator = context->GetResourceAllocator();
 
   // ---------------------------------------------------------------------------
-  // Step 8: Upload the atlas as a texture.
+  // Step 1: Collect unique font-glyph pairs in the frame and stamp them as
+  //         used by this frame.
   // ---------------------------------------------------------------------------
-  PixelFormat format;
-  switch (type) {
-    case GlyphAtlas::Type::kSignedDistanceField:
-      ConvertBitmapToSignedDistanceField(
-          reinterpret_cast<uint8_t*>(bitmap->getPixels()), atlas_size.width,
-          atlas_size.height);
-    case GlyphAtlas::Type::kAlphaBitmap:
-      format = PixelFormat::kA8UNormInt;
-      break;
-    case GlyphAtlas::Type::kColorBitmap:
-      format = PixelFormat::kR8G8B8A8UNormInt;
-      break;
+
+  auto font_glyph_pairs = CollectUniqueFontGlyphPairs(type, frame_iterator);
+  if (font_glyph_pairs.empty()) {
+    return last_atlas;
   }
-  auto texture = UploadGlyphTextureAtlas(GetContext()->GetResourceAllocator(),
-                                         bitmap, atlas_size, format);
-  if (!texture) {
-    return nullptr;
+  atlas_context->AdvanceFrame();
+  for (const auto& pair : font_glyph_pairs) {
+    atlas_context->MarkGlyphUsed(pair);
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 2: Determine if the atlas type and font glyph pairs are compatible
+  //         with the current atlas and reuse if possible.
+  // ---------------------------------------------------------------------------
+  auto new_glyphs = last_atlas->HasSamePairs(font_glyph_pairs);
+  if (last_atlas->GetType() == type && new_glyphs.size() == 0) {
+    return last_atlas;
   }
 
   // ---------------------------------------------------------------------------
-  // Step 9: Record the texture in the glyph atlas.
+  // Step 3: Determine if the additional missing glyphs can be added to the
+  //         pages of the existing atlas without recreating it. This requires
+  //         that the type is identical.
   // ---------------------------------------------------------------------------
-  glyph_atlas->SetTexture(std::move(texture));
+  if (last_atlas->GetType() == type) {
+    if (auto atlas = AppendToExistingAtlas(last_atlas, new_glyphs,
+                                           *atlas_context, *context)) {
+      return atlas;
+    }
 
-  return glyph_atlas;
+    // -------------------------------------------------------------------------
+    // Step 4: The atlas has to be recreated, which is usually because its
+    //         only page must grow. Keep the glyphs of the previous atlas if
+    //         they still fit so that they need not be added again later.
+    // -------------------------------------------------------------------------
+    auto all_glyphs = font_glyph_pairs;
+    last_atlas->IterateGlyphs([&](const FontGlyphPair& pair, const Rect&) {
+      if (atlas_context->GetGlyphLastUsedFrame(pair) !=
+          atlas_context->GetFrame()) {
+        all_glyphs.push_back(pair);
+      }
+      return true;
+    });
+    if (all_glyphs.size() > font_glyph_pairs.size()) {
+      if (auto atlas = RebuildAtlas(type, last_atlas, all_glyphs,
+                                    *atlas_context, allocator)) {
+        return atlas;
+      }
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 5: Recreate the atlas with only the glyphs of this frame.
+  // ---------------------------------------------------------------------------
+  return RebuildAtlas(type, last_atlas, font_glyph_pairs, *atlas_context,
+                      allocator);
 }
 
 }  // namespace impeller
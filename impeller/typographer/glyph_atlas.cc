@@ -4,13 +4,26 @@
 
 #include "impeller/typographer/glyph_atlas.h"
 
+#include <atomic>
 #include <utility>
 
+#include "flutter/fml/logging.h"
+
 namespace impeller {
 
-GlyphAtlasContext::GlyphAtlasContext()
-    : atlas_(std::make_shared<GlyphAtlas>(GlyphAtlas::Type::kAlphaBitmap)),
-      atlas_size_(ISize(0, 0)) {}
+GlyphAtlasContext::GlyphAtlasContext(
+    ISize page_size,
+    size_t max_page_count,
+    std::shared_ptr<fml::BasicTaskRunner> worker_task_runner,
+    size_t worker_count)
+    : max_page_size_(page_size),
+      max_page_count_(max_page_count),
+      worker_task_runner_(std::move(worker_task_runner)),
+      worker_count_(worker_task_runner_ ? worker_count : 0u),
+      atlas_(std::make_shared<GlyphAtlas>(GlyphAtlas::Type::kAlphaBitmap)) {
+  FML_DCHECK(!max_page_size_.IsEmpty());
+  FML_DCHECK(max_page_count_ > 0u);
+}
 
 GlyphAtlasContext::~GlyphAtlasContext() {}
 
@@ -18,39 +31,170 @@ std::shared_ptr<GlyphAtlas> GlyphAtlasContext::GetGlyphAtlas() const {
   return atlas_;
 }
 
-const ISize& GlyphAtlasContext::GetAtlasSize() const {
-  return atlas_size_;
+const ISize& GlyphAtlasContext::GetMaxPageSize() const {
+  return max_page_size_;
+}
+
+size_t GlyphAtlasContext::GetMaxPageCount() const {
+  return max_page_count_;
+}
+
+const std::shared_ptr<fml::BasicTaskRunner>&
+GlyphAtlasContext::GetWorkerTaskRunner() const {
+  return worker_task_runner_;
+}
+
+size_t GlyphAtlasContext::GetWorkerCount() const {
+  return worker_count_;
 }
 
-std::shared_ptr<SkBitmap> GlyphAtlasContext::GetBitmap() const {
-  return bitmap_;
+size_t GlyphAtlasContext::GetPageCount() const {
+  return pages_.size();
 }
 
-std::shared_ptr<skgpu::Rectanizer> GlyphAtlasContext::GetRectPacker() const {
-  return rect_packer_;
+ISize GlyphAtlasContext::GetAtlasSize(size_t page) const {
+  if (page >= pages_.size()) {
+    return ISize(0, 0);
+  }
+  return pages_[page].size;
+}
+
+std::shared_ptr<SkBitmap> GlyphAtlasContext::GetBitmap(size_t page) const {
+  if (page >= pages_.size()) {
+    return nullptr;
+  }
+  return pages_[page].bitmap;
+}
+
+std::shared_ptr<skgpu::Rectanizer> GlyphAtlasContext::GetRectPacker(
+    size_t page) const {
+  if (page >= pages_.size()) {
+    return nullptr;
+  }
+  return pages_[page].rect_packer;
 }
 
-void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas,
-                                         ISize size) {
+void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas) {
   atlas_ = std::move(atlas);
-  atlas_size_ = size;
 }
 
-void GlyphAtlasContext::UpdateBitmap(std::shared_ptr<SkBitmap> bitmap) {
-  bitmap_ = std::move(bitmap);
+void GlyphAtlasContext::ResetPages() {
+  pages_.clear();
 }
 
-void GlyphAtlasContext::UpdateRectPacker(
+void GlyphAtlasContext::TruncatePages(size_t page_count) {
+  if (page_count < pages_.size()) {
+    pages_.resize(page_count);
+  }
+}
+
+size_t GlyphAtlasContext::AddPage(
+    ISize size,
     std::shared_ptr<skgpu::Rectanizer> rect_packer) {
-  rect_packer_ = std::move(rect_packer);
+  pages_.push_back({
+      .size = size,
+      .bitmap = nullptr,
+      .rect_packer = std::move(rect_packer),
+  });
+  return pages_.size() - 1;
+}
+
+void GlyphAtlasContext::UpdateBitmap(std::shared_ptr<SkBitmap> bitmap,
+                                     size_t page) {
+  FML_DCHECK(page < pages_.size());
+  pages_[page].bitmap = std::move(bitmap);
+}
+
+void GlyphAtlasContext::UpdateRectPacker(
+    std::shared_ptr<skgpu::Rectanizer> rect_packer,
+    size_t page) {
+  FML_DCHECK(page < pages_.size());
+  pages_[page].rect_packer = std::move(rect_packer);
+}
+
+uint64_t GlyphAtlasContext::AdvanceFrame() {
+  return ++frame_;
 }
 
-GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
+uint64_t GlyphAtlasContext::GetFrame() const {
+  return frame_;
+}
+
+void GlyphAtlasContext::MarkGlyphUsed(const FontGlyphPair& pair) {
+  last_used_frames_[pair] = frame_;
+}
+
+uint64_t GlyphAtlasContext::GetGlyphLastUsedFrame(
+    const FontGlyphPair& pair) const {
+  auto found = last_used_frames_.find(pair);
+  if (found == last_used_frames_.end()) {
+    return 0u;
+  }
+  return found->second;
+}
+
+void GlyphAtlasContext::ForgetGlyph(const FontGlyphPair& pair) {
+  last_used_frames_.erase(pair);
+}
+
+const GlyphAtlasContext::Statistics& GlyphAtlasContext::GetStatistics() const {
+  return statistics_;
+}
+
+void GlyphAtlasContext::RecordRebuild() {
+  statistics_.rebuild_count++;
+}
+
+void GlyphAtlasContext::RecordPageAdded() {
+  statistics_.page_add_count++;
+}
+
+void GlyphAtlasContext::RecordEviction(size_t glyph_count) {
+  statistics_.page_eviction_count++;
+  statistics_.evicted_glyph_count += glyph_count;
+}
+
+void GlyphAtlasContext::RecordUpload(size_t bytes, size_t region_count) {
+  statistics_.uploaded_bytes += bytes;
+  statistics_.uploaded_region_count += region_count;
+}
+
+void GlyphAtlasContext::RecordRasterization(size_t glyph_count) {
+  statistics_.rasterized_glyph_count += glyph_count;
+}
+
+// Generations are handed out from a single counter so that an atlas never
+// shares a generation with another one, which may live at the same address
+// as an atlas that was destroyed.
+static uint64_t NextGlyphAtlasGeneration() {
+  static std::atomic_uint64_t next_generation = 1u;
+  return next_generation++;
+}
+
+Font GlyphAtlas::GetAtlasFont(Type type, const Font& font) {
+  auto metrics = font.GetMetrics();
+  if (type != Type::kSignedDistanceField || metrics.point_size <= 0) {
+    return font;
+  }
+  metrics.scale = kSignedDistanceFieldEmSize / metrics.point_size;
+  return Font(font.GetTypeface(), metrics);
+}
+
+GlyphAtlas::GlyphAtlas(Type type)
+    : type_(type), generation_(NextGlyphAtlasGeneration()) {}
 
 GlyphAtlas::~GlyphAtlas() = default;
 
 bool GlyphAtlas::IsValid() const {
-  return !!texture_;
+  if (textures_.empty()) {
+    return false;
+  }
+  for (const auto& texture : textures_) {
+    if (!texture) {
+      return false;
+    }
+  }
+  return true;
 }
 
 GlyphAtlas::Type GlyphAtlas::GetType() const {
@@ -58,16 +202,51 @@ GlyphAtlas::Type GlyphAtlas::GetType() const {
 }
 
 const std::shared_ptr<Texture>& GlyphAtlas::GetTexture() const {
-  return texture_;
+  return GetTexture(0u);
+}
+
+const std::shared_ptr<Texture>& GlyphAtlas::GetTexture(size_t page) const {
+  static const std::shared_ptr<Texture> kNoTexture;
+  if (page >= textures_.size()) {
+    return kNoTexture;
+  }
+  return textures_[page];
+}
+
+size_t GlyphAtlas::GetPageCount() const {
+  return textures_.size();
+}
+
+uint64_t GlyphAtlas::GetGeneration() const {
+  return generation_;
 }
 
 void GlyphAtlas::SetTexture(std::shared_ptr<Texture> texture) {
-  texture_ = std::move(texture);
+  SetTexture(0u, std::move(texture));
+}
+
+void GlyphAtlas::SetTexture(size_t page, std::shared_ptr<Texture> texture) {
+  if (page >= textures_.size()) {
+    textures_.resize(page + 1);
+  }
+  if (textures_[page] && textures_[page] != texture) {
+    generation_ = NextGlyphAtlasGeneration();
+  }
+  textures_[page] = std::move(texture);
 }
 
 void GlyphAtlas::AddTypefaceGlyphPosition(const FontGlyphPair& pair,
-                                          Rect rect) {
-  positions_[pair] = rect;
+                                          Rect rect,
+                                          size_t page) {
+  auto [position, inserted] =
+      positions_.try_emplace(pair, GlyphLocation{.page = page, .bounds = rect});
+  if (inserted) {
+    return;
+  }
+  if (position->second.page != page || !(position->second.bounds == rect)) {
+    position->second = {.page = page, .bounds = rect};
+    generation_ = NextGlyphAtlasGeneration();
+  }
 }
 
 std::optional<Rect> GlyphAtlas::FindFontGlyphBounds(
@@ -76,6 +255,15 @@ std::optional<Rect> GlyphAtlas::FindFontGlyphBounds(
   if (found == positions_.end()) {
     return std::nullopt;
   }
+  return found->second.bounds;
+}
+
+std::optional<GlyphAtlas::GlyphLocation> GlyphAtlas::FindFontGlyphLocation(
+    const FontGlyphPair& pair) const {
+  auto found = positions_.find(pair);
+  if (found == positions_.end()) {
+    return std::nullopt;
+  }
   return found->second;
 }
 
@@ -93,7 +281,28 @@ size_t GlyphAtlas::IterateGlyphs(
   size_t count = 0u;
   for (const auto& position : positions_) {
     count++;
-    if (!iterator(position.first, position.second)) {
+    if (!iterator(position.first, position.second.bounds)) {
+      return count;
+    }
+  }
+  return count;
+}
+
+size_t GlyphAtlas::IteratePageGlyphs(
+    size_t page,
+    const std::function<bool(const FontGlyphPair& pair, const Rect& rect)>&
+        iterator) const {
+  if (!iterator) {
+    return 0u;
+  }
+
+  size_t count = 0u;
+  for (const auto& position : positions_) {
+    if (position.second.page != page) {
+      continue;
+    }
+    count++;
+    if (!iterator(position.first, position.second.bounds)) {
       return count;
     }
   }
@@ -111,4 +320,67 @@ FontGlyphPair::Vector GlyphAtlas::HasSamePairs(
   return new_pairs;
 }
 
+// Whether uploading the union of two regions is cheaper than uploading them
+// separately.
+static bool ShouldMergeRegions(const IRect& a, const IRect& b) {
+  return a.Union(b).size.Area() <= a.size.Area() + b.size.Area() +
+                                       GlyphAtlas::kRegionUploadCostInPixels;
+}
+
+void GlyphAtlas::AddDirtyRegion(size_t page, const IRect& region) {
+  if (region.IsEmpty()) {
+    return;
+  }
+  if (page >= dirty_regions_.size()) {
+    dirty_regions_.resize(page + 1);
+  }
+  auto& regions = dirty_regions_[page];
+
+  // Merging two regions grows the merged region, which may now be worth
+  // merging with, or overlap, regions that were kept apart before.
+  auto merged = region;
+  for (auto found = true; found;) {
+    found = false;
+    for (auto it = regions.begin(); it != regions.end(); ++it) {
+      if (ShouldMergeRegions(merged, *it) ||
+          merged.Intersection(*it).has_value()) {
+        merged = merged.Union(*it);
+        regions.erase(it);
+        found = true;
+        break;
+      }
+    }
+  }
+
+  if (regions.size() < kMaxDirtyRegionsPerPage) {
+    regions.push_back(merged);
+    return;
+  }
+
+  // There are too many regions, so merge with the one that grows the least
+  // and merge again with the regions that the result now covers.
+  auto cheapest = regions.begin();
+  for (auto it = regions.begin(); it != regions.end(); ++it) {
+    if (merged.Union(*it).size.Area() - it->size.Area() <
+        merged.Union(*cheapest).size.Area() - cheapest->size.Area()) {
+      cheapest = it;
+    }
+  }
+  merged = merged.Union(*cheapest);
+  regions.erase(cheapest);
+  AddDirtyRegion(page, merged);
+}
+
+const std::vector<IRect>& GlyphAtlas::GetDirtyRegions(size_t page) const {
+  static const std::vector<IRect> kNoRegions;
+  if (page >= dirty_regions_.size()) {
+    return kNoRegions;
+  }
+  return dirty_regions_[page];
+}
+
+void GlyphAtlas::ClearDirtyRegions() {
+  dirty_regions_.clear();
+}
+
 }  // namespace impeller
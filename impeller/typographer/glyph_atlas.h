@@ -8,8 +8,10 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
 #include "impeller/core/texture.h"
 #include "impeller/geometry/rect.h"
 #include "impeller/renderer/pipeline.h"
@@ -27,6 +29,9 @@ namespace impeller {
 ///             different fonts along with the ability to query the location of
 ///             specific font glyphs within the texture.
 ///
+///             The glyphs may be spread over several pages, each of which
+///             is a separate texture.
+///
 class GlyphAtlas {
  public:
   //----------------------------------------------------------------------------
@@ -52,6 +57,46 @@ class GlyphAtlas {
     kColorBitmap,
   };
 
+  //----------------------------------------------------------------------------
+  /// The size of the em square, in pixels, at which the glyphs of
+  /// signed-distance-field atlases are rasterized, whatever scale they are
+  /// drawn at.
+  ///
+  static constexpr Scalar kSignedDistanceFieldEmSize = 48.0f;
+
+  //----------------------------------------------------------------------------
+  /// The distance, in pixels, from the outline of a glyph at which its
+  /// signed-distance field saturates. The glyphs of signed-distance-field
+  /// atlases are surrounded by this much room for the field.
+  ///
+  static constexpr int kSignedDistanceFieldSpread = 8;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the font that the glyphs of a font are rasterized with
+  ///             in an atlas of the given type.
+  ///
+  ///             Signed-distance-field atlases rasterize the glyphs of a font
+  ///             at a fixed size, so that they can be drawn at any scale
+  ///             without being rasterized again. Other atlases use the font
+  ///             as is.
+  ///
+  /// @param[in]  type  The type of the atlas
+  /// @param[in]  font  The font of the glyphs as they are drawn
+  ///
+  /// @return     The font of the glyphs in the atlas.
+  ///
+  static Font GetAtlasFont(Type type, const Font& font);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The location of a font-glyph pair in the atlas.
+  ///
+  struct GlyphLocation {
+    /// The index of the page that contains the glyph.
+    size_t page = 0u;
+    /// The bounds of the glyph within the page.
+    Rect bounds;
+  };
+
   //----------------------------------------------------------------------------
   /// @brief      Create an empty glyph atlas.
   ///
@@ -69,27 +114,66 @@ class GlyphAtlas {
   Type GetType() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Set the texture for the glyph atlas.
+  /// @brief      Set the texture for the first page of the glyph atlas.
   ///
   /// @param[in]  texture  The texture
   ///
   void SetTexture(std::shared_ptr<Texture> texture);
 
   //----------------------------------------------------------------------------
-  /// @brief      Get the texture for the glyph atlas.
+  /// @brief      Set the texture for a page of the glyph atlas, adding pages
+  ///             as necessary.
+  ///
+  /// @param[in]  page     The index of the page
+  /// @param[in]  texture  The texture
+  ///
+  void SetTexture(size_t page, std::shared_ptr<Texture> texture);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the texture for the first page of the glyph atlas.
   ///
   /// @return     The texture.
   ///
   const std::shared_ptr<Texture>& GetTexture() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the texture for a page of the glyph atlas.
+  ///
+  /// @param[in]  page  The index of the page
+  ///
+  /// @return     The texture, or null if there is no such page.
+  ///
+  const std::shared_ptr<Texture>& GetTexture(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the number of pages in the glyph atlas.
+  ///
+  size_t GetPageCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get a value that changes whenever a glyph that is already in
+  ///             the atlas may have moved, or the texture of a page that
+  ///             holds glyphs was replaced. Adding glyphs or pages leaves it
+  ///             unchanged. No two atlases share a generation.
+  ///
+  ///             Anything derived from the locations of glyphs in the atlas
+  ///             remains valid while the generation is unchanged.
+  ///
+  /// @return     The generation.
+  ///
+  uint64_t GetGeneration() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Record the location of a specific font-glyph pair within the
   ///             atlas.
   ///
   /// @param[in]  pair  The font-glyph pair
   /// @param[in]  rect  The rectangle
+  /// @param[in]  page  The index of the page that contains the rectangle
   ///
-  void AddTypefaceGlyphPosition(const FontGlyphPair& pair, Rect rect);
+  void AddTypefaceGlyphPosition(const FontGlyphPair& pair,
+                                Rect rect,
+                                size_t page = 0u);
 
   //----------------------------------------------------------------------------
   /// @brief      Get the number of unique font-glyph pairs in this atlas.
@@ -111,6 +195,21 @@ class GlyphAtlas {
       const std::function<bool(const FontGlyphPair& pair, const Rect& rect)>&
           iterator) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Iterate of the glyphs on a single page along with their
+  ///             locations in the page.
+  ///
+  /// @param[in]  page      The index of the page
+  /// @param[in]  iterator  The iterator. Return `false` from the iterator to
+  ///                       stop iterating.
+  ///
+  /// @return     The number of glyphs iterated over.
+  ///
+  size_t IteratePageGlyphs(
+      size_t page,
+      const std::function<bool(const FontGlyphPair& pair, const Rect& rect)>&
+          iterator) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Find the location of a specific font-glyph pair in the atlas.
   ///
@@ -121,6 +220,18 @@ class GlyphAtlas {
   ///
   std::optional<Rect> FindFontGlyphBounds(const FontGlyphPair& pair) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the page and location of a specific font-glyph pair in
+  ///             the atlas.
+  ///
+  /// @param[in]  pair  The font-glyph pair
+  ///
+  /// @return     The location of the font-glyph pair in the atlas.
+  ///             `std::nullopt` of the pair in not in the atlas.
+  ///
+  std::optional<GlyphLocation> FindFontGlyphLocation(
+      const FontGlyphPair& pair) const;
+
   //----------------------------------------------------------------------------
   /// @brief      whether this atlas contains all of the same font-glyph pairs
   ///             as the vector.
@@ -132,12 +243,55 @@ class GlyphAtlas {
   ///
   FontGlyphPair::Vector HasSamePairs(const FontGlyphPair::Vector& new_glyphs);
 
+  //----------------------------------------------------------------------------
+  /// The number of pixels that an upload of a region costs beyond the pixels
+  /// of the region. Regions are merged while the merged region wastes fewer
+  /// pixels than this.
+  ///
+  static constexpr int64_t kRegionUploadCostInPixels = 4096;
+
+  //----------------------------------------------------------------------------
+  /// The maximum number of dirty regions tracked per page. Beyond this,
+  /// regions are merged with the region that grows the least.
+  ///
+  static constexpr size_t kMaxDirtyRegionsPerPage = 8u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark a region of a page as changed since the texture of the
+  ///             page was last uploaded.
+  ///
+  ///             Nearby regions are merged so that the regions stay few and
+  ///             each upload is worth its fixed cost.
+  ///
+  /// @param[in]  page    The index of the page
+  /// @param[in]  region  The region of the page, in pixels
+  ///
+  void AddDirtyRegion(size_t page, const IRect& region);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the regions of a page that changed since the texture of
+  ///             the page was last uploaded. The regions do not overlap.
+  ///
+  /// @param[in]  page  The index of the page
+  ///
+  /// @return     The dirty regions of the page.
+  ///
+  const std::vector<IRect>& GetDirtyRegions(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget the dirty regions of all pages, which is done once
+  ///             they were uploaded.
+  ///
+  void ClearDirtyRegions();
+
  private:
   const Type type_;
-  std::shared_ptr<Texture> texture_;
+  uint64_t generation_;
+  std::vector<std::shared_ptr<Texture>> textures_;
+  std::vector<std::vector<IRect>> dirty_regions_;
 
   std::unordered_map<FontGlyphPair,
-                     Rect,
+                     GlyphLocation,
                      FontGlyphPair::Hash,
                      FontGlyphPair::Equal>
       positions_;
@@ -148,9 +302,63 @@ class GlyphAtlas {
 //------------------------------------------------------------------------------
 /// @brief      A container for caching a glyph atlas across frames.
 ///
+///             The context owns the bitmap and the rect packer of every page
+///             of the atlas so that glyphs can be added to the pages that
+///             still have room without repacking the others. It also stamps
+///             every glyph with the last frame that used it, so that the
+///             glyphs that went cold can be evicted from a page once all
+///             pages are full instead of rebuilding the whole atlas.
+///
 class GlyphAtlasContext {
  public:
-  GlyphAtlasContext();
+  //----------------------------------------------------------------------------
+  /// The maximum size of a page. Pages added to an existing atlas are
+  /// allocated at this size while the first page is only as large as needed
+  /// to fit the glyphs it was created with.
+  ///
+  static constexpr ISize kDefaultPageSize = ISize(2048, 2048);
+
+  //----------------------------------------------------------------------------
+  /// The number of pages beyond which glyphs are evicted to make room.
+  ///
+  static constexpr size_t kDefaultMaxPageCount = 4u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counters for the work done to keep the atlas up to date.
+  ///
+  struct Statistics {
+    /// The number of times all glyphs were repacked into new pages.
+    size_t rebuild_count = 0u;
+    /// The number of pages that were added to an existing atlas.
+    size_t page_add_count = 0u;
+    /// The number of times cold glyphs were evicted from a page.
+    size_t page_eviction_count = 0u;
+    /// The number of glyphs that were evicted.
+    size_t evicted_glyph_count = 0u;
+    /// The number of bytes of pixel data uploaded to textures.
+    size_t uploaded_bytes = 0u;
+    /// The number of regions of existing pages that were uploaded.
+    size_t uploaded_region_count = 0u;
+    /// The number of glyphs that were rasterized.
+    size_t rasterized_glyph_count = 0u;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Create an empty glyph atlas context.
+  ///
+  /// @param[in]  page_size           The maximum size of a page.
+  /// @param[in]  max_page_count      The maximum number of pages.
+  /// @param[in]  worker_task_runner  The task runner used to rasterize new
+  ///                                 glyphs in parallel, or nullptr to
+  ///                                 rasterize them on the calling thread.
+  /// @param[in]  worker_count        The number of tasks that can run
+  ///                                 concurrently on the worker task runner.
+  ///
+  explicit GlyphAtlasContext(
+      ISize page_size = kDefaultPageSize,
+      size_t max_page_count = kDefaultMaxPageCount,
+      std::shared_ptr<fml::BasicTaskRunner> worker_task_runner = nullptr,
+      size_t worker_count = 0u);
 
   ~GlyphAtlasContext();
 
@@ -159,30 +367,119 @@ class GlyphAtlasContext {
   std::shared_ptr<GlyphAtlas> GetGlyphAtlas() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the size of the current glyph atlas.
-  const ISize& GetAtlasSize() const;
+  /// @brief      Retrieve the maximum size of a page.
+  const ISize& GetMaxPageSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the maximum number of pages.
+  size_t GetMaxPageCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the task runner used to rasterize glyphs in
+  ///             parallel, if any.
+  const std::shared_ptr<fml::BasicTaskRunner>& GetWorkerTaskRunner() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the number of tasks that can run concurrently on
+  ///             the worker task runner.
+  size_t GetWorkerCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the number of pages of the current glyph atlas.
+  size_t GetPageCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the size of a page of the current glyph atlas.
+  ISize GetAtlasSize(size_t page = 0u) const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the previous (if any) SkBitmap instance.
-  std::shared_ptr<SkBitmap> GetBitmap() const;
+  /// @brief      Retrieve the previous (if any) SkBitmap instance of a page.
+  std::shared_ptr<SkBitmap> GetBitmap(size_t page = 0u) const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the previous (if any) rect packer.
-  std::shared_ptr<skgpu::Rectanizer> GetRectPacker() const;
+  /// @brief      Retrieve the previous (if any) rect packer of a page.
+  std::shared_ptr<skgpu::Rectanizer> GetRectPacker(size_t page = 0u) const;
 
   //----------------------------------------------------------------------------
   /// @brief      Update the context with a newly constructed glyph atlas.
-  void UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas, ISize size);
+  void UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas);
 
-  void UpdateBitmap(std::shared_ptr<SkBitmap> bitmap);
+  //----------------------------------------------------------------------------
+  /// @brief      Discard all pages.
+  void ResetPages();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Discard the pages after the first |page_count| pages.
+  void TruncatePages(size_t page_count);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Add a page of the given size.
+  ///
+  /// @return     The index of the new page.
+  ///
+  size_t AddPage(ISize size, std::shared_ptr<skgpu::Rectanizer> rect_packer);
+
+  void UpdateBitmap(std::shared_ptr<SkBitmap> bitmap, size_t page = 0u);
 
-  void UpdateRectPacker(std::shared_ptr<skgpu::Rectanizer> rect_packer);
+  void UpdateRectPacker(std::shared_ptr<skgpu::Rectanizer> rect_packer,
+                        size_t page = 0u);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Start a new frame for the purpose of tracking glyph usage.
+  ///
+  /// @return     The number of the new frame.
+  ///
+  uint64_t AdvanceFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of the current frame.
+  uint64_t GetFrame() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stamp a glyph as used by the current frame.
+  void MarkGlyphUsed(const FontGlyphPair& pair);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of the last frame that used a glyph, or zero if
+  ///             the glyph was never used.
+  uint64_t GetGlyphLastUsedFrame(const FontGlyphPair& pair) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stop tracking the usage of a glyph that left the atlas.
+  void ForgetGlyph(const FontGlyphPair& pair);
+
+  const Statistics& GetStatistics() const;
+
+  void RecordRebuild();
+
+  void RecordPageAdded();
+
+  void RecordEviction(size_t glyph_count);
+
+  void RecordUpload(size_t bytes, size_t region_count = 0u);
+
+  void RecordRasterization(size_t glyph_count);
 
  private:
+  struct Page {
+    ISize size;
+    std::shared_ptr<SkBitmap> bitmap;
+    std::shared_ptr<skgpu::Rectanizer> rect_packer;
+  };
+
+  const ISize max_page_size_;
+  const size_t max_page_count_;
+  const std::shared_ptr<fml::BasicTaskRunner> worker_task_runner_;
+  const size_t worker_count_;
   std::shared_ptr<GlyphAtlas> atlas_;
-  ISize atlas_size_;
-  std::shared_ptr<SkBitmap> bitmap_;
-  std::shared_ptr<skgpu::Rectanizer> rect_packer_;
+  std::vector<Page> pages_;
+  uint64_t frame_ = 0u;
+  std::unordered_map<FontGlyphPair,
+                     uint64_t,
+                     FontGlyphPair::Hash,
+                     FontGlyphPair::Equal>
+      last_used_frames_;
+  Statistics statistics_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GlyphAtlasContext);
 };
@@ -18,6 +18,7 @@ LazyGlyphAtlas::~LazyGlyphAtlas() = default;
 
 void LazyGlyphAtlas::AddTextFrame(const TextFrame& frame) {
   FML_DCHECK(atlas_map_.empty());
+  FML_DCHECK(!sdf_identities_.has_value());
   has_color_ |= frame.HasColor();
   frames_.emplace_back(frame);
 }
@@ -26,6 +27,42 @@ bool LazyGlyphAtlas::HasColor() const {
   return has_color_;
 }
 
+// The scale the glyphs of a text frame are drawn at, which is baked into its
+// fonts when the text frame is created.
+static Scalar GetTextFrameScale(const TextFrame& frame) {
+  const auto& runs = frame.GetRuns();
+  return runs.empty() ? 1.0f : runs.front().GetFont().GetMetrics().scale;
+}
+
+void LazyGlyphAtlas::SortTextFrames(TextScaleTracker& tracker) const {
+  if (sdf_identities_.has_value()) {
+    return;
+  }
+  sdf_identities_.emplace();
+  for (const auto& frame : frames_) {
+    // Color glyphs have no distance field representation.
+    if (!frame.HasColor() &&
+        tracker.IsScaleAnimating(frame.GetIdentity(),
+                                 GetTextFrameScale(frame))) {
+      sdf_identities_->insert(frame.GetIdentity());
+    }
+  }
+}
+
+bool LazyGlyphAtlas::IsSignedDistanceField(const TextFrame& frame) const {
+  return sdf_identities_.has_value() &&
+         sdf_identities_->count(frame.GetIdentity()) > 0u;
+}
+
+bool LazyGlyphAtlas::IsInAtlas(const TextFrame& frame,
+                               GlyphAtlas::Type type) const {
+  if (!sdf_identities_.has_value()) {
+    return true;
+  }
+  return IsSignedDistanceField(frame) ==
+         (type == GlyphAtlas::Type::kSignedDistanceField);
+}
+
 std::shared_ptr<GlyphAtlas> LazyGlyphAtlas::CreateOrGetGlyphAtlas(
     GlyphAtlas::Type type,
     std::shared_ptr<GlyphAtlasContext> atlas_context,
@@ -43,6 +80,9 @@ std::shared_ptr<GlyphAtlas> LazyGlyphAtlas::CreateOrGetGlyphAtlas(
   }
   size_t i = 0;
   TextRenderContext::FrameIterator iterator = [&]() -> const TextFrame* {
+    while (i < frames_.size() && !IsInAtlas(frames_[i], type)) {
+      i++;
+    }
     if (i >= frames_.size()) {
       return nullptr;
     }
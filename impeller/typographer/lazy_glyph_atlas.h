@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "flutter/fml/macros.h"
 #include "impeller/renderer/context.h"
 #include "impeller/typographer/glyph_atlas.h"
 #include "impeller/typographer/text_frame.h"
+#include "impeller/typographer/text_scale_tracker.h"
 
 namespace impeller {
 
@@ -21,6 +24,28 @@ class LazyGlyphAtlas {
 
   void AddTextFrame(const TextFrame& frame);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sort the text frames into the atlases they are drawn from.
+  ///             Text frames whose scale is animating go to the signed
+  ///             distance field atlas, and all others go to the bitmap
+  ///             atlases.
+  ///
+  ///             Only the first call sorts the text frames, using the scales
+  ///             they were added at, so every text frame stays in one atlas
+  ///             for the whole scene. Atlases created before the text frames
+  ///             are sorted hold the glyphs of all text frames.
+  ///
+  /// @param[in]  tracker  The tracker of the scales text frames were drawn at
+  ///                      in previous scenes.
+  ///
+  void SortTextFrames(TextScaleTracker& tracker) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the text frame was sorted into the signed distance
+  ///             field atlas.
+  ///
+  bool IsSignedDistanceField(const TextFrame& frame) const;
+
   std::shared_ptr<GlyphAtlas> CreateOrGetGlyphAtlas(
       GlyphAtlas::Type type,
       std::shared_ptr<GlyphAtlasContext> atlas_context,
@@ -32,8 +57,13 @@ class LazyGlyphAtlas {
   std::vector<TextFrame> frames_;
   mutable std::unordered_map<GlyphAtlas::Type, std::shared_ptr<GlyphAtlas>>
       atlas_map_;
+  // The identities of the text frames drawn from the signed distance field
+  // atlas, once the text frames are sorted.
+  mutable std::optional<std::unordered_set<uint64_t>> sdf_identities_;
   bool has_color_ = false;
 
+  bool IsInAtlas(const TextFrame& frame, GlyphAtlas::Type type) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(LazyGlyphAtlas);
 };
 
@@ -46,6 +46,14 @@ bool TextFrame::HasColor() const {
   return has_color_;
 }
 
+void TextFrame::SetIdentity(uint64_t identity) {
+  identity_ = identity;
+}
+
+uint64_t TextFrame::GetIdentity() const {
+  return identity_;
+}
+
 bool TextFrame::MaybeHasOverlapping() const {
   if (runs_.size() > 1) {
     return true;
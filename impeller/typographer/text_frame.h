@@ -66,9 +66,26 @@ class TextFrame {
   /// @brief      Whether any run in this frame has color.
   bool HasColor() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Set a value that identifies the source of this frame, such
+  ///             as the unique ID of the text blob it was made from.
+  ///
+  ///             Frames with the same non-zero identity must have the same
+  ///             runs, which allows their layout to be cached.
+  ///
+  /// @param[in]  identity  The identity, or zero if it is unknown.
+  ///
+  void SetIdentity(uint64_t identity);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The value that identifies the source of this frame, or zero
+  ///             if it is unknown.
+  uint64_t GetIdentity() const;
+
  private:
   std::vector<TextRun> runs_;
   bool has_color_ = false;
+  uint64_t identity_ = 0u;
 };
 
 }  // namespace impeller
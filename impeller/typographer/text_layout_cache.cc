@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/typographer/text_layout_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+TextLayoutCache::TextLayoutCache() = default;
+
+TextLayoutCache::~TextLayoutCache() = default;
+
+std::shared_ptr<const TextLayoutCache::Layout>
+TextLayoutCache::GetOrBuildLayout(const Key& key,
+                                  const GlyphAtlas& atlas,
+                                  const LayoutBuilder& builder) {
+  auto generation = atlas_generations_.find(atlas.GetType());
+  if (generation == atlas_generations_.end()) {
+    atlas_generations_[atlas.GetType()] = atlas.GetGeneration();
+  } else if (generation->second != atlas.GetGeneration()) {
+    DropLayoutsOfType(atlas.GetType());
+    generation->second = atlas.GetGeneration();
+  }
+
+  use_count_++;
+  if (key.frame_identity != 0u) {
+    auto found = entries_.find(key);
+    if (found != entries_.end()) {
+      statistics_.hit_count++;
+      found->second.last_use = use_count_;
+      return found->second.layout;
+    }
+  }
+
+  statistics_.miss_count++;
+  auto layout = builder();
+  if (!layout.has_value()) {
+    return nullptr;
+  }
+  statistics_.glyph_lookup_count += layout->glyph_count;
+  auto result = std::make_shared<const Layout>(std::move(layout.value()));
+  if (key.frame_identity != 0u) {
+    if (entries_.size() >= kMaxEntryCount) {
+      DropLeastRecentlyUsed();
+    }
+    entries_[key] = {.layout = result, .last_use = use_count_};
+  }
+  return result;
+}
+
+void TextLayoutCache::DropLayoutsOfType(GlyphAtlas::Type type) {
+  bool dropped = false;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->first.type == type) {
+      it = entries_.erase(it);
+      dropped = true;
+    } else {
+      ++it;
+    }
+  }
+  if (dropped) {
+    statistics_.invalidation_count++;
+  }
+}
+
+void TextLayoutCache::DropLeastRecentlyUsed() {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  std::vector<uint64_t> last_uses;
+  last_uses.reserve(entries_.size());
+  for (const auto& entry : entries_) {
+    last_uses.push_back(entry.second.last_use);
+  }
+  auto median = last_uses.begin() + last_uses.size() / 2;
+  std::nth_element(last_uses.begin(), median, last_uses.end());
+  const auto threshold = *median;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.last_use < threshold) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+size_t TextLayoutCache::GetEntryCount() const {
+  return entries_.size();
+}
+
+const TextLayoutCache::Statistics& TextLayoutCache::GetStatistics() const {
+  return statistics_;
+}
+
+}  // namespace impeller
@@ -0,0 +1,157 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/point.h"
+#include "impeller/geometry/scalar.h"
+#include "impeller/typographer/glyph_atlas.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A cache of the vertices of the glyph quads of text frames,
+///             ready to be uploaded, so that text that is drawn again need
+///             not look up each of its glyphs in the glyph atlas.
+///
+///             The layout of a frame is only valid for the atlas generation
+///             it was built with, so all layouts of an atlas type are
+///             dropped once the generation of the atlas of that type
+///             changes.
+///
+///             This class is not thread safe.
+///
+class TextLayoutCache {
+ public:
+  //----------------------------------------------------------------------------
+  /// The maximum number of layouts kept. Once reached, the least recently
+  /// used half of the layouts is dropped.
+  ///
+  static constexpr size_t kMaxEntryCount = 2048u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Identifies the layout of a text frame.
+  ///
+  struct Key {
+    /// The identity of the text frame.
+    uint64_t frame_identity = 0u;
+    /// The type of the atlas the layout samples from.
+    GlyphAtlas::Type type = GlyphAtlas::Type::kAlphaBitmap;
+    /// The scale the glyphs of the frame were rasterized at.
+    Scalar glyph_scale = 1.0f;
+    /// The scale of the transform the layout was snapped to the pixel grid
+    /// at, or zero if the layout is not snapped.
+    Vector2 pixel_scale;
+
+    struct Hash {
+      std::size_t operator()(const Key& k) const {
+        return fml::HashCombine(k.frame_identity, k.type, k.glyph_scale,
+                                k.pixel_scale.x, k.pixel_scale.y);
+      }
+    };
+
+    struct Equal {
+      bool operator()(const Key& lhs, const Key& rhs) const {
+        return lhs.frame_identity == rhs.frame_identity &&
+               lhs.type == rhs.type && lhs.glyph_scale == rhs.glyph_scale &&
+               lhs.pixel_scale == rhs.pixel_scale;
+      }
+    };
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      The vertices and indices of the glyphs of a frame that are
+  ///             on a single page of the atlas.
+  ///
+  struct PageVertices {
+    /// The index of the page.
+    size_t page = 0u;
+    /// The vertex data, in the layout of the pipeline that draws it.
+    std::vector<uint8_t> vertices;
+    /// The alignment of the vertex data.
+    size_t vertex_alignment = 1u;
+    /// The indices of the vertices.
+    std::vector<uint32_t> indices;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      The glyph quads of a text frame.
+  ///
+  struct Layout {
+    /// The vertices of the pages that have glyphs of the frame.
+    std::vector<PageVertices> pages;
+    /// The number of glyphs that were looked up in the atlas to build the
+    /// layout.
+    size_t glyph_count = 0u;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counters for the work saved by the cache.
+  ///
+  struct Statistics {
+    /// The number of layouts that were found in the cache.
+    size_t hit_count = 0u;
+    /// The number of layouts that had to be built.
+    size_t miss_count = 0u;
+    /// The number of glyphs that were looked up in the atlas to build
+    /// layouts.
+    size_t glyph_lookup_count = 0u;
+    /// The number of times the layouts of an atlas type were dropped
+    /// because the generation of the atlas changed.
+    size_t invalidation_count = 0u;
+  };
+
+  using LayoutBuilder = std::function<std::optional<Layout>()>;
+
+  TextLayoutCache();
+
+  ~TextLayoutCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the layout of a text frame, building it if it is not in
+  ///             the cache. Frames without an identity are never cached.
+  ///
+  /// @param[in]  key      The key of the layout.
+  /// @param[in]  atlas    The atlas the layout samples from.
+  /// @param[in]  builder  Builds the layout if it is not in the cache.
+  ///
+  /// @return     The layout, or null if it could not be built.
+  ///
+  std::shared_ptr<const Layout> GetOrBuildLayout(const Key& key,
+                                                 const GlyphAtlas& atlas,
+                                                 const LayoutBuilder& builder);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of layouts in the cache.
+  size_t GetEntryCount() const;
+
+  const Statistics& GetStatistics() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const Layout> layout;
+    uint64_t last_use = 0u;
+  };
+
+  std::unordered_map<Key, Entry, Key::Hash, Key::Equal> entries_;
+  std::unordered_map<GlyphAtlas::Type, uint64_t> atlas_generations_;
+  uint64_t use_count_ = 0u;
+  Statistics statistics_;
+
+  void DropLayoutsOfType(GlyphAtlas::Type type);
+
+  void DropLeastRecentlyUsed();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextLayoutCache);
+};
+
+}  // namespace impeller
@@ -0,0 +1,69 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/typographer/text_scale_tracker.h"
+
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+TextScaleTracker::TextScaleTracker() = default;
+
+TextScaleTracker::~TextScaleTracker() = default;
+
+bool TextScaleTracker::IsScaleAnimating(uint64_t identity, Scalar scale) {
+  if (identity == 0u) {
+    return false;
+  }
+
+  auto found = entries_.find(identity);
+  if (found == entries_.end()) {
+    if (entries_.size() >= kMaxEntryCount) {
+      DropStaleEntries();
+    }
+    entries_[identity] = {.scale = scale, .last_seen_frame = frame_};
+    return false;
+  }
+
+  auto& entry = found->second;
+  if (entry.last_seen_frame != frame_) {
+    if (!ScalarNearlyEqual(entry.scale, scale)) {
+      entry.scale = scale;
+      entry.last_change_frame = frame_;
+    }
+    entry.last_seen_frame = frame_;
+  }
+  return IsAnimating(entry);
+}
+
+void TextScaleTracker::AdvanceFrame() {
+  frame_++;
+}
+
+size_t TextScaleTracker::GetEntryCount() const {
+  return entries_.size();
+}
+
+bool TextScaleTracker::IsAnimating(const Entry& entry) const {
+  return entry.last_change_frame.has_value() &&
+         frame_ - entry.last_change_frame.value() < kSettleFrameCount;
+}
+
+void TextScaleTracker::DropStaleEntries() {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.last_seen_frame + kSettleFrameCount < frame_) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Every text frame was drawn recently, so there is nothing to tell them
+  // apart by. Start over rather than tracking an unbounded number of them.
+  if (entries_.size() >= kMaxEntryCount) {
+    entries_.clear();
+  }
+}
+
+}  // namespace impeller
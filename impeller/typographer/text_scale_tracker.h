@@ -0,0 +1,88 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/scalar.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Tracks the scale text frames are drawn at from frame to frame
+///             to tell which of them are under a continuous scale
+///             animation, such as a zoom.
+///
+///             The glyphs of such text would have to be rasterized again at
+///             every new scale. Drawing it from a signed distance field
+///             instead lets all scales share the same glyphs.
+///
+///             This class is not thread safe.
+///
+class TextScaleTracker {
+ public:
+  //----------------------------------------------------------------------------
+  /// The number of frames the scale of a text frame must stay the same for
+  /// before it is no longer considered to be animating.
+  ///
+  static constexpr uint64_t kSettleFrameCount = 4u;
+
+  //----------------------------------------------------------------------------
+  /// The maximum number of text frames tracked. Once reached, the text
+  /// frames that were not drawn recently are forgotten.
+  ///
+  static constexpr size_t kMaxEntryCount = 2048u;
+
+  TextScaleTracker();
+
+  ~TextScaleTracker();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record the scale a text frame is drawn at in the current
+  ///             frame and tell whether that scale is animating.
+  ///
+  ///             Only the first scale a text frame is drawn at in a frame
+  ///             is recorded.
+  ///
+  /// @param[in]  identity  The identity of the text frame. Text frames
+  ///                       without an identity are never animating.
+  /// @param[in]  scale     The scale the text frame is drawn at.
+  ///
+  /// @return     Whether the scale of the text frame changed within the last
+  ///             `kSettleFrameCount` frames.
+  ///
+  bool IsScaleAnimating(uint64_t identity, Scalar scale);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Start a new frame.
+  ///
+  void AdvanceFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of text frames tracked.
+  ///
+  size_t GetEntryCount() const;
+
+ private:
+  struct Entry {
+    Scalar scale = 1.0f;
+    uint64_t last_seen_frame = 0u;
+    std::optional<uint64_t> last_change_frame;
+  };
+
+  uint64_t frame_ = 0u;
+  std::unordered_map<uint64_t, Entry> entries_;
+
+  bool IsAnimating(const Entry& entry) const;
+
+  void DropStaleEntries();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextScaleTracker);
+};
+
+}  // namespace impeller
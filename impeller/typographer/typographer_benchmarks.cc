@@ -0,0 +1,614 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "impeller/core/allocator.h"
+#include "impeller/core/device_buffer.h"
+#include "impeller/core/formats.h"
+#include "impeller/core/texture.h"
+#include "impeller/renderer/blit_pass.h"
+#include "impeller/renderer/command_buffer.h"
+#include "impeller/renderer/context.h"
+#include "impeller/typographer/backends/skia/text_frame_skia.h"
+#include "impeller/typographer/text_layout_cache.h"
+#include "impeller/typographer/text_render_context.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace impeller {
+
+namespace {
+
+// A texture that keeps its contents in host memory, so that the cost of
+// uploads is a copy of the uploaded bytes.
+class HostTexture final : public Texture {
+ public:
+  explicit HostTexture(const TextureDescriptor& desc)
+      : Texture(desc), contents_(desc.GetByteSizeOfBaseMipLevel()) {}
+
+  // |Texture|
+  void SetLabel(std::string_view label) override {}
+
+  // |Texture|
+  bool IsValid() const override { return true; }
+
+  // |Texture|
+  ISize GetSize() const override { return GetTextureDescriptor().size; }
+
+  // Copies tightly packed rows into a region of the texture.
+  bool CopyRegion(const uint8_t* rows, const IRect& region) {
+    const auto& desc = GetTextureDescriptor();
+    if (!IRect::MakeSize(desc.size).Contains(region)) {
+      return false;
+    }
+    const size_t bytes_per_pixel = BytesPerPixelForPixelFormat(desc.format);
+    const size_t row_bytes = region.size.width * bytes_per_pixel;
+    const size_t stride = desc.size.width * bytes_per_pixel;
+    for (int64_t row = 0; row < region.size.height; row++) {
+      std::memcpy(contents_.data() + (region.origin.y + row) * stride +
+                      region.origin.x * bytes_per_pixel,
+                  rows + row * row_bytes, row_bytes);
+    }
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> contents_;
+
+  // |Texture|
+  bool OnSetContents(const uint8_t* contents,
+                     size_t length,
+                     size_t slice) override {
+    if (length > contents_.size()) {
+      return false;
+    }
+    std::memcpy(contents_.data(), contents, length);
+    return true;
+  }
+
+  // |Texture|
+  bool OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
+                     size_t slice) override {
+    return OnSetContents(mapping->GetMapping(), mapping->GetSize(), slice);
+  }
+};
+
+// A device buffer that keeps its contents in host memory.
+class HostDeviceBuffer final : public DeviceBuffer {
+ public:
+  explicit HostDeviceBuffer(const DeviceBufferDescriptor& desc)
+      : DeviceBuffer(desc), contents_(desc.size) {}
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label) override { return true; }
+
+  // |DeviceBuffer|
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+
+  // |DeviceBuffer|
+  uint8_t* OnGetContents() const override {
+    return const_cast<uint8_t*>(contents_.data());
+  }
+
+ private:
+  std::vector<uint8_t> contents_;
+
+  // |DeviceBuffer|
+  bool OnCopyHostBuffer(const uint8_t* source,
+                        Range source_range,
+                        size_t offset) override {
+    if (offset + source_range.length > contents_.size()) {
+      return false;
+    }
+    std::memcpy(contents_.data() + offset, source + source_range.offset,
+                source_range.length);
+    return true;
+  }
+};
+
+// A blit pass that copies buffers into host textures when it is encoded.
+// Other commands are not supported.
+class HostBlitPass final : public BlitPass {
+ public:
+  // |BlitPass|
+  bool IsValid() const override { return true; }
+
+  // |BlitPass|
+  bool EncodeCommands(
+      const std::shared_ptr<Allocator>& transients_allocator) const override {
+    for (const auto& copy : copies_) {
+      const auto& buffer =
+          static_cast<const DeviceBuffer&>(*copy.source.buffer);
+      const auto* source = buffer.OnGetContents() + copy.source.range.offset;
+      auto& texture = static_cast<HostTexture&>(*copy.destination);
+      if (!texture.CopyRegion(source, copy.region)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct BufferToTextureCopy {
+    BufferView source;
+    std::shared_ptr<Texture> destination;
+    IRect region;
+  };
+
+  std::vector<BufferToTextureCopy> copies_;
+
+  // |BlitPass|
+  void OnSetLabel(std::string label) override {}
+
+  // |BlitPass|
+  bool OnCopyTextureToTextureCommand(std::shared_ptr<Texture> source,
+                                     std::shared_ptr<Texture> destination,
+                                     IRect source_region,
+                                     IPoint destination_origin,
+                                     std::string label) override {
+    return false;
+  }
+
+  // |BlitPass|
+  bool OnCopyTextureToBufferCommand(std::shared_ptr<Texture> source,
+                                    std::shared_ptr<DeviceBuffer> destination,
+                                    IRect source_region,
+                                    size_t destination_offset,
+                                    std::string label) override {
+    return false;
+  }
+
+  // |BlitPass|
+  bool OnCopyBufferToTextureCommand(BufferView source,
+                                    std::shared_ptr<Texture> destination,
+                                    IRect destination_region,
+                                    std::string label) override {
+    copies_.push_back({std::move(source), std::move(destination),
+                       destination_region});
+    return true;
+  }
+
+  // |BlitPass|
+  bool OnGenerateMipmapCommand(std::shared_ptr<Texture> texture,
+                               std::string label) override {
+    return false;
+  }
+};
+
+// A command buffer that can only create blit passes, which do their work
+// when they are encoded.
+class HostCommandBuffer final : public CommandBuffer {
+ public:
+  explicit HostCommandBuffer(std::weak_ptr<const Context> context)
+      : CommandBuffer(std::move(context)) {}
+
+  // |CommandBuffer|
+  bool IsValid() const override { return true; }
+
+  // |CommandBuffer|
+  void SetLabel(const std::string& label) const override {}
+
+ private:
+  // |CommandBuffer|
+  std::shared_ptr<RenderPass> OnCreateRenderPass(
+      RenderTarget render_target) override {
+    return nullptr;
+  }
+
+  // |CommandBuffer|
+  std::shared_ptr<BlitPass> OnCreateBlitPass() const override {
+    return std::make_shared<HostBlitPass>();
+  }
+
+  // |CommandBuffer|
+  bool OnSubmitCommands(CompletionCallback callback) override {
+    if (callback) {
+      callback(Status::kCompleted);
+    }
+    return true;
+  }
+
+  // |CommandBuffer|
+  std::shared_ptr<ComputePass> OnCreateComputePass() const override {
+    return nullptr;
+  }
+};
+
+class HostAllocator final : public Allocator {
+ public:
+  // |Allocator|
+  ISize GetMaxTextureSizeSupported() const override { return {8192, 8192}; }
+
+ private:
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> OnCreateBuffer(
+      const DeviceBufferDescriptor& desc) override {
+    return std::make_shared<HostDeviceBuffer>(desc);
+  }
+
+  // |Allocator|
+  std::shared_ptr<Texture> OnCreateTexture(
+      const TextureDescriptor& desc) override {
+    return std::make_shared<HostTexture>(desc);
+  }
+};
+
+// A context that can only allocate host buffers and textures and blit
+// between them, which is all that is needed to build glyph atlases. A
+// context that does not support blits makes the atlas fall back to uploading
+// whole pages.
+class HostContext final : public Context {
+ public:
+  explicit HostContext(bool supports_blits = true)
+      : supports_blits_(supports_blits) {}
+
+  // |Context|
+  bool IsValid() const override { return true; }
+
+  // |Context|
+  const std::shared_ptr<const Capabilities>& GetCapabilities() const override {
+    return capabilities_;
+  }
+
+  // |Context|
+  std::shared_ptr<Allocator> GetResourceAllocator() const override {
+    return allocator_;
+  }
+
+  // |Context|
+  std::shared_ptr<ShaderLibrary> GetShaderLibrary() const override {
+    return nullptr;
+  }
+
+  // |Context|
+  std::shared_ptr<SamplerLibrary> GetSamplerLibrary() const override {
+    return nullptr;
+  }
+
+  // |Context|
+  std::shared_ptr<PipelineLibrary> GetPipelineLibrary() const override {
+    return nullptr;
+  }
+
+  // |Context|
+  std::shared_ptr<CommandBuffer> CreateCommandBuffer() const override {
+    if (!supports_blits_) {
+      return nullptr;
+    }
+    return std::make_shared<HostCommandBuffer>(shared_from_this());
+  }
+
+ private:
+  const bool supports_blits_;
+  std::shared_ptr<const Capabilities> capabilities_;
+  std::shared_ptr<Allocator> allocator_ = std::make_shared<HostAllocator>();
+};
+
+// Lines of text in several scripts, which are shown at several sizes to
+// produce far more unique glyphs than a single screen of text uses.
+const std::vector<std::string> kMultilingualLines = {
+    "The quick brown fox jumps over the lazy dog 0123456789",
+    "Portez ce vieux whisky au juge blond qui fume àéèêëîïôœùûüÿç",
+    "Zwölf Boxkämpfer jagen Viktor quer über den großen Sylter Deich",
+    "Τάχιστη αλώπηξ βαφής ψημένη γη, δρασκελίζει υπέρ νωθρού κυνός",
+    "Съешь же ещё этих мягких французских булок, да выпей чаю",
+    "天地玄黄宇宙洪荒日月盈昃辰宿列张寒来暑往秋收冬藏闰余成岁律吕调阳",
+    "いろはにほへとちりぬるをわかよたれそつねならむうゐのおくやまけふこえて",
+    "다람쥐 헌 쳇바퀴에 타고파 키스의 고유조건은 입술끼리 만나야 하고",
+};
+
+constexpr size_t kScrollLineCount = 400u;
+constexpr size_t kVisibleLineCount = 40u;
+
+// The scale of a line of the scroll, which cycles through the sizes of
+// typical headings, body text and captions.
+Scalar GetLineScale(size_t line) {
+  constexpr Scalar kScales[] = {1.0, 1.25, 1.5, 2.0, 0.875};
+  return kScales[(line / kMultilingualLines.size()) % std::size(kScales)];
+}
+
+// The vertex of a glyph quad, as laid out for the glyph atlas pipeline.
+struct GlyphVertex {
+  Point position;
+  Point uv;
+};
+
+// Builds the glyph quads of a frame in the same way as text contents do,
+// which looks up every glyph of the frame in the atlas.
+std::optional<TextLayoutCache::Layout> BuildGlyphLayout(
+    const TextFrame& frame,
+    const GlyphAtlas& atlas) {
+  constexpr Point kUnitPoints[] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+  constexpr uint32_t kIndices[] = {0, 1, 2, 1, 2, 3};
+  std::vector<std::vector<GlyphVertex>> page_vertices(atlas.GetPageCount());
+  TextLayoutCache::Layout layout;
+  std::vector<std::vector<uint32_t>> page_indices(atlas.GetPageCount());
+  for (const auto& run : frame.GetRuns()) {
+    for (const auto& glyph_position : run.GetGlyphPositions()) {
+      auto location = atlas.FindFontGlyphLocation(
+          FontGlyphPair{run.GetFont(), glyph_position.glyph});
+      if (!location.has_value() || location->page >= atlas.GetPageCount()) {
+        return std::nullopt;
+      }
+      layout.glyph_count++;
+      auto& vertices = page_vertices[location->page];
+      const auto index_offset = static_cast<uint32_t>(vertices.size());
+      for (auto index : kIndices) {
+        page_indices[location->page].push_back(index + index_offset);
+      }
+      for (const auto& point : kUnitPoints) {
+        vertices.push_back({
+            .position = glyph_position.position +
+                        glyph_position.glyph.bounds.origin +
+                        point * glyph_position.glyph.bounds.size,
+            .uv = location->bounds.origin + point * location->bounds.size,
+        });
+      }
+    }
+  }
+  for (size_t page = 0; page < page_vertices.size(); page++) {
+    const auto& vertices = page_vertices[page];
+    if (vertices.empty()) {
+      continue;
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(vertices.data());
+    layout.pages.push_back({
+        .page = page,
+        .vertices = std::vector<uint8_t>(
+            data, data + vertices.size() * sizeof(GlyphVertex)),
+        .vertex_alignment = alignof(GlyphVertex),
+        .indices = std::move(page_indices[page]),
+    });
+  }
+  return layout;
+}
+
+}  // namespace
+
+// Measures the cost of laying out the glyph quads of a screen of text while
+// scrolling through a long list of multilingual text, one line per frame.
+// Without the layout cache, every glyph of every visible line is looked up
+// in the atlas on every frame.
+static void BM_TextLayoutScroll(benchmark::State& state, bool use_cache) {
+  auto text_context =
+      TextRenderContext::Create(std::make_shared<HostContext>());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+  TextLayoutCache layout_cache;
+
+  SkFont sk_font;
+  sk_font.setSize(14);
+  std::vector<TextFrame> lines;
+  lines.reserve(kScrollLineCount);
+  for (size_t i = 0; i < kScrollLineCount; i++) {
+    auto blob = SkTextBlob::MakeFromString(
+        kMultilingualLines[i % kMultilingualLines.size()].c_str(), sk_font);
+    lines.push_back(TextFrameFromTextBlob(blob, GetLineScale(i)));
+  }
+
+  size_t frame_count = 0u;
+  size_t first_line = 0u;
+  while (state.KeepRunning()) {
+    size_t line = first_line;
+    TextRenderContext::FrameIterator iterator = [&]() -> const TextFrame* {
+      if (line >= first_line + kVisibleLineCount) {
+        return nullptr;
+      }
+      return &lines[line++ % kScrollLineCount];
+    };
+    auto atlas = text_context->CreateGlyphAtlas(
+        GlyphAtlas::Type::kAlphaBitmap, atlas_context, iterator);
+    if (!atlas) {
+      state.SkipWithError("Could not create the glyph atlas.");
+      break;
+    }
+    for (size_t i = 0; i < kVisibleLineCount; i++) {
+      const auto& frame = lines[(first_line + i) % kScrollLineCount];
+      TextLayoutCache::Key key;
+      key.frame_identity = use_cache ? frame.GetIdentity() : 0u;
+      key.type = atlas->GetType();
+      key.glyph_scale = GetLineScale((first_line + i) % kScrollLineCount);
+      auto layout = layout_cache.GetOrBuildLayout(
+          key, *atlas,
+          [&frame, &atlas]() { return BuildGlyphLayout(frame, *atlas); });
+      if (!layout) {
+        state.SkipWithError("Could not lay out the glyphs.");
+        break;
+      }
+      benchmark::DoNotOptimize(layout);
+    }
+    first_line = (first_line + 1) % kScrollLineCount;
+    frame_count++;
+  }
+
+  const auto& statistics = layout_cache.GetStatistics();
+  state.counters["GlyphLookupsPerFrame"] =
+      frame_count == 0u ? 0.0
+                        : static_cast<double>(statistics.glyph_lookup_count) /
+                              static_cast<double>(frame_count);
+  state.counters["LayoutHits"] = statistics.hit_count;
+  state.counters["LayoutMisses"] = statistics.miss_count;
+  state.counters["Invalidations"] = statistics.invalidation_count;
+}
+
+// Measures the cost of keeping the glyph atlas up to date while scrolling
+// through a long list of multilingual text, one line per frame. Without
+// blits, pages that gained glyphs are uploaded whole.
+static void BM_GlyphAtlasMultilingualScroll(benchmark::State& state,
+                                            bool supports_blits) {
+  auto text_context =
+      TextRenderContext::Create(std::make_shared<HostContext>(supports_blits));
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+
+  SkFont sk_font;
+  sk_font.setSize(14);
+  std::vector<TextFrame> lines;
+  lines.reserve(kScrollLineCount);
+  for (size_t i = 0; i < kScrollLineCount; i++) {
+    auto blob = SkTextBlob::MakeFromString(
+        kMultilingualLines[i % kMultilingualLines.size()].c_str(), sk_font);
+    lines.push_back(TextFrameFromTextBlob(blob, GetLineScale(i)));
+  }
+
+  size_t frame_count = 0u;
+  size_t first_line = 0u;
+  while (state.KeepRunning()) {
+    size_t line = first_line;
+    TextRenderContext::FrameIterator iterator = [&]() -> const TextFrame* {
+      if (line >= first_line + kVisibleLineCount) {
+        return nullptr;
+      }
+      return &lines[line++ % kScrollLineCount];
+    };
+    auto atlas = text_context->CreateGlyphAtlas(
+        GlyphAtlas::Type::kAlphaBitmap, atlas_context, iterator);
+    if (!atlas) {
+      state.SkipWithError("Could not create the glyph atlas.");
+      break;
+    }
+    first_line = (first_line + 1) % kScrollLineCount;
+    frame_count++;
+  }
+
+  const auto& statistics = atlas_context->GetStatistics();
+  state.counters["Rebuilds"] = statistics.rebuild_count;
+  state.counters["PagesAdded"] = statistics.page_add_count;
+  state.counters["PageEvictions"] = statistics.page_eviction_count;
+  state.counters["UploadBytesPerFrame"] =
+      frame_count == 0u ? 0.0
+                        : static_cast<double>(statistics.uploaded_bytes) /
+                              static_cast<double>(frame_count);
+  state.counters["UploadRegionsPerFrame"] =
+      frame_count == 0u
+          ? 0.0
+          : static_cast<double>(statistics.uploaded_region_count) /
+                static_cast<double>(frame_count);
+  state.counters["Pages"] = atlas_context->GetPageCount();
+}
+
+// Measures the time to build the glyph atlas for the first frame of a screen
+// full of multilingual text at several sizes, with the number of threads
+// given by the benchmark argument, which includes the calling thread.
+// Measures the time to keep the atlas up to date while a paragraph is
+// zoomed, with the scale changing every frame. Bitmap atlases rasterize the
+// glyphs again at every new scale, while signed distance field atlases serve
+// all scales with the same glyphs.
+static void BM_GlyphAtlasZoom(benchmark::State& state, GlyphAtlas::Type type) {
+  auto text_context =
+      TextRenderContext::Create(std::make_shared<HostContext>());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+
+  SkFont sk_font;
+  sk_font.setSize(14);
+  auto blob =
+      SkTextBlob::MakeFromString(kMultilingualLines[0].c_str(), sk_font);
+
+  constexpr size_t kZoomFrameCount = 120u;
+  size_t frame_count = 0u;
+  while (state.KeepRunning()) {
+    const auto step = frame_count % kZoomFrameCount;
+    const Scalar scale = 1.0f + 2.0f * step / kZoomFrameCount;
+    auto atlas = text_context->CreateGlyphAtlas(
+        type, atlas_context, TextFrameFromTextBlob(blob, scale));
+    if (!atlas) {
+      state.SkipWithError("Could not create the glyph atlas.");
+      break;
+    }
+    frame_count++;
+  }
+
+  const auto& statistics = atlas_context->GetStatistics();
+  state.counters["RasterizedGlyphsPerFrame"] =
+      frame_count == 0u
+          ? 0.0
+          : static_cast<double>(statistics.rasterized_glyph_count) /
+                static_cast<double>(frame_count);
+  state.counters["UploadBytesPerFrame"] =
+      frame_count == 0u ? 0.0
+                        : static_cast<double>(statistics.uploaded_bytes) /
+                              static_cast<double>(frame_count);
+}
+
+static void BM_GlyphAtlasFirstPaint(benchmark::State& state) {
+  const size_t thread_count = state.range(0);
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::BasicTaskRunner> worker_task_runner;
+  if (thread_count > 1) {
+    loop = fml::ConcurrentMessageLoop::Create(thread_count - 1);
+    worker_task_runner = loop->GetTaskRunner();
+  }
+  auto text_context =
+      TextRenderContext::Create(std::make_shared<HostContext>());
+
+  SkFont sk_font;
+  sk_font.setSize(14);
+  std::vector<TextFrame> lines;
+  for (size_t i = 0; i < kMultilingualLines.size() * 5; i++) {
+    auto blob = SkTextBlob::MakeFromString(
+        kMultilingualLines[i % kMultilingualLines.size()].c_str(), sk_font);
+    lines.push_back(TextFrameFromTextBlob(blob, GetLineScale(i)));
+  }
+
+  size_t glyph_count = 0u;
+  while (state.KeepRunning()) {
+    auto atlas_context = std::make_shared<GlyphAtlasContext>(
+        GlyphAtlasContext::kDefaultPageSize,
+        GlyphAtlasContext::kDefaultMaxPageCount, worker_task_runner,
+        thread_count - 1);
+    size_t line = 0u;
+    TextRenderContext::FrameIterator iterator = [&]() -> const TextFrame* {
+      return line < lines.size() ? &lines[line++] : nullptr;
+    };
+    auto atlas = text_context->CreateGlyphAtlas(
+        GlyphAtlas::Type::kAlphaBitmap, atlas_context, iterator);
+    if (!atlas) {
+      state.SkipWithError("Could not create the glyph atlas.");
+      break;
+    }
+    glyph_count = atlas->GetGlyphCount();
+  }
+  state.counters["Glyphs"] = glyph_count;
+  state.counters["GlyphRate"] = benchmark::Counter(
+      static_cast<double>(glyph_count) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_CAPTURE(BM_GlyphAtlasMultilingualScroll, DirtyRegions, true)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_GlyphAtlasMultilingualScroll, WholePages, false)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_TextLayoutScroll, Cached, true)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_TextLayoutScroll, Uncached, false)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_GlyphAtlasZoom,
+                  AlphaBitmap,
+                  GlyphAtlas::Type::kAlphaBitmap)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_GlyphAtlasZoom,
+                  SignedDistanceField,
+                  GlyphAtlas::Type::kSignedDistanceField)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_GlyphAtlasFirstPaint)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace impeller
@@ -2,11 +2,17 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/testing/testing.h"
 #include "impeller/playground/playground_test.h"
 #include "impeller/typographer/backends/skia/text_frame_skia.h"
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 #include "impeller/typographer/lazy_glyph_atlas.h"
+#include "impeller/typographer/text_layout_cache.h"
+#include "impeller/typographer/text_scale_tracker.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
 
@@ -237,6 +243,405 @@ TEST_P(TypographerTest, GlyphAtlasTextureIsRecreatedIfTypeChanges) {
   ASSERT_NE(old_packer, new_packer);
 }
 
+TEST_P(TypographerTest, GlyphAtlasAddsPagesInsteadOfRebuilding) {
+  auto context = TextRenderContext::Create(GetContext());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>(ISize(32, 32), 16u);
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+
+  // More glyphs than fit in a single page.
+  auto blob = SkTextBlob::MakeFromString("abcdefghijklmnopqrstuvwxyz", sk_font);
+  ASSERT_TRUE(blob);
+  auto atlas =
+      context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+                                TextFrameFromTextBlob(blob));
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_TRUE(atlas->IsValid());
+  ASSERT_GT(atlas->GetPageCount(), 1u);
+  ASSERT_EQ(atlas->GetPageCount(), atlas_context->GetPageCount());
+  ASSERT_EQ(atlas_context->GetStatistics().rebuild_count, 1u);
+  auto* first_texture = atlas->GetTexture(0).get();
+
+  auto blob2 =
+      SkTextBlob::MakeFromString("ABCDEFGHIJKLMNOPQRSTUVWXYZ", sk_font);
+  auto frame2 = TextFrameFromTextBlob(blob2);
+  auto next_atlas = context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap,
+                                              atlas_context, frame2);
+  ASSERT_EQ(atlas, next_atlas);
+  ASSERT_EQ(atlas_context->GetStatistics().rebuild_count, 1u);
+  ASSERT_GT(atlas_context->GetStatistics().page_add_count, 0u);
+  ASSERT_EQ(next_atlas->GetTexture(0).get(), first_texture);
+  for (const auto& run : frame2.GetRuns()) {
+    for (const auto& glyph_position : run.GetGlyphPositions()) {
+      ASSERT_TRUE(next_atlas
+                      ->FindFontGlyphLocation(
+                          {run.GetFont(), glyph_position.glyph})
+                      .has_value());
+    }
+  }
+}
+
+TEST_P(TypographerTest, GlyphAtlasEvictsColdGlyphsWhenFull) {
+  auto context = TextRenderContext::Create(GetContext());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>(ISize(128, 128), 2u);
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto blob = SkTextBlob::MakeFromString("abcd", sk_font);
+  ASSERT_TRUE(blob);
+
+  // Every frame draws the same text at a new scale, which makes all of its
+  // glyphs new. Far more glyphs are drawn over all frames than fit in the
+  // atlas.
+  constexpr size_t kFrameCount = 100u;
+  for (size_t i = 0; i < kFrameCount; i++) {
+    auto frame = TextFrameFromTextBlob(blob, 1.0 + 0.01 * i);
+    auto atlas = context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap,
+                                           atlas_context, frame);
+    ASSERT_NE(atlas, nullptr);
+    ASSERT_TRUE(atlas->IsValid());
+    ASSERT_LE(atlas->GetPageCount(), 2u);
+    for (const auto& run : frame.GetRuns()) {
+      for (const auto& glyph_position : run.GetGlyphPositions()) {
+        ASSERT_TRUE(atlas
+                        ->FindFontGlyphLocation(
+                            {run.GetFont(), glyph_position.glyph})
+                        .has_value());
+      }
+    }
+  }
+
+  const auto& statistics = atlas_context->GetStatistics();
+  ASSERT_GT(statistics.page_eviction_count, 0u);
+  ASSERT_GT(statistics.evicted_glyph_count, 0u);
+  ASSERT_LT(statistics.rebuild_count, kFrameCount / 4);
+}
+
+TEST_P(TypographerTest, GlyphAtlasParallelRasterizationMatchesSingleThreaded) {
+  auto context = TextRenderContext::Create(GetContext());
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto blob = SkTextBlob::MakeFromString(
+      "The quick brown fox jumps over the lazy dog 0123456789", sk_font);
+  ASSERT_TRUE(blob);
+  auto frame = TextFrameFromTextBlob(blob, 3.0);
+
+  auto single_threaded = std::make_shared<GlyphAtlasContext>();
+  ASSERT_NE(context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap,
+                                      single_threaded, frame),
+            nullptr);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  auto parallel = std::make_shared<GlyphAtlasContext>(
+      GlyphAtlasContext::kDefaultPageSize,
+      GlyphAtlasContext::kDefaultMaxPageCount, loop->GetTaskRunner(),
+      loop->GetWorkerCount());
+  ASSERT_NE(context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap, parallel,
+                                      frame),
+            nullptr);
+
+  ASSERT_EQ(single_threaded->GetPageCount(), 1u);
+  ASSERT_EQ(parallel->GetPageCount(), 1u);
+  const auto& expected = single_threaded->GetBitmap()->pixmap();
+  const auto& actual = parallel->GetBitmap()->pixmap();
+  ASSERT_EQ(expected.computeByteSize(), actual.computeByteSize());
+  ASSERT_EQ(std::memcmp(expected.addr(), actual.addr(),
+                        expected.computeByteSize()),
+            0);
+}
+
+TEST_P(TypographerTest, GlyphAtlasMergesNearbyDirtyRegions) {
+  GlyphAtlas atlas(GlyphAtlas::Type::kAlphaBitmap);
+  atlas.AddDirtyRegion(0u, IRect::MakeXYWH(0, 0, 10, 10));
+  // Close enough that one upload is cheaper than two.
+  atlas.AddDirtyRegion(0u, IRect::MakeXYWH(12, 0, 10, 10));
+  // Far enough to be uploaded on its own.
+  atlas.AddDirtyRegion(0u, IRect::MakeXYWH(1000, 1000, 10, 10));
+  // Empty regions are ignored.
+  atlas.AddDirtyRegion(0u, IRect::MakeXYWH(500, 500, 0, 10));
+  atlas.AddDirtyRegion(1u, IRect::MakeXYWH(500, 500, 10, 10));
+
+  ASSERT_EQ(atlas.GetDirtyRegions(0u).size(), 2u);
+  EXPECT_EQ(atlas.GetDirtyRegions(0u)[0], IRect::MakeXYWH(0, 0, 22, 10));
+  EXPECT_EQ(atlas.GetDirtyRegions(0u)[1], IRect::MakeXYWH(1000, 1000, 10, 10));
+  EXPECT_EQ(atlas.GetDirtyRegions(1u).size(), 1u);
+  EXPECT_TRUE(atlas.GetDirtyRegions(2u).empty());
+
+  atlas.ClearDirtyRegions();
+  EXPECT_TRUE(atlas.GetDirtyRegions(0u).empty());
+  EXPECT_TRUE(atlas.GetDirtyRegions(1u).empty());
+}
+
+TEST_P(TypographerTest, GlyphAtlasCapsDirtyRegionsPerPage) {
+  GlyphAtlas atlas(GlyphAtlas::Type::kAlphaBitmap);
+  for (int64_t i = 0; i < 20; i++) {
+    atlas.AddDirtyRegion(0u, IRect::MakeXYWH(i * 1000, 0, 10, 10));
+  }
+  const auto& regions = atlas.GetDirtyRegions(0u);
+  EXPECT_EQ(regions.size(), GlyphAtlas::kMaxDirtyRegionsPerPage);
+
+  // Every region that was added is still covered, and no regions overlap.
+  for (int64_t i = 0; i < 20; i++) {
+    auto region = IRect::MakeXYWH(i * 1000, 0, 10, 10);
+    EXPECT_TRUE(std::any_of(
+        regions.begin(), regions.end(),
+        [&region](const IRect& r) { return r.Contains(region); }));
+  }
+  for (size_t i = 0; i < regions.size(); i++) {
+    for (size_t j = i + 1; j < regions.size(); j++) {
+      EXPECT_FALSE(regions[i].Intersection(regions[j]).has_value());
+    }
+  }
+}
+
+TEST_P(TypographerTest, GlyphAtlasGenerationChangesWhenGlyphsMove) {
+  Font font = Font(nullptr, {});
+  FontGlyphPair pair_1 = {
+      .font = font,
+      .glyph = Glyph(0, Glyph::Type::kPath, Rect::MakeXYWH(0, 0, 1, 1))};
+  FontGlyphPair pair_2 = {
+      .font = font,
+      .glyph = Glyph(1, Glyph::Type::kPath, Rect::MakeXYWH(0, 0, 1, 1))};
+
+  GlyphAtlas atlas(GlyphAtlas::Type::kAlphaBitmap);
+  GlyphAtlas other_atlas(GlyphAtlas::Type::kAlphaBitmap);
+  EXPECT_NE(atlas.GetGeneration(), other_atlas.GetGeneration());
+
+  const auto generation = atlas.GetGeneration();
+  atlas.AddTypefaceGlyphPosition(pair_1, Rect::MakeXYWH(0, 0, 10, 10));
+  atlas.AddTypefaceGlyphPosition(pair_2, Rect::MakeXYWH(10, 0, 10, 10));
+  // Adding glyphs leaves the glyphs that were already there in place.
+  EXPECT_EQ(atlas.GetGeneration(), generation);
+  atlas.AddTypefaceGlyphPosition(pair_1, Rect::MakeXYWH(0, 0, 10, 10));
+  EXPECT_EQ(atlas.GetGeneration(), generation);
+
+  atlas.AddTypefaceGlyphPosition(pair_1, Rect::MakeXYWH(20, 0, 10, 10));
+  EXPECT_NE(atlas.GetGeneration(), generation);
+}
+
+TEST_P(TypographerTest, TextLayoutCacheReusesLayoutsUntilGenerationChanges) {
+  Font font = Font(nullptr, {});
+  FontGlyphPair pair = {
+      .font = font,
+      .glyph = Glyph(0, Glyph::Type::kPath, Rect::MakeXYWH(0, 0, 1, 1))};
+  GlyphAtlas atlas(GlyphAtlas::Type::kAlphaBitmap);
+  atlas.AddTypefaceGlyphPosition(pair, Rect::MakeXYWH(0, 0, 10, 10));
+
+  size_t build_count = 0u;
+  TextLayoutCache::LayoutBuilder builder = [&build_count]() {
+    build_count++;
+    TextLayoutCache::Layout layout;
+    layout.glyph_count = 3u;
+    return layout;
+  };
+
+  TextLayoutCache cache;
+  TextLayoutCache::Key key;
+  key.frame_identity = 1u;
+  auto layout = cache.GetOrBuildLayout(key, atlas, builder);
+  ASSERT_NE(layout, nullptr);
+  EXPECT_EQ(cache.GetOrBuildLayout(key, atlas, builder), layout);
+  EXPECT_EQ(build_count, 1u);
+
+  // A different scale is a different layout.
+  key.glyph_scale = 2.0f;
+  EXPECT_NE(cache.GetOrBuildLayout(key, atlas, builder), layout);
+  EXPECT_EQ(build_count, 2u);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  // Frames without an identity are never cached.
+  TextLayoutCache::Key anonymous_key;
+  cache.GetOrBuildLayout(anonymous_key, atlas, builder);
+  cache.GetOrBuildLayout(anonymous_key, atlas, builder);
+  EXPECT_EQ(build_count, 4u);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  // Moving a glyph drops all layouts.
+  atlas.AddTypefaceGlyphPosition(pair, Rect::MakeXYWH(10, 0, 10, 10));
+  cache.GetOrBuildLayout(key, atlas, builder);
+  EXPECT_EQ(build_count, 5u);
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+
+  const auto& statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.hit_count, 1u);
+  EXPECT_EQ(statistics.miss_count, 5u);
+  EXPECT_EQ(statistics.glyph_lookup_count, 15u);
+  EXPECT_EQ(statistics.invalidation_count, 1u);
+}
+
+TEST_P(TypographerTest, SignedDistanceFieldAtlasServesAllScales) {
+  auto context = TextRenderContext::Create(GetContext());
+  ASSERT_TRUE(context && context->IsValid());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+  SkFont sk_font;
+  auto blob = SkTextBlob::MakeFromString("Zoom in and out", sk_font);
+  ASSERT_TRUE(blob);
+
+  auto atlas = context->CreateGlyphAtlas(
+      GlyphAtlas::Type::kSignedDistanceField, atlas_context,
+      TextFrameFromTextBlob(blob, 1.0));
+  ASSERT_NE(atlas, nullptr);
+  const auto rasterized_glyph_count =
+      atlas_context->GetStatistics().rasterized_glyph_count;
+  EXPECT_GT(rasterized_glyph_count, 0u);
+
+  // Zooming the text rasterizes no new glyphs.
+  for (Scalar scale : {1.5f, 2.0f, 3.0f, 0.5f}) {
+    EXPECT_EQ(context->CreateGlyphAtlas(GlyphAtlas::Type::kSignedDistanceField,
+                                        atlas_context,
+                                        TextFrameFromTextBlob(blob, scale)),
+              atlas);
+  }
+  EXPECT_EQ(atlas_context->GetStatistics().rasterized_glyph_count,
+            rasterized_glyph_count);
+}
+
+TEST_P(TypographerTest, SignedDistanceFieldGlyphsMatchBitmapGlyphs) {
+  auto context = TextRenderContext::Create(GetContext());
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto blob = SkTextBlob::MakeFromString("Quality 0123456789", sk_font);
+  ASSERT_TRUE(blob);
+  // Draw the bitmap glyphs at the size of the distance field glyphs.
+  auto frame = TextFrameFromTextBlob(
+      blob, GlyphAtlas::kSignedDistanceFieldEmSize / sk_font.getSize());
+
+  auto alpha_context = std::make_shared<GlyphAtlasContext>();
+  auto alpha_atlas = context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap,
+                                               alpha_context, frame);
+  auto sdf_context = std::make_shared<GlyphAtlasContext>();
+  auto sdf_atlas = context->CreateGlyphAtlas(
+      GlyphAtlas::Type::kSignedDistanceField, sdf_context, frame);
+  ASSERT_NE(alpha_atlas, nullptr);
+  ASSERT_NE(sdf_atlas, nullptr);
+  ASSERT_EQ(alpha_context->GetPageCount(), 1u);
+  ASSERT_EQ(sdf_context->GetPageCount(), 1u);
+
+  // Outside of the outline of the glyphs, where distance fields are neither
+  // inside nor outside, both atlases must agree on the coverage of almost
+  // every pixel.
+  constexpr uint8_t kOutline = 127u;
+  const auto alpha_bitmap = alpha_context->GetBitmap();
+  const auto sdf_bitmap = sdf_context->GetBitmap();
+  size_t pixel_count = 0u;
+  size_t mismatch_count = 0u;
+  alpha_atlas->IterateGlyphs([&](const FontGlyphPair& pair,
+                                 const Rect& alpha_location) {
+    auto sdf_location = sdf_atlas->FindFontGlyphLocation(
+        {GlyphAtlas::GetAtlasFont(sdf_atlas->GetType(), pair.font),
+         pair.glyph});
+    EXPECT_TRUE(sdf_location.has_value());
+    if (!sdf_location.has_value()) {
+      return false;
+    }
+    EXPECT_EQ(sdf_location->bounds.size, alpha_location.size);
+    const auto size = ISize::Ceil(alpha_location.size);
+    for (int64_t y = 0; y < size.height; y++) {
+      for (int64_t x = 0; x < size.width; x++) {
+        const auto distance = *sdf_bitmap->getAddr8(
+            sdf_location->bounds.origin.x + x,
+            sdf_location->bounds.origin.y + y);
+        if (distance == kOutline) {
+          continue;
+        }
+        const auto coverage = *alpha_bitmap->getAddr8(
+            alpha_location.origin.x + x, alpha_location.origin.y + y);
+        pixel_count++;
+        if ((distance > kOutline) != (coverage > kOutline)) {
+          mismatch_count++;
+        }
+      }
+    }
+    return true;
+  });
+  ASSERT_GT(pixel_count, 0u);
+  EXPECT_LT(static_cast<Scalar>(mismatch_count) / pixel_count, 0.05f);
+}
+
+TEST_P(TypographerTest, TextScaleTrackerDetectsScaleAnimations) {
+  TextScaleTracker tracker;
+  // Text without an identity is never tracked.
+  EXPECT_FALSE(tracker.IsScaleAnimating(0u, 1.0f));
+  EXPECT_EQ(tracker.GetEntryCount(), 0u);
+
+  EXPECT_FALSE(tracker.IsScaleAnimating(1u, 1.0f));
+  tracker.AdvanceFrame();
+  EXPECT_FALSE(tracker.IsScaleAnimating(1u, 1.0f));
+
+  // Zoom in over a few frames.
+  Scalar scale = 1.0f;
+  for (int i = 0; i < 10; i++) {
+    tracker.AdvanceFrame();
+    scale += 0.1f;
+    EXPECT_TRUE(tracker.IsScaleAnimating(1u, scale));
+  }
+
+  // The text keeps counting as animating until its scale settles.
+  for (uint64_t i = 1u; i < TextScaleTracker::kSettleFrameCount; i++) {
+    tracker.AdvanceFrame();
+    EXPECT_TRUE(tracker.IsScaleAnimating(1u, scale));
+  }
+  tracker.AdvanceFrame();
+  EXPECT_FALSE(tracker.IsScaleAnimating(1u, scale));
+
+  // Drawing the same text at another scale in the same frame is not an
+  // animation.
+  EXPECT_FALSE(tracker.IsScaleAnimating(1u, scale * 2.0f));
+  tracker.AdvanceFrame();
+  EXPECT_FALSE(tracker.IsScaleAnimating(1u, scale));
+  EXPECT_EQ(tracker.GetEntryCount(), 1u);
+}
+
+TEST_P(TypographerTest, LazyAtlasKeepsAnimatingTextOutOfBitmapAtlas) {
+  SkFont sk_font;
+  auto static_blob = SkTextBlob::MakeFromString("Static text", sk_font);
+  auto zoom_blob = SkTextBlob::MakeFromString("Zooming 0123456789", sk_font);
+  ASSERT_TRUE(static_blob && zoom_blob);
+
+  TextScaleTracker tracker;
+  auto bitmap_context = std::make_shared<GlyphAtlasContext>();
+  auto sdf_context = std::make_shared<GlyphAtlasContext>();
+
+  // Draws a scene with the static text at a fixed scale and the zooming text
+  // at the given scale, and returns whether the latter was drawn from the
+  // signed distance field atlas.
+  auto draw_scene = [&](Scalar zoom_scale) {
+    tracker.AdvanceFrame();
+    auto static_frame = TextFrameFromTextBlob(static_blob, 1.0);
+    auto zoom_frame = TextFrameFromTextBlob(zoom_blob, zoom_scale);
+    LazyGlyphAtlas lazy_atlas;
+    lazy_atlas.AddTextFrame(static_frame);
+    lazy_atlas.AddTextFrame(zoom_frame);
+
+    lazy_atlas.SortTextFrames(tracker);
+    EXPECT_FALSE(lazy_atlas.IsSignedDistanceField(static_frame));
+    EXPECT_TRUE(lazy_atlas.CreateOrGetGlyphAtlas(
+        GlyphAtlas::Type::kAlphaBitmap, bitmap_context, GetContext()));
+    const auto is_sdf = lazy_atlas.IsSignedDistanceField(zoom_frame);
+    if (is_sdf) {
+      EXPECT_TRUE(lazy_atlas.CreateOrGetGlyphAtlas(
+          GlyphAtlas::Type::kSignedDistanceField, sdf_context, GetContext()));
+    }
+    return is_sdf;
+  };
+
+  // Both texts start out in the bitmap atlas.
+  EXPECT_FALSE(draw_scene(1.0f));
+  const auto bitmap_glyph_count =
+      bitmap_context->GetStatistics().rasterized_glyph_count;
+  EXPECT_GT(bitmap_glyph_count, 0u);
+
+  // While the zoom is animating, its glyphs come from the distance field
+  // atlas and the bitmap atlas rasterizes no new glyphs.
+  Scalar scale = 1.0f;
+  for (int i = 0; i < 10; i++) {
+    scale += 0.25f;
+    EXPECT_TRUE(draw_scene(scale));
+    EXPECT_EQ(bitmap_context->GetStatistics().rasterized_glyph_count,
+              bitmap_glyph_count);
+  }
+  EXPECT_GT(sdf_context->GetStatistics().rasterized_glyph_count, 0u);
+}
+
 TEST_P(TypographerTest, FontGlyphPairTypeChangesHashAndEquals) {
   Font font = Font(nullptr, {});
   FontGlyphPair pair_1 = {
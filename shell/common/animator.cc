@@ -28,16 +28,18 @@ Animator::Animator(Delegate& delegate,
       task_runners_(task_runners),
       waiter_(std::move(waiter)),
 #if SHELL_ENABLE_METAL
-      layer_tree_pipeline_(std::make_shared<LayerTreePipeline>(2)),
+      layer_tree_pipeline_(
+          std::make_shared<LayerTreePipeline>(2, kMaxAdaptivePipelineDepth)),
 #else   // SHELL_ENABLE_METAL
       // TODO(dnfield): We should remove this logic and set the pipeline depth
       // back to 2 in this case. See
       // https://github.com/flutter/engine/pull/9132 for discussion.
-      layer_tree_pipeline_(std::make_shared<LayerTreePipeline>(
+      layer_tree_pipeline_(
           task_runners.GetPlatformTaskRunner() ==
                   task_runners.GetRasterTaskRunner()
-              ? 1
-              : 2)),
+              ? std::make_shared<LayerTreePipeline>(1)
+              : std::make_shared<LayerTreePipeline>(
+                    2, kMaxAdaptivePipelineDepth)),
 #endif  // SHELL_ENABLE_METAL
       pending_frame_semaphore_(1),
       weak_factory_(this) {
@@ -57,6 +59,20 @@ void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
       });
 }
 
+void Animator::EnableAdaptivePipelineDepth() {
+  PipelineDepthController::Settings settings;
+  settings.max_depth = kMaxAdaptivePipelineDepth;
+  layer_tree_pipeline_->EnableAdaptiveDepth(settings);
+}
+
+void Animator::NotifyLatencySensitive() {
+  layer_tree_pipeline_->NotifyLatencySensitive();
+}
+
+PipelineMetrics Animator::GetPipelineMetrics() const {
+  return layer_tree_pipeline_->GetMetrics();
+}
+
 void Animator::BeginFrame(
     std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending",
@@ -100,6 +116,8 @@ void Animator::BeginFrame(
   const fml::TimePoint frame_target_time =
       frame_timings_recorder_->GetVsyncTargetTime();
   dart_frame_deadline_ = frame_target_time.ToEpochDelta();
+  layer_tree_pipeline_->SetFrameBudget(
+      frame_target_time - frame_timings_recorder_->GetVsyncStartTime());
   uint64_t frame_number = frame_timings_recorder_->GetFrameNumber();
   delegate_.OnAnimatorBeginFrame(frame_target_time, frame_number);
 
@@ -81,6 +81,36 @@ class Animator final {
   // rendering.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
+  //--------------------------------------------------------------------------
+  /// @brief    Lets the depth of the layer tree pipeline follow the raster
+  ///           time of frames. The depth grows, up to
+  ///           |kMaxAdaptivePipelineDepth|, while frames take longer to
+  ///           rasterize than the frame budget so that the UI thread can
+  ///           build ahead of the raster thread, and shrinks back once they
+  ///           fit in the budget again.
+  ///
+  ///           Has no effect if the UI and raster work share a thread, in
+  ///           which case the pipeline depth is always 1.
+  ///
+  void EnableAdaptivePipelineDepth();
+
+  //--------------------------------------------------------------------------
+  /// @brief    Signals that the frames being produced respond to user input,
+  ///           for example during pointer interaction. An adaptive pipeline
+  ///           depth drops to 1 for a short while so that frames do not wait
+  ///           behind each other.
+  ///
+  void NotifyLatencySensitive();
+
+  //--------------------------------------------------------------------------
+  /// @brief    The depth, queue length and added latency of the layer tree
+  ///           pipeline.
+  ///
+  PipelineMetrics GetPipelineMetrics() const;
+
+  // The largest depth an adaptive layer tree pipeline grows to.
+  static constexpr uint32_t kMaxAdaptivePipelineDepth = 3;
+
  private:
   void BeginFrame(std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder);
 
@@ -508,6 +508,9 @@ FontCollection& Engine::GetFontCollection() {
 void Engine::DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
                               uint64_t trace_flow_id) {
   animator_->EnqueueTraceFlowId(trace_flow_id);
+  // Frames built in response to pointer input should not wait behind other
+  // frames in the pipeline.
+  animator_->NotifyLatencySensitive();
   if (runtime_controller_) {
     runtime_controller_->DispatchPointerDataPacket(*packet);
   }
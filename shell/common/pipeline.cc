@@ -4,6 +4,8 @@
 
 #include "flutter/shell/common/pipeline.h"
 
+#include "flutter/fml/logging.h"
+
 namespace flutter {
 
 size_t GetNextPipelineTraceID() {
@@ -11,4 +13,51 @@ size_t GetNextPipelineTraceID() {
   return ++PipelineLastTraceID;
 }
 
+PipelineDepthController::PipelineDepthController(const Settings& settings)
+    : settings_(settings), depth_(settings.min_depth) {
+  FML_DCHECK(settings_.min_depth >= 1);
+  FML_DCHECK(settings_.min_depth <= settings_.max_depth);
+}
+
+PipelineDepthController::~PipelineDepthController() = default;
+
+uint32_t PipelineDepthController::depth() const {
+  return depth_;
+}
+
+uint32_t PipelineDepthController::OnResourceConsumed(
+    fml::TimeDelta consume_time,
+    fml::TimeDelta frame_budget,
+    fml::TimePoint now) {
+  if (consume_time > frame_budget) {
+    within_budget_count_ = 0;
+    over_budget_count_++;
+    if (over_budget_count_ >= settings_.over_budget_count_to_grow &&
+        depth_ < settings_.max_depth) {
+      depth_++;
+      over_budget_count_ = 0;
+    }
+  } else {
+    over_budget_count_ = 0;
+    within_budget_count_++;
+    if (within_budget_count_ >= settings_.within_budget_count_to_shrink &&
+        depth_ > settings_.min_depth) {
+      depth_--;
+      within_budget_count_ = 0;
+    }
+  }
+
+  // The depth the consumer needs is still tracked while latency sensitive so
+  // that the pipeline returns to it right away afterwards.
+  return IsLatencySensitive(now) ? 1 : depth_;
+}
+
+void PipelineDepthController::NotifyLatencySensitive(fml::TimePoint now) {
+  latency_sensitive_until_ = now + settings_.latency_sensitive_duration;
+}
+
+bool PipelineDepthController::IsLatencySensitive(fml::TimePoint now) const {
+  return now < latency_sensitive_until_;
+}
+
 }  // namespace flutter
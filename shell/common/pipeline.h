@@ -5,15 +5,19 @@
 #ifndef FLUTTER_SHELL_COMMON_PIPELINE_H_
 #define FLUTTER_SHELL_COMMON_PIPELINE_H_
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include "flutter/flow/frame_timings.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -34,6 +38,83 @@ enum class PipelineConsumeResult {
 
 size_t GetNextPipelineTraceID();
 
+/// A snapshot of the state of a |Pipeline|.
+struct PipelineMetrics {
+  // The number of resources the producer may have in flight at once.
+  uint32_t depth = 0;
+  // The number of resources that are being produced or are waiting to be
+  // consumed.
+  uint32_t inflight = 0;
+  // The number of produced resources waiting to be consumed.
+  uint32_t queued = 0;
+  // The time the most recently consumed resource waited in the queue before
+  // the consumer took it. This is the latency added by pipelining.
+  fml::TimeDelta last_queue_latency;
+  // The time the consumer took for the most recently consumed resource.
+  fml::TimeDelta last_consume_time;
+};
+
+/// Decides the depth of a |Pipeline| from the time its consumer takes for
+/// each resource.
+///
+/// The depth grows by one, up to the maximum depth, after the consumer has
+/// exceeded the frame budget for a number of consecutive resources, which
+/// lets the producer work ahead of a consumer that is temporarily slow. It
+/// shrinks by one after the consumer has met the frame budget for a longer
+/// run of consecutive resources. While latency sensitive, for example during
+/// pointer interaction, the depth is 1 so that no frame waits behind another.
+///
+/// This class is not thread-safe.
+class PipelineDepthController {
+ public:
+  struct Settings {
+    // The smallest and largest depth to use.
+    uint32_t min_depth = 1;
+    uint32_t max_depth = 3;
+    // The number of consecutive resources for which the consumer must
+    // exceed the frame budget before the depth grows.
+    uint32_t over_budget_count_to_grow = 2;
+    // The number of consecutive resources for which the consumer must meet
+    // the frame budget before the depth shrinks.
+    uint32_t within_budget_count_to_shrink = 60;
+    // How long the depth stays at 1 after the last call to
+    // |NotifyLatencySensitive|.
+    fml::TimeDelta latency_sensitive_duration =
+        fml::TimeDelta::FromMilliseconds(250);
+  };
+
+  explicit PipelineDepthController(const Settings& settings);
+
+  ~PipelineDepthController();
+
+  const Settings& settings() const { return settings_; }
+
+  /// The depth the consumer needs, regardless of latency sensitivity.
+  uint32_t depth() const;
+
+  /// Records the time the consumer took for a resource, against the time
+  /// available per frame, and returns the new depth.
+  uint32_t OnResourceConsumed(fml::TimeDelta consume_time,
+                              fml::TimeDelta frame_budget,
+                              fml::TimePoint now);
+
+  /// Keeps the depth at 1 until the |Settings::latency_sensitive_duration|
+  /// has passed since |now|.
+  void NotifyLatencySensitive(fml::TimePoint now);
+
+  /// Whether the depth is currently being kept at 1 for latency.
+  bool IsLatencySensitive(fml::TimePoint now) const;
+
+ private:
+  const Settings settings_;
+  uint32_t depth_;
+  uint32_t over_budget_count_ = 0;
+  uint32_t within_budget_count_ = 0;
+  fml::TimePoint latency_sensitive_until_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PipelineDepthController);
+};
+
 /// A thread-safe queue of resources for a single consumer and a single
 /// producer, with a maximum queue depth.
 ///
@@ -55,6 +136,15 @@ size_t GetNextPipelineTraceID();
 ///   calls |Produce| to the time they complete the `ProducerContinuation` with
 ///   a resource.
 /// * Pipeline Depth: counter of inflight resource producers.
+/// * Pipeline Adaptive Depth: counter of the depth and the queue latency of
+///   the last consumed resource, for pipelines with an adaptive depth.
+///
+/// The depth of the pipeline can be changed at runtime up to the maximum
+/// depth it was created with, either directly with |SetDepth| or by a
+/// |PipelineDepthController| enabled with |EnableAdaptiveDepth|. Lowering
+/// the depth does not drop resources that are already in flight; the
+/// producer is only prevented from adding more until the consumer catches
+/// up.
 ///
 /// The primary use of this class is as the frame pipeline used in Flutter's
 /// animator/rasterizer.
@@ -124,20 +214,88 @@ class Pipeline {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(uint32_t depth) : Pipeline(depth, depth) {}
+
+  Pipeline(uint32_t depth, uint32_t max_depth)
+      : max_depth_(std::max(max_depth, 1u)),
+        empty_(max_depth_),
+        available_(0),
+        inflight_(0),
+        depth_(std::clamp(depth, 1u, max_depth_)) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  uint32_t GetMaxDepth() const { return max_depth_; }
+
+  uint32_t GetDepth() const { return depth_.load(); }
+
+  /// Sets the number of resources the producer may have in flight, clamped
+  /// to [1, max depth]. Ignored while an adaptive depth is enabled.
+  void SetDepth(uint32_t depth) {
+    std::scoped_lock lock(depth_mutex_);
+    if (!depth_controller_.has_value()) {
+      UpdateDepth(depth);
+    }
+  }
+
+  /// Lets a |PipelineDepthController| with the given settings pick the depth
+  /// from the time the consumer takes for each resource. The maximum depth
+  /// of the settings is clamped to the maximum depth of the pipeline.
+  void EnableAdaptiveDepth(PipelineDepthController::Settings settings) {
+    std::scoped_lock lock(depth_mutex_);
+    settings.max_depth = std::clamp(settings.max_depth, 1u, max_depth_);
+    settings.min_depth = std::clamp(settings.min_depth, 1u, settings.max_depth);
+    depth_controller_.emplace(settings);
+    UpdateDepth(depth_controller_->depth());
+  }
+
+  bool IsAdaptiveDepthEnabled() const {
+    std::scoped_lock lock(depth_mutex_);
+    return depth_controller_.has_value();
+  }
+
+  /// Sets the time available to the consumer per resource, against which
+  /// an adaptive depth is measured.
+  void SetFrameBudget(fml::TimeDelta frame_budget) {
+    std::scoped_lock lock(depth_mutex_);
+    frame_budget_ = frame_budget;
+  }
+
+  /// Drops an adaptive depth to 1 for a while, because the resources being
+  /// produced respond to user input and must not wait behind others.
+  void NotifyLatencySensitive() {
+    std::scoped_lock lock(depth_mutex_);
+    if (depth_controller_.has_value()) {
+      depth_controller_->NotifyLatencySensitive(fml::TimePoint::Now());
+      UpdateDepth(1);
+    }
+  }
+
+  PipelineMetrics GetMetrics() const {
+    PipelineMetrics metrics;
+    metrics.depth = depth_.load();
+    metrics.inflight = std::max(inflight_.load(), 0);
+    {
+      std::scoped_lock lock(queue_mutex_);
+      metrics.queued = queue_.size();
+    }
+    {
+      std::scoped_lock lock(depth_mutex_);
+      metrics.last_queue_latency = last_queue_latency_;
+      metrics.last_consume_time = last_consume_time_;
+    }
+    return metrics;
+  }
+
   /// Creates a `ProducerContinuation` that a producer can use to add a
   /// resource to the queue.
   ///
   /// If the queue is already at its maximum depth, the `ProducerContinuation`
   /// is returned with success = false.
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    if (IsAtDepth() || !empty_.TryWait()) {
       return {};
     }
     ++inflight_;
@@ -185,21 +343,24 @@ class Pipeline {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
+    QueueItem item;
     size_t items_count = 0;
 
     {
       std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
+      item = std::move(queue_.front());
       queue_.pop_front();
       items_count = queue_.size();
     }
 
-    consumer(std::move(resource));
+    const fml::TimePoint consume_start = fml::TimePoint::Now();
+    consumer(std::move(item.resource));
+    OnConsumed(consume_start - item.commit_time,
+               fml::TimePoint::Now() - consume_start);
 
     empty_.Signal();
     --inflight_;
+    const size_t trace_id = item.trace_id;
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
@@ -209,11 +370,54 @@ class Pipeline {
   }
 
  private:
+  struct QueueItem {
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    fml::TimePoint commit_time;
+  };
+
+  const uint32_t max_depth_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
-  std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  std::atomic<uint32_t> depth_;
+  mutable std::mutex queue_mutex_;
+  std::deque<QueueItem> queue_;
+
+  // Guards the adaptive depth state and the consumer metrics below.
+  mutable std::mutex depth_mutex_;
+  std::optional<PipelineDepthController> depth_controller_;
+  fml::TimeDelta frame_budget_ = fml::TimeDelta::FromSecondsF(1.0 / 60.0);
+  fml::TimeDelta last_queue_latency_;
+  fml::TimeDelta last_consume_time_;
+
+  /// Whether the producer already has as many resources in flight as the
+  /// depth allows. Resources produced before the depth was lowered keep
+  /// their place.
+  bool IsAtDepth() const {
+    return inflight_.load() >= static_cast<int>(depth_.load());
+  }
+
+  // Must be called with |depth_mutex_| held.
+  void UpdateDepth(uint32_t depth) {
+    depth_ = std::clamp(depth, 1u, max_depth_);
+  }
+
+  void OnConsumed(fml::TimeDelta queue_latency, fml::TimeDelta consume_time) {
+    std::scoped_lock lock(depth_mutex_);
+    last_queue_latency_ = queue_latency;
+    last_consume_time_ = consume_time;
+    if (!depth_controller_.has_value()) {
+      return;
+    }
+    UpdateDepth(depth_controller_->OnResourceConsumed(
+        consume_time, frame_budget_, fml::TimePoint::Now()));
+    FML_TRACE_COUNTER("flutter", "Pipeline Adaptive Depth",
+                      reinterpret_cast<int64_t>(this),                    //
+                      "depth", depth_.load(),                             //
+                      "queue latency us", queue_latency.ToMicroseconds()  //
+    );
+  }
 
   /// Commits a produced resource to the queue and signals the consumer that a
   /// resource is available.
@@ -222,7 +426,9 @@ class Pipeline {
     {
       std::scoped_lock lock(queue_mutex_);
       is_first_item = queue_.empty();
-      queue_.emplace_back(std::move(resource), trace_id);
+      queue_.push_back({.resource = std::move(resource),
+                        .trace_id = trace_id,
+                        .commit_time = fml::TimePoint::Now()});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -240,7 +446,9 @@ class Pipeline {
         empty_.Signal();
         return {.success = false, .is_first_item = false};
       }
-      queue_.emplace_back(std::move(resource), trace_id);
+      queue_.push_back({.resource = std::move(resource),
+                        .trace_id = trace_id,
+                        .commit_time = fml::TimePoint::Now()});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -0,0 +1,130 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pipeline.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace flutter {
+
+namespace {
+
+using IntPipeline = Pipeline<int>;
+
+constexpr fml::TimeDelta kFrameBudget =
+    fml::TimeDelta::FromMicroseconds(16667);
+constexpr int kSimulatedFrameCount = 600;
+
+fml::TimePoint gSimulatedNow;
+
+fml::TimePoint SimulatedNow() {
+  return gSimulatedNow;
+}
+
+// The synthetic build and raster times of a frame. Every 8th frame is a
+// burst that takes two and a half frame budgets to rasterize, as a frame
+// that shows a new route or warms up shaders would.
+fml::TimeDelta BuildTime(int frame) {
+  return fml::TimeDelta::FromMicroseconds(6000 + (frame % 3) * 1000);
+}
+
+fml::TimeDelta RasterTime(int frame) {
+  return frame % 8 == 0 ? kFrameBudget * 5 / 2 : kFrameBudget * 3 / 5;
+}
+
+struct SimulationResult {
+  int produced_frames = 0;
+  int skipped_vsyncs = 0;
+  int64_t total_queue_latency_us = 0;
+  int64_t total_depth = 0;
+  int consumed_frames = 0;
+};
+
+// Simulates the UI thread producing a frame at each vsync and the raster
+// thread consuming them in order, on a clock that only advances by the
+// synthetic build and raster times. A vsync at which the pipeline is full
+// is skipped, which is a dropped frame.
+SimulationResult Simulate(IntPipeline& pipeline) {
+  SimulationResult result;
+  const fml::TimePoint start = gSimulatedNow;
+  fml::TimePoint raster_free_at = start;
+  std::deque<fml::TimePoint> commit_times;
+
+  auto consume_until = [&](fml::TimePoint until) {
+    while (!commit_times.empty() &&
+           std::max(raster_free_at, commit_times.front()) <= until) {
+      gSimulatedNow = std::max(raster_free_at, commit_times.front());
+      commit_times.pop_front();
+      int frame = 0;
+      (void)pipeline.Consume([&frame](std::unique_ptr<int> value) {
+        frame = *value;
+        gSimulatedNow = gSimulatedNow + RasterTime(frame);
+      });
+      raster_free_at = gSimulatedNow;
+      PipelineMetrics metrics = pipeline.GetMetrics();
+      result.total_queue_latency_us +=
+          metrics.last_queue_latency.ToMicroseconds();
+      result.total_depth += metrics.depth;
+      result.consumed_frames++;
+    }
+  };
+
+  for (int frame = 0; frame < kSimulatedFrameCount; frame++) {
+    const fml::TimePoint vsync = start + kFrameBudget * frame;
+    consume_until(vsync);
+    gSimulatedNow = vsync;
+    IntPipeline::ProducerContinuation continuation = pipeline.Produce();
+    if (!continuation) {
+      result.skipped_vsyncs++;
+      continue;
+    }
+    gSimulatedNow = vsync + BuildTime(frame);
+    (void)continuation.Complete(std::make_unique<int>(frame));
+    commit_times.push_back(gSimulatedNow);
+    result.produced_frames++;
+  }
+  consume_until(fml::TimePoint::Max());
+  return result;
+}
+
+}  // namespace
+
+// Runs the frame simulation against a pipeline of a fixed depth, or against
+// an adaptive pipeline if the depth is 0.
+static void BM_PipelineSimulation(benchmark::State& state) {
+  const uint32_t depth = state.range(0);
+  fml::TimePoint::SetClockSource(&SimulatedNow);
+
+  SimulationResult result;
+  while (state.KeepRunning()) {
+    gSimulatedNow =
+        fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromSeconds(1));
+    IntPipeline pipeline(depth == 0 ? 1 : depth, 3);
+    if (depth == 0) {
+      pipeline.EnableAdaptiveDepth({});
+      pipeline.SetFrameBudget(kFrameBudget);
+    }
+    result = Simulate(pipeline);
+  }
+  fml::TimePoint::SetClockSource(nullptr);
+
+  state.counters["DroppedFrames"] = result.skipped_vsyncs;
+  state.counters["AvgQueueLatencyMs"] =
+      result.total_queue_latency_us / 1000.0 / result.consumed_frames;
+  state.counters["AvgDepth"] =
+      static_cast<double>(result.total_depth) / result.consumed_frames;
+}
+
+BENCHMARK(BM_PipelineSimulation)
+    ->ArgName("depth")
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(3)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -10,6 +10,8 @@
 #include <future>
 #include <memory>
 
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "gtest/gtest.h"
 
 namespace flutter {
@@ -18,6 +20,36 @@ namespace testing {
 using IntPipeline = Pipeline<int>;
 using Continuation = IntPipeline::ProducerContinuation;
 
+namespace {
+
+// A clock that only advances when told to, so that the pipeline measures
+// the time the test decides its consumer takes.
+fml::TimePoint gFakeNow;
+
+fml::TimePoint FakeNow() {
+  return gFakeNow;
+}
+
+class ScopedFakeClock {
+ public:
+  ScopedFakeClock() {
+    gFakeNow = fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromSeconds(1));
+    fml::TimePoint::SetClockSource(&FakeNow);
+  }
+
+  ~ScopedFakeClock() { fml::TimePoint::SetClockSource(nullptr); }
+
+  void Advance(fml::TimeDelta delta) { gFakeNow = gFakeNow + delta; }
+};
+
+void ProduceAndComplete(IntPipeline& pipeline, int value) {
+  Continuation continuation = pipeline.Produce();
+  ASSERT_TRUE(continuation);
+  ASSERT_TRUE(continuation.Complete(std::make_unique<int>(value)).success);
+}
+
+}  // namespace
+
 TEST(PipelineTest, ConsumeOneVal) {
   std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(2);
 
@@ -144,5 +176,176 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, SetDepthIsClampedToMaxDepth) {
+  IntPipeline pipeline(1, 3);
+  ASSERT_EQ(pipeline.GetDepth(), 1u);
+  ASSERT_EQ(pipeline.GetMaxDepth(), 3u);
+
+  pipeline.SetDepth(10);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+  pipeline.SetDepth(0);
+  ASSERT_EQ(pipeline.GetDepth(), 1u);
+
+  // The single argument constructor has a fixed depth.
+  IntPipeline fixed(2);
+  fixed.SetDepth(3);
+  ASSERT_EQ(fixed.GetDepth(), 2u);
+}
+
+TEST(PipelineTest, DepthLimitsResourcesInFlight) {
+  IntPipeline pipeline(1, 3);
+
+  Continuation continuation_1 = pipeline.Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_FALSE(pipeline.Produce());
+
+  pipeline.SetDepth(2);
+  Continuation continuation_2 = pipeline.Produce();
+  ASSERT_TRUE(continuation_2);
+  ASSERT_FALSE(pipeline.Produce());
+
+  // Lowering the depth keeps the resources that are already in flight.
+  pipeline.SetDepth(1);
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)).success);
+  ASSERT_TRUE(continuation_2.Complete(std::make_unique<int>(2)).success);
+  ASSERT_EQ(pipeline.GetMetrics().queued, 2u);
+
+  ASSERT_EQ(pipeline.Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 1); }),
+            PipelineConsumeResult::MoreAvailable);
+  // One resource is still in flight, which is all a depth of 1 allows.
+  ASSERT_FALSE(pipeline.Produce());
+  ASSERT_EQ(pipeline.Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2); }),
+            PipelineConsumeResult::Done);
+  ASSERT_TRUE(pipeline.Produce());
+}
+
+TEST(PipelineTest, MetricsReportQueueLatencyAndConsumeTime) {
+  ScopedFakeClock clock;
+  IntPipeline pipeline(2, 2);
+
+  ProduceAndComplete(pipeline, 1);
+  ProduceAndComplete(pipeline, 2);
+  PipelineMetrics metrics = pipeline.GetMetrics();
+  ASSERT_EQ(metrics.depth, 2u);
+  ASSERT_EQ(metrics.inflight, 2u);
+  ASSERT_EQ(metrics.queued, 2u);
+
+  clock.Advance(fml::TimeDelta::FromMilliseconds(5));
+  ASSERT_EQ(pipeline.Consume([&clock](std::unique_ptr<int> v) {
+    clock.Advance(fml::TimeDelta::FromMilliseconds(12));
+  }),
+            PipelineConsumeResult::MoreAvailable);
+  metrics = pipeline.GetMetrics();
+  ASSERT_EQ(metrics.inflight, 1u);
+  ASSERT_EQ(metrics.queued, 1u);
+  ASSERT_EQ(metrics.last_queue_latency, fml::TimeDelta::FromMilliseconds(5));
+  ASSERT_EQ(metrics.last_consume_time, fml::TimeDelta::FromMilliseconds(12));
+
+  // The second resource waited for the first to be consumed.
+  ASSERT_EQ(pipeline.Consume([](std::unique_ptr<int> v) {}),
+            PipelineConsumeResult::Done);
+  metrics = pipeline.GetMetrics();
+  ASSERT_EQ(metrics.queued, 0u);
+  ASSERT_EQ(metrics.last_queue_latency, fml::TimeDelta::FromMilliseconds(17));
+}
+
+TEST(PipelineTest, AdaptiveDepthFollowsConsumeTime) {
+  ScopedFakeClock clock;
+  IntPipeline pipeline(1, 3);
+  PipelineDepthController::Settings settings;
+  settings.max_depth = 3;
+  settings.over_budget_count_to_grow = 2;
+  settings.within_budget_count_to_shrink = 3;
+  pipeline.EnableAdaptiveDepth(settings);
+  pipeline.SetFrameBudget(fml::TimeDelta::FromMilliseconds(16));
+  ASSERT_TRUE(pipeline.IsAdaptiveDepthEnabled());
+  ASSERT_EQ(pipeline.GetDepth(), 1u);
+
+  auto consume = [&pipeline, &clock](int64_t millis) {
+    ProduceAndComplete(pipeline, 0);
+    ASSERT_EQ(pipeline.Consume([&clock, millis](std::unique_ptr<int> v) {
+      clock.Advance(fml::TimeDelta::FromMilliseconds(millis));
+    }),
+              PipelineConsumeResult::Done);
+  };
+
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 1u);
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 2u);
+  consume(30);
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+  // The depth does not grow beyond the maximum.
+  consume(30);
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+
+  // An explicit depth is ignored while the depth is adaptive.
+  pipeline.SetDepth(1);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+
+  consume(8);
+  consume(8);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+  consume(8);
+  ASSERT_EQ(pipeline.GetDepth(), 2u);
+}
+
+TEST(PipelineTest, LatencySensitiveAdaptiveDepthDropsToOne) {
+  ScopedFakeClock clock;
+  IntPipeline pipeline(1, 3);
+  PipelineDepthController::Settings settings;
+  settings.over_budget_count_to_grow = 1;
+  settings.latency_sensitive_duration = fml::TimeDelta::FromMilliseconds(100);
+  pipeline.EnableAdaptiveDepth(settings);
+  pipeline.SetFrameBudget(fml::TimeDelta::FromMilliseconds(16));
+
+  auto consume = [&pipeline, &clock](int64_t millis) {
+    ProduceAndComplete(pipeline, 0);
+    ASSERT_EQ(pipeline.Consume([&clock, millis](std::unique_ptr<int> v) {
+      clock.Advance(fml::TimeDelta::FromMilliseconds(millis));
+    }),
+              PipelineConsumeResult::Done);
+  };
+
+  consume(30);
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+
+  pipeline.NotifyLatencySensitive();
+  ASSERT_EQ(pipeline.GetDepth(), 1u);
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 1u);
+
+  // Once the interaction is over the depth the consumer needs is restored.
+  clock.Advance(fml::TimeDelta::FromMilliseconds(100));
+  consume(30);
+  ASSERT_EQ(pipeline.GetDepth(), 3u);
+}
+
+TEST(PipelineDepthControllerTest, MinDepthIsRespected) {
+  PipelineDepthController::Settings settings;
+  settings.min_depth = 2;
+  settings.max_depth = 3;
+  settings.within_budget_count_to_shrink = 1;
+  PipelineDepthController controller(settings);
+  const fml::TimePoint now = fml::TimePoint::Now();
+  const fml::TimeDelta budget = fml::TimeDelta::FromMilliseconds(16);
+
+  ASSERT_EQ(controller.depth(), 2u);
+  ASSERT_EQ(controller.OnResourceConsumed(fml::TimeDelta::FromMilliseconds(1),
+                                          budget, now),
+            2u);
+  ASSERT_FALSE(controller.IsLatencySensitive(now));
+  controller.NotifyLatencySensitive(now);
+  ASSERT_TRUE(controller.IsLatencySensitive(now));
+  // Latency sensitivity overrides the minimum depth.
+  ASSERT_EQ(controller.OnResourceConsumed(fml::TimeDelta::FromMilliseconds(1),
+                                          budget, now),
+            1u);
+  ASSERT_EQ(controller.depth(), 2u);
+}
+
 }  // namespace testing
 }  // namespace flutter
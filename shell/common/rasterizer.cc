@@ -590,6 +590,8 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
         raster_status == RasterStatus::kSkipAndRetry) {
       return raster_status;
     }
+    frame_timings_recorder.RecordOcclusionCulling(
+        layer_tree.occluded_layer_count(), layer_tree.occluded_op_count());
 
     SurfaceFrame::SubmitInfo submit_info;
     // TODO (https://github.com/flutter/flutter/issues/105596): this can be in
@@ -5,6 +5,8 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include "flutter/shell/common/shell.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <sstream>
 #include <utility>
@@ -290,6 +292,9 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         // from the platform.
         auto animator = std::make_unique<Animator>(*shell, task_runners,
                                                    std::move(vsync_waiter));
+        if (shell->GetSettings().enable_adaptive_pipeline_depth) {
+          animator->EnableAdaptivePipelineDepth();
+        }
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -460,6 +465,11 @@ Shell::Shell(DartVMRef vm,
       task_runners_.GetPlatformTaskRunner(),
       std::bind(&Shell::OnServiceProtocolReloadAssetFonts, this,
                 std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingPercentilesExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingPercentiles, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -1453,6 +1463,8 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
 
+  frame_timing_histogram_.Record(timing);
+
   // The C++ callback defined in settings.h and set by Flutter runner. This is
   // independent of the timings report to the Dart side.
   if (settings_.frame_rasterized_callback) {
@@ -1735,6 +1747,52 @@ bool Shell::OnServiceProtocolGetDisplayRefreshRate(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetFrameTimingPercentiles(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  fml::TimeDelta window = FrameTimingHistogram::kMaxWindow;
+  auto window_param = params.find("windowMilliseconds");
+  if (window_param != params.end()) {
+    char* end = nullptr;
+    const int64_t millis = std::strtoll(window_param->second.c_str(), &end, 10);
+    if (end == window_param->second.c_str() || *end != '\0' || millis <= 0) {
+      ServiceProtocolParameterError(
+          response, "'windowMilliseconds' must be a positive integer.");
+      return false;
+    }
+    window = std::min(fml::TimeDelta::FromMilliseconds(millis),
+                      FrameTimingHistogram::kMaxWindow);
+  }
+
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "FrameTimingPercentiles", allocator);
+  response->AddMember<int64_t>("windowMilliseconds", window.ToMilliseconds(),
+                               allocator);
+
+  const fml::TimePoint now = fml::TimePoint::Now();
+  auto add_metric = [&](const char* name, FrameTimingHistogram::Metric metric) {
+    const FrameTimingPercentiles percentiles =
+        frame_timing_histogram_.GetPercentiles(metric, window, now);
+    rapidjson::Value value(rapidjson::kObjectType);
+    value.AddMember<uint64_t>("count", percentiles.count, allocator);
+    value.AddMember<uint64_t>("p50", percentiles.p50, allocator);
+    value.AddMember<uint64_t>("p90", percentiles.p90, allocator);
+    value.AddMember<uint64_t>("p99", percentiles.p99, allocator);
+    value.AddMember<uint64_t>("max", percentiles.max, allocator);
+    response->AddMember(rapidjson::StringRef(name), value, allocator);
+  };
+  // Durations are in microseconds.
+  add_metric("vsyncToBuildStart",
+             FrameTimingHistogram::Metric::kVsyncToBuildStart);
+  add_metric("build", FrameTimingHistogram::Metric::kBuild);
+  add_metric("raster", FrameTimingHistogram::Metric::kRaster);
+  add_metric("endToEnd", FrameTimingHistogram::Metric::kEndToEnd);
+  add_metric("rasterCacheBytes",
+             FrameTimingHistogram::Metric::kRasterCacheBytes);
+  return true;
+}
+
 double Shell::GetMainDisplayRefreshRate() {
   return display_manager_->GetMainDisplayRefreshRate();
 }
@@ -14,6 +14,7 @@
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/flow/frame_timing_histogram.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -384,6 +385,14 @@ class Shell final : public PlatformView::Delegate,
   ///
   double GetMainDisplayRefreshRate();
 
+  //----------------------------------------------------------------------------
+  /// @brief      The histograms of the timings of the frames rasterized by
+  ///             this shell. They may be queried from any thread.
+  ///
+  const FrameTimingHistogram& GetFrameTimingHistogram() const {
+    return frame_timing_histogram_;
+  }
+
   //----------------------------------------------------------------------------
   /// @brief      Install a new factory that can match against and decode image
   ///             data.
@@ -462,6 +471,10 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // Written on the raster thread for every rasterized frame and read from
+  // the service protocol and embedders on any thread.
+  FrameTimingHistogram frame_timing_histogram_;
+
   /// Manages the displays. This class is thread safe, can be accessed from any
   /// of the threads.
   std::unique_ptr<DisplayManager> display_manager_;
@@ -722,6 +735,15 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Responds with the count, p50, p90, p99 and max of each metric of the
+  // frame timing histogram over the last `windowMilliseconds`, which
+  // defaults to the longest window the histogram keeps.
+  bool OnServiceProtocolGetFrameTimingPercentiles(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Send a system font change notification.
   void SendFontChangeNotification();
 
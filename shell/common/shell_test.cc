@@ -274,6 +274,9 @@ void ShellTest::OnServiceProtocol(
       case ServiceProtocolEnum::kRenderFrameWithRasterStats:
         shell->OnServiceProtocolRenderFrameWithRasterStats(params, response);
         break;
+      case ServiceProtocolEnum::kGetFrameTimingPercentiles:
+        shell->OnServiceProtocolGetFrameTimingPercentiles(params, response);
+        break;
     }
     finished.set_value(true);
   });
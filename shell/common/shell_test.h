@@ -108,6 +108,7 @@ class ShellTest : public FixtureTest {
     kSetAssetBundlePath,
     kRunInView,
     kRenderFrameWithRasterStats,
+    kGetFrameTimingPercentiles,
   };
 
   // Helper method to test private method Shell::OnServiceProtocolGetSkSLs.
@@ -2548,6 +2548,54 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetFrameTimingPercentilesWorks) {
+  auto settings = CreateSettingsForFixture();
+  fml::AutoResetWaitableEvent timing_latch;
+  settings.frame_rasterized_callback = [&timing_latch](const FrameTiming& t) {
+    timing_latch.Signal();
+  };
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  // Create the surface needed by rasterizer
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+  PumpOneFrame(shell.get());
+  timing_latch.Wait();
+
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  params["windowMilliseconds"] = "10000";
+  rapidjson::Document document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetFrameTimingPercentiles,
+      shell->GetTaskRunners().GetIOTaskRunner(), params, &document);
+  ASSERT_EQ(std::string(document["type"].GetString()),
+            "FrameTimingPercentiles");
+  ASSERT_EQ(document["windowMilliseconds"].GetInt64(), 10000);
+  for (const char* metric : {"vsyncToBuildStart", "build", "raster",
+                             "endToEnd", "rasterCacheBytes"}) {
+    ASSERT_TRUE(document.HasMember(metric)) << metric;
+    const auto& percentiles = document[metric];
+    ASSERT_EQ(percentiles["count"].GetUint64(), 1u) << metric;
+    ASSERT_LE(percentiles["p50"].GetUint64(), percentiles["max"].GetUint64());
+    ASSERT_LE(percentiles["p99"].GetUint64(), percentiles["max"].GetUint64());
+  }
+  ASSERT_GE(document["endToEnd"]["max"].GetUint64(),
+            document["raster"]["max"].GetUint64());
+
+  params["windowMilliseconds"] = "soon";
+  rapidjson::Document error_document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetFrameTimingPercentiles,
+      shell->GetTaskRunners().GetIOTaskRunner(), params, &error_document);
+  ASSERT_TRUE(error_document.HasMember("code"));
+  ASSERT_EQ(error_document["code"].GetInt64(), -32602);
+
+  DestroyShell(std::move(shell));
+}
+
 // ktz
 TEST_F(ShellTest, OnServiceProtocolRenderFrameWithRasterStatsWorks) {
   auto settings = CreateSettingsForFixture();
@@ -319,6 +319,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  settings.enable_adaptive_pipeline_depth = command_line.HasOption(
+      FlagForSwitch(Switch::EnableAdaptivePipelineDepth));
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
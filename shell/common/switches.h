@@ -128,6 +128,12 @@ DEF_SWITCH(EndlessTraceBuffer,
            "This is useful when very old events need to viewed. For example, "
            "during application launch. Memory usage will continue to grow "
            "indefinitely however.")
+DEF_SWITCH(EnableAdaptivePipelineDepth,
+           "enable-adaptive-pipeline-depth",
+           "Let the UI thread build up to three frames ahead of the raster "
+           "thread while frames take longer to rasterize than the frame "
+           "budget. The depth drops back to one frame during pointer "
+           "interaction.")
 DEF_SWITCH(EnableSoftwareRendering,
            "enable-software-rendering",
            "Enable rendering using the Skia software backend. This is useful "
@@ -48,6 +48,11 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
   const auto size = SkISize::Make(logical_size.width(), logical_size.height());
 
+  if (TiledBackingStore* tiled_backing_store =
+          delegate_->GetTiledBackingStore()) {
+    return AcquireTiledFrame(tiled_backing_store, size);
+  }
+
   sk_sp<SkSurface> backing_store = delegate_->AcquireBackingStore(size);
 
   if (backing_store == nullptr) {
@@ -81,6 +86,66 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
                                         on_submit, logical_size);
 }
 
+std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireTiledFrame(
+    TiledBackingStore* tiled_backing_store,
+    const SkISize& size) {
+  if (!tiled_backing_store->Resize(size)) {
+    return nullptr;
+  }
+
+  // The frame is recorded into a display list and only the tiles that
+  // intersect the damage computed by the rasterizer are re-rasterized from
+  // it on submit. Damage is snapped to the tile grid so that no tile is
+  // rasterized more than once.
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_readback = true;
+  framebuffer_info.supports_partial_repaint = true;
+  framebuffer_info.existing_damage = tiled_backing_store->existing_damage();
+  framebuffer_info.horizontal_clip_alignment =
+      tiled_backing_store->tile_size().width();
+  framebuffer_info.vertical_clip_alignment =
+      tiled_backing_store->tile_size().height();
+
+  SurfaceFrame::SubmitCallback on_submit =
+      [self = weak_factory_.GetWeakPtr()](SurfaceFrame& surface_frame,
+                                          DlCanvas* canvas) -> bool {
+    // If the surface itself went away, there is nothing more to do.
+    if (!self || !self->IsValid()) {
+      return false;
+    }
+
+    TiledBackingStore* tiled_backing_store =
+        self->delegate_->GetTiledBackingStore();
+    if (tiled_backing_store == nullptr) {
+      return false;
+    }
+
+    auto display_list = surface_frame.BuildDisplayList();
+    if (canvas == nullptr || !display_list) {
+      FML_LOG(ERROR) << "Could not build display list for surface frame.";
+      // The rasterizer assumes the frame made it into the backing store, so
+      // the next frame must be painted in full.
+      tiled_backing_store->Invalidate();
+      return false;
+    }
+
+    tiled_backing_store->Rasterize(display_list,
+                                   surface_frame.submit_info().buffer_damage);
+
+    return self->delegate_->PresentBackingStore(
+        tiled_backing_store->surface());
+  };
+
+  return std::make_unique<SurfaceFrame>(nullptr,           // surface
+                                        framebuffer_info,  // framebuffer info
+                                        on_submit,         // submit callback
+                                        size,              // frame size
+                                        nullptr,           // context result
+                                        true,  // display list fallback
+                                        true   // display list fallback rtree
+  );
+}
+
 // |Surface|
 SkMatrix GPUSurfaceSoftware::GetRootTransformation() const {
   // This backend does not currently support root surface transformations. Just
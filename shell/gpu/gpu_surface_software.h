@@ -32,6 +32,10 @@ class GPUSurfaceSoftware : public Surface {
   GrDirectContext* GetContext() override;
 
  private:
+  std::unique_ptr<SurfaceFrame> AcquireTiledFrame(
+      TiledBackingStore* tiled_backing_store,
+      const SkISize& size);
+
   GPUSurfaceSoftwareDelegate* delegate_;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
   // external view embedder may want to render to the root surface. This is a
@@ -8,4 +8,8 @@ namespace flutter {
 
 GPUSurfaceSoftwareDelegate::~GPUSurfaceSoftwareDelegate() = default;
 
+TiledBackingStore* GPUSurfaceSoftwareDelegate::GetTiledBackingStore() {
+  return nullptr;
+}
+
 }  // namespace flutter
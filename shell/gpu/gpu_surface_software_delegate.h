@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/tiled_backing_store.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -48,6 +49,18 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by the GPU surface to decide whether frames should be
+  ///             rendered into a tiled backing store that persists across
+  ///             frames, in which case only the tiles that were damaged since
+  ///             the previous frame are re-rasterized. The surface of the
+  ///             tiled backing store is handed to |PresentBackingStore|.
+  ///
+  /// @return     The tiled backing store to render into, or nullptr to render
+  ///             into the surfaces returned by |AcquireBackingStore|.
+  ///
+  virtual TiledBackingStore* GetTiledBackingStore();
 };
 
 }  // namespace flutter
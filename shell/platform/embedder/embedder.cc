@@ -5,6 +5,7 @@
 #define FML_USED_ON_EMBEDDER
 #define RAPIDJSON_HAS_STDSTRING 1
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -623,9 +624,20 @@ InferSoftwarePlatformViewCreationCallback(
     return ptr(user_data, allocation, row_bytes, height);
   };
 
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+  int32_t tile_size = static_cast<int32_t>(
+      SAFE_ACCESS(software_config, backing_store_tile_size, 0));
+  const size_t rasterizer_thread_count = std::max<size_t>(
+      SAFE_ACCESS(software_config, rasterizer_thread_count, 1), 1);
+  if (rasterizer_thread_count > 1 && tile_size == 0) {
+    tile_size = flutter::TiledBackingStore::kDefaultTileSize;
+  }
+
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,       // required
+          SkISize::Make(tile_size, tile_size),  // optional
+          rasterizer_thread_count,              // optional
       };
 
   return fml::MakeCopyable(
@@ -3062,6 +3074,64 @@ FlutterEngineResult FlutterEngineSetNextFrameCallback(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineGetFrameTimingPercentiles(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingMetric metric,
+    uint64_t window_milliseconds,
+    FlutterFrameTimingPercentiles* percentiles) {
+  auto embedder_engine = reinterpret_cast<flutter::EmbedderEngine*>(engine);
+  if (embedder_engine == nullptr || !embedder_engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (percentiles == nullptr ||
+      percentiles->struct_size < sizeof(FlutterFrameTimingPercentiles)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Frame timing percentiles were invalid.");
+  }
+
+  flutter::FrameTimingHistogram::Metric histogram_metric;
+  switch (metric) {
+    case kFlutterFrameTimingMetricVsyncToBuildStart:
+      histogram_metric =
+          flutter::FrameTimingHistogram::Metric::kVsyncToBuildStart;
+      break;
+    case kFlutterFrameTimingMetricBuild:
+      histogram_metric = flutter::FrameTimingHistogram::Metric::kBuild;
+      break;
+    case kFlutterFrameTimingMetricRaster:
+      histogram_metric = flutter::FrameTimingHistogram::Metric::kRaster;
+      break;
+    case kFlutterFrameTimingMetricEndToEnd:
+      histogram_metric = flutter::FrameTimingHistogram::Metric::kEndToEnd;
+      break;
+    case kFlutterFrameTimingMetricRasterCacheBytes:
+      histogram_metric =
+          flutter::FrameTimingHistogram::Metric::kRasterCacheBytes;
+      break;
+    default:
+      return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                "Invalid frame timing metric.");
+  }
+
+  // Clamp before converting so that large windows cannot overflow.
+  const uint64_t max_window_milliseconds =
+      flutter::FrameTimingHistogram::kMaxWindow.ToMilliseconds();
+  const fml::TimeDelta window = fml::TimeDelta::FromMilliseconds(
+      std::min(window_milliseconds, max_window_milliseconds));
+
+  flutter::FrameTimingPercentiles result =
+      embedder_engine->GetShell().GetFrameTimingHistogram().GetPercentiles(
+          histogram_metric, window, fml::TimePoint::Now());
+
+  percentiles->frame_count = result.count;
+  percentiles->p50 = result.p50;
+  percentiles->p90 = result.p90;
+  percentiles->p99 = result.p99;
+  percentiles->max = result.max;
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -3114,6 +3184,8 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
   SET_PROC(ScheduleFrame, FlutterEngineScheduleFrame);
   SET_PROC(SetNextFrameCallback, FlutterEngineSetNextFrameCallback);
+  SET_PROC(GetFrameTimingPercentiles,
+           FlutterEngineGetFrameTimingPercentiles);
 #undef SET_PROC
 
   return kSuccess;
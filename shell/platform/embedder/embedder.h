@@ -793,6 +793,20 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// The width and height, in physical pixels, of the square tiles of a
+  /// backing store that the engine keeps across frames. When non-zero, only
+  /// the tiles that changed since the previous frame are re-rasterized and
+  /// the same buffer is handed to the `surface_present_callback` for every
+  /// frame. When zero (the default) every frame is rasterized in full.
+  /// Tiles are not used if a FlutterCompositor is supplied in
+  /// FlutterProjectArgs.
+  size_t backing_store_tile_size;
+  /// The number of threads, including the raster thread, that rasterize the
+  /// tiles of a frame in parallel. Values greater than one enable the tiled
+  /// backing store even if `backing_store_tile_size` is zero, in which case
+  /// tiles of 256 by 256 pixels are used. Zero or one (the default)
+  /// rasterize all tiles on the raster thread.
+  size_t rasterizer_thread_count;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -1688,6 +1702,42 @@ typedef enum {
   kFlutterEngineDisplaysUpdateTypeCount,
 } FlutterEngineDisplaysUpdateType;
 
+/// The frame timing metrics whose percentiles can be queried with
+/// `FlutterEngineGetFrameTimingPercentiles`.
+typedef enum {
+  /// The time in microseconds from the vsync signal to the start of the build
+  /// phase of the frame on the UI thread.
+  kFlutterFrameTimingMetricVsyncToBuildStart,
+  /// The time in microseconds spent building the frame on the UI thread.
+  kFlutterFrameTimingMetricBuild,
+  /// The time in microseconds spent rasterizing the frame on the raster
+  /// thread.
+  kFlutterFrameTimingMetricRaster,
+  /// The time in microseconds from the vsync signal to the end of the
+  /// rasterization of the frame.
+  kFlutterFrameTimingMetricEndToEnd,
+  /// The number of bytes used by the raster cache after the frame was
+  /// rasterized.
+  kFlutterFrameTimingMetricRasterCacheBytes,
+} FlutterFrameTimingMetric;
+
+/// The distribution of a frame timing metric over the frames rasterized in a
+/// recent time window. Values are accurate to within 12.5%.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimingPercentiles).
+  size_t struct_size;
+  /// The number of frames in the window.
+  uint64_t frame_count;
+  /// The median value of the metric.
+  uint64_t p50;
+  /// The 90th percentile value of the metric.
+  uint64_t p90;
+  /// The 99th percentile value of the metric.
+  uint64_t p99;
+  /// The largest value of the metric.
+  uint64_t max;
+} FlutterFrameTimingPercentiles;
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -2791,6 +2841,31 @@ FlutterEngineResult FlutterEngineSetNextFrameCallback(
     VoidCallback callback,
     void* user_data);
 
+//------------------------------------------------------------------------------
+/// @brief      Gets the percentiles of a frame timing metric over the frames
+///             that were rasterized in a recent time window. The engine keeps
+///             the timings of the frames of the last minute in a fixed size
+///             histogram so this call is cheap and may be made from any
+///             thread, for instance to drive telemetry.
+///
+/// @param[in]  engine               A running engine instance.
+/// @param[in]  metric               The frame timing metric to query.
+/// @param[in]  window_milliseconds  The length of the window that ends now.
+///                                  Windows longer than a minute are clamped
+///                                  to a minute.
+/// @param[out] percentiles          The percentiles of the metric. The
+///                                  `struct_size` field must be set by the
+///                                  caller.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameTimingPercentiles(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingMetric metric,
+    uint64_t window_milliseconds,
+    FlutterFrameTimingPercentiles* percentiles);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2913,6 +2988,11 @@ typedef FlutterEngineResult (*FlutterEngineSetNextFrameCallbackFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     VoidCallback callback,
     void* user_data);
+typedef FlutterEngineResult (*FlutterEngineGetFrameTimingPercentilesFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingMetric metric,
+    uint64_t window_milliseconds,
+    FlutterFrameTimingPercentiles* percentiles);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2959,6 +3039,7 @@ typedef struct {
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
   FlutterEngineScheduleFrameFnPtr ScheduleFrame;
   FlutterEngineSetNextFrameCallbackFnPtr SetNextFrameCallback;
+  FlutterEngineGetFrameTimingPercentilesFnPtr GetFrameTimingPercentiles;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -23,6 +23,23 @@ EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
   if (!software_dispatch_table_.software_present_backing_store) {
     return;
   }
+  // Platform views are composited by the external view embedder which
+  // renders into backing stores of its own.
+  if (!software_dispatch_table_.backing_store_tile_size.isEmpty() &&
+      !external_view_embedder_) {
+    // The raster thread rasterizes tiles too, so it only needs help from
+    // the remaining threads.
+    const size_t worker_count =
+        software_dispatch_table_.rasterizer_thread_count - 1;
+    std::shared_ptr<fml::BasicTaskRunner> worker_task_runner;
+    if (worker_count > 0) {
+      tile_raster_loop_ = fml::ConcurrentMessageLoop::Create(worker_count);
+      worker_task_runner = tile_raster_loop_->GetTaskRunner();
+    }
+    tiled_backing_store_ = std::make_unique<TiledBackingStore>(
+        software_dispatch_table_.backing_store_tile_size, worker_task_runner,
+        worker_count);
+  }
   valid_ = true;
 }
 
@@ -112,4 +129,9 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+TiledBackingStore* EmbedderSurfaceSoftware::GetTiledBackingStore() {
+  return tiled_backing_store_.get();
+}
+
 }  // namespace flutter
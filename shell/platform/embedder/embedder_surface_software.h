@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include "flutter/flow/tiled_backing_store.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -20,6 +22,13 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
         software_present_backing_store;  // required
+    // The size of the tiles of a backing store that is kept across frames
+    // so that only damaged tiles are re-rasterized. Frames are rasterized in
+    // full into a plain backing store if empty.
+    SkISize backing_store_tile_size = SkISize::MakeEmpty();  // optional
+    // The number of threads, including the raster thread, that rasterize
+    // the tiles of the backing store in parallel.
+    size_t rasterizer_thread_count = 1;  // optional
   };
 
   EmbedderSurfaceSoftware(
@@ -32,6 +41,8 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  std::shared_ptr<fml::ConcurrentMessageLoop> tile_raster_loop_;
+  std::unique_ptr<TiledBackingStore> tiled_backing_store_;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
   // |EmbedderSurface|
@@ -49,6 +60,9 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  TiledBackingStore* GetTiledBackingStore() override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
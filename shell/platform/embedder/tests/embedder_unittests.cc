@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,6 +30,8 @@
 #include "flutter/shell/platform/embedder/tests/embedder_unittests_util.h"
 #include "flutter/testing/assertions_skia.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
@@ -1091,6 +1094,72 @@ TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
       ImageMatchesFixture("verifyb143464703_soft_noxform.png", rendered_scene));
 }
 
+//------------------------------------------------------------------------------
+/// Renders the first frame of the given entrypoint with the software renderer
+/// and returns a copy of its pixels, which are owned by the engine.
+///
+static sk_sp<SkImage> RenderSoftwareScene(EmbedderTestContext& context,
+                                          const std::string& entrypoint,
+                                          size_t backing_store_tile_size,
+                                          size_t rasterizer_thread_count) {
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.GetRendererConfig().software.backing_store_tile_size =
+      backing_store_tile_size;
+  builder.GetRendererConfig().software.rasterizer_thread_count =
+      rasterizer_thread_count;
+  builder.SetDartEntrypoint(entrypoint);
+
+  auto rendered_scene = context.GetNextSceneImage();
+
+  auto engine = builder.LaunchEngine();
+  if (!engine.is_valid()) {
+    return nullptr;
+  }
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  if (FlutterEngineSendWindowMetricsEvent(engine.get(), &event) != kSuccess) {
+    return nullptr;
+  }
+
+  sk_sp<SkImage> image = rendered_scene.get();
+  SkBitmap bitmap;
+  if (!image || !bitmap.tryAllocPixels(image->imageInfo()) ||
+      !image->readPixels(nullptr, bitmap.pixmap(), 0, 0)) {
+    return nullptr;
+  }
+  bitmap.setImmutable();
+  return SkImages::RasterFromBitmap(bitmap);
+}
+
+TEST_F(EmbedderTest, TiledSoftwareRenderingMatchesUntiledRendering) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  for (const char* entrypoint :
+       {"render_gradient", "can_render_scene_without_custom_compositor"}) {
+    auto untiled = RenderSoftwareScene(context, entrypoint, 0, 1);
+    ASSERT_TRUE(untiled);
+
+    auto tiled = RenderSoftwareScene(context, entrypoint, 128, 1);
+    ASSERT_TRUE(tiled);
+    EXPECT_TRUE(RasterImagesAreSame(untiled, tiled)) << entrypoint;
+
+    auto parallel = RenderSoftwareScene(context, entrypoint, 128, 4);
+    ASSERT_TRUE(parallel);
+    EXPECT_TRUE(RasterImagesAreSame(untiled, parallel)) << entrypoint;
+
+    // The thread count alone enables tiles of the default size.
+    auto default_tiles = RenderSoftwareScene(context, entrypoint, 0, 8);
+    ASSERT_TRUE(default_tiles);
+    EXPECT_TRUE(RasterImagesAreSame(untiled, default_tiles)) << entrypoint;
+  }
+}
+
 TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
 
@@ -2226,6 +2295,51 @@ TEST_F(EmbedderTest, CanSetNextFrameCallback) {
   callback_latch.Wait();
 }
 
+TEST_F(EmbedderTest, CanGetFrameTimingPercentiles) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("draw_solid_red");
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameTimingPercentiles percentiles = {};
+  ASSERT_EQ(FlutterEngineGetFrameTimingPercentiles(
+                engine.get(), kFlutterFrameTimingMetricRaster, 1000,
+                &percentiles),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineGetFrameTimingPercentiles(
+                engine.get(), kFlutterFrameTimingMetricRaster, 1000, nullptr),
+            kInvalidArguments);
+
+  // No frame has been rasterized as no window metrics have been sent.
+  percentiles.struct_size = sizeof(percentiles);
+  percentiles.frame_count = 1;
+  ASSERT_EQ(FlutterEngineGetFrameTimingPercentiles(
+                engine.get(), kFlutterFrameTimingMetricRaster,
+                std::numeric_limits<uint64_t>::max(), &percentiles),
+            kSuccess);
+  EXPECT_EQ(percentiles.frame_count, 0u);
+  EXPECT_EQ(percentiles.max, 0u);
+}
+
+TEST_F(EmbedderTest, CannotGetFrameTimingPercentilesOfEngineThatIsNotRunning) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+
+  auto engine = builder.InitializeEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameTimingPercentiles percentiles = {};
+  percentiles.struct_size = sizeof(percentiles);
+  ASSERT_EQ(FlutterEngineGetFrameTimingPercentiles(
+                engine.get(), kFlutterFrameTimingMetricRaster, 1000,
+                &percentiles),
+            kInvalidArguments);
+}
+
 #if defined(FML_OS_MACOSX)
 
 static void MockThreadConfigSetter(const fml::Thread::ThreadConfig& config) {